@@ -9,7 +9,8 @@ set warnings=/WX /W4 /wd4201 /wd4100 /wd4189 /wd4505 /wd4701 /wd4101 /wd4324
 set includes=/I ../my_lib/ /I ../external/ /I ../external/D3D12/headers/d3dx12/ /I ../external/dxc/ /I ../external/D3D12/headers/  /I ../external/DDSTextureLoader
 set linkerFlags=/OUT:DeRex12.exe /INCREMENTAL:NO /OPT:REF /CGTHREADS:6 /STACK:0x100000,0x100000
 set linkerLibs=user32.lib gdi32.lib winmm.lib ole32.lib dxguid.lib dxgi.lib d3d12.lib dxcompiler.lib
-set compilerFlags=/std:c++20 /MP /arch:AVX2 /Oi /Ob3 /EHsc /fp:fast /fp:except- /nologo /GS- /Gs999999 /GR- /FC /Z7 %includes% %warnings%
+REM No /arch - runs on any x64 with SSE4.1, AVX2 / AVX-512 code is picked at runtime by CPUID (Cpu_Features.hpp)
+set compilerFlags=/std:c++20 /MP /Oi /Ob3 /EHsc /fp:fast /fp:except- /nologo /GS- /Gs999999 /GR- /FC /Z7 %includes% %warnings%
 set translation_units=../source/Win32_x64_Platform.cpp ../source/RHI_D3D12.cpp
 
 set dxcLib=/LIBPATH:../external/dxc/
@@ -28,6 +29,12 @@ if "%~1"=="-Release" (
 	set compilerFlags=%compilerFlags% /O2 /MT 
 )
 
+REM set ALLOC_INSTRUMENTATION=1 before build - allocations accounting per arena & call site (Alloc_Instrumentation.hpp)
+if defined ALLOC_INSTRUMENTATION (
+	echo [[ allocation instrumentation ]]
+	set compilerFlags=%compilerFlags% /DALLOC_INSTRUMENTATION
+)
+
 IF NOT EXIST .\build mkdir .\build
 pushd .\build
 
@@ -0,0 +1,47 @@
+#!/bin/sh
+# Headless Linux build (no window, no D3D12) - counterpart of build.bat used for CPU side benchmarks
+
+# CXX wins, otherwise clang++ and then system default "c++"
+compiler=$CXX
+if [ -z "$compiler" ]; then
+	for candidate in clang++ c++; do
+		if command -v "$candidate" >/dev/null 2>&1; then
+			compiler=$candidate
+			break
+		fi
+	done
+fi
+
+if [ -z "$compiler" ] || ! command -v "$compiler" >/dev/null 2>&1; then
+	echo "ERROR: could not find C++ compiler (\"${compiler:-clang++ or c++}\") - set CXX to a C++20 compiler."
+	exit 1
+fi
+
+warnings="-Wall -Wextra"
+includes="-I ../my_lib/ -I ../external/"
+linkerFlags="-pthread"
+# SSE4.1 baseline - AVX2 / AVX-512 code is picked at runtime by CPUID (Cpu_Features.hpp)
+compilerFlags="-std=c++20 -msse4.1 -ffast-math -fno-rtti -g $includes $warnings"
+translation_units="../source/Linux_x64_Platform.cpp ../source/RHI_Null.cpp ../source/App.cpp"
+# Self-checks of my_lib, "DeRex12_tests" exits with 1 when any of them fails
+test_translation_units="../source/Linux_x64_Tests.cpp"
+
+if [ "$1" = "-Release" ]; then
+	echo "[[ release build ]]"
+	compilerFlags="$compilerFlags -O2"
+else
+	echo "[[ debug build ]]"
+	compilerFlags="$compilerFlags -O0 -D_DEBUG"
+fi
+
+# ALLOC_INSTRUMENTATION=1 ./build.sh - allocations accounting per arena & call site (Alloc_Instrumentation.hpp)
+if [ -n "$ALLOC_INSTRUMENTATION" ]; then
+	echo "[[ allocation instrumentation ]]"
+	compilerFlags="$compilerFlags -DALLOC_INSTRUMENTATION"
+fi
+
+mkdir -p ./build
+cd ./build || exit 1
+
+$compiler $compilerFlags $translation_units $linkerFlags -o DeRex12_headless || exit 1
+$compiler $compilerFlags $test_translation_units $linkerFlags -o DeRex12_tests
@@ -0,0 +1,278 @@
+#pragma once
+
+//? Optional accounting of allocations, compiled in only with ALLOC_INSTRUMENTATION defined (zero cost otherwise).
+//? Every "allocate"/"push_type" records its call site (file:line of caller) and allocator, so report shows per allocator
+//? usage, its peak and % of budget, plus count & bytes per call site - both for last frame and in total.
+//? Tables are global per module - with hot reloaded App DLL, App and platform/RHI have separate ones, so
+//? "alloc_print_report" shows allocations of module it is called from.
+//? Usage: name allocators you care about once, call "alloc_end_frame" at frame boundary and print report when needed.
+//? Wrappers that allocate on behalf of their caller (containers, library callbacks) take ALLOC_SITE_PARAM too and pass
+//? it on, so recorded site is the caller and not the wrapper
+
+#include <cstdio>
+#include <cstring>
+
+#include "Utils.hpp"
+
+#if defined(ALLOC_INSTRUMENTATION)
+#include <atomic>
+#include <source_location>
+
+#define ALLOC_SITE_PARAM , const std::source_location alloc_site = std::source_location::current()
+#define ALLOC_SITE_ARG , alloc_site
+#define ALLOC_RECORD(allocator, bytes, used_bytes) alloc_record(allocator, alloc_site, bytes, used_bytes)
+#define ALLOC_SET_USED(allocator, used_bytes) alloc_set_used(allocator, used_bytes)
+#define ALLOC_RECORD_CHILD(allocator, bytes, end_offset) alloc_record_child(allocator, bytes, end_offset)
+#else
+#define ALLOC_SITE_PARAM
+#define ALLOC_SITE_ARG
+#define ALLOC_RECORD(allocator, bytes, used_bytes)
+#define ALLOC_SET_USED(allocator, used_bytes)
+#define ALLOC_RECORD_CHILD(allocator, bytes, end_offset)
+#endif
+
+inline constexpr u32 g_max_count_alloc_sites = 1024; // power of 2, open addressing
+inline constexpr u32 g_max_count_alloc_owners = 64;
+
+struct Alloc_Counters
+{
+	u64 count;
+	u64 bytes;
+};
+
+struct Alloc_Site_Stats
+{
+	const void* allocator;
+	const char* file;
+	const char* function;
+	u32 line;
+
+	Alloc_Counters frame;
+	Alloc_Counters total;
+};
+
+//? Per allocator, "used_bytes" is its offset after last allocation (for arenas) without ranges reserved for child
+//? arenas, peaks are taken from it. Child ranges are counted in "children_bytes", their users report them on their own
+struct Alloc_Owner_Stats
+{
+	const void* allocator;
+	const char* name;
+	u64 max_size;
+
+	u64 children_bytes;
+	u64 children_end_offset;
+	u64 used_bytes;
+	u64 peak_bytes;
+	u64 frame_peak_bytes;
+
+	Alloc_Counters frame;
+	Alloc_Counters total;
+};
+
+struct Alloc_Instrumentation
+{
+	u64 count_frames;
+	u32 count_owners;
+	u32 count_sites;
+	Alloc_Owner_Stats owners[g_max_count_alloc_owners];
+	Alloc_Site_Stats sites[g_max_count_alloc_sites];
+	b32 is_sites_overflow;
+
+#if defined(ALLOC_INSTRUMENTATION)
+	std::atomic_flag lock;
+#endif
+};
+
+#if defined(ALLOC_INSTRUMENTATION)
+inline Alloc_Instrumentation g_alloc_instrumentation;
+
+struct Alloc_Instrumentation_Lock
+{
+	Alloc_Instrumentation_Lock() { while (g_alloc_instrumentation.lock.test_and_set(std::memory_order_acquire)) {} }
+	~Alloc_Instrumentation_Lock() { g_alloc_instrumentation.lock.clear(std::memory_order_release); }
+};
+
+//? Caller must hold the lock
+[[nodiscard]]
+inline Alloc_Owner_Stats* alloc_find_owner(const void* allocator)
+{
+	auto* in = &g_alloc_instrumentation;
+	for (u32 i = 0; i < in->count_owners; ++i)
+	{
+		if (in->owners[i].allocator == allocator)
+			return &in->owners[i];
+	}
+
+	if (in->count_owners == g_max_count_alloc_owners)
+		return nullptr;
+
+	Alloc_Owner_Stats* out = &in->owners[in->count_owners++];
+	*out = {};
+	out->allocator = allocator;
+	return out;
+}
+
+inline void alloc_record(const void* allocator, const std::source_location& site, const u64 bytes, u64 used_bytes)
+{
+	auto* in = &g_alloc_instrumentation;
+	Alloc_Instrumentation_Lock lock;
+
+	if (Alloc_Owner_Stats* owner = alloc_find_owner(allocator))
+	{
+		used_bytes = (used_bytes > owner->children_bytes) ? used_bytes - owner->children_bytes : 0;
+		owner->used_bytes = used_bytes;
+		owner->peak_bytes = (used_bytes > owner->peak_bytes) ? used_bytes : owner->peak_bytes;
+		owner->frame_peak_bytes = (used_bytes > owner->frame_peak_bytes) ? used_bytes : owner->frame_peak_bytes;
+		owner->frame.count += 1;
+		owner->frame.bytes += bytes;
+		owner->total.count += 1;
+		owner->total.bytes += bytes;
+	}
+
+	// Same file name may be a different string in every translation unit, so it is not hashed
+	u64 hash = (((u64)site.line() * 0x9E3779B97F4A7C15ull) ^ ((u64)allocator >> 4)) * 0xff51afd7ed558ccdull;
+	u32 mask = g_max_count_alloc_sites - 1;
+	for (u32 probe = 0; probe < g_max_count_alloc_sites; ++probe)
+	{
+		Alloc_Site_Stats* stats = &in->sites[((u32)(hash >> 32) + probe) & mask];
+		if (stats->file == nullptr)
+		{
+			*stats = { .allocator = allocator, .file = site.file_name(), .function = site.function_name(), .line = site.line(),
+			           .frame = {}, .total = {} };
+			in->count_sites += 1;
+		}
+		else if (stats->line != site.line() || stats->allocator != allocator || 
+		         (stats->file != site.file_name() && strcmp(stats->file, site.file_name()) != 0))
+		{
+			continue;
+		}
+
+		stats->frame.count += 1;
+		stats->frame.bytes += bytes;
+		stats->total.count += 1;
+		stats->total.bytes += bytes;
+		return;
+	}
+
+	in->is_sites_overflow = true;
+}
+
+//? Range ending at "end_offset" was reserved for child arena, it is not counted in "used_bytes" of this allocator
+inline void alloc_record_child(const void* allocator, const u64 bytes, const u64 end_offset)
+{
+	Alloc_Instrumentation_Lock lock;
+	if (Alloc_Owner_Stats* owner = alloc_find_owner(allocator))
+	{
+		owner->children_bytes += bytes;
+		owner->children_end_offset = (end_offset > owner->children_end_offset) ? end_offset : owner->children_end_offset;
+	}
+}
+
+//? Allocator got smaller (reset, end of temp, pop), only known allocators are updated. Going below child ranges
+//? invalidates them
+inline void alloc_set_used(const void* allocator, u64 used_bytes)
+{
+	auto* in = &g_alloc_instrumentation;
+	Alloc_Instrumentation_Lock lock;
+	for (u32 i = 0; i < in->count_owners; ++i)
+	{
+		Alloc_Owner_Stats* owner = &in->owners[i];
+		if (owner->allocator != allocator)
+			continue;
+
+		if (used_bytes < owner->children_end_offset)
+		{
+			owner->children_bytes = 0;
+			owner->children_end_offset = 0;
+		}
+		owner->used_bytes = (used_bytes > owner->children_bytes) ? used_bytes - owner->children_bytes : 0;
+	}
+}
+#endif
+
+//? Name and budget shown in report, "max_size" of 0 is taken as unknown
+inline void alloc_name([[maybe_unused]] const void* allocator, [[maybe_unused]] const char* name, [[maybe_unused]] const u64 max_size)
+{
+#if defined(ALLOC_INSTRUMENTATION)
+	Alloc_Instrumentation_Lock lock;
+	if (Alloc_Owner_Stats* owner = alloc_find_owner(allocator))
+	{
+		owner->name = name;
+		owner->max_size = max_size;
+	}
+#endif
+}
+
+//? Starts new frame for "frame" counters & peaks - call it before first allocation of a frame
+inline void alloc_end_frame()
+{
+#if defined(ALLOC_INSTRUMENTATION)
+	auto* in = &g_alloc_instrumentation;
+	Alloc_Instrumentation_Lock lock;
+
+	in->count_frames += 1;
+	for (u32 i = 0; i < in->count_owners; ++i)
+	{
+		in->owners[i].frame = {};
+		in->owners[i].frame_peak_bytes = in->owners[i].used_bytes;
+	}
+	for (auto& site : in->sites)
+		site.frame = {};
+#endif
+}
+
+[[nodiscard]]
+inline const char* alloc_file_name(const char* path)
+{
+	const char* out = path;
+	for (const char* at = path; *at; ++at)
+	{
+		if (*at == '/' || *at == '\\')
+			out = at + 1;
+	}
+	return out;
+}
+
+//? Current frame counters (since last "alloc_end_frame") and totals, call sites grouped under their allocator
+inline void alloc_print_report(FILE* out)
+{
+#if defined(ALLOC_INSTRUMENTATION)
+	auto* in = &g_alloc_instrumentation;
+	Alloc_Instrumentation_Lock lock;
+
+	fprintf(out, "allocations in frame %llu (frame | total):\n", (unsigned long long)in->count_frames);
+	for (u32 owner_i = 0; owner_i < in->count_owners; ++owner_i)
+	{
+		const Alloc_Owner_Stats* owner = &in->owners[owner_i];
+		// Budget of allocator itself, child ranges are reported by child arenas
+		u64 own_max_size = (owner->max_size > owner->children_bytes) ? owner->max_size - owner->children_bytes : 0;
+		fprintf(out, "  %-16s peak %llu (frame %llu) / %llu bytes (%.2lf%%), children %llu bytes | %llu allocs, %llu bytes | %llu allocs, %llu bytes\n",
+		        owner->name ? owner->name : "<unnamed>",
+		        (unsigned long long)owner->peak_bytes, (unsigned long long)owner->frame_peak_bytes,
+		        (unsigned long long)own_max_size,
+		        own_max_size ? 100.0 * (f64)owner->peak_bytes / (f64)own_max_size : 0.0,
+		        (unsigned long long)owner->children_bytes,
+		        (unsigned long long)owner->frame.count, (unsigned long long)owner->frame.bytes,
+		        (unsigned long long)owner->total.count, (unsigned long long)owner->total.bytes);
+
+		for (const auto& site : in->sites)
+		{
+			if (site.file == nullptr || site.allocator != owner->allocator)
+				continue;
+
+			char location[64];
+			snprintf(location, sizeof(location), "%s:%u", alloc_file_name(site.file), site.line);
+			fprintf(out, "    %-32s %-40.40s %llu allocs, %llu bytes | %llu allocs, %llu bytes\n", location, site.function,
+			        (unsigned long long)site.frame.count, (unsigned long long)site.frame.bytes,
+			        (unsigned long long)site.total.count, (unsigned long long)site.total.bytes);
+		}
+	}
+
+	if (in->count_owners == g_max_count_alloc_owners)
+		fprintf(out, "  WARNING: allocators table is full, some are not reported\n");
+	if (in->is_sites_overflow)
+		fprintf(out, "  WARNING: call sites table is full, some are not reported\n");
+#else
+	fprintf(out, "allocations: build with ALLOC_INSTRUMENTATION defined to get report\n");
+#endif
+}
@@ -2,50 +2,151 @@
 
 #include <cassert>
 #include <cstring>
+#include <atomic>
 
 #include "Utils.hpp"
+#include "VM_Memory.hpp"
+#include "Alloc_Instrumentation.hpp"
 
 //TODO: CUSTOM MEMSET
-//TODO: Consider removing memsetting or leaving it only for reset 
+
+//? When memory handed out by arena/pool is zeroed. Default "on_free" keeps returned memory always zeroed by paying
+//? on reset/end of temp/free_block for everything used before, other policies move or skip that cost
+enum struct Alloc_Zeroing : u8
+{
+	on_free,				// memset of freed range, reset cost grows with bytes used
+	none,						// never zeroed, content of returned memory is undefined, reset is O(1)
+	on_allocate,		// only requested range is zeroed by allocate, reset is O(1)
+	reclaim_pages,	// as "on_free", but freed ranges over "reclaim_threshold" give their whole pages back to OS
+									// (they come back zeroed on next touch), arena memory must come from "vm_reserve"!
+};
+
+inline constexpr u64 g_default_reclaim_threshold = KiB(256);
 
 template <typename T>
 [[nodiscard]]
-inline T *push_type(auto *allocator, u32 count = 1)
+inline T *push_type(auto *allocator, u32 count = 1 ALLOC_SITE_PARAM)
 {
-	return ( T*)allocate(allocator, sizeof(T) * count, alignof(T));
+	return ( T*)allocate(allocator, sizeof(T) * count, alignof(T) ALLOC_SITE_ARG);
 } 
 
-struct Alloc_Arena_Temp
+//? Arena works in one of two modes:
+//? 1) memory fully committed up front (commit_step == 0), it is just a view on provided memory
+//? 2) lazily committed (commit_step != 0), "base" points to reserved address space and pages are committed
+//?		in "commit_step" chunks as "curr_offset" grows, on reset everything above "retained_size" is decommitted
+//? Independently of mode "zeroing" selects when memory is zeroed, "reclaim_threshold" of 0 means default one and
+//? threshold below one page counts as one page
+struct Alloc_Arena
 {
+	u64 max_size;
+	byte *base;
+
 	u64 curr_offset;
 	u64 prev_offset;
+	
+	u64 committed_size;
+	u64 children_size; // part of "committed_size" handed to child arenas as reserved ranges, committed by them
+	u64 commit_step;
+	u64 retained_size;
+
+	Alloc_Zeroing zeroing;
+	u64 reclaim_threshold;
 };
 
-struct Alloc_Arena
+//? Arena state saved by "arena_start_temp", temps of one arena can nest but must end in reverse order
+struct Alloc_Arena_Temp
 {
-	u64 max_size;
-	byte *base;
-
+	Alloc_Arena *arena;
 	u64 curr_offset;
 	u64 prev_offset;
-	Alloc_Arena_Temp temp_start;
 };
 
+//? "base" must be reserved (not committed) and page aligned, "retained_size" of max_size means never decommit
+[[nodiscard]]
+inline Alloc_Arena arena_from_reserved(void *base, const u64 max_size, const u64 commit_step, const u64 retained_size)
+{
+	assert(commit_step > 0 && "Use plain arena for already committed memory");
+	return { .max_size = max_size, .base = (byte *)base, .curr_offset = 0, .prev_offset = 0, .committed_size = 0, .children_size = 0,
+	         .commit_step = vm_align_to_page(commit_step), .retained_size = vm_align_to_page(retained_size),
+	         .zeroing = Alloc_Zeroing::on_free, .reclaim_threshold = vm_align_to_page(g_default_reclaim_threshold) };
+}
+
+//? Lazily committed arena with its own address space reservation
+[[nodiscard]]
+inline Alloc_Arena arena_reserve(const u64 max_size, const u64 commit_step = MiB(1))
+{
+	return arena_from_reserved(vm_reserve(max_size), max_size, commit_step, max_size);
+}
+
+//? Same as "arena_reserve" but backed by huge pages where OS gives them, commit step is rounded up to huge page.
+//? Child arenas start on commit step boundary, so they get huge pages too
+[[nodiscard]]
+inline Alloc_Arena arena_reserve_huge(const u64 max_size, const u64 commit_step = g_vm_huge_page_size)
+{
+	return arena_from_reserved(vm_reserve_huge(max_size), max_size, AlignAddressPow2(commit_step, g_vm_huge_page_size), max_size);
+}
+
+inline void arena_commit_up_to(Alloc_Arena *arena, const u64 offset)
+{
+	assert(offset <= arena->max_size && "No more memory!");
+	u64 new_committed = (offset + (arena->commit_step - 1)) / arena->commit_step * arena->commit_step;
+	new_committed = (new_committed > arena->max_size) ? vm_align_to_page(arena->max_size) : new_committed;
+	
+	b32 is_committed = vm_commit(arena->base + arena->committed_size, new_committed - arena->committed_size);
+	assert(is_committed && "Failed to commit memory");
+	arena->committed_size = new_committed;
+}
+
+inline void arena_ensure_committed(Alloc_Arena *arena, const u64 offset)
+{
+	if (arena->commit_step != 0 && offset > arena->committed_size)
+		arena_commit_up_to(arena, offset);
+}
+
+//? Hands out address range without committing it, only for lazily committed arenas (used to carve child arenas).
+//? Range is skipped by commits of this arena from now on - its owner commits it, and reset of this arena invalidates it.
+//? It is counted in "children_size", so "committed_size" minus it is what this arena committed itself
+[[nodiscard]]
+inline void *arena_push_reserved(Alloc_Arena *arena, const u64 size_bytes)
+{
+	assert(arena->commit_step != 0 && "Arena is not lazily committed");
+	
+	// Child range starts on commit step boundry, so it never shares pages with memory committed by this arena
+	u64 start = (arena->curr_offset + (arena->commit_step - 1)) / arena->commit_step * arena->commit_step;
+	assert( ( (start + size_bytes) <= arena->max_size) && "No more memory!" );
+	// Padding to commit step boundry is counted with child, it is not used by this arena either
+	ALLOC_RECORD_CHILD(arena, start + size_bytes - arena->curr_offset, start + size_bytes);
+	
+	arena->prev_offset = start;
+	arena->curr_offset = start + size_bytes;
+	u64 new_committed = (arena->curr_offset + (arena->commit_step - 1)) / arena->commit_step * arena->commit_step;
+	u64 own_end = (arena->committed_size > start) ? arena->committed_size : start;
+	if (new_committed > own_end)
+	{
+		arena->children_size += new_committed - own_end;
+		arena->committed_size = new_committed;
+	}
+	
+	return arena->base + start;
+}
+
 [[nodiscard]]
 inline Alloc_Arena arena_from_allocator(auto* allocator, const u64 max_size)
 {
 	return { max_size, (byte *)allocate(allocator, max_size) };
 }
 
-inline u64 manual_offset(Alloc_Arena *arena, u64 offset)
+inline u64 manual_offset(Alloc_Arena *arena, u64 offset ALLOC_SITE_PARAM)
 {
 	assert( ( (arena->curr_offset + offset) <= arena->max_size) && "No more memory!" );
 	arena->curr_offset += offset;
+	arena_ensure_committed(arena, arena->curr_offset);
+	ALLOC_RECORD(arena, offset, arena->curr_offset);
 	return arena->curr_offset;
 }
 
 [[nodiscard]]
-inline void *allocate(Alloc_Arena *arena, const u64 size_bytes, const u64 alignment = alignof(u64))
+inline void *allocate(Alloc_Arena *arena, const u64 size_bytes, const u64 alignment = alignof(u64) ALLOC_SITE_PARAM)
 {
 	arena->curr_offset = AlignAddressPow2((u64)arena->base + arena->curr_offset, alignment);
 	arena->curr_offset -= (u64)arena->base;
@@ -54,24 +155,31 @@ inline void *allocate(Alloc_Arena *arena, const u64 size_bytes, const u64 alignm
 	void *out = (void*) ((byte*)arena->base + arena->curr_offset);
 	arena->prev_offset = arena->curr_offset;
 	arena->curr_offset += size_bytes;
+	arena_ensure_committed(arena, arena->curr_offset);
+	ALLOC_RECORD(arena, size_bytes, arena->curr_offset);
+	
+	if (arena->zeroing == Alloc_Zeroing::on_allocate)
+		memset(out, 0, size_bytes);
 
 	return out;
 }
 
+//? Child of lazily committed arena is lazily committed too, "retained_size" of 0 means never decommit
 [[nodiscard]]
-inline void *arena_resize_last(Alloc_Arena *arena, void *old_memory, const u64 size_bytes)
+inline Alloc_Arena arena_from_allocator(Alloc_Arena* parent, const u64 max_size, const u64 retained_size = 0 ALLOC_SITE_PARAM)
 {
-	assert((byte *)old_memory == arena->base + arena->prev_offset && "This is not last allocated memory");
-	assert( ( (arena->curr_offset + size_bytes) <= arena->max_size) && "No more memory!" );
-
-	auto new_size = arena->prev_offset + size_bytes;
-	auto old_size = arena->curr_offset - arena->prev_offset;
-
-	if(new_size < old_size)
-		memset(arena->base + new_size, 0, old_size - new_size);
-	arena->curr_offset = new_size;
+	if (parent->commit_step == 0)
+	{
+		// Whole range goes to child, same as reserved one
+		ALLOC_RECORD_CHILD(parent, max_size, parent->curr_offset + max_size);
+		Alloc_Arena out{};
+		out.max_size = max_size;
+		out.base = (byte *)allocate(parent, max_size, alignof(u64) ALLOC_SITE_ARG);
+		return out;
+	}
 	
-	return old_memory;
+	return arena_from_reserved(arena_push_reserved(parent, max_size), max_size, parent->commit_step, 
+	                           retained_size ? retained_size : max_size);
 }
 
 //?(doc) Null terminated ASCII string assumed
@@ -96,46 +204,383 @@ inline auto arena_push_string(Alloc_Arena *arena, const char *string)
 	return Output{src, size};
 }
 
-inline void arena_start_temp(Alloc_Arena *arena)
+//? Lazily committed arena gives pages above its retained size back to OS, they come back zeroed on next commit.
+//? Called when arena gets empty, so child ranges are gone too
+inline void arena_decommit_to_retained(Alloc_Arena *arena)
+{
+	// Child ranges were never committed by this arena, they can not stay below "committed_size"
+	if (arena->children_size != 0)
+	{
+		b32 is_decommitted = vm_decommit(arena->base, arena->committed_size);
+		assert(is_decommitted && "Failed to decommit memory");
+		arena->committed_size = 0;
+		arena->children_size = 0;
+	}
+	
+	if (arena->commit_step != 0 && arena->committed_size > arena->retained_size)
+	{
+		b32 is_decommitted = vm_decommit(arena->base + arena->retained_size, arena->committed_size - arena->retained_size);
+		assert(is_decommitted && "Failed to decommit memory");
+		arena->committed_size = arena->retained_size;
+	}
+}
+
+//? Threshold is never below one page, smaller freed range has no whole page to give back
+[[nodiscard]]
+inline u64 arena_get_reclaim_threshold(const Alloc_Arena *arena)
+{
+	u64 threshold = arena->reclaim_threshold ? arena->reclaim_threshold : g_default_reclaim_threshold;
+	return (threshold < vm_page_size()) ? vm_page_size() : threshold;
+}
+
+//? Applies arena zeroing policy to range [start, end) that is no longer used
+inline void arena_zero_freed(Alloc_Arena *arena, const u64 start, u64 end)
+{
+	if (arena->zeroing == Alloc_Zeroing::none || arena->zeroing == Alloc_Zeroing::on_allocate)
+		return;
+	
+	// Decommitted part is already zero
+	if (arena->commit_step != 0 && end > arena->committed_size)
+		end = arena->committed_size;
+	if (end <= start)
+		return;
+	
+	if (arena->zeroing == Alloc_Zeroing::reclaim_pages && (end - start) >= arena_get_reclaim_threshold(arena))
+	{
+		// Partial pages on both sides keep their memory and are cleared by hand
+		u64 page_mask = vm_page_size() - 1;
+		u64 pages_start = ((u64)arena->base + start + page_mask) & ~page_mask;
+		u64 pages_end = ((u64)arena->base + end) & ~page_mask;
+		if (pages_end <= pages_start)
+		{
+			// No whole page inside the range
+			memset(arena->base + start, 0, end - start);
+			return;
+		}
+		
+		memset(arena->base + start, 0, pages_start - ((u64)arena->base + start));
+		b32 is_reclaimed = vm_reclaim((void *)pages_start, pages_end - pages_start);
+		assert(is_reclaimed && "Failed to reclaim memory");
+		memset((void *)pages_end, 0, ((u64)arena->base + end) - pages_end);
+		return;
+	}
+	
+	memset(arena->base + start, 0, end - start);
+}
+
+[[nodiscard]]
+inline void *arena_resize_last(Alloc_Arena *arena, void *old_memory, const u64 size_bytes)
+{
+	assert((byte *)old_memory == arena->base + arena->prev_offset && "This is not last allocated memory");
+	assert( ( (arena->prev_offset + size_bytes) <= arena->max_size) && "No more memory!" );
+
+	// Both are offsets from arena base, not sizes
+	u64 new_end = arena->prev_offset + size_bytes;
+	u64 old_end = arena->curr_offset;
+	arena_ensure_committed(arena, new_end);
+	
+	if (arena->zeroing == Alloc_Zeroing::on_allocate && new_end > old_end)
+		memset(arena->base + old_end, 0, new_end - old_end);
+
+	if (new_end < old_end)
+		arena_zero_freed(arena, new_end, old_end);
+	arena->curr_offset = new_end;
+	ALLOC_SET_USED(arena, new_end);
+	
+	return old_memory;
+}
+
+[[nodiscard]]
+inline Alloc_Arena_Temp arena_start_temp(Alloc_Arena *arena)
 {
 	assert(arena);
-	arena->temp_start.curr_offset = arena->curr_offset;
-	arena->temp_start.prev_offset = arena->prev_offset;
+	return { arena, arena->curr_offset, arena->prev_offset };
 }
 
-inline void arena_end_temp(Alloc_Arena *arena)
+inline void arena_end_temp(Alloc_Arena_Temp temp)
 {
+	Alloc_Arena *arena = temp.arena;
 	assert(arena);
-	memset(arena->base + arena->prev_offset, 0, arena->curr_offset - arena->prev_offset);
-	arena->curr_offset = arena->temp_start.curr_offset;
-	arena->prev_offset = arena->temp_start.prev_offset;
+	assert(arena->curr_offset >= temp.curr_offset && "Temp ended after its outer temp or arena reset");
+	
+	// Arena is empty again, so outermost temp can give back memory above retained size
+	if (temp.curr_offset == 0)
+		arena_decommit_to_retained(arena);
+	arena_zero_freed(arena, temp.curr_offset, arena->curr_offset);
+	arena->curr_offset = temp.curr_offset;
+	arena->prev_offset = temp.prev_offset;
+	ALLOC_SET_USED(arena, arena->curr_offset);
 }
 
+//? Ends temp on scope exit, nest them freely
+struct Arena_Temp_Scope
+{
+	Alloc_Arena_Temp temp;
+	
+	explicit Arena_Temp_Scope(Alloc_Arena *arena) : temp(arena_start_temp(arena)) {}
+	~Arena_Temp_Scope() { arena_end_temp(temp); }
+	
+	Arena_Temp_Scope(const Arena_Temp_Scope&) = delete;
+	Arena_Temp_Scope& operator=(const Arena_Temp_Scope&) = delete;
+	
+	Alloc_Arena *arena() const { return temp.arena; }
+};
+
 inline void arena_reset(Alloc_Arena *arena)
 {
 	assert(arena);
-	memset(arena->base, 0, arena->curr_offset);
+	arena_decommit_to_retained(arena);
+	arena_zero_freed(arena, 0, arena->curr_offset);
 	arena->curr_offset = 0;
 	arena->prev_offset = 0;
+	ALLOC_SET_USED(arena, 0);
 }
 
 inline void arena_reset_nz(Alloc_Arena *arena)
 {
 	assert(arena);
+	arena_decommit_to_retained(arena);
 	arena->curr_offset = 0;
 	arena->prev_offset = 0;
+	ALLOC_SET_USED(arena, 0);
+}
+
+//? Every thread has a pair of lazily committed scratch arenas, only address space is reserved on first use and it is
+//? never released - threads are expected to live as long as process. Two of them are enough to avoid conflict between
+//? caller scratch and callee one: when function gets output arena that may be a scratch, it passes it as "conflict"
+inline constexpr u64 g_scratch_max_size = GiB(1);
+inline constexpr u64 g_scratch_commit_step = KiB(64);
+inline constexpr u64 g_scratch_retained_size = MiB(1);
+inline constexpr u32 g_count_scratch_arenas = 2;
+
+inline thread_local Alloc_Arena g_scratch_arenas[g_count_scratch_arenas];
+
+[[nodiscard]]
+inline Arena_Temp_Scope get_scratch(const Alloc_Arena *conflict = nullptr)
+{
+	Alloc_Arena *scratch = &g_scratch_arenas[0];
+	if (scratch == conflict)
+		scratch = &g_scratch_arenas[1];
+	
+	if (scratch->base == nullptr)
+	{
+		void *base = vm_reserve(g_scratch_max_size);
+		assert(base && "Failed to reserve scratch arena");
+		*scratch = arena_from_reserved(base, g_scratch_max_size, g_scratch_commit_step, g_scratch_retained_size);
+		alloc_name(scratch, "scratch", g_scratch_max_size);
+		scratch->zeroing = Alloc_Zeroing::on_allocate; // scratch is ended often and mostly overwritten anyway
+	}
+	
+	return Arena_Temp_Scope(scratch);
 }
 
-inline void *arena_alloc_for_lib(void *arena, u64 size)
+//? "user_data" of C library allocation callbacks (cgltf), allocations made by library are recorded at place where
+//? context was made, its callbacks can not take call site
+struct Arena_Lib_Context
 {
-	return allocate((Alloc_Arena *)arena, size);
+	Alloc_Arena *arena;
+#if defined(ALLOC_INSTRUMENTATION)
+	std::source_location alloc_site;
+#endif
+};
+
+[[nodiscard]]
+inline Arena_Lib_Context arena_lib_context(Alloc_Arena *arena ALLOC_SITE_PARAM)
+{
+	Arena_Lib_Context out{};
+	out.arena = arena;
+#if defined(ALLOC_INSTRUMENTATION)
+	out.alloc_site = alloc_site;
+#endif
+	return out;
 }
 
-inline void arena_reset_for_lib(void *arena, void *ptr)
+//? "context" is Arena_Lib_Context
+inline void *arena_alloc_for_lib(void *context, u64 size)
+{
+	Arena_Lib_Context *lib_context = (Arena_Lib_Context *)context;
+#if defined(ALLOC_INSTRUMENTATION)
+	const std::source_location alloc_site = lib_context->alloc_site;
+#endif
+	return allocate(lib_context->arena, size, alignof(u64) ALLOC_SITE_ARG);
+}
+
+inline void arena_reset_for_lib(void * /*arena*/, void * /*ptr*/)
 {
 	// Nothing
 }
 
+//? Arena for many producer threads: "allocate" may be called concurrently, every thread bumps inside its own chunk
+//? taken from shared atomic offset, so threads only contend once per "chunk_size" bytes. Allocations bigger than
+//? half of chunk (or all of them with "chunk_size" of 0) go straight to shared offset.
+//? Reset only from one thread while no one allocates (main thread between frames) - it invalidates all chunks.
+//? Lazily committed mode works as in Alloc_Arena, every thread commits pages of its own chunks
+struct Alloc_Arena_MT
+{
+	u64 max_size;
+	byte *base;
+	u64 chunk_size;
+	
+	u64 committed_size; // below it pages are known to be committed, changes only on reset
+	u64 commit_step;
+	u64 retained_size;
+	Alloc_Zeroing zeroing;
+	u64 reclaim_threshold;
+	
+	// Written by all threads, kept away from read mostly fields above
+	alignas(64) std::atomic<u64> curr_offset;
+	std::atomic<u64> commit_high_water;
+	std::atomic<u32> epoch;
+};
+
+//? Thread's current chunk of one MT arena, chunks from before arena reset are recognised by "epoch"
+struct Arena_MT_Chunk
+{
+	const Alloc_Arena_MT *arena;
+	u32 epoch;
+	u64 curr_offset;
+	u64 end_offset;
+};
+
+inline constexpr u64 g_default_arena_mt_chunk_size = KiB(64);
+inline constexpr u32 g_count_arena_mt_chunks = 4; // MT arenas one thread can push into without losing its chunks
+
+inline thread_local Arena_MT_Chunk g_arena_mt_chunks[g_count_arena_mt_chunks];
+inline thread_local u32 g_arena_mt_chunk_next_evict;
+
+inline void arena_mt_init(Alloc_Arena_MT *arena, void *base, const u64 max_size, const u64 chunk_size = g_default_arena_mt_chunk_size)
+{
+	arena->max_size = max_size;
+	arena->base = (byte *)base;
+	arena->chunk_size = chunk_size;
+	arena->curr_offset.store(0, std::memory_order_relaxed);
+	arena->commit_high_water.store(0, std::memory_order_relaxed);
+	arena->epoch.store(0, std::memory_order_relaxed);
+}
+
+//? Same as "arena_from_allocator" - child of lazily committed arena is lazily committed too
+inline void arena_mt_from_allocator(Alloc_Arena_MT *arena, Alloc_Arena *parent, const u64 max_size, 
+                                    const u64 retained_size = 0, const u64 chunk_size = g_default_arena_mt_chunk_size)
+{
+	if (parent->commit_step == 0)
+	{
+		arena_mt_init(arena, allocate(parent, max_size), max_size, chunk_size);
+		return;
+	}
+	
+	arena_mt_init(arena, arena_push_reserved(parent, max_size), max_size, chunk_size);
+	arena->commit_step = parent->commit_step;
+	arena->retained_size = vm_align_to_page(retained_size ? retained_size : max_size);
+}
+
+//? Range [start, end) was just taken from shared offset by calling thread, pages shared with neighbours are committed
+//? twice which is harmless
+inline void arena_mt_commit_range(Alloc_Arena_MT *arena, const u64 start, const u64 end)
+{
+	if (arena->commit_step == 0 || end <= arena->committed_size)
+		return;
+	
+	u64 page_mask = vm_page_size() - 1;
+	u64 commit_start = start & ~page_mask;
+	b32 is_committed = vm_commit(arena->base + commit_start, end - commit_start);
+	assert(is_committed && "Failed to commit memory");
+	
+	u64 high_water = arena->commit_high_water.load(std::memory_order_relaxed);
+	while (high_water < end && !arena->commit_high_water.compare_exchange_weak(high_water, end, std::memory_order_relaxed))
+	{
+	}
+}
+
+[[nodiscard]]
+inline u64 arena_mt_push_shared(Alloc_Arena_MT *arena, const u64 size_bytes)
+{
+	u64 start = arena->curr_offset.fetch_add(size_bytes, std::memory_order_relaxed);
+	assert( ( (start + size_bytes) <= arena->max_size) && "No more memory!" );
+	arena_mt_commit_range(arena, start, start + size_bytes);
+	return start;
+}
+
+[[nodiscard]]
+inline Arena_MT_Chunk *arena_mt_get_thread_chunk(Alloc_Arena_MT *arena)
+{
+	u32 epoch = arena->epoch.load(std::memory_order_relaxed);
+	for (auto& chunk : g_arena_mt_chunks)
+	{
+		if (chunk.arena == arena)
+		{
+			if (chunk.epoch != epoch)
+				chunk = { .arena = arena, .epoch = epoch, .curr_offset = 0, .end_offset = 0 };
+			return &chunk;
+		}
+	}
+	
+	Arena_MT_Chunk *chunk = &g_arena_mt_chunks[g_arena_mt_chunk_next_evict];
+	g_arena_mt_chunk_next_evict = (g_arena_mt_chunk_next_evict + 1) % g_count_arena_mt_chunks;
+	*chunk = { .arena = arena, .epoch = epoch, .curr_offset = 0, .end_offset = 0 };
+	return chunk;
+}
+
+[[nodiscard]]
+inline void *allocate(Alloc_Arena_MT *arena, const u64 size_bytes, const u64 alignment = alignof(u64) ALLOC_SITE_PARAM)
+{
+	Arena_MT_Chunk *chunk = arena_mt_get_thread_chunk(arena);
+	ALLOC_RECORD(arena, size_bytes, arena->curr_offset.load(std::memory_order_relaxed));
+	
+	u64 start = AlignAddressPow2((u64)arena->base + chunk->curr_offset, alignment);
+	start -= (u64)arena->base;
+	if (start + size_bytes > chunk->end_offset)
+	{
+		u64 padded_size = size_bytes + alignment - 1;
+		if (padded_size > arena->chunk_size / 2)
+		{
+			// Rest of current chunk stays usable
+			start = AlignAddressPow2((u64)arena->base + arena_mt_push_shared(arena, padded_size), alignment);
+			start -= (u64)arena->base;
+			void *out = arena->base + start;
+			if (arena->zeroing == Alloc_Zeroing::on_allocate)
+				memset(out, 0, size_bytes);
+			return out;
+		}
+		
+		chunk->curr_offset = arena_mt_push_shared(arena, arena->chunk_size);
+		chunk->end_offset = chunk->curr_offset + arena->chunk_size;
+		start = AlignAddressPow2((u64)arena->base + chunk->curr_offset, alignment);
+		start -= (u64)arena->base;
+	}
+	
+	void *out = arena->base + start;
+	chunk->curr_offset = start + size_bytes;
+	if (arena->zeroing == Alloc_Zeroing::on_allocate)
+		memset(out, 0, size_bytes);
+	
+	return out;
+}
+
+//? Not thread safe! Applies zeroing policy and decommit same as "arena_reset"
+inline void arena_mt_reset(Alloc_Arena_MT *arena)
+{
+	assert(arena);
+	u64 used = arena->curr_offset.load(std::memory_order_acquire);
+	used = (used > arena->max_size) ? arena->max_size : used;
+	
+	// Single threaded view on same memory, so policies stay implemented in one place
+	Alloc_Arena view = { .max_size = arena->max_size, .base = arena->base, .curr_offset = used, .prev_offset = 0,
+	                     .committed_size = 0, .children_size = 0, .commit_step = arena->commit_step,
+	                     .retained_size = arena->retained_size, .zeroing = arena->zeroing, .reclaim_threshold = arena->reclaim_threshold };
+	if (arena->commit_step != 0)
+	{
+		u64 high_water = vm_align_to_page(arena->commit_high_water.load(std::memory_order_relaxed));
+		view.committed_size = (high_water > arena->committed_size) ? high_water : arena->committed_size;
+	}
+	arena_reset(&view);
+	
+	arena->committed_size = view.committed_size;
+	arena->commit_high_water.store(0, std::memory_order_relaxed);
+	arena->curr_offset.store(0, std::memory_order_relaxed);
+	arena->epoch.fetch_add(1, std::memory_order_release);
+	ALLOC_SET_USED(arena, 0);
+}
+
 struct Alloc_Stack_Header
 {
 	u64 prev_offset;
@@ -158,7 +603,7 @@ inline Alloc_Stack stack_from_allocator(auto* allocator, const u64 max_size)
 }
 
 [[nodiscard]]
-inline void *allocate(Alloc_Stack *stack, const u64 size_bytes, const u64 alignment = alignof(u64))
+inline void *allocate(Alloc_Stack *stack, const u64 size_bytes, const u64 alignment = alignof(u64) ALLOC_SITE_PARAM)
 {
 	auto header_start = AlignAddressPow2((u64)stack->base + stack->curr_offset, alignof(Alloc_Stack_Header));
 	header_start -= (u64)stack->base;
@@ -173,6 +618,7 @@ inline void *allocate(Alloc_Stack *stack, const u64 size_bytes, const u64 alignm
 
 	void *out = (void*) ((byte*)stack->base + data_offset);
 	stack->curr_offset = size_bytes + data_offset;
+	ALLOC_RECORD(stack, size_bytes, stack->curr_offset);
 
 	return out;
 }
@@ -184,6 +630,7 @@ inline void stack_pop(Alloc_Stack *stack)
 
 	stack->curr_offset = currHeader->prev_offset;
 	stack->last_header_offset = currHeader->prev_header;
+	ALLOC_SET_USED(stack, stack->curr_offset);
 }
 
 inline void stack_reset(Alloc_Stack *stack)
@@ -192,6 +639,7 @@ inline void stack_reset(Alloc_Stack *stack)
 	memset(stack->base, 0, stack->curr_offset);
 	stack->curr_offset = 0;
 	stack->last_header_offset = 0;
+	ALLOC_SET_USED(stack, 0);
 }
 
 struct Pool_Free_Node
@@ -199,6 +647,29 @@ struct Pool_Free_Node
 	u64 next;
 };
 
+//? Debug poisoning: freed block (except free list link at its start) is filled with pattern that is checked when block
+//? is handed out again, so writes through dangling pointers are caught. It replaces zeroing on free - pool with
+//? zeroing other than "none" zeroes blocks on allocate then
+inline constexpr byte g_pool_poison = 0xDD;
+
+inline void pool_poison_block(void *block, const u64 block_size)
+{
+	memset((byte *)block + sizeof(Pool_Free_Node), g_pool_poison, block_size - sizeof(Pool_Free_Node));
+}
+
+inline void pool_check_poison(const void *block, const u64 block_size)
+{
+	const byte *at = (const byte *)block + sizeof(Pool_Free_Node);
+	for (u64 i = 0; i < block_size - sizeof(Pool_Free_Node); ++i)
+		assert(at[i] == g_pool_poison && "Freed pool block was written to!");
+}
+
+[[nodiscard]]
+inline b32 pool_zeroes_on_allocate(const Alloc_Zeroing zeroing, const b32 is_poisoned)
+{
+	return zeroing == Alloc_Zeroing::on_allocate || (is_poisoned && zeroing != Alloc_Zeroing::none);
+}
+
 struct Alloc_Pool
 {
 	u64 max_size;
@@ -206,6 +677,9 @@ struct Alloc_Pool
 
 	u64 block_size;
 	u64 head_block;
+	
+	Alloc_Zeroing zeroing; // "reclaim_pages" behaves as "on_free", blocks are too small to give pages back
+	b32 is_poisoned;
 };
 
 [[nodiscard]]
@@ -224,42 +698,55 @@ inline void reset_list(Alloc_Pool *pool)
 		Pool_Free_Node *node = get_node(pool, i);
 		node->next = pool->head_block;
 		pool->head_block = i;
+		if (pool->is_poisoned)
+			pool_poison_block(node, pool->block_size);
 	}
 }
 
 [[nodiscard]]
-inline Alloc_Pool create_pool(byte *const mem_buffer, const u64 max_size, const u64 block_size, const u64 alignment = alignof(u64))
+inline Alloc_Pool create_pool(byte *const mem_buffer, const u64 max_size, const u64 block_size, const u64 alignment = alignof(u64), 
+                              const b32 is_poisoned = false)
 {
 	assert(block_size <= max_size && "Block is bigger than max size!");
 	assert(block_size >= sizeof(Pool_Free_Node) && "Block size is too small - minimum size is 8 bytes!");
-	assert(alignment % 2 == 0 && "Alignment is not power of 2 base!");
+	assert(alignment != 0 && (alignment & (alignment - 1)) == 0 && "Alignment is not power of 2!");
 
 	byte *aligned_mem = (byte *)(AlignAddressPow2((u64)mem_buffer, alignment));
 	u64 aligned_size = max_size - (u64)(aligned_mem - mem_buffer);
 	u64 aligned_block = AlignAddressPow2(block_size, alignment); //Align address is fine also, changed to it to prevent compiler warning
 	u64 head = aligned_size / aligned_block; // block_count that means end of list
 
-	Alloc_Pool out = {aligned_size, aligned_mem, aligned_block, head};
+	Alloc_Pool out = {aligned_size, aligned_mem, aligned_block, head, Alloc_Zeroing::on_free, is_poisoned};
 	reset_list(&out);
 
 	return out;
 }
 
 [[nodiscard]]
-inline Alloc_Pool pool_from_allocator(auto* allocator, const u64 max_size_bytes, const u64 block_size, const u64 alignment = alignof(u64))
+inline Alloc_Pool pool_from_allocator(auto* allocator, const u64 max_size_bytes, const u64 block_size, const u64 alignment = alignof(u64),
+                                      const b32 is_poisoned = false)
 {
-	return create_pool((byte *)allocate(allocator, max_size_bytes), max_size_bytes, block_size, alignment);
+	return create_pool((byte *)allocate(allocator, max_size_bytes), max_size_bytes, block_size, alignment, is_poisoned);
 }
 
 //? The allocation must fit in a single block size!
 [[nodiscard]]
-	inline void *allocate(Alloc_Pool *pool, const u64 alignment = alignof(u64))
+	inline void *allocate(Alloc_Pool *pool, const u64 alignment = alignof(u64) ALLOC_SITE_PARAM)
 {
 	assert(alignment <= pool->block_size && "Alignment is bigger than block size!");
+	ALLOC_RECORD(pool, pool->block_size, 0);
 
 	Pool_Free_Node *head_node = get_node(pool, pool->head_block);
 	pool->head_block = head_node->next;
 	
+	if (pool->is_poisoned)
+		pool_check_poison(head_node, pool->block_size);
+	
+	if (pool_zeroes_on_allocate(pool->zeroing, pool->is_poisoned))
+		memset(head_node, 0, pool->block_size);
+	else if (pool->zeroing != Alloc_Zeroing::none)
+		head_node->next = 0; // rest of block was zeroed on free
+	
 	return head_node;
 }
 
@@ -270,10 +757,543 @@ inline void free_block(Alloc_Pool *pool, void *ptr)
 		return;
 	
 	assert(((byte *)ptr < pool->base + pool->max_size ) && ((byte *)ptr >= pool->base) && "Provided memory addres is out of bounds!");
-	assert((u64)ptr % pool->block_size == 0 && "The address is offsetted - is not a block beginning!");
+	assert((u64)((byte *)ptr - pool->base) % pool->block_size == 0 && "The address is offsetted - is not a block beginning!");
 	
-	memset(ptr, 0, pool->block_size);
+	if (pool->is_poisoned)
+		pool_poison_block(ptr, pool->block_size);
+	else if (pool->zeroing == Alloc_Zeroing::on_free || pool->zeroing == Alloc_Zeroing::reclaim_pages)
+		memset(ptr, 0, pool->block_size);
 	Pool_Free_Node *head_node = (Pool_Free_Node *)ptr;
 	head_node->next = pool->head_block;
-	pool->head_block = (u64)(head_node - (Pool_Free_Node *)pool->base);
-}
\ No newline at end of file
+	pool->head_block = (u64)((byte *)ptr - pool->base) / pool->block_size;
+}
+
+//? Pool for many threads: every thread allocates from and frees to its own magazine (small stack of free blocks),
+//? only full or empty magazine touches global free list - lock-free stack with head tagged by change counter against ABA.
+//? Blocks may be freed on other thread than allocated them. Magazines are per thread, so before worker thread exits
+//? it should call "pool_mt_flush_thread" or its cached blocks are lost until "pool_mt_reset".
+//? Pool must outlive threads which used it, same as Alloc_Arena_MT
+struct Alloc_Pool_MT
+{
+	u64 max_size;
+	byte *base;
+	u64 block_size;
+	u32 count_blocks; // also index meaning end of list
+	
+	Alloc_Zeroing zeroing;
+	b32 is_poisoned;
+	
+	// Written by all threads, kept away from read mostly fields above
+	alignas(64) std::atomic<u64> head; // (tag << 32) | block index
+	std::atomic<u32> epoch;
+};
+
+inline constexpr u32 g_pool_mt_magazine_size = 32;
+inline constexpr u32 g_count_pool_mt_magazines = 4; // MT pools one thread can use without flushing magazines
+
+struct Pool_MT_Magazine
+{
+	Alloc_Pool_MT *pool;
+	u32 epoch;
+	u32 count;
+	u32 blocks[g_pool_mt_magazine_size];
+};
+
+inline thread_local Pool_MT_Magazine g_pool_mt_magazines[g_count_pool_mt_magazines];
+inline thread_local u32 g_pool_mt_magazine_next_evict;
+
+//? Free list link, other thread may read it while block is already handed out (its pop then fails on tag)
+[[nodiscard]]
+inline std::atomic_ref<u32> pool_mt_next(Alloc_Pool_MT *pool, const u32 block)
+{
+	return std::atomic_ref<u32>(*(u32 *)(pool->base + (u64)block * pool->block_size));
+}
+
+//? Pushes blocks linked as first -> ... -> last
+inline void pool_mt_push_list(Alloc_Pool_MT *pool, const u32 first, const u32 last)
+{
+	u64 head = pool->head.load(std::memory_order_relaxed);
+	u64 new_head = 0;
+	do
+	{
+		pool_mt_next(pool, last).store((u32)head, std::memory_order_relaxed);
+		new_head = (((head >> 32) + 1) << 32) | first;
+	} while (!pool->head.compare_exchange_weak(head, new_head, std::memory_order_release, std::memory_order_relaxed));
+}
+
+//? Returns "count_blocks" when global list is empty
+[[nodiscard]]
+inline u32 pool_mt_pop(Alloc_Pool_MT *pool)
+{
+	u64 head = pool->head.load(std::memory_order_acquire);
+	while ((u32)head != pool->count_blocks)
+	{
+		u32 next = pool_mt_next(pool, (u32)head).load(std::memory_order_relaxed);
+		u64 new_head = (((head >> 32) + 1) << 32) | next;
+		if (pool->head.compare_exchange_weak(head, new_head, std::memory_order_acquire, std::memory_order_acquire))
+			return (u32)head;
+	}
+	
+	return pool->count_blocks;
+}
+
+//? Not thread safe! Puts all blocks to global list, magazines of all threads are dropped
+inline void pool_mt_reset(Alloc_Pool_MT *pool)
+{
+	for (u32 i = 0; i < pool->count_blocks; ++i)
+	{
+		pool_mt_next(pool, i).store(i + 1, std::memory_order_relaxed); // last one points to end of list
+		if (pool->is_poisoned)
+			pool_poison_block(pool->base + (u64)i * pool->block_size, pool->block_size);
+	}
+	
+	pool->head.store(((pool->head.load(std::memory_order_relaxed) >> 32) + 1) << 32, std::memory_order_relaxed);
+	pool->epoch.fetch_add(1, std::memory_order_release);
+}
+
+inline void create_pool_mt(Alloc_Pool_MT *pool, byte *const mem_buffer, const u64 max_size, const u64 block_size, 
+                           const u64 alignment = alignof(u64), const b32 is_poisoned = false)
+{
+	assert(block_size <= max_size && "Block is bigger than max size!");
+	assert(block_size >= sizeof(Pool_Free_Node) && "Block size is too small - minimum size is 8 bytes!");
+	assert(alignment != 0 && (alignment & (alignment - 1)) == 0 && "Alignment is not power of 2!");
+	
+	byte *aligned_mem = (byte *)(AlignAddressPow2((u64)mem_buffer, alignment));
+	u64 aligned_size = max_size - (u64)(aligned_mem - mem_buffer);
+	u64 aligned_block = AlignAddressPow2(block_size, alignment);
+	assert(aligned_size / aligned_block < 0xffffffff && "Too many blocks for 32 bit indices!");
+	
+	pool->max_size = aligned_size;
+	pool->base = aligned_mem;
+	pool->block_size = aligned_block;
+	pool->count_blocks = (u32)(aligned_size / aligned_block);
+	pool->is_poisoned = is_poisoned;
+	pool->head.store(0, std::memory_order_relaxed);
+	pool->epoch.store(0, std::memory_order_relaxed);
+	pool_mt_reset(pool);
+}
+
+inline void pool_mt_from_allocator(Alloc_Pool_MT *pool, auto* allocator, const u64 max_size_bytes, const u64 block_size, 
+                                   const u64 alignment = alignof(u64), const b32 is_poisoned = false)
+{
+	create_pool_mt(pool, (byte *)allocate(allocator, max_size_bytes), max_size_bytes, block_size, alignment, is_poisoned);
+}
+
+//? Moves "count" blocks from bottom of magazine to global list with single CAS
+inline void pool_mt_flush_magazine(Pool_MT_Magazine *magazine, const u32 count)
+{
+	if (count == 0)
+		return;
+	
+	Alloc_Pool_MT *pool = magazine->pool;
+	for (u32 i = 0; i + 1 < count; ++i)
+		pool_mt_next(pool, magazine->blocks[i]).store(magazine->blocks[i + 1], std::memory_order_relaxed);
+	pool_mt_push_list(pool, magazine->blocks[0], magazine->blocks[count - 1]);
+	
+	magazine->count -= count;
+	memmove(magazine->blocks, magazine->blocks + count, magazine->count * sizeof(u32));
+}
+
+[[nodiscard]]
+inline Pool_MT_Magazine *pool_mt_get_magazine(Alloc_Pool_MT *pool)
+{
+	u32 epoch = pool->epoch.load(std::memory_order_acquire);
+	for (auto& magazine : g_pool_mt_magazines)
+	{
+		if (magazine.pool == pool)
+		{
+			if (magazine.epoch != epoch)
+				magazine = { .pool = pool, .epoch = epoch, .count = 0, .blocks = {} };
+			return &magazine;
+		}
+	}
+	
+	// Evicted magazine gives its blocks back, if they are not from before reset of its pool
+	Pool_MT_Magazine *magazine = &g_pool_mt_magazines[g_pool_mt_magazine_next_evict];
+	g_pool_mt_magazine_next_evict = (g_pool_mt_magazine_next_evict + 1) % g_count_pool_mt_magazines;
+	if (magazine->pool && magazine->epoch == magazine->pool->epoch.load(std::memory_order_acquire))
+		pool_mt_flush_magazine(magazine, magazine->count);
+	
+	*magazine = { .pool = pool, .epoch = epoch, .count = 0, .blocks = {} };
+	return magazine;
+}
+
+//? Gives blocks cached by calling thread back to global list, call it before thread that used pool exits
+inline void pool_mt_flush_thread(Alloc_Pool_MT *pool)
+{
+	Pool_MT_Magazine *magazine = pool_mt_get_magazine(pool);
+	pool_mt_flush_magazine(magazine, magazine->count);
+}
+
+//? The allocation must fit in a single block size!
+[[nodiscard]]
+inline void *allocate(Alloc_Pool_MT *pool, const u64 alignment = alignof(u64) ALLOC_SITE_PARAM)
+{
+	assert(alignment <= pool->block_size && "Alignment is bigger than block size!");
+	ALLOC_RECORD(pool, pool->block_size, 0);
+	
+	Pool_MT_Magazine *magazine = pool_mt_get_magazine(pool);
+	if (magazine->count == 0)
+	{
+		// Refill half, so following frees do not flush right away
+		for (u32 i = 0; i < g_pool_mt_magazine_size / 2; ++i)
+		{
+			u32 block = pool_mt_pop(pool);
+			if (block == pool->count_blocks)
+				break;
+			magazine->blocks[magazine->count++] = block;
+		}
+		assert(magazine->count > 0 && "No more free blocks!");
+	}
+	
+	byte *out = pool->base + (u64)magazine->blocks[--magazine->count] * pool->block_size;
+	
+	if (pool->is_poisoned)
+		pool_check_poison(out, pool->block_size);
+	
+	if (pool_zeroes_on_allocate(pool->zeroing, pool->is_poisoned))
+		memset(out, 0, pool->block_size);
+	else if (pool->zeroing != Alloc_Zeroing::none)
+		memset(out, 0, sizeof(Pool_Free_Node)); // rest of block was zeroed on free
+	
+	return out;
+}
+
+inline void free_block(Alloc_Pool_MT *pool, void *ptr)
+{
+	if (ptr == nullptr)
+		return;
+	
+	assert(((byte *)ptr < pool->base + pool->max_size ) && ((byte *)ptr >= pool->base) && "Provided memory addres is out of bounds!");
+	assert((u64)((byte *)ptr - pool->base) % pool->block_size == 0 && "The address is offsetted - is not a block beginning!");
+	
+	if (pool->is_poisoned)
+		pool_poison_block(ptr, pool->block_size);
+	else if (pool->zeroing == Alloc_Zeroing::on_free || pool->zeroing == Alloc_Zeroing::reclaim_pages)
+		memset(ptr, 0, pool->block_size);
+	
+	Pool_MT_Magazine *magazine = pool_mt_get_magazine(pool);
+	if (magazine->count == g_pool_mt_magazine_size)
+		pool_mt_flush_magazine(magazine, g_pool_mt_magazine_size / 2);
+	
+	magazine->blocks[magazine->count++] = (u32)((u64)((byte *)ptr - pool->base) / pool->block_size);
+}
+
+//? Two-Level Segregated Fit allocator over one memory block: O(1) allocate and free of any size with any lifetime.
+//? Free blocks are kept in lists by size class - first level is power of 2, second splits it linearly into
+//? "g_tlsf_sl_count" parts, so taken block is at most 1/g_tlsf_sl_count bigger than request (bounded fragmentation).
+//? Neighbour free blocks are merged on free. Every block has 16 bytes header, payloads are 16 bytes aligned
+inline constexpr u32 g_tlsf_sl_log2 = 5;
+inline constexpr u32 g_tlsf_sl_count = 1 << g_tlsf_sl_log2;
+inline constexpr u32 g_tlsf_align_log2 = 4;
+inline constexpr u64 g_tlsf_align = 1ull << g_tlsf_align_log2;
+inline constexpr u32 g_tlsf_fl_shift = g_tlsf_sl_log2 + g_tlsf_align_log2;
+inline constexpr u32 g_tlsf_fl_max_log2 = 40; // blocks up to 1 TiB
+inline constexpr u32 g_tlsf_fl_count = g_tlsf_fl_max_log2 - g_tlsf_fl_shift + 1;
+
+inline constexpr u64 g_tlsf_block_free = 1; // flag in low bit of size
+
+struct Tlsf_Block
+{
+	Tlsf_Block *prev_phys; // nullptr for first block
+	u64 size_flags; // payload size | flags
+
+	// Only in free blocks, overlap payload
+	Tlsf_Block *next_free;
+	Tlsf_Block *prev_free;
+};
+
+inline constexpr u64 g_tlsf_header_size = 16; // "prev_phys" & "size_flags"
+inline constexpr u64 g_tlsf_min_payload = sizeof(Tlsf_Block) - g_tlsf_header_size;
+
+struct Tlsf_Stats
+{
+	u64 used_bytes; // payloads of allocated blocks
+	u64 peak_used_bytes;
+	u64 free_bytes;
+	u64 largest_free_bytes; // biggest allocation that surely fits, free_bytes vs it shows fragmentation
+	u32 count_allocs;
+	u32 count_free_blocks;
+};
+
+struct Alloc_TLSF
+{
+	u64 max_size;
+	byte *base;
+
+	u32 fl_bitmap;
+	u32 sl_bitmaps[g_tlsf_fl_count];
+	Tlsf_Block *free_heads[g_tlsf_fl_count][g_tlsf_sl_count];
+
+	u64 used_bytes;
+	u64 peak_used_bytes;
+	u64 free_bytes;
+	u32 count_allocs;
+	u32 count_free_blocks;
+};
+
+[[nodiscard]]
+inline u64 tlsf_block_size(const Tlsf_Block *block)
+{
+	return block->size_flags & ~(g_tlsf_align - 1);
+}
+
+[[nodiscard]]
+inline b32 tlsf_is_free(const Tlsf_Block *block)
+{
+	return (block->size_flags & g_tlsf_block_free) != 0;
+}
+
+[[nodiscard]]
+inline Tlsf_Block *tlsf_next_phys(Tlsf_Block *block)
+{
+	return (Tlsf_Block *)((byte *)block + g_tlsf_header_size + tlsf_block_size(block));
+}
+
+//? Size class of block "units" long, shared with Alloc_Offset. Unit is granularity of sizes (16 bytes here, min
+//? alignment there), first "g_tlsf_sl_count" units are linear classes
+inline void tlsf_mapping_units(const u64 units, u32 *fl, u32 *sl)
+{
+	if (units < g_tlsf_sl_count)
+	{
+		*fl = 0;
+		*sl = (u32)units;
+	}
+	else
+	{
+		u32 msb = find_msb_u64(units);
+		*sl = (u32)(units >> (msb - g_tlsf_sl_log2)) ^ g_tlsf_sl_count;
+		*fl = msb - g_tlsf_sl_log2 + 1;
+	}
+}
+
+//? Size class of block with "size" bytes
+inline void tlsf_mapping(const u64 size, u32 *fl, u32 *sl)
+{
+	tlsf_mapping_units(size >> g_tlsf_align_log2, fl, sl);
+}
+
+//? Lowest non empty class that guarantees fit of "units", false when there is none. Request is rounded up to next
+//? class, so any block of found class fits. Bitmaps are of first "fl_count" classes
+[[nodiscard]]
+inline b32 tlsf_search_class(u64 units, const u32 fl_bitmap, const u32 *sl_bitmaps, const u32 fl_count, u32 *fl, u32 *sl)
+{
+	if (units >= g_tlsf_sl_count)
+		units += (1ull << (find_msb_u64(units) - g_tlsf_sl_log2)) - 1;
+
+	tlsf_mapping_units(units, fl, sl);
+	if (*fl >= fl_count)
+		return false;
+
+	u32 sl_map = sl_bitmaps[*fl] & (~0u << *sl);
+	if (sl_map == 0)
+	{
+		u32 fl_map = (*fl + 1 < 32) ? fl_bitmap & (~0u << (*fl + 1)) : 0;
+		if (fl_map == 0)
+			return false;
+
+		*fl = find_lsb_u64(fl_map);
+		sl_map = sl_bitmaps[*fl];
+	}
+	*sl = find_lsb_u64(sl_map);
+	return true;
+}
+
+inline void tlsf_insert_free(Alloc_TLSF *tlsf, Tlsf_Block *block)
+{
+	u32 fl, sl;
+	tlsf_mapping(tlsf_block_size(block), &fl, &sl);
+
+	Tlsf_Block *head = tlsf->free_heads[fl][sl];
+	block->next_free = head;
+	block->prev_free = nullptr;
+	if (head)
+		head->prev_free = block;
+	tlsf->free_heads[fl][sl] = block;
+
+	tlsf->fl_bitmap |= 1u << fl;
+	tlsf->sl_bitmaps[fl] |= 1u << sl;
+	tlsf->free_bytes += tlsf_block_size(block);
+	tlsf->count_free_blocks += 1;
+}
+
+inline void tlsf_remove_free(Alloc_TLSF *tlsf, Tlsf_Block *block)
+{
+	u32 fl, sl;
+	tlsf_mapping(tlsf_block_size(block), &fl, &sl);
+
+	if (block->prev_free)
+		block->prev_free->next_free = block->next_free;
+	else
+		tlsf->free_heads[fl][sl] = block->next_free;
+	if (block->next_free)
+		block->next_free->prev_free = block->prev_free;
+
+	if (tlsf->free_heads[fl][sl] == nullptr)
+	{
+		tlsf->sl_bitmaps[fl] &= ~(1u << sl);
+		if (tlsf->sl_bitmaps[fl] == 0)
+			tlsf->fl_bitmap &= ~(1u << fl);
+	}
+	tlsf->free_bytes -= tlsf_block_size(block);
+	tlsf->count_free_blocks -= 1;
+}
+
+//? First free block from class that guarantees fit of "size" bytes, nullptr when there is none
+[[nodiscard]]
+inline Tlsf_Block *tlsf_find_free(Alloc_TLSF *tlsf, const u64 size)
+{
+	u32 fl, sl;
+	if (!tlsf_search_class(size >> g_tlsf_align_log2, tlsf->fl_bitmap, tlsf->sl_bitmaps, g_tlsf_fl_count, &fl, &sl))
+		return nullptr;
+
+	return tlsf->free_heads[fl][sl];
+}
+
+//? Cuts "block" after "size" bytes of payload, rest becomes free block. Caller checked that rest is big enough
+inline void tlsf_split(Alloc_TLSF *tlsf, Tlsf_Block *block, const u64 size)
+{
+	Tlsf_Block *rest = (Tlsf_Block *)((byte *)block + g_tlsf_header_size + size);
+	rest->prev_phys = block;
+	rest->size_flags = (tlsf_block_size(block) - size - g_tlsf_header_size) | g_tlsf_block_free;
+	tlsf_next_phys(rest)->prev_phys = rest;
+	block->size_flags = size | (block->size_flags & g_tlsf_block_free);
+	tlsf_insert_free(tlsf, rest);
+}
+
+//? "mem_buffer" is taken whole, last 16 bytes hold end sentinel
+inline void create_tlsf(Alloc_TLSF *tlsf, byte *const mem_buffer, const u64 max_size)
+{
+	*tlsf = {};
+	byte *aligned_mem = (byte *)(AlignAddressPow2((u64)mem_buffer, g_tlsf_align));
+	u64 aligned_size = (max_size - (u64)(aligned_mem - mem_buffer)) & ~(g_tlsf_align - 1);
+	assert(aligned_size >= 2 * g_tlsf_header_size + g_tlsf_min_payload && "Memory is too small!");
+
+	tlsf->max_size = aligned_size;
+	tlsf->base = aligned_mem;
+
+	Tlsf_Block *first = (Tlsf_Block *)aligned_mem;
+	first->prev_phys = nullptr;
+	first->size_flags = (aligned_size - 2 * g_tlsf_header_size) | g_tlsf_block_free;
+	assert(tlsf_block_size(first) < (1ull << g_tlsf_fl_max_log2) && "Memory is too big!");
+
+	// Used block of size 0, so every real block has next physical one
+	Tlsf_Block *sentinel = tlsf_next_phys(first);
+	sentinel->prev_phys = first;
+	sentinel->size_flags = 0;
+
+	tlsf_insert_free(tlsf, first);
+}
+
+inline void tlsf_from_allocator(Alloc_TLSF *tlsf, auto* allocator, const u64 max_size_bytes)
+{
+	create_tlsf(tlsf, (byte *)allocate(allocator, max_size_bytes, g_tlsf_align), max_size_bytes);
+}
+
+//? Frees everything at once
+inline void tlsf_reset(Alloc_TLSF *tlsf)
+{
+	u64 peak_used_bytes = tlsf->peak_used_bytes;
+	create_tlsf(tlsf, tlsf->base, tlsf->max_size);
+	tlsf->peak_used_bytes = peak_used_bytes;
+}
+
+//? Returns nullptr (and asserts) when no free block fits
+[[nodiscard]]
+inline void *allocate(Alloc_TLSF *tlsf, const u64 size_bytes, const u64 alignment = g_tlsf_align ALLOC_SITE_PARAM)
+{
+	assert(alignment != 0 && (alignment & (alignment - 1)) == 0 && "Alignment is not power of 2!");
+	u64 size = AlignAddressPow2(size_bytes, g_tlsf_align);
+	size = (size < g_tlsf_min_payload) ? g_tlsf_min_payload : size;
+
+	// Bigger alignment may need to cut free block off the front
+	u64 search_size = (alignment > g_tlsf_align) ? size + alignment + sizeof(Tlsf_Block) : size;
+	Tlsf_Block *block = tlsf_find_free(tlsf, search_size);
+	assert(block && "No more memory!");
+	if (block == nullptr)
+		return nullptr;
+	tlsf_remove_free(tlsf, block);
+
+	if (alignment > g_tlsf_align)
+	{
+		u64 payload = (u64)block + g_tlsf_header_size;
+		u64 aligned = AlignAddressPow2(payload, alignment);
+		if (aligned != payload && aligned - payload < sizeof(Tlsf_Block))
+			aligned = AlignAddressPow2(payload + sizeof(Tlsf_Block), alignment);
+
+		if (aligned != payload)
+		{
+			// Front part stays free, block before it is used (free ones are always merged)
+			Tlsf_Block *front = block;
+			block = (Tlsf_Block *)(aligned - g_tlsf_header_size);
+			block->prev_phys = front;
+			block->size_flags = tlsf_block_size(front) - (aligned - payload);
+			tlsf_next_phys(block)->prev_phys = block;
+			front->size_flags = (aligned - payload - g_tlsf_header_size) | g_tlsf_block_free;
+			tlsf_insert_free(tlsf, front);
+		}
+	}
+
+	if (tlsf_block_size(block) >= size + sizeof(Tlsf_Block))
+		tlsf_split(tlsf, block, size);
+	block->size_flags &= ~g_tlsf_block_free;
+
+	tlsf->used_bytes += tlsf_block_size(block);
+	tlsf->peak_used_bytes = (tlsf->used_bytes > tlsf->peak_used_bytes) ? tlsf->used_bytes : tlsf->peak_used_bytes;
+	tlsf->count_allocs += 1;
+	ALLOC_RECORD(tlsf, size_bytes, tlsf->used_bytes);
+
+	return (byte *)block + g_tlsf_header_size;
+}
+
+inline void free_block(Alloc_TLSF *tlsf, void *ptr)
+{
+	if (ptr == nullptr)
+		return;
+
+	assert(((byte *)ptr < tlsf->base + tlsf->max_size ) && ((byte *)ptr > tlsf->base) && "Provided memory addres is out of bounds!");
+	Tlsf_Block *block = (Tlsf_Block *)((byte *)ptr - g_tlsf_header_size);
+	assert(!tlsf_is_free(block) && "Double free!");
+
+	tlsf->used_bytes -= tlsf_block_size(block);
+	tlsf->count_allocs -= 1;
+	ALLOC_SET_USED(tlsf, tlsf->used_bytes);
+	block->size_flags |= g_tlsf_block_free;
+
+	Tlsf_Block *prev = block->prev_phys;
+	if (prev && tlsf_is_free(prev))
+	{
+		tlsf_remove_free(tlsf, prev);
+		prev->size_flags += g_tlsf_header_size + tlsf_block_size(block);
+		tlsf_next_phys(prev)->prev_phys = prev;
+		block = prev;
+	}
+
+	Tlsf_Block *next = tlsf_next_phys(block);
+	if (tlsf_is_free(next))
+	{
+		tlsf_remove_free(tlsf, next);
+		block->size_flags += g_tlsf_header_size + tlsf_block_size(next);
+		tlsf_next_phys(block)->prev_phys = block;
+	}
+
+	tlsf_insert_free(tlsf, block);
+}
+
+[[nodiscard]]
+inline Tlsf_Stats tlsf_get_stats(const Alloc_TLSF *tlsf)
+{
+	Tlsf_Stats out = { .used_bytes = tlsf->used_bytes, .peak_used_bytes = tlsf->peak_used_bytes, .free_bytes = tlsf->free_bytes,
+	                   .largest_free_bytes = 0, .count_allocs = tlsf->count_allocs, .count_free_blocks = tlsf->count_free_blocks };
+
+	// Biggest block is in highest non empty class, only that list is walked
+	if (tlsf->fl_bitmap)
+	{
+		u32 fl = find_msb_u64(tlsf->fl_bitmap);
+		u32 sl = find_msb_u64(tlsf->sl_bitmaps[fl]);
+		for (const Tlsf_Block *at = tlsf->free_heads[fl][sl]; at; at = at->next_free)
+			out.largest_free_bytes = (tlsf_block_size(at) > out.largest_free_bytes) ? tlsf_block_size(at) : out.largest_free_bytes;
+	}
+
+	return out;
+}
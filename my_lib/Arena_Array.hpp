@@ -0,0 +1,177 @@
+#pragma once
+
+#include <cassert>
+#include <cstring>
+#include <type_traits>
+
+#include "Utils.hpp"
+#include "Allocators.hpp"
+#include "Views.hpp"
+
+inline constexpr u64 g_arena_array_min_capacity = 16;
+inline constexpr u64 g_arena_array_alignment = 16; // keeps casts of elements to SIMD types aligned
+
+//? Growable array in Alloc_Arena. While it is last allocation of its arena it grows in place (arena_resize_last), so
+//? array built alone in arena never copies. Otherwise it moves to new memory at arena end and old one stays unused
+//? till arena reset - build one array at time when it matters. Elements have to be trivially copyable
+template<typename T>
+struct Arena_Array
+{
+	static_assert(std::is_trivially_copyable_v<T>, "Elements must be trivially copyable!");
+
+	Alloc_Arena* arena;
+	T* data;
+	u64 count;
+	u64 capacity;
+
+	inline void init(Alloc_Arena* arena_to_use, const u64 elements = 0 ALLOC_SITE_PARAM)
+	{
+		arena = arena_to_use;
+		data = nullptr;
+		count = 0;
+		capacity = 0;
+		if (elements > 0)
+			reserve(elements ALLOC_SITE_ARG);
+	}
+
+	[[nodiscard]]
+	inline b32 is_last_in_arena() const
+	{
+		return data != nullptr && (byte*)data == arena->base + arena->prev_offset;
+	}
+
+	//? Capacity grows at least twice, so pushing N elements is O(N) even when array has to move
+	inline void reserve(const u64 min_capacity ALLOC_SITE_PARAM)
+	{
+		if (min_capacity <= capacity)
+			return;
+
+		u64 new_capacity = (capacity * 2 > min_capacity) ? capacity * 2 : min_capacity;
+		new_capacity = (new_capacity > g_arena_array_min_capacity) ? new_capacity : g_arena_array_min_capacity;
+		if (is_last_in_arena())
+		{
+			(void)arena_resize_last(arena, data, new_capacity * sizeof(T));
+		}
+		else
+		{
+			constexpr u64 alignment = (alignof(T) > g_arena_array_alignment) ? alignof(T) : g_arena_array_alignment;
+			T* new_data = (T*)allocate(arena, new_capacity * sizeof(T), alignment ALLOC_SITE_ARG);
+			if (count > 0)
+				memcpy(new_data, data, count * sizeof(T));
+			data = new_data;
+		}
+		capacity = new_capacity;
+	}
+
+	//? Appends "elements_to_add" uninitialized elements, returns first of them
+	[[nodiscard]]
+	inline T* add_count(const u64 elements_to_add ALLOC_SITE_PARAM)
+	{
+		reserve(count + elements_to_add ALLOC_SITE_ARG);
+		T* out = data + count;
+		count += elements_to_add;
+		return out;
+	}
+
+	inline void push(const T& el ALLOC_SITE_PARAM)
+	{
+		if (count == capacity)
+			reserve(count + 1 ALLOC_SITE_ARG);
+		data[count++] = el;
+	}
+
+	inline void append(const T* elements, const u64 elements_count ALLOC_SITE_PARAM)
+	{
+		if (elements_count > 0)
+			memcpy(add_count(elements_count ALLOC_SITE_ARG), elements, elements_count * sizeof(T));
+	}
+
+	//? Bulk append of strided view (vertex stream, gltf accessor), every element is first sizeof(T) bytes of stride
+	inline void append(const Memory_View view ALLOC_SITE_PARAM)
+	{
+		assert(view.stride >= sizeof(T) && "Stride is smaller than element!");
+		u64 elements_count = view.bytes / view.stride;
+		if (view.stride == sizeof(T))
+		{
+			append((const T*)view.data, elements_count ALLOC_SITE_ARG);
+			return;
+		}
+
+		T* dst = add_count(elements_count ALLOC_SITE_ARG);
+		const byte* at = (const byte*)view.data;
+		for (u64 i = 0; i < elements_count; ++i, at += view.stride)
+			memcpy(&dst[i], at, sizeof(T));
+	}
+
+	inline void pop()
+	{
+		assert(count > 0);
+		--count;
+	}
+
+	inline void erase_swap(const u64 i)
+	{
+		assert(i < count);
+		data[i] = data[--count];
+	}
+
+	//? Elements are kept, capacity is not
+	inline void clear()
+	{
+		count = 0;
+	}
+
+	//? Gives unused capacity back to arena when array is still its last allocation
+	inline void shrink_to_fit()
+	{
+		if (is_last_in_arena() && count > 0)
+		{
+			(void)arena_resize_last(arena, data, count * sizeof(T));
+			capacity = count;
+		}
+	}
+
+	inline T& operator[] (const u64 i)
+	{
+		assert(i < count); return data[i];
+	}
+
+	inline const T& operator[] (const u64 i) const
+	{
+		assert(i < count); return data[i];
+	}
+
+	inline T* begin()
+	{
+		return data;
+	}
+
+	inline const T* begin() const
+	{
+		return data;
+	}
+
+	inline T* end()
+	{
+		return data + count;
+	}
+
+	inline const T* end() const
+	{
+		return data + count;
+	}
+
+	[[nodiscard]]
+	inline Memory_View get_memory_view() const
+	{
+		return { data, count * sizeof(T), sizeof(T) };
+	}
+
+	//? Fixed size view of elements, for APIs that take Array_View
+	[[nodiscard]]
+	inline Array_View<T> get_array_view() const
+	{
+		assert(count <= 0x7fffffff && "Too many elements for Array_View!");
+		return { (s32)count, (s32)count, data };
+	}
+};
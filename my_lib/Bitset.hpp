@@ -0,0 +1,245 @@
+#pragma once
+
+#include <cassert>
+#include <cstring>
+#include <immintrin.h>
+
+#include "Utils.hpp"
+#include "Cpu_Features.hpp"
+
+//? Dense bit per object (visible, resident, dirty) with summary level: bit "i" of summary is set when word "i" has any
+//? bit set, so scans skip 64 empty words per summary word - 1M bits have 256 summary words. Bulk operations run 4 words
+//? at time with AVX2 (2 with SSE2 on CPUs without it) and rebuild summary on the way, when summary says result is empty
+//? they skip the words entirely. Word count is padded to whole AVX2 registers, padding bits are always zero. Memory comes from allocator in "init"
+
+inline constexpr u32 g_bitset_simd_words = 4; // u64 words in __m256i
+
+enum struct Bitset_Op : u8
+{
+	bit_and,
+	bit_or,
+	bit_and_not, // a & ~b
+};
+
+//? Combines words [first_word, end_word) of one summary word, returns summary bits of result
+template<Bitset_Op op>
+inline u64 bitset_combine_sse2(u64* dst, const u64* a, const u64* b, const u32 first_word, const u32 end_word)
+{
+	u64 out_summary = 0;
+	for (u32 word_i = first_word; word_i < end_word; word_i += 2)
+	{
+		__m128i va = _mm_load_si128((const __m128i*)(a + word_i));
+		__m128i vb = _mm_load_si128((const __m128i*)(b + word_i));
+		__m128i result;
+		if constexpr (op == Bitset_Op::bit_and)
+			result = _mm_and_si128(va, vb);
+		else if constexpr (op == Bitset_Op::bit_or)
+			result = _mm_or_si128(va, vb);
+		else
+			result = _mm_andnot_si128(vb, va);
+		_mm_store_si128((__m128i*)(dst + word_i), result);
+
+		out_summary |= (u64)((dst[word_i] != 0) | ((dst[word_i + 1] != 0) << 1)) << (word_i - first_word);
+	}
+	return out_summary;
+}
+
+LIB_TARGET_AVX2_BEGIN
+
+template<Bitset_Op op>
+inline u64 bitset_combine_avx2(u64* dst, const u64* a, const u64* b, const u32 first_word, const u32 end_word)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	u64 out_summary = 0;
+	for (u32 word_i = first_word; word_i < end_word; word_i += g_bitset_simd_words)
+	{
+		__m256i va = _mm256_load_si256((const __m256i*)(a + word_i));
+		__m256i vb = _mm256_load_si256((const __m256i*)(b + word_i));
+		__m256i result;
+		if constexpr (op == Bitset_Op::bit_and)
+			result = _mm256_and_si256(va, vb);
+		else if constexpr (op == Bitset_Op::bit_or)
+			result = _mm256_or_si256(va, vb);
+		else
+			result = _mm256_andnot_si256(vb, va);
+		_mm256_store_si256((__m256i*)(dst + word_i), result);
+
+		// Sign bit of every 64 bit lane is set for zero words
+		u32 zero_words = (u32)_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(result, zero)));
+		out_summary |= (u64)(~zero_words & 0xf) << (word_i - first_word);
+	}
+	return out_summary;
+}
+
+LIB_TARGET_AVX2_END
+
+struct Bitset
+{
+	u64* words;
+	u64* summary;
+	u32 count_bits;
+	u32 count_words;
+	u32 count_summary_words;
+
+	//? All bits start unset
+	inline void init(auto* allocator, const u32 bits)
+	{
+		assert(bits > 0);
+		count_bits = bits;
+		count_words = ((bits + 63) / 64 + g_bitset_simd_words - 1) / g_bitset_simd_words * g_bitset_simd_words;
+		count_summary_words = (count_words + 63) / 64;
+		words = (u64*)allocate(allocator, (u64)count_words * sizeof(u64), sizeof(__m256i));
+		summary = (u64*)allocate(allocator, (u64)count_summary_words * sizeof(u64), sizeof(u64));
+		clear_all();
+	}
+
+	inline void set(const u32 i)
+	{
+		assert(i < count_bits);
+		u32 word_i = i / 64;
+		words[word_i] |= 1ull << (i % 64);
+		summary[word_i / 64] |= 1ull << (word_i % 64);
+	}
+
+	inline void unset(const u32 i)
+	{
+		assert(i < count_bits);
+		u32 word_i = i / 64;
+		words[word_i] &= ~(1ull << (i % 64));
+		if (words[word_i] == 0)
+			summary[word_i / 64] &= ~(1ull << (word_i % 64));
+	}
+
+	inline void set_to(const u32 i, const b32 is_set)
+	{
+		if (is_set)
+			set(i);
+		else
+			unset(i);
+	}
+
+	[[nodiscard]]
+	inline b32 test(const u32 i) const
+	{
+		assert(i < count_bits);
+		return (words[i / 64] >> (i % 64)) & 1;
+	}
+
+	inline void clear_all()
+	{
+		memset(words, 0, (u64)count_words * sizeof(u64));
+		memset(summary, 0, (u64)count_summary_words * sizeof(u64));
+	}
+
+	inline void set_all()
+	{
+		u32 count_full_words = count_bits / 64;
+		memset(words, 0xff, (u64)count_full_words * sizeof(u64));
+		memset(words + count_full_words, 0, (u64)(count_words - count_full_words) * sizeof(u64));
+		if (count_bits % 64)
+			words[count_full_words] = (1ull << (count_bits % 64)) - 1;
+
+		u32 count_used_words = (count_bits + 63) / 64;
+		for (u32 i = 0; i < count_summary_words; ++i)
+		{
+			u32 first_word = i * 64;
+			u32 count_in_summary = (count_used_words - first_word < 64) ? count_used_words - first_word : 64;
+			summary[i] = (count_in_summary == 64) ? ~0ull : (1ull << count_in_summary) - 1;
+		}
+	}
+
+	inline void copy_from(const Bitset& other)
+	{
+		assert(count_bits == other.count_bits);
+		memcpy(words, other.words, (u64)count_words * sizeof(u64));
+		memcpy(summary, other.summary, (u64)count_summary_words * sizeof(u64));
+	}
+
+	[[nodiscard]]
+	inline b32 is_any() const
+	{
+		for (u32 i = 0; i < count_summary_words; ++i)
+		{
+			if (summary[i])
+				return true;
+		}
+		return false;
+	}
+
+	//? Popcount of words marked in summary only
+	[[nodiscard]]
+	inline u32 count() const
+	{
+		u32 out = 0;
+		for (u32 summary_i = 0; summary_i < count_summary_words; ++summary_i)
+		{
+			for (u64 bits = summary[summary_i]; bits; bits &= bits - 1)
+				out += count_bits_u64(words[summary_i * 64 + find_lsb_u64(bits)]);
+		}
+		return out;
+	}
+
+	//? Calls "func(index)" for every set bit in increasing order. Each word is read before its bits are visited, so "func"
+	//? may unset bits it gets
+	inline void for_each_set(auto func) const
+	{
+		for (u32 summary_i = 0; summary_i < count_summary_words; ++summary_i)
+		{
+			for (u64 live_words = summary[summary_i]; live_words; live_words &= live_words - 1)
+			{
+				u32 word_i = summary_i * 64 + find_lsb_u64(live_words);
+				for (u64 bits = words[word_i]; bits; bits &= bits - 1)
+					func(word_i * 64 + find_lsb_u64(bits));
+			}
+		}
+	}
+
+	//? this = a op b, "this" may be "a" or "b". All three have to be same size
+	template<Bitset_Op op>
+	inline void assign(const Bitset& a, const Bitset& b)
+	{
+		assert(count_bits == a.count_bits && count_bits == b.count_bits);
+		b32 is_avx2 = get_cpu_features().has_avx2;
+		for (u32 summary_i = 0; summary_i < count_summary_words; ++summary_i)
+		{
+			u32 first_word = summary_i * 64;
+			u32 end_word = (first_word + 64 < count_words) ? first_word + 64 : count_words;
+
+			// Words that can have bits in result
+			u64 live_words = 0;
+			if constexpr (op == Bitset_Op::bit_and)
+				live_words = a.summary[summary_i] & b.summary[summary_i];
+			else if constexpr (op == Bitset_Op::bit_or)
+				live_words = a.summary[summary_i] | b.summary[summary_i];
+			else
+				live_words = a.summary[summary_i];
+
+			if (live_words == 0)
+			{
+				if (summary[summary_i])
+					memset(words + first_word, 0, (u64)(end_word - first_word) * sizeof(u64));
+				summary[summary_i] = 0;
+				continue;
+			}
+
+			summary[summary_i] = is_avx2 ? bitset_combine_avx2<op>(words, a.words, b.words, first_word, end_word)
+			                             : bitset_combine_sse2<op>(words, a.words, b.words, first_word, end_word);
+		}
+	}
+
+	inline void assign_and(const Bitset& a, const Bitset& b)
+	{
+		assign<Bitset_Op::bit_and>(a, b);
+	}
+
+	inline void assign_or(const Bitset& a, const Bitset& b)
+	{
+		assign<Bitset_Op::bit_or>(a, b);
+	}
+
+	//? this = a & ~b
+	inline void assign_and_not(const Bitset& a, const Bitset& b)
+	{
+		assign<Bitset_Op::bit_and_not>(a, b);
+	}
+};
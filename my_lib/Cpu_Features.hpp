@@ -0,0 +1,126 @@
+#pragma once
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+#include "Utils.hpp"
+
+//? Runtime detection of SIMD instruction sets for dispatch of bulk kernels. Build baseline is SSE4.1, code for newer
+//? sets is compiled inside LIB_TARGET_*_BEGIN/END regions (GCC/Clang need the target to accept intrinsics, MSVC takes
+//? them anywhere) and must run only when "get_cpu_features" reports the set
+
+enum struct Simd_Level : u8
+{
+	scalar,
+	sse41,
+	avx2,		// with FMA
+	avx512,	// F only
+
+	count
+};
+
+inline constexpr const char* g_simd_level_names[(u32)Simd_Level::count] = { "scalar", "sse4.1", "avx2", "avx512" };
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#define LIB_TARGET_AVX2_BEGIN
+#define LIB_TARGET_AVX2_END
+#define LIB_TARGET_AVX512_BEGIN
+#define LIB_TARGET_AVX512_END
+#elif defined(__clang__)
+#define LIB_TARGET_AVX2_BEGIN _Pragma("clang attribute push(__attribute__((target(\"avx2,fma\"))), apply_to = function)")
+#define LIB_TARGET_AVX2_END _Pragma("clang attribute pop")
+#define LIB_TARGET_AVX512_BEGIN _Pragma("clang attribute push(__attribute__((target(\"avx512f,avx2,fma\"))), apply_to = function)")
+#define LIB_TARGET_AVX512_END _Pragma("clang attribute pop")
+#else
+#define LIB_TARGET_AVX2_BEGIN _Pragma("GCC push_options") _Pragma("GCC target(\"avx2,fma\")")
+#define LIB_TARGET_AVX2_END _Pragma("GCC pop_options")
+// GCC 12 warns about "_mm512_undefined_ps" inside its own AVX-512 intrinsics (PR 105593)
+#define LIB_TARGET_AVX512_BEGIN _Pragma("GCC push_options") _Pragma("GCC target(\"avx512f,avx2,fma\")") \
+                                _Pragma("GCC diagnostic push") _Pragma("GCC diagnostic ignored \"-Wuninitialized\"") \
+                                _Pragma("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
+#define LIB_TARGET_AVX512_END _Pragma("GCC diagnostic pop") _Pragma("GCC pop_options")
+#endif
+
+struct Cpu_Features
+{
+	b32 has_sse41;
+	b32 has_avx2; // and FMA, with YMM state enabled by OS
+	b32 has_avx512; // AVX-512F, with ZMM state enabled by OS
+	Simd_Level best_level;
+};
+
+inline void cpuid(const u32 leaf, const u32 sub_leaf, u32 out_regs[4])
+{
+#if defined(_MSC_VER)
+	__cpuidex((int*)out_regs, (int)leaf, (int)sub_leaf);
+#else
+	if (!__get_cpuid_count(leaf, sub_leaf, &out_regs[0], &out_regs[1], &out_regs[2], &out_regs[3]))
+		out_regs[0] = out_regs[1] = out_regs[2] = out_regs[3] = 0;
+#endif
+}
+
+//? Register state the OS saves on context switch (XCR0)
+inline u64 get_os_saved_state()
+{
+#if defined(_MSC_VER)
+	return _xgetbv(0);
+#else
+	u32 low, high;
+	__asm__ volatile("xgetbv" : "=a"(low), "=d"(high) : "c"(0));
+	return ((u64)high << 32) | low;
+#endif
+}
+
+[[nodiscard]]
+inline Cpu_Features detect_cpu_features()
+{
+	constexpr u32 ecx_sse41 = 1u << 19;
+	constexpr u32 ecx_fma = 1u << 12;
+	constexpr u32 ecx_osxsave = 1u << 27;
+	constexpr u32 ecx_avx = 1u << 28;
+	constexpr u32 ebx_avx2 = 1u << 5;
+	constexpr u32 ebx_avx512f = 1u << 16;
+	constexpr u64 xcr0_ymm = 0x6; // SSE & AVX state
+	constexpr u64 xcr0_zmm = 0xe6; // + opmask & upper ZMM state
+
+	Cpu_Features out{};
+	u32 regs[4];
+	cpuid(0, 0, regs);
+	u32 max_leaf = regs[0];
+
+	cpuid(1, 0, regs);
+	u32 ecx_1 = regs[2];
+	out.has_sse41 = (ecx_1 & ecx_sse41) != 0;
+
+	u64 os_state = (ecx_1 & ecx_osxsave) ? get_os_saved_state() : 0;
+	b32 has_avx = (ecx_1 & ecx_avx) && (os_state & xcr0_ymm) == xcr0_ymm;
+	if (has_avx && max_leaf >= 7)
+	{
+		cpuid(7, 0, regs);
+		u32 ebx_7 = regs[1];
+		out.has_avx2 = (ebx_7 & ebx_avx2) && (ecx_1 & ecx_fma);
+		out.has_avx512 = out.has_avx2 && (ebx_7 & ebx_avx512f) && (os_state & xcr0_zmm) == xcr0_zmm;
+	}
+
+	out.best_level = out.has_avx512 ? Simd_Level::avx512 :
+	                 out.has_avx2 ? Simd_Level::avx2 :
+	                 out.has_sse41 ? Simd_Level::sse41 : Simd_Level::scalar;
+	return out;
+}
+
+//? Detected once per module on first use
+[[nodiscard]]
+inline const Cpu_Features& get_cpu_features()
+{
+	static const Cpu_Features features = detect_cpu_features();
+	return features;
+}
+
+[[nodiscard]]
+inline b32 is_simd_level_supported(const Simd_Level level)
+{
+	return (u32)level <= (u32)get_cpu_features().best_level;
+}
@@ -1,4 +1,6 @@
 #pragma once
+
+#if defined(_WIN32)
 #include <corecrt.h>
 
 _CRT_BEGIN_C_HEADER
@@ -23,4 +25,29 @@ _ACRTIMP void __cdecl _wassert(
 #define GameAssert(expression) ((void)0)	
 #endif
 
-_CRT_END_C_HEADER
\ No newline at end of file
+_CRT_END_C_HEADER
+
+#else
+#include <cstdio>
+#include <cstdlib>
+
+//? Non-Windows counterpart of _wassert, assertions stay on in release builds same as on Win32
+[[noreturn]]
+inline void game_assert_failed(const char* message, const char* file, unsigned line)
+{
+	fprintf(stderr, "Assertion failed: %s, file %s, line %u\n", message, file, line);
+	abort();
+}
+
+#define AlwaysAssert(expression) (void)( \
+		(!!(expression)) || \
+		(game_assert_failed(#expression, __FILE__, (unsigned)(__LINE__)), 0) \
+	)
+
+#if Game_ASSERTIONS
+#define GameAssert(expression) AlwaysAssert(expression)
+#else
+#define GameAssert(expression) ((void)0)	
+#endif
+
+#endif
@@ -0,0 +1,340 @@
+#pragma once
+
+#include <cassert>
+#include <cstring>
+#include <immintrin.h>
+#include <type_traits>
+
+#include "Utils.hpp"
+#include "Alloc_Instrumentation.hpp"
+
+//? Open addressing hash map & set in Swiss table style: every slot has control byte - empty, deleted or 7 bits of hash.
+//? Lookup takes 16 control bytes at once and compares them with SSE2, so usually only slots with matching hash bits are
+//? touched. Memory comes from any allocator in "init"/"reserve" only, inserts never allocate. Keys and values must be
+//? trivially copyable (they are moved with memcpy on rehash), keys are compared with ==
+
+inline constexpr u32 g_hash_group_size = 16;
+inline constexpr u32 g_hash_min_capacity = 16;
+inline constexpr s8 g_hash_ctrl_empty = -128; // 0b10000000
+inline constexpr s8 g_hash_ctrl_deleted = -2; // 0b11111110, full slots have high bit clear
+
+//? Integers, enums and pointers are mixed, other keys are hashed as bytes so they can not have padding
+template<typename K>
+[[nodiscard]]
+inline u64 hash_key(const K& key)
+{
+	if constexpr (std::is_integral_v<K> || std::is_enum_v<K> || std::is_pointer_v<K>)
+	{
+		return hash_mix((u64)key);
+	}
+	else
+	{
+		static_assert(std::has_unique_object_representations_v<K>, "Key has padding or floats, provide own hash function!");
+		return hash_bytes(&key, sizeof(K));
+	}
+}
+
+template<typename K, typename V>
+struct Hash_Map_Slot
+{
+	K key;
+	V value;
+};
+
+template<typename K>
+struct Hash_Set_Slot
+{
+	K key;
+};
+
+//? Common part of Hash_Map & Hash_Set. "ctrl" has "capacity" + g_hash_group_size bytes, last group mirrors the first one
+//? so group load at any position needs no wrap. Tables are at most 7/8 full, deleted slots count as full till they are
+//? reused or dropped by same capacity rehash once "growth_left" runs out
+template<typename K, typename Slot, u64 (*hash_func)(const K&)>
+struct Hash_Table
+{
+	static_assert(std::is_trivially_copyable_v<Slot>, "Keys and values must be trivially copyable!");
+
+	u32 capacity;
+	u32 count;
+	u32 growth_left;
+
+	s8* ctrl;
+	Slot* slots;
+
+	//? Room for "min_count" elements without rehash
+	inline void init(auto* allocator, const u32 min_count ALLOC_SITE_PARAM)
+	{
+		u32 new_capacity = get_capacity_for(min_count);
+		ctrl = (s8*)allocate(allocator, new_capacity + g_hash_group_size, g_hash_group_size ALLOC_SITE_ARG);
+		slots = (Slot*)allocate(allocator, (u64)new_capacity * sizeof(Slot), alignof(Slot) ALLOC_SITE_ARG);
+		capacity = new_capacity;
+		clear();
+	}
+
+	//? Rehash into new memory from "allocator" when "min_count" elements would not fit. Arena keeps the old memory
+	//? till its reset, so reserve upfront instead of growing in small steps
+	inline void reserve(auto* allocator, const u32 min_count ALLOC_SITE_PARAM)
+	{
+		if (ctrl && min_count <= count + growth_left)
+			return;
+
+		s8* old_ctrl = ctrl;
+		Slot* old_slots = slots;
+		u32 old_capacity = capacity;
+		init(allocator, (min_count > count) ? min_count : count ALLOC_SITE_ARG);
+
+		for (u32 i = 0; i < old_capacity; ++i)
+		{
+			if (old_ctrl[i] >= 0)
+			{
+				u64 hash = hash_func(old_slots[i].key);
+				u32 slot_i = find_free(hash);
+				set_ctrl(slot_i, get_h2(hash));
+				memcpy(&slots[slot_i], &old_slots[i], sizeof(Slot));
+				++count;
+				--growth_left;
+			}
+		}
+	}
+
+	inline void clear()
+	{
+		memset(ctrl, (u8)g_hash_ctrl_empty, capacity + g_hash_group_size);
+		count = 0;
+		growth_left = get_max_load(capacity);
+	}
+
+	//? Slot index or "capacity" when key is not there
+	[[nodiscard]]
+	inline u32 find_index(const K& key) const
+	{
+		u64 hash = hash_func(key);
+		__m128i h2 = _mm_set1_epi8(get_h2(hash));
+		u32 mask = capacity - 1;
+		u32 pos = get_h1(hash) & mask;
+		for (u32 step = g_hash_group_size; ; step += g_hash_group_size)
+		{
+			__m128i group = _mm_loadu_si128((const __m128i*)(ctrl + pos));
+			for (u32 bits = (u32)_mm_movemask_epi8(_mm_cmpeq_epi8(group, h2)); bits; bits &= bits - 1)
+			{
+				u32 slot_i = (pos + find_lsb_u64(bits)) & mask;
+				if (slots[slot_i].key == key)
+					return slot_i;
+			}
+
+			// Empty slot ends probe sequence, key would have been placed there
+			if (_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(g_hash_ctrl_empty))))
+				return capacity;
+
+			pos = (pos + step) & mask;
+		}
+	}
+
+	//? Slot of "key", inserted with uninitialized value if it was not there
+	[[nodiscard]]
+	inline u32 find_or_insert_index(const K& key, b32* is_new)
+	{
+		u32 out = find_index(key);
+		*is_new = (out == capacity);
+		if (*is_new)
+		{
+			u64 hash = hash_func(key);
+			out = find_free(hash);
+
+			// Reused deleted slot keeps the budget, otherwise drop deleted slots when they ate all of it
+			if (growth_left == 0 && ctrl[out] != g_hash_ctrl_deleted)
+			{
+				assert(count < get_max_load(capacity) && "Hash table is full, reserve more!");
+				rehash_in_place();
+				out = find_free(hash);
+			}
+			if (ctrl[out] == g_hash_ctrl_empty)
+				--growth_left;
+
+			set_ctrl(out, get_h2(hash));
+			slots[out].key = key;
+			++count;
+		}
+		return out;
+	}
+
+	//? Slot becomes deleted, its space comes back when it is reused or with next rehash
+	inline b32 remove(const K& key)
+	{
+		u32 slot_i = find_index(key);
+		if (slot_i == capacity)
+			return false;
+
+		set_ctrl(slot_i, g_hash_ctrl_deleted);
+		--count;
+		return true;
+	}
+
+	[[nodiscard]]
+	inline b32 contains(const K& key) const
+	{
+		return find_index(key) != capacity;
+	}
+
+	//? Calls "func(slot)" for every element, order is not stable
+	inline void for_each(auto func)
+	{
+		for (u32 i = 0; i < capacity; ++i)
+		{
+			if (ctrl[i] >= 0)
+				func(slots[i]);
+		}
+	}
+
+	//? Same capacity rehash that turns all deleted slots back to empty, needs no memory. Full slots are first marked
+	//? deleted as "not placed yet", then each one moves to first free slot on its probe sequence (swapping with not
+	//? placed one if needed) or stays when that slot is in the same group anyway
+	inline void rehash_in_place()
+	{
+		for (u32 i = 0; i < capacity; ++i)
+			ctrl[i] = (ctrl[i] >= 0) ? g_hash_ctrl_deleted : g_hash_ctrl_empty;
+		memcpy(ctrl + capacity, ctrl, g_hash_group_size);
+
+		u32 mask = capacity - 1;
+		for (u32 i = 0; i < capacity; ++i)
+		{
+			while (ctrl[i] == g_hash_ctrl_deleted)
+			{
+				u64 hash = hash_func(slots[i].key);
+				u32 probe_start = get_h1(hash) & mask;
+				u32 new_i = find_free(hash);
+
+				// Groups start at multiples of g_hash_group_size from probe start, so distance tells the group
+				if (((i - probe_start) & mask) / g_hash_group_size == ((new_i - probe_start) & mask) / g_hash_group_size)
+				{
+					set_ctrl(i, get_h2(hash));
+					break;
+				}
+
+				s8 new_ctrl = ctrl[new_i];
+				set_ctrl(new_i, get_h2(hash));
+				if (new_ctrl == g_hash_ctrl_empty)
+				{
+					memcpy(&slots[new_i], &slots[i], sizeof(Slot));
+					set_ctrl(i, g_hash_ctrl_empty);
+				}
+				else
+				{
+					// Not placed element comes to "i" and gets its turn in next iteration
+					Slot temp;
+					memcpy(&temp, &slots[new_i], sizeof(Slot));
+					memcpy(&slots[new_i], &slots[i], sizeof(Slot));
+					memcpy(&slots[i], &temp, sizeof(Slot));
+				}
+			}
+		}
+		growth_left = get_max_load(capacity) - count;
+	}
+
+	//? First empty or deleted slot on probe sequence of "hash"
+	[[nodiscard]]
+	inline u32 find_free(const u64 hash) const
+	{
+		u32 mask = capacity - 1;
+		u32 pos = get_h1(hash) & mask;
+		for (u32 step = g_hash_group_size; ; step += g_hash_group_size)
+		{
+			// Empty and deleted are the only control bytes with high bit set
+			__m128i group = _mm_loadu_si128((const __m128i*)(ctrl + pos));
+			u32 bits = (u32)_mm_movemask_epi8(group);
+			if (bits)
+				return (pos + find_lsb_u64(bits)) & mask;
+
+			pos = (pos + step) & mask;
+		}
+	}
+
+	inline void set_ctrl(const u32 slot_i, const s8 value)
+	{
+		ctrl[slot_i] = value;
+		if (slot_i < g_hash_group_size)
+			ctrl[capacity + slot_i] = value;
+	}
+
+	[[nodiscard]]
+	static constexpr u32 get_h1(const u64 hash)
+	{
+		return (u32)(hash >> 7);
+	}
+
+	[[nodiscard]]
+	static constexpr s8 get_h2(const u64 hash)
+	{
+		return (s8)(hash & 0x7f);
+	}
+
+	[[nodiscard]]
+	static constexpr u32 get_max_load(const u32 capacity)
+	{
+		return capacity - capacity / 8;
+	}
+
+	//? Power of 2 that keeps "min_count" under max load
+	[[nodiscard]]
+	static constexpr u32 get_capacity_for(const u32 min_count)
+	{
+		u32 out = g_hash_min_capacity;
+		while (get_max_load(out) < min_count)
+			out *= 2;
+		return out;
+	}
+};
+
+template<typename K, typename V, u64 (*hash_func)(const K&) = hash_key<K>>
+struct Hash_Map : Hash_Table<K, Hash_Map_Slot<K, V>, hash_func>
+{
+	//? nullptr when key is not there
+	[[nodiscard]]
+	inline V* find(const K& key)
+	{
+		u32 slot_i = this->find_index(key);
+		return (slot_i != this->capacity) ? &this->slots[slot_i].value : nullptr;
+	}
+
+	[[nodiscard]]
+	inline const V* find(const K& key) const
+	{
+		u32 slot_i = this->find_index(key);
+		return (slot_i != this->capacity) ? &this->slots[slot_i].value : nullptr;
+	}
+
+	//? Value of existing key is overwritten
+	inline V* insert(const K& key, const V& value)
+	{
+		b32 is_new;
+		V* out = &this->slots[this->find_or_insert_index(key, &is_new)].value;
+		*out = value;
+		return out;
+	}
+
+	//? New value is zeroed, "is_new" tells if it was just inserted
+	[[nodiscard]]
+	inline V* find_or_insert(const K& key, b32* is_new = nullptr)
+	{
+		b32 is_inserted;
+		V* out = &this->slots[this->find_or_insert_index(key, &is_inserted)].value;
+		if (is_inserted)
+			memset((void*)out, 0, sizeof(V));
+		if (is_new)
+			*is_new = is_inserted;
+		return out;
+	}
+};
+
+template<typename K, u64 (*hash_func)(const K&) = hash_key<K>>
+struct Hash_Set : Hash_Table<K, Hash_Set_Slot<K>, hash_func>
+{
+	//? False when key was already there
+	inline b32 insert(const K& key)
+	{
+		b32 is_new;
+		(void)this->find_or_insert_index(key, &is_new);
+		return is_new;
+	}
+};
@@ -6,7 +6,6 @@
 #include "Utils.hpp"
 
 //TODO: Lerp, ceil, floor, round, trunc with vectors
-//TODO: quaternions (angle and other), quaternion to rotation mat4 (check insomniac paper), and mat4 to quaternion
 //TODO: Exponent for integers and floats
 //TODO: ? To concept or not to concept ?
 //TODO: Consider inlining instead of calling dots, crosses etc.
@@ -292,7 +291,7 @@ namespace lib
 
 	//! WIP, do not call this!
 	// https://shaderbits.com/blog/optimized-snell-s-law-refraction
-	inline Vec2 refract_fast(const Vec2 a, const Vec2 b, const f32 ratio)
+	inline Vec2 refract_fast(const Vec2 /*a*/, const Vec2 /*b*/, const f32 /*ratio*/)
 	{
 		//TODO: This will be specialized implementation for known materials (eg. only air - water refraction)
 		__debugbreak();
@@ -507,7 +506,7 @@ namespace lib
 		struct
 		{
 			Vec3 xyz;
-			f32 w;
+			f32 xyz_w; // same storage as 'w', renamed cause only MSVC accepts duplicated anonymous members
 		};
 
 		struct
@@ -518,7 +517,7 @@ namespace lib
 		struct
 		{
 			Vec3 rgb;
-			f32 a;
+			f32 rgb_a; // same storage as 'a'
 		};
 
 		struct 
@@ -1236,4 +1235,463 @@ namespace lib
 
 		return out;
 	}
+
+	//? Unit quaternion for rotations, xyz is vector part and w is scalar part (same order as glTF).
+	//? Rotation direction matches "create_rotation" for the same axis and angle
+	union alignas(__m128) Quat
+	{
+		struct
+		{
+			f32 x, y, z, w;
+		};
+
+		struct
+		{
+			Vec3 xyz;
+			f32 xyz_w; // same storage as 'w'
+		};
+
+		f32 e[4];
+		__m128 simd;
+
+		inline Quat operator-() const { return Quat{ .simd = _mm_xor_ps(simd, _mm_set_ps1(-0.f)) }; }
+		inline const f32& operator[](s32 i) const { return e[i]; }
+		inline f32& operator[](s32 i) { return e[i]; }
+	};
+
+	[[nodiscard]]
+	inline Quat create_quat_identity()
+	{
+		return Quat{ .simd = _mm_set_ps(1.0f, 0.0f, 0.0f, 0.0f) };
+	}
+
+	[[nodiscard]]
+	inline Quat create_quat(Vec3 axis, f32 angle)
+	{
+		axis = normalize(axis);
+		f32 sin_half = sinf(angle * 0.5f);
+		return Quat{ .simd = _mm_set_ps(cosf(angle * 0.5f), axis.z * sin_half, axis.y * sin_half, axis.x * sin_half) };
+	}
+
+	inline Quat operator+(const Quat a, const Quat b)
+	{
+		return Quat{ .simd = _mm_add_ps(a.simd, b.simd) };
+	}
+
+	inline Quat operator*(const f32 t, const Quat b)
+	{
+		return Quat{ .simd = _mm_mul_ps(_mm_set_ps1(t), b.simd) };
+	}
+
+	//? Hamilton product, "a * b" rotates by "b" first then by "a" (as with matrices).
+	//? Each of a.x, a.y, a.z multiplies shuffled "b" with sign flips, 4 mul + 3 add instead of 16 scalar mul
+	inline Quat operator*(const Quat a, const Quat b)
+	{
+		__m128 b_wzyx = _mm_xor_ps(_mm_shuffle_ps(b.simd, b.simd, _MM_SHUFFLE(0, 1, 2, 3)), _mm_set_ps(-0.f, 0.f, -0.f, 0.f));
+		__m128 b_zwxy = _mm_xor_ps(_mm_shuffle_ps(b.simd, b.simd, _MM_SHUFFLE(1, 0, 3, 2)), _mm_set_ps(-0.f, -0.f, 0.f, 0.f));
+		__m128 b_yxwz = _mm_xor_ps(_mm_shuffle_ps(b.simd, b.simd, _MM_SHUFFLE(2, 3, 0, 1)), _mm_set_ps(-0.f, 0.f, 0.f, -0.f));
+
+		__m128 out = _mm_mul_ps(_mm_shuffle_ps(a.simd, a.simd, _MM_SHUFFLE(3, 3, 3, 3)), b.simd);
+		out = _mm_add_ps(out, _mm_mul_ps(_mm_shuffle_ps(a.simd, a.simd, _MM_SHUFFLE(0, 0, 0, 0)), b_wzyx));
+		out = _mm_add_ps(out, _mm_mul_ps(_mm_shuffle_ps(a.simd, a.simd, _MM_SHUFFLE(1, 1, 1, 1)), b_zwxy));
+		out = _mm_add_ps(out, _mm_mul_ps(_mm_shuffle_ps(a.simd, a.simd, _MM_SHUFFLE(2, 2, 2, 2)), b_yxwz));
+
+		return Quat{ .simd = out };
+	}
+
+	inline b32 operator==(const Quat a, const Quat b)
+	{
+		return a.x == b.x && a.y == b.y && a.z == b.z && a.w == b.w;
+	}
+
+	inline f32 dot(const Quat a, const Quat b)
+	{
+		return (a.x*b.x) + (a.y*b.y) + (a.z*b.z) + (a.w*b.w);
+	}
+
+	//? Inverse for unit quaternions
+	inline Quat conjugate(const Quat a)
+	{
+		return Quat{ .simd = _mm_xor_ps(a.simd, _mm_set_ps(0.f, -0.f, -0.f, -0.f)) };
+	}
+
+	//? Zero quaternion gives identity instead of nan
+	inline Quat normalize(const Quat a)
+	{
+		f32 length_squared = dot(a, a);
+		if (length_squared == 0.0f)
+			return create_quat_identity();
+
+		return Quat{ .simd = _mm_mul_ps(a.simd, _mm_set_ps1(1.0f / sqrt(length_squared))) };
+	}
+
+	//? v + 2w(q x v) + 2q x (q x v), cheaper than building matrix for a few vectors
+	inline Vec3 rotate(const Quat q, const Vec3 v)
+	{
+		Vec3 t = 2.0f * cross(q.xyz, v);
+		return v + q.w * t + cross(q.xyz, t);
+	}
+
+	//? Linear blend renormalized, along shorter arc. Angular speed is not constant, but for small angles
+	//? (animation frames) it is indistinguishable from slerp and much cheaper
+	inline Quat nlerp(const Quat a, const Quat b, const f32 t)
+	{
+		Quat b_near = (dot(a, b) < 0.0f) ? -b : b;
+		return normalize((1.0f - t) * a + t * b_near);
+	}
+
+	//? Constant angular speed along shorter arc, falls back to nlerp when quaternions are nearly equal
+	inline Quat slerp(const Quat a, const Quat b, const f32 t)
+	{
+		f32 cos_theta = dot(a, b);
+		Quat b_near = b;
+		if (cos_theta < 0.0f)
+		{
+			b_near = -b;
+			cos_theta = -cos_theta;
+		}
+
+		if (cos_theta > 0.9995f)
+			return normalize((1.0f - t) * a + t * b_near);
+
+		f32 theta = acosf(cos_theta);
+		f32 inv_sin_theta = 1.0f / sinf(theta);
+		return (sinf((1.0f - t) * theta) * inv_sin_theta) * a + (sinf(t * theta) * inv_sin_theta) * b_near;
+	}
+
+	//? Expects unit quaternion, translation column is identity
+	[[nodiscard]]
+	inline Mat4 create_rotation(const Quat q)
+	{
+		Mat4 out = create_diagonal_matrix();
+
+		f32 xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+		f32 xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+		f32 wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+
+		out.e[0][0] = 1.0f - 2.0f * (yy + zz);
+		out.e[0][1] = 2.0f * (xy + wz);
+		out.e[0][2] = 2.0f * (xz - wy);
+
+		out.e[1][0] = 2.0f * (xy - wz);
+		out.e[1][1] = 1.0f - 2.0f * (xx + zz);
+		out.e[1][2] = 2.0f * (yz + wx);
+
+		out.e[2][0] = 2.0f * (xz + wy);
+		out.e[2][1] = 2.0f * (yz - wx);
+		out.e[2][2] = 1.0f - 2.0f * (xx + yy);
+
+		return out;
+	}
+
+	//? Rotation part of "a" as quaternion, columns are normalized first so scale does not leak in. Branches on largest
+	//? diagonal term (Shepperd) so sqrt argument never gets near 0. Mirroring matrices give garbage, see "decompose_trs"
+	[[nodiscard]]
+	inline Quat get_rotation(const Mat4 a)
+	{
+		Vec3 c0 = normalize(a.vecs[0].xyz);
+		Vec3 c1 = normalize(a.vecs[1].xyz);
+		Vec3 c2 = normalize(a.vecs[2].xyz);
+
+		// m_row_column
+		f32 m00 = c0.x, m10 = c0.y, m20 = c0.z;
+		f32 m01 = c1.x, m11 = c1.y, m21 = c1.z;
+		f32 m02 = c2.x, m12 = c2.y, m22 = c2.z;
+
+		Quat out{};
+		f32 trace = m00 + m11 + m22;
+		if (trace > 0.0f)
+		{
+			f32 s = 0.5f / sqrt(trace + 1.0f);
+			out = Quat{ (m21 - m12) * s, (m02 - m20) * s, (m10 - m01) * s, 0.25f / s };
+		}
+		else if (m00 > m11 && m00 > m22)
+		{
+			f32 s = 2.0f * sqrt(1.0f + m00 - m11 - m22);
+			f32 inv_s = 1.0f / s;
+			out = Quat{ 0.25f * s, (m01 + m10) * inv_s, (m02 + m20) * inv_s, (m21 - m12) * inv_s };
+		}
+		else if (m11 > m22)
+		{
+			f32 s = 2.0f * sqrt(1.0f + m11 - m00 - m22);
+			f32 inv_s = 1.0f / s;
+			out = Quat{ (m01 + m10) * inv_s, 0.25f * s, (m12 + m21) * inv_s, (m02 - m20) * inv_s };
+		}
+		else
+		{
+			f32 s = 2.0f * sqrt(1.0f + m22 - m00 - m11);
+			f32 inv_s = 1.0f / s;
+			out = Quat{ (m02 + m20) * inv_s, (m12 + m21) * inv_s, 0.25f * s, (m10 - m01) * inv_s };
+		}
+
+		return normalize(out);
+	}
+
+	//? Translation, rotation, scale - applied in reverse order (scale first), as glTF nodes store them
+	struct Trs
+	{
+		Vec3 translation;
+		Quat rotation;
+		Vec3 scale;
+	};
+
+	[[nodiscard]]
+	inline Trs create_trs_identity()
+	{
+		return Trs{ .translation = {}, .rotation = create_quat_identity(), .scale = { 1.0f, 1.0f, 1.0f } };
+	}
+
+	//? T * R * S written out directly: rotation columns scaled, translation put in last column. No matrix products,
+	//? result has bottom row (0,0,0,1) so it composes further with "mul_trans"
+	[[nodiscard]]
+	inline Mat4 create_transform(const Trs& trs)
+	{
+		Mat4 out = create_rotation(trs.rotation);
+
+		out.columns[0] = _mm_mul_ps(out.columns[0], _mm_set_ps1(trs.scale.x));
+		out.columns[1] = _mm_mul_ps(out.columns[1], _mm_set_ps1(trs.scale.y));
+		out.columns[2] = _mm_mul_ps(out.columns[2], _mm_set_ps1(trs.scale.z));
+		out.columns[3] = _mm_set_ps(1.0f, trs.translation.z, trs.translation.y, trs.translation.x);
+
+		return out;
+	}
+
+	//? Inverse of "create_transform" for matrices without shear. Mirroring (negative determinant) is put into scale.x,
+	//? so rotation stays proper. Scale of 0 on any axis leaves rotation undefined
+	[[nodiscard]]
+	inline Trs decompose_trs(const Mat4 a)
+	{
+		Trs out{};
+		out.translation = get_translation(a);
+		out.scale = { length_vec(a.vecs[0].xyz), length_vec(a.vecs[1].xyz), length_vec(a.vecs[2].xyz) };
+
+		Mat4 rotation = a;
+		if (dot(cross(a.vecs[0].xyz, a.vecs[1].xyz), a.vecs[2].xyz) < 0.0f)
+		{
+			out.scale.x = -out.scale.x;
+			rotation.columns[0] = _mm_xor_ps(rotation.columns[0], _mm_set_ps1(-0.f));
+		}
+		out.rotation = get_rotation(rotation);
+
+		return out;
+	}
+
+	//? Affine transform stored as 3x4 row major matrix (rows of linear part with translation in w), bottom row
+	//? (0,0,0,1) is implicit. 48 bytes instead of 64 for Mat4, and composition skips all work on bottom row.
+	//? Rows (not columns as in Mat4) let composition broadcast scalars of "a" over rows of "b", same layout is read
+	//? by shaders as transposed float4x3 (see Shader_And_CPU_Common.h)
+	struct alignas(__m128) Trans4
+	{
+		union
+		{
+			f32 e[3][4];
+			__m128 rows[3];
+			Vec4 vecs[3];
+		};
+
+		//? overloaded () for accessing by math notation
+		inline f32& operator ()(const s32 row, const s32 column)
+		{
+			return (e[row][column]);
+		}
+
+		inline const f32& operator ()(const s32 row, const s32 column) const
+		{
+			return (e[row][column]);
+		}
+	};
+	static_assert(sizeof(Trans4) == 48, "Trans4 must match 48 byte layout of shaders!");
+
+	[[nodiscard]]
+	inline Trans4 create_trans4_identity()
+	{
+		Trans4 out{};
+
+		out.e[0][0] = 1.0f;
+		out.e[1][1] = 1.0f;
+		out.e[2][2] = 1.0f;
+
+		return out;
+	}
+
+	//? Bottom row of "a" is dropped, so it has to be affine
+	[[nodiscard]]
+	inline Trans4 create_trans4(const Mat4 a)
+	{
+		Trans4 out{};
+
+		__m128 c0 = a.columns[0], c1 = a.columns[1], c2 = a.columns[2], c3 = a.columns[3];
+		_MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+		out.rows[0] = c0;
+		out.rows[1] = c1;
+		out.rows[2] = c2;
+
+		return out;
+	}
+
+	[[nodiscard]]
+	inline Trans4 create_trans4(const Trs& trs)
+	{
+		return create_trans4(create_transform(trs));
+	}
+
+	[[nodiscard]]
+	inline Mat4 create_mat4(const Trans4 a)
+	{
+		Mat4 out{};
+
+		__m128 r0 = a.rows[0], r1 = a.rows[1], r2 = a.rows[2], r3 = _mm_set_ps(1.0f, 0.0f, 0.0f, 0.0f);
+		_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+		out.columns[0] = r0;
+		out.columns[1] = r1;
+		out.columns[2] = r2;
+		out.columns[3] = r3;
+
+		return out;
+	}
+
+	//? Row of "a" times "b": linear combination of rows of "b", plus translation of "a" (times implicit bottom row of "b").
+	//? Pairwise sums, so hierarchy propagation (chain of products) waits for 2 adds per level instead of 3
+	inline __m128 trans_combine_rows(const __m128 row, const Trans4 b)
+	{
+		__m128 sum01 = _mm_add_ps(_mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(0, 0, 0, 0)), b.rows[0]),
+		                          _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(1, 1, 1, 1)), b.rows[1]));
+		__m128 sum2w = _mm_add_ps(_mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(2, 2, 2, 2)), b.rows[2]),
+		                          _mm_and_ps(row, _mm_castsi128_ps(_mm_set_epi32(-1, 0, 0, 0))));
+
+		return _mm_add_ps(sum01, sum2w);
+	}
+
+	//? 9 mul + 9 add, "mul_trans" of Mat4 needs 13 mul + 9 add
+	inline Trans4 operator*(const Trans4 a, const Trans4 b)
+	{
+		Trans4 out{};
+
+		out.rows[0] = trans_combine_rows(a.rows[0], b);
+		out.rows[1] = trans_combine_rows(a.rows[1], b);
+		out.rows[2] = trans_combine_rows(a.rows[2], b);
+
+		return out;
+	}
+
+	//? Three row dots summed horizontally, last lane of result is 0
+	inline __m128 trans_dot_rows(const Trans4 a, const __m128 b)
+	{
+		__m128 xy = _mm_hadd_ps(_mm_mul_ps(a.rows[0], b), _mm_mul_ps(a.rows[1], b));
+		__m128 z = _mm_hadd_ps(_mm_mul_ps(a.rows[2], b), _mm_setzero_ps());
+
+		return _mm_hadd_ps(xy, z);
+	}
+
+	inline Vec3 mul_trans_point(const Trans4 a, const Vec3 p)
+	{
+		Vec4 out{ .simd = trans_dot_rows(a, _mm_set_ps(1.0f, p.z, p.y, p.x)) };
+		return out.xyz;
+	}
+
+	inline Vec3 mul_trans_vec(const Trans4 a, const Vec3 v)
+	{
+		Vec4 out{ .simd = trans_dot_rows(a, _mm_set_ps(0.0f, v.z, v.y, v.x)) };
+		return out.xyz;
+	}
+
+	inline Vec3 get_translation(const Trans4 a)
+	{
+		return { a.e[0][3], a.e[1][3], a.e[2][3] };
+	}
+
+	//? Full affine inverse (shear and non uniform scale included): columns of inverse 3x3 are crosses of rows divided
+	//? by determinant, inverse translation -L^-1 * t is their linear combination. One transpose turns those columns
+	//? and translation into rows
+	[[nodiscard]]
+	inline Trans4 inverse(const Trans4 a)
+	{
+		Trans4 out{};
+
+		// Vec4 cross ignores w (translation) and gives w = 0
+		Vec4 c0 = cross(a.vecs[1], a.vecs[2]);
+		Vec4 c1 = cross(a.vecs[2], a.vecs[0]);
+		Vec4 c2 = cross(a.vecs[0], a.vecs[1]);
+		__m128 inv_det = _mm_set_ps1(1.0f / dot(a.vecs[0], c0));
+		c0.simd = _mm_mul_ps(c0.simd, inv_det);
+		c1.simd = _mm_mul_ps(c1.simd, inv_det);
+		c2.simd = _mm_mul_ps(c2.simd, inv_det);
+
+		__m128 inv_t = _mm_mul_ps(c0.simd, _mm_set_ps1(a.e[0][3]));
+		inv_t = _mm_add_ps(inv_t, _mm_mul_ps(c1.simd, _mm_set_ps1(a.e[1][3])));
+		inv_t = _mm_add_ps(inv_t, _mm_mul_ps(c2.simd, _mm_set_ps1(a.e[2][3])));
+		inv_t = _mm_xor_ps(inv_t, _mm_set_ps1(-0.f));
+
+		_MM_TRANSPOSE4_PS(c0.simd, c1.simd, c2.simd, inv_t);
+		out.rows[0] = c0.simd;
+		out.rows[1] = c1.simd;
+		out.rows[2] = c2.simd;
+
+		return out;
+	}
+
+	//? Box of transformed AABB, extent is sum of absolute values of linear part times extent (J. Arvo)
+	inline void transform_aabb(const Trans4 a, const Vec3 center, const Vec3 extent, Vec3* out_center, Vec3* out_extent)
+	{
+		Trans4 abs_linear{};
+		const __m128 mask_abs_xyz = _mm_castsi128_ps(_mm_set_epi32(0, 0x7fffffff, 0x7fffffff, 0x7fffffff));
+		abs_linear.rows[0] = _mm_and_ps(a.rows[0], mask_abs_xyz);
+		abs_linear.rows[1] = _mm_and_ps(a.rows[1], mask_abs_xyz);
+		abs_linear.rows[2] = _mm_and_ps(a.rows[2], mask_abs_xyz);
+
+		*out_center = mul_trans_point(a, center);
+		*out_extent = mul_trans_vec(abs_linear, extent);
+	}
+
+	//? Planes as (normal, distance) with normals pointing inside, point p is inside of plane when
+	//? dot(normal, p) + distance >= 0. Normals are unit length so distances are in world units
+	struct Frustum
+	{
+		Vec4 planes[6]; // left, right, bottom, top, near, far
+	};
+
+	//? Planes of D3D clip volume (-w <= x,y <= w, 0 <= z <= w) from rows of "world_to_clip" (Gribb & Hartmann).
+	//? With "obj_to_clip" planes are in object space instead
+	[[nodiscard]]
+	inline Frustum create_frustum(const Mat4 world_to_clip)
+	{
+		Frustum out{};
+
+		Mat4 rows = transpose(world_to_clip);
+		out.planes[0] = rows.vecs[3] + rows.vecs[0];
+		out.planes[1] = rows.vecs[3] - rows.vecs[0];
+		out.planes[2] = rows.vecs[3] + rows.vecs[1];
+		out.planes[3] = rows.vecs[3] - rows.vecs[1];
+		out.planes[4] = rows.vecs[2];
+		out.planes[5] = rows.vecs[3] - rows.vecs[2];
+
+		for (Vec4& plane : out.planes)
+			plane *= 1.0f / length_vec(plane.xyz);
+
+		return out;
+	}
+
+	//? Conservative - only spheres fully outside of some plane are rejected
+	inline b32 is_sphere_visible(const Frustum& frustum, const Vec3 center, const f32 radius)
+	{
+		for (const Vec4& plane : frustum.planes)
+		{
+			if (dot(plane.xyz, center) + plane.w < -radius)
+				return false;
+		}
+		return true;
+	}
+
+	//? Conservative as sphere test, box given by center and half size. Extent projected on plane normal is the
+	//? "radius" of box for that plane
+	inline b32 is_aabb_visible(const Frustum& frustum, const Vec3 center, const Vec3 extent)
+	{
+		for (const Vec4& plane : frustum.planes)
+		{
+			f32 radius = fabsf(plane.x) * extent.x + fabsf(plane.y) * extent.y + fabsf(plane.z) * extent.z;
+			if (dot(plane.xyz, center) + plane.w < -radius)
+				return false;
+		}
+		return true;
+	}
 }
@@ -0,0 +1,1092 @@
+#pragma once
+#include <immintrin.h>
+#include <cmath>
+
+#include "Utils.hpp"
+#include "Cpu_Features.hpp"
+#include "Math.hpp"
+#include "Math_x8.hpp"
+
+//? Bulk math over SoA streams with scalar, SSE4.1, AVX2 and AVX-512 variants. Plain names (transform_points etc.) go
+//? through table picked once per module by CPUID, variants stay callable by name or through "get_math_kernels_for"
+//? (tests compare them against scalar reference). Scalar kernels also finish tails of SSE & AVX2 variants, AVX-512 masks
+//? its tail instead. Streams need no alignment and "in" may be same as "out"
+
+namespace lib
+{
+	inline Vec3_Soa_View offset_view(const Vec3_Soa_View view, const u32 i)
+	{
+		return { view.x + i, view.y + i, view.z + i };
+	}
+
+	inline Vec4_Soa_View offset_view(const Vec4_Soa_View view, const u32 i)
+	{
+		return { view.x + i, view.y + i, view.z + i, view.w + i };
+	}
+
+	inline Mat4_Soa_View offset_view(const Mat4_Soa_View& view, const u32 i)
+	{
+		Mat4_Soa_View out;
+		for (u32 column = 0; column < 4; ++column)
+		{
+			for (u32 row = 0; row < 4; ++row)
+				out.e[column][row] = view.e[column][row] + i;
+		}
+		return out;
+	}
+
+	// ===============================================================================================================================
+	// ======================================================= SCALAR ================================================================
+	// ===============================================================================================================================
+
+	//? out[i] = a * (in[i], 1), w of result is dropped so "a" should be affine
+	inline void transform_points_scalar(const Mat4& a, const Vec3_Soa_View in, const Vec3_Soa_View out, const u32 count)
+	{
+		for (u32 i = 0; i < count; ++i)
+		{
+			f32 x = in.x[i], y = in.y[i], z = in.z[i];
+			out.x[i] = a.e[0][0] * x + a.e[1][0] * y + a.e[2][0] * z + a.e[3][0];
+			out.y[i] = a.e[0][1] * x + a.e[1][1] * y + a.e[2][1] * z + a.e[3][1];
+			out.z[i] = a.e[0][2] * x + a.e[1][2] * y + a.e[2][2] * z + a.e[3][2];
+		}
+	}
+
+	//? out[i] = a * (in[i], 0), translation is ignored. For normals pass inverse transpose of model matrix (inverse_trans)
+	//? and normalize afterwards if it scales
+	inline void transform_vectors_scalar(const Mat4& a, const Vec3_Soa_View in, const Vec3_Soa_View out, const u32 count)
+	{
+		for (u32 i = 0; i < count; ++i)
+		{
+			f32 x = in.x[i], y = in.y[i], z = in.z[i];
+			out.x[i] = a.e[0][0] * x + a.e[1][0] * y + a.e[2][0] * z;
+			out.y[i] = a.e[0][1] * x + a.e[1][1] * y + a.e[2][1] * z;
+			out.z[i] = a.e[0][2] * x + a.e[1][2] * y + a.e[2][2] * z;
+		}
+	}
+
+	//? out[i] = a * in[i] for full homogeneous vectors (clip space positions etc.)
+	inline void transform_vec4s_scalar(const Mat4& a, const Vec4_Soa_View in, const Vec4_Soa_View out, const u32 count)
+	{
+		f32* rows_out[4] = { out.x, out.y, out.z, out.w };
+		for (u32 i = 0; i < count; ++i)
+		{
+			f32 x = in.x[i], y = in.y[i], z = in.z[i], w = in.w[i];
+			for (u32 row = 0; row < 4; ++row)
+				rows_out[row][i] = a.e[0][row] * x + a.e[1][row] * y + a.e[2][row] * z + a.e[3][row] * w;
+		}
+	}
+
+	//? out[i] = a * in[i], e.g. parent world matrix times local matrices of its children
+	inline void multiply_matrices_scalar(const Mat4& a, const Mat4_Soa_View& in, const Mat4_Soa_View& out, const u32 count)
+	{
+		for (u32 i = 0; i < count; ++i)
+		{
+			for (u32 column = 0; column < 4; ++column)
+			{
+				f32 b0 = in.e[column][0][i], b1 = in.e[column][1][i], b2 = in.e[column][2][i], b3 = in.e[column][3][i];
+				for (u32 row = 0; row < 4; ++row)
+					out.e[column][row][i] = a.e[0][row] * b0 + a.e[1][row] * b1 + a.e[2][row] * b2 + a.e[3][row] * b3;
+			}
+		}
+	}
+
+	//? Zero length vectors stay zero
+	inline void normalize_vectors_scalar(const Vec3_Soa_View in, const Vec3_Soa_View out, const u32 count)
+	{
+		for (u32 i = 0; i < count; ++i)
+		{
+			f32 x = in.x[i], y = in.y[i], z = in.z[i];
+			f32 length_squared = x * x + y * y + z * z;
+			f32 multi = (length_squared > 0.0f) ? 1.0f / sqrtf(length_squared) : 0.0f;
+			out.x[i] = x * multi;
+			out.y[i] = y * multi;
+			out.z[i] = z * multi;
+		}
+	}
+
+	//? Bounds of points, min stays at +huge and max at -huge for 0 points
+	inline void find_min_max_scalar(const Vec3_Soa_View in, const u32 count, Vec3* out_min, Vec3* out_max)
+	{
+		Vec3 min = { HUGE_VALF, HUGE_VALF, HUGE_VALF };
+		Vec3 max = { -HUGE_VALF, -HUGE_VALF, -HUGE_VALF };
+		for (u32 i = 0; i < count; ++i)
+		{
+			min.x = (in.x[i] < min.x) ? in.x[i] : min.x;
+			min.y = (in.y[i] < min.y) ? in.y[i] : min.y;
+			min.z = (in.z[i] < min.z) ? in.z[i] : min.z;
+			max.x = (in.x[i] > max.x) ? in.x[i] : max.x;
+			max.y = (in.y[i] > max.y) ? in.y[i] : max.y;
+			max.z = (in.z[i] > max.z) ? in.z[i] : max.z;
+		}
+		*out_min = min;
+		*out_max = max;
+	}
+
+	//? Quaternions are (x, y, z, w) streams, "t" is blend factor per quaternion (fill it for single weight).
+	//? Both blends take shorter arc like scalar "nlerp" and "slerp"
+	inline void nlerp_quats_scalar(const Vec4_Soa_View a, const Vec4_Soa_View b, const f32* t, const Vec4_Soa_View out, const u32 count)
+	{
+		for (u32 i = 0; i < count; ++i)
+		{
+			Quat q = nlerp(Quat{ a.x[i], a.y[i], a.z[i], a.w[i] }, Quat{ b.x[i], b.y[i], b.z[i], b.w[i] }, t[i]);
+			out.x[i] = q.x;
+			out.y[i] = q.y;
+			out.z[i] = q.z;
+			out.w[i] = q.w;
+		}
+	}
+
+	inline void slerp_quats_scalar(const Vec4_Soa_View a, const Vec4_Soa_View b, const f32* t, const Vec4_Soa_View out, const u32 count)
+	{
+		for (u32 i = 0; i < count; ++i)
+		{
+			Quat q = slerp(Quat{ a.x[i], a.y[i], a.z[i], a.w[i] }, Quat{ b.x[i], b.y[i], b.z[i], b.w[i] }, t[i]);
+			out.x[i] = q.x;
+			out.y[i] = q.y;
+			out.z[i] = q.z;
+			out.w[i] = q.w;
+		}
+	}
+
+	//? SIMD slerp has no acos & sin, weights sin(t*theta)/sin(theta) come from polynomial in t and cos(theta) instead
+	//? (D. Eberly, "A Fast and Accurate Algorithm for Computing SLERP"): t * (1 + b0 * (1 + b1 * (... (1 + b7)))),
+	//? bk = (u[k] * t^2 - v[k]) * (cos(theta) - 1). Error of weights is below 1e-7 up to 90 degrees between rotations
+	//? and ~2e-5 for opposite ones
+	inline constexpr f32 g_slerp_mu = 1.85298109240830f;
+	inline constexpr f32 g_slerp_u[8] = { 1.0f / (1 * 3), 1.0f / (2 * 5), 1.0f / (3 * 7), 1.0f / (4 * 9),
+	                                      1.0f / (5 * 11), 1.0f / (6 * 13), 1.0f / (7 * 15), g_slerp_mu / (8 * 17) };
+	inline constexpr f32 g_slerp_v[8] = { 1.0f / 3, 2.0f / 5, 3.0f / 7, 4.0f / 9,
+	                                      5.0f / 11, 6.0f / 13, 7.0f / 15, g_slerp_mu * 8 / 17 };
+
+	//? Frustum culling: indices of visible spheres / boxes go to "out_visible" in input order, count of them is returned.
+	//? "out_visible" needs room for "count" indices - SIMD variants store whole vectors of candidates, but never past
+	//? position of last tested object. Tests are conservative as "is_sphere_visible" and "is_aabb_visible". Variants
+	//? sum plane distances in same order, lists can differ only for objects within rounding of a plane (compiler may
+	//? fuse mul+add in AVX code)
+	inline u32 cull_spheres_scalar(const Frustum& frustum, const Vec3_Soa_View centers, const f32* radii, const u32 count, u32* out_visible)
+	{
+		u32 count_visible = 0;
+		for (u32 i = 0; i < count; ++i)
+		{
+			f32 min_distance = HUGE_VALF;
+			for (const Vec4& plane : frustum.planes)
+			{
+				f32 distance = plane.x * centers.x[i] + plane.y * centers.y[i] + plane.z * centers.z[i] + plane.w;
+				min_distance = (distance < min_distance) ? distance : min_distance;
+			}
+			out_visible[count_visible] = i;
+			count_visible += (min_distance >= -radii[i]) ? 1 : 0;
+		}
+		return count_visible;
+	}
+
+	inline u32 cull_aabbs_scalar(const Frustum& frustum, const Vec3_Soa_View centers, const Vec3_Soa_View extents, const u32 count, u32* out_visible)
+	{
+		u32 count_visible = 0;
+		for (u32 i = 0; i < count; ++i)
+		{
+			f32 min_distance = HUGE_VALF;
+			for (const Vec4& plane : frustum.planes)
+			{
+				f32 distance = plane.x * centers.x[i] + plane.y * centers.y[i] + plane.z * centers.z[i] + plane.w;
+				f32 radius = fabsf(plane.x) * extents.x[i] + fabsf(plane.y) * extents.y[i] + fabsf(plane.z) * extents.z[i];
+				distance = distance + radius;
+				min_distance = (distance < min_distance) ? distance : min_distance;
+			}
+			out_visible[count_visible] = i;
+			count_visible += (min_distance >= 0.0f) ? 1 : 0;
+		}
+		return count_visible;
+	}
+
+	//? Lane numbers of set bits in 8 bit mask, packed as bytes from lowest lane. Used to compact candidates of vector
+	//? with one permute (AVX2) or widening (SSE4.1, low 4 bytes for masks below 16)
+	struct Compaction_Lut
+	{
+		u64 lanes[256];
+	};
+
+	inline constexpr Compaction_Lut create_compaction_lut()
+	{
+		Compaction_Lut out{};
+		for (u32 mask = 0; mask < 256; ++mask)
+		{
+			u32 count_set = 0;
+			for (u32 lane = 0; lane < 8; ++lane)
+			{
+				if (mask & (1u << lane))
+					out.lanes[mask] |= (u64)lane << (8 * count_set++);
+			}
+		}
+		return out;
+	}
+
+	inline constexpr Compaction_Lut g_compaction_lut = create_compaction_lut();
+
+	//? SIMD tails go through scalar variants, which number objects from 0
+	inline u32 rebase_indices(u32* indices, const u32 count, const u32 base)
+	{
+		for (u32 i = 0; i < count; ++i)
+			indices[i] += base;
+		return count;
+	}
+
+	// ===============================================================================================================================
+	// ======================================================= SSE4.1 ================================================================
+	// ===============================================================================================================================
+
+	inline void transform_points_sse41(const Mat4& a, const Vec3_Soa_View in, const Vec3_Soa_View out, const u32 count)
+	{
+		__m128 m[4][3];
+		for (u32 column = 0; column < 4; ++column)
+		{
+			for (u32 row = 0; row < 3; ++row)
+				m[column][row] = _mm_set1_ps(a.e[column][row]);
+		}
+
+		u32 i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128 x = _mm_loadu_ps(in.x + i), y = _mm_loadu_ps(in.y + i), z = _mm_loadu_ps(in.z + i);
+			f32* rows_out[3] = { out.x, out.y, out.z };
+			for (u32 row = 0; row < 3; ++row)
+			{
+				__m128 sum = _mm_add_ps(_mm_mul_ps(m[0][row], x), m[3][row]);
+				sum = _mm_add_ps(sum, _mm_mul_ps(m[1][row], y));
+				sum = _mm_add_ps(sum, _mm_mul_ps(m[2][row], z));
+				_mm_storeu_ps(rows_out[row] + i, sum);
+			}
+		}
+		transform_points_scalar(a, offset_view(in, i), offset_view(out, i), count - i);
+	}
+
+	inline void transform_vectors_sse41(const Mat4& a, const Vec3_Soa_View in, const Vec3_Soa_View out, const u32 count)
+	{
+		__m128 m[3][3];
+		for (u32 column = 0; column < 3; ++column)
+		{
+			for (u32 row = 0; row < 3; ++row)
+				m[column][row] = _mm_set1_ps(a.e[column][row]);
+		}
+
+		u32 i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128 x = _mm_loadu_ps(in.x + i), y = _mm_loadu_ps(in.y + i), z = _mm_loadu_ps(in.z + i);
+			f32* rows_out[3] = { out.x, out.y, out.z };
+			for (u32 row = 0; row < 3; ++row)
+			{
+				__m128 sum = _mm_mul_ps(m[0][row], x);
+				sum = _mm_add_ps(sum, _mm_mul_ps(m[1][row], y));
+				sum = _mm_add_ps(sum, _mm_mul_ps(m[2][row], z));
+				_mm_storeu_ps(rows_out[row] + i, sum);
+			}
+		}
+		transform_vectors_scalar(a, offset_view(in, i), offset_view(out, i), count - i);
+	}
+
+	inline void transform_vec4s_sse41(const Mat4& a, const Vec4_Soa_View in, const Vec4_Soa_View out, const u32 count)
+	{
+		u32 i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128 x = _mm_loadu_ps(in.x + i), y = _mm_loadu_ps(in.y + i), z = _mm_loadu_ps(in.z + i), w = _mm_loadu_ps(in.w + i);
+			f32* rows_out[4] = { out.x, out.y, out.z, out.w };
+			for (u32 row = 0; row < 4; ++row)
+			{
+				__m128 sum = _mm_mul_ps(_mm_set1_ps(a.e[0][row]), x);
+				sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(a.e[1][row]), y));
+				sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(a.e[2][row]), z));
+				sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(a.e[3][row]), w));
+				_mm_storeu_ps(rows_out[row] + i, sum);
+			}
+		}
+		transform_vec4s_scalar(a, offset_view(in, i), offset_view(out, i), count - i);
+	}
+
+	inline void multiply_matrices_sse41(const Mat4& a, const Mat4_Soa_View& in, const Mat4_Soa_View& out, const u32 count)
+	{
+		u32 i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			for (u32 column = 0; column < 4; ++column)
+			{
+				__m128 b0 = _mm_loadu_ps(in.e[column][0] + i);
+				__m128 b1 = _mm_loadu_ps(in.e[column][1] + i);
+				__m128 b2 = _mm_loadu_ps(in.e[column][2] + i);
+				__m128 b3 = _mm_loadu_ps(in.e[column][3] + i);
+				for (u32 row = 0; row < 4; ++row)
+				{
+					__m128 sum = _mm_mul_ps(_mm_set1_ps(a.e[0][row]), b0);
+					sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(a.e[1][row]), b1));
+					sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(a.e[2][row]), b2));
+					sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(a.e[3][row]), b3));
+					_mm_storeu_ps(out.e[column][row] + i, sum);
+				}
+			}
+		}
+		multiply_matrices_scalar(a, offset_view(in, i), offset_view(out, i), count - i);
+	}
+
+	inline void normalize_vectors_sse41(const Vec3_Soa_View in, const Vec3_Soa_View out, const u32 count)
+	{
+		u32 i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128 x = _mm_loadu_ps(in.x + i), y = _mm_loadu_ps(in.y + i), z = _mm_loadu_ps(in.z + i);
+			__m128 length_squared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+			__m128 is_non_zero = _mm_cmpgt_ps(length_squared, _mm_setzero_ps());
+			__m128 multi = _mm_and_ps(_mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(length_squared)), is_non_zero);
+			_mm_storeu_ps(out.x + i, _mm_mul_ps(x, multi));
+			_mm_storeu_ps(out.y + i, _mm_mul_ps(y, multi));
+			_mm_storeu_ps(out.z + i, _mm_mul_ps(z, multi));
+		}
+		normalize_vectors_scalar(offset_view(in, i), offset_view(out, i), count - i);
+	}
+
+	inline f32 reduce_min_sse41(__m128 a)
+	{
+		a = _mm_min_ps(a, _mm_shuffle_ps(a, a, _MM_SHUFFLE(1, 0, 3, 2)));
+		a = _mm_min_ps(a, _mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)));
+		return _mm_cvtss_f32(a);
+	}
+
+	inline f32 reduce_max_sse41(__m128 a)
+	{
+		a = _mm_max_ps(a, _mm_shuffle_ps(a, a, _MM_SHUFFLE(1, 0, 3, 2)));
+		a = _mm_max_ps(a, _mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)));
+		return _mm_cvtss_f32(a);
+	}
+
+	inline void find_min_max_sse41(const Vec3_Soa_View in, const u32 count, Vec3* out_min, Vec3* out_max)
+	{
+		__m128 min_x = _mm_set1_ps(HUGE_VALF), min_y = min_x, min_z = min_x;
+		__m128 max_x = _mm_set1_ps(-HUGE_VALF), max_y = max_x, max_z = max_x;
+		u32 i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128 x = _mm_loadu_ps(in.x + i), y = _mm_loadu_ps(in.y + i), z = _mm_loadu_ps(in.z + i);
+			min_x = _mm_min_ps(min_x, x); min_y = _mm_min_ps(min_y, y); min_z = _mm_min_ps(min_z, z);
+			max_x = _mm_max_ps(max_x, x); max_y = _mm_max_ps(max_y, y); max_z = _mm_max_ps(max_z, z);
+		}
+
+		Vec3 tail_min, tail_max;
+		find_min_max_scalar(offset_view(in, i), count - i, &tail_min, &tail_max);
+		*out_min = { min(reduce_min_sse41(min_x), tail_min.x), min(reduce_min_sse41(min_y), tail_min.y), min(reduce_min_sse41(min_z), tail_min.z) };
+		*out_max = { max(reduce_max_sse41(max_x), tail_max.x), max(reduce_max_sse41(max_y), tail_max.y), max(reduce_max_sse41(max_z), tail_max.z) };
+	}
+
+	inline void nlerp_quats_sse41(const Vec4_Soa_View a, const Vec4_Soa_View b, const f32* t, const Vec4_Soa_View out, const u32 count)
+	{
+		u32 i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128 ax = _mm_loadu_ps(a.x + i), ay = _mm_loadu_ps(a.y + i), az = _mm_loadu_ps(a.z + i), aw = _mm_loadu_ps(a.w + i);
+			__m128 bx = _mm_loadu_ps(b.x + i), by = _mm_loadu_ps(b.y + i), bz = _mm_loadu_ps(b.z + i), bw = _mm_loadu_ps(b.w + i);
+			__m128 t4 = _mm_loadu_ps(t + i);
+
+			__m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, bx), _mm_mul_ps(ay, by)), _mm_add_ps(_mm_mul_ps(az, bz), _mm_mul_ps(aw, bw)));
+			__m128 sign = _mm_and_ps(_mm_cmplt_ps(d, _mm_setzero_ps()), _mm_set1_ps(-0.f));
+			__m128 ta = _mm_sub_ps(_mm_set1_ps(1.0f), t4);
+			__m128 tb = _mm_xor_ps(t4, sign);
+			__m128 x = _mm_add_ps(_mm_mul_ps(ta, ax), _mm_mul_ps(tb, bx));
+			__m128 y = _mm_add_ps(_mm_mul_ps(ta, ay), _mm_mul_ps(tb, by));
+			__m128 z = _mm_add_ps(_mm_mul_ps(ta, az), _mm_mul_ps(tb, bz));
+			__m128 w = _mm_add_ps(_mm_mul_ps(ta, aw), _mm_mul_ps(tb, bw));
+
+			// Zero blend (opposite inputs at half way) gives identity as scalar normalize does
+			__m128 length_squared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_add_ps(_mm_mul_ps(z, z), _mm_mul_ps(w, w)));
+			__m128 is_non_zero = _mm_cmpgt_ps(length_squared, _mm_setzero_ps());
+			__m128 multi = _mm_and_ps(_mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(length_squared)), is_non_zero);
+			_mm_storeu_ps(out.x + i, _mm_mul_ps(x, multi));
+			_mm_storeu_ps(out.y + i, _mm_mul_ps(y, multi));
+			_mm_storeu_ps(out.z + i, _mm_mul_ps(z, multi));
+			_mm_storeu_ps(out.w + i, _mm_blendv_ps(_mm_set1_ps(1.0f), _mm_mul_ps(w, multi), is_non_zero));
+		}
+		nlerp_quats_scalar(offset_view(a, i), offset_view(b, i), t + i, offset_view(out, i), count - i);
+	}
+
+	inline __m128 get_slerp_weight_sse41(const __m128 t, const __m128 cos_theta_minus_1)
+	{
+		__m128 t_squared = _mm_mul_ps(t, t);
+		__m128 out = _mm_set1_ps(1.0f);
+		for (s32 k = 7; k >= 0; --k)
+		{
+			__m128 b_k = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(_mm_set1_ps(g_slerp_u[k]), t_squared), _mm_set1_ps(g_slerp_v[k])), cos_theta_minus_1);
+			out = _mm_add_ps(_mm_set1_ps(1.0f), _mm_mul_ps(b_k, out));
+		}
+		return _mm_mul_ps(t, out);
+	}
+
+	inline void slerp_quats_sse41(const Vec4_Soa_View a, const Vec4_Soa_View b, const f32* t, const Vec4_Soa_View out, const u32 count)
+	{
+		u32 i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128 ax = _mm_loadu_ps(a.x + i), ay = _mm_loadu_ps(a.y + i), az = _mm_loadu_ps(a.z + i), aw = _mm_loadu_ps(a.w + i);
+			__m128 bx = _mm_loadu_ps(b.x + i), by = _mm_loadu_ps(b.y + i), bz = _mm_loadu_ps(b.z + i), bw = _mm_loadu_ps(b.w + i);
+			__m128 t4 = _mm_loadu_ps(t + i);
+
+			__m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, bx), _mm_mul_ps(ay, by)), _mm_add_ps(_mm_mul_ps(az, bz), _mm_mul_ps(aw, bw)));
+			__m128 sign = _mm_and_ps(_mm_cmplt_ps(d, _mm_setzero_ps()), _mm_set1_ps(-0.f));
+			__m128 cos_theta_minus_1 = _mm_sub_ps(_mm_xor_ps(d, sign), _mm_set1_ps(1.0f));
+			__m128 ta = get_slerp_weight_sse41(_mm_sub_ps(_mm_set1_ps(1.0f), t4), cos_theta_minus_1);
+			__m128 tb = _mm_xor_ps(get_slerp_weight_sse41(t4, cos_theta_minus_1), sign);
+			_mm_storeu_ps(out.x + i, _mm_add_ps(_mm_mul_ps(ta, ax), _mm_mul_ps(tb, bx)));
+			_mm_storeu_ps(out.y + i, _mm_add_ps(_mm_mul_ps(ta, ay), _mm_mul_ps(tb, by)));
+			_mm_storeu_ps(out.z + i, _mm_add_ps(_mm_mul_ps(ta, az), _mm_mul_ps(tb, bz)));
+			_mm_storeu_ps(out.w + i, _mm_add_ps(_mm_mul_ps(ta, aw), _mm_mul_ps(tb, bw)));
+		}
+		slerp_quats_scalar(offset_view(a, i), offset_view(b, i), t + i, offset_view(out, i), count - i);
+	}
+
+	struct Frustum_Sse41
+	{
+		__m128 normal_x[6], normal_y[6], normal_z[6], distance[6];
+		__m128 abs_x[6], abs_y[6], abs_z[6];
+	};
+
+	inline Frustum_Sse41 splat_frustum_sse41(const Frustum& frustum)
+	{
+		Frustum_Sse41 out;
+		for (u32 p = 0; p < 6; ++p)
+		{
+			const Vec4& plane = frustum.planes[p];
+			out.normal_x[p] = _mm_set1_ps(plane.x); out.normal_y[p] = _mm_set1_ps(plane.y); out.normal_z[p] = _mm_set1_ps(plane.z);
+			out.distance[p] = _mm_set1_ps(plane.w);
+			out.abs_x[p] = _mm_set1_ps(fabsf(plane.x)); out.abs_y[p] = _mm_set1_ps(fabsf(plane.y)); out.abs_z[p] = _mm_set1_ps(fabsf(plane.z));
+		}
+		return out;
+	}
+
+	inline u32 store_visible_sse41(const __m128 is_visible, const u32 i, u32* out_visible)
+	{
+		u32 mask = (u32)_mm_movemask_ps(is_visible);
+		__m128i lanes = _mm_cvtepu8_epi32(_mm_cvtsi32_si128((s32)(u32)g_compaction_lut.lanes[mask]));
+		_mm_storeu_si128((__m128i*)out_visible, _mm_add_epi32(lanes, _mm_set1_epi32((s32)i)));
+		return count_bits_u64(mask);
+	}
+
+	inline u32 cull_spheres_sse41(const Frustum& frustum, const Vec3_Soa_View centers, const f32* radii, const u32 count, u32* out_visible)
+	{
+		Frustum_Sse41 wide = splat_frustum_sse41(frustum);
+		u32 count_visible = 0;
+		u32 i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128 x = _mm_loadu_ps(centers.x + i), y = _mm_loadu_ps(centers.y + i), z = _mm_loadu_ps(centers.z + i);
+			__m128 min_distance = _mm_set1_ps(HUGE_VALF);
+			for (u32 p = 0; p < 6; ++p)
+			{
+				__m128 distance = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(wide.normal_x[p], x), _mm_mul_ps(wide.normal_y[p], y)),
+				                                        _mm_mul_ps(wide.normal_z[p], z)), wide.distance[p]);
+				min_distance = _mm_min_ps(min_distance, distance);
+			}
+			__m128 neg_radius = _mm_xor_ps(_mm_loadu_ps(radii + i), _mm_set1_ps(-0.f));
+			count_visible += store_visible_sse41(_mm_cmpge_ps(min_distance, neg_radius), i, out_visible + count_visible);
+		}
+		u32* tail = out_visible + count_visible;
+		return count_visible + rebase_indices(tail, cull_spheres_scalar(frustum, offset_view(centers, i), radii + i, count - i, tail), i);
+	}
+
+	inline u32 cull_aabbs_sse41(const Frustum& frustum, const Vec3_Soa_View centers, const Vec3_Soa_View extents, const u32 count, u32* out_visible)
+	{
+		Frustum_Sse41 wide = splat_frustum_sse41(frustum);
+		u32 count_visible = 0;
+		u32 i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128 x = _mm_loadu_ps(centers.x + i), y = _mm_loadu_ps(centers.y + i), z = _mm_loadu_ps(centers.z + i);
+			__m128 ex = _mm_loadu_ps(extents.x + i), ey = _mm_loadu_ps(extents.y + i), ez = _mm_loadu_ps(extents.z + i);
+			__m128 min_distance = _mm_set1_ps(HUGE_VALF);
+			for (u32 p = 0; p < 6; ++p)
+			{
+				__m128 distance = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(wide.normal_x[p], x), _mm_mul_ps(wide.normal_y[p], y)),
+				                                        _mm_mul_ps(wide.normal_z[p], z)), wide.distance[p]);
+				__m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(wide.abs_x[p], ex), _mm_mul_ps(wide.abs_y[p], ey)), _mm_mul_ps(wide.abs_z[p], ez));
+				min_distance = _mm_min_ps(min_distance, _mm_add_ps(distance, radius));
+			}
+			count_visible += store_visible_sse41(_mm_cmpge_ps(min_distance, _mm_setzero_ps()), i, out_visible + count_visible);
+		}
+		u32* tail = out_visible + count_visible;
+		return count_visible + rebase_indices(tail, cull_aabbs_scalar(frustum, offset_view(centers, i), offset_view(extents, i), count - i, tail), i);
+	}
+}
+
+// ===============================================================================================================================
+// ======================================================= AVX2 ==================================================================
+// ===============================================================================================================================
+
+LIB_TARGET_AVX2_BEGIN
+
+namespace lib
+{
+	inline void transform_points_avx2(const Mat4& a, const Vec3_Soa_View in, const Vec3_Soa_View out, const u32 count)
+	{
+		Mat4x8 wide = splat(a);
+		u32 i = 0;
+		for (; i + g_simd_width <= count; i += g_simd_width)
+		{
+			Vec3x8 p = load_x8(in, i);
+			Vec3x8 result;
+			result.x = _mm256_fmadd_ps(wide.e[0][0], p.x, _mm256_fmadd_ps(wide.e[1][0], p.y, _mm256_fmadd_ps(wide.e[2][0], p.z, wide.e[3][0])));
+			result.y = _mm256_fmadd_ps(wide.e[0][1], p.x, _mm256_fmadd_ps(wide.e[1][1], p.y, _mm256_fmadd_ps(wide.e[2][1], p.z, wide.e[3][1])));
+			result.z = _mm256_fmadd_ps(wide.e[0][2], p.x, _mm256_fmadd_ps(wide.e[1][2], p.y, _mm256_fmadd_ps(wide.e[2][2], p.z, wide.e[3][2])));
+			store_x8(out, i, result);
+		}
+		transform_points_scalar(a, offset_view(in, i), offset_view(out, i), count - i);
+	}
+
+	inline void transform_vectors_avx2(const Mat4& a, const Vec3_Soa_View in, const Vec3_Soa_View out, const u32 count)
+	{
+		Mat4x8 wide = splat(a);
+		u32 i = 0;
+		for (; i + g_simd_width <= count; i += g_simd_width)
+		{
+			Vec3x8 v = load_x8(in, i);
+			Vec3x8 result;
+			result.x = _mm256_fmadd_ps(wide.e[0][0], v.x, _mm256_fmadd_ps(wide.e[1][0], v.y, _mm256_mul_ps(wide.e[2][0], v.z)));
+			result.y = _mm256_fmadd_ps(wide.e[0][1], v.x, _mm256_fmadd_ps(wide.e[1][1], v.y, _mm256_mul_ps(wide.e[2][1], v.z)));
+			result.z = _mm256_fmadd_ps(wide.e[0][2], v.x, _mm256_fmadd_ps(wide.e[1][2], v.y, _mm256_mul_ps(wide.e[2][2], v.z)));
+			store_x8(out, i, result);
+		}
+		transform_vectors_scalar(a, offset_view(in, i), offset_view(out, i), count - i);
+	}
+
+	inline void transform_vec4s_avx2(const Mat4& a, const Vec4_Soa_View in, const Vec4_Soa_View out, const u32 count)
+	{
+		Mat4x8 wide = splat(a);
+		u32 i = 0;
+		for (; i + g_simd_width <= count; i += g_simd_width)
+			store_x8(out, i, wide * load_x8(in, i));
+		transform_vec4s_scalar(a, offset_view(in, i), offset_view(out, i), count - i);
+	}
+
+	inline void multiply_matrices_avx2(const Mat4& a, const Mat4_Soa_View& in, const Mat4_Soa_View& out, const u32 count)
+	{
+		Mat4x8 wide = splat(a);
+		u32 i = 0;
+		for (; i + g_simd_width <= count; i += g_simd_width)
+		{
+			// Column at time keeps 4 inputs and 1 sum live, whole Mat4x8 in registers would spill
+			for (u32 column = 0; column < 4; ++column)
+			{
+				__m256 b0 = _mm256_loadu_ps(in.e[column][0] + i);
+				__m256 b1 = _mm256_loadu_ps(in.e[column][1] + i);
+				__m256 b2 = _mm256_loadu_ps(in.e[column][2] + i);
+				__m256 b3 = _mm256_loadu_ps(in.e[column][3] + i);
+				for (u32 row = 0; row < 4; ++row)
+				{
+					__m256 sum = _mm256_mul_ps(wide.e[0][row], b0);
+					sum = _mm256_fmadd_ps(wide.e[1][row], b1, sum);
+					sum = _mm256_fmadd_ps(wide.e[2][row], b2, sum);
+					_mm256_storeu_ps(out.e[column][row] + i, _mm256_fmadd_ps(wide.e[3][row], b3, sum));
+				}
+			}
+		}
+		multiply_matrices_scalar(a, offset_view(in, i), offset_view(out, i), count - i);
+	}
+
+	inline void normalize_vectors_avx2(const Vec3_Soa_View in, const Vec3_Soa_View out, const u32 count)
+	{
+		u32 i = 0;
+		for (; i + g_simd_width <= count; i += g_simd_width)
+			store_x8(out, i, normalize(load_x8(in, i)));
+		normalize_vectors_scalar(offset_view(in, i), offset_view(out, i), count - i);
+	}
+
+	inline void find_min_max_avx2(const Vec3_Soa_View in, const u32 count, Vec3* out_min, Vec3* out_max)
+	{
+		Vec3x8 bounds_min = splat(Vec3{ HUGE_VALF, HUGE_VALF, HUGE_VALF });
+		Vec3x8 bounds_max = splat(Vec3{ -HUGE_VALF, -HUGE_VALF, -HUGE_VALF });
+		u32 i = 0;
+		for (; i + g_simd_width <= count; i += g_simd_width)
+		{
+			Vec3x8 p = load_x8(in, i);
+			bounds_min = { _mm256_min_ps(bounds_min.x, p.x), _mm256_min_ps(bounds_min.y, p.y), _mm256_min_ps(bounds_min.z, p.z) };
+			bounds_max = { _mm256_max_ps(bounds_max.x, p.x), _mm256_max_ps(bounds_max.y, p.y), _mm256_max_ps(bounds_max.z, p.z) };
+		}
+
+		auto reduce_min = [](__m256 a) { return reduce_min_sse41(_mm_min_ps(_mm256_castps256_ps128(a), _mm256_extractf128_ps(a, 1))); };
+		auto reduce_max = [](__m256 a) { return reduce_max_sse41(_mm_max_ps(_mm256_castps256_ps128(a), _mm256_extractf128_ps(a, 1))); };
+		Vec3 tail_min, tail_max;
+		find_min_max_scalar(offset_view(in, i), count - i, &tail_min, &tail_max);
+		*out_min = { min(reduce_min(bounds_min.x), tail_min.x), min(reduce_min(bounds_min.y), tail_min.y), min(reduce_min(bounds_min.z), tail_min.z) };
+		*out_max = { max(reduce_max(bounds_max.x), tail_max.x), max(reduce_max(bounds_max.y), tail_max.y), max(reduce_max(bounds_max.z), tail_max.z) };
+	}
+
+	inline void nlerp_quats_avx2(const Vec4_Soa_View a, const Vec4_Soa_View b, const f32* t, const Vec4_Soa_View out, const u32 count)
+	{
+		const __m256 one = _mm256_set1_ps(1.0f);
+		u32 i = 0;
+		for (; i + g_simd_width <= count; i += g_simd_width)
+		{
+			Vec4x8 qa = load_x8(a, i), qb = load_x8(b, i);
+			__m256 t8 = _mm256_loadu_ps(t + i);
+			__m256 sign = _mm256_and_ps(_mm256_cmp_ps(dot(qa, qb), _mm256_setzero_ps(), _CMP_LT_OQ), _mm256_set1_ps(-0.f));
+			Vec4x8 q = _mm256_sub_ps(one, t8) * qa + _mm256_xor_ps(t8, sign) * qb;
+
+			__m256 is_non_zero = _mm256_cmp_ps(dot(q, q), _mm256_setzero_ps(), _CMP_GT_OQ);
+			q = normalize(q);
+			q.w = _mm256_blendv_ps(one, q.w, is_non_zero);
+			store_x8(out, i, q);
+		}
+		nlerp_quats_scalar(offset_view(a, i), offset_view(b, i), t + i, offset_view(out, i), count - i);
+	}
+
+	inline __m256 get_slerp_weight_avx2(const __m256 t, const __m256 cos_theta_minus_1)
+	{
+		const __m256 one = _mm256_set1_ps(1.0f);
+		__m256 t_squared = _mm256_mul_ps(t, t);
+		__m256 out = one;
+		for (s32 k = 7; k >= 0; --k)
+		{
+			__m256 b_k = _mm256_mul_ps(_mm256_fmsub_ps(_mm256_set1_ps(g_slerp_u[k]), t_squared, _mm256_set1_ps(g_slerp_v[k])), cos_theta_minus_1);
+			out = _mm256_fmadd_ps(b_k, out, one);
+		}
+		return _mm256_mul_ps(t, out);
+	}
+
+	inline void slerp_quats_avx2(const Vec4_Soa_View a, const Vec4_Soa_View b, const f32* t, const Vec4_Soa_View out, const u32 count)
+	{
+		const __m256 one = _mm256_set1_ps(1.0f);
+		u32 i = 0;
+		for (; i + g_simd_width <= count; i += g_simd_width)
+		{
+			Vec4x8 qa = load_x8(a, i), qb = load_x8(b, i);
+			__m256 t8 = _mm256_loadu_ps(t + i);
+			__m256 d = dot(qa, qb);
+			__m256 sign = _mm256_and_ps(_mm256_cmp_ps(d, _mm256_setzero_ps(), _CMP_LT_OQ), _mm256_set1_ps(-0.f));
+			__m256 cos_theta_minus_1 = _mm256_sub_ps(_mm256_xor_ps(d, sign), one);
+			__m256 ta = get_slerp_weight_avx2(_mm256_sub_ps(one, t8), cos_theta_minus_1);
+			__m256 tb = _mm256_xor_ps(get_slerp_weight_avx2(t8, cos_theta_minus_1), sign);
+			store_x8(out, i, ta * qa + tb * qb);
+		}
+		slerp_quats_scalar(offset_view(a, i), offset_view(b, i), t + i, offset_view(out, i), count - i);
+	}
+
+	struct Frustum_Avx2
+	{
+		__m256 normal_x[6], normal_y[6], normal_z[6], distance[6];
+		__m256 abs_x[6], abs_y[6], abs_z[6];
+	};
+
+	inline Frustum_Avx2 splat_frustum_avx2(const Frustum& frustum)
+	{
+		Frustum_Avx2 out;
+		for (u32 p = 0; p < 6; ++p)
+		{
+			const Vec4& plane = frustum.planes[p];
+			out.normal_x[p] = _mm256_set1_ps(plane.x); out.normal_y[p] = _mm256_set1_ps(plane.y); out.normal_z[p] = _mm256_set1_ps(plane.z);
+			out.distance[p] = _mm256_set1_ps(plane.w);
+			out.abs_x[p] = _mm256_set1_ps(fabsf(plane.x)); out.abs_y[p] = _mm256_set1_ps(fabsf(plane.y)); out.abs_z[p] = _mm256_set1_ps(fabsf(plane.z));
+		}
+		return out;
+	}
+
+	//? Visible lanes are permuted to front and all 8 stored, next store overwrites the rest
+	inline u32 store_visible_avx2(const __m256 is_visible, const u32 i, u32* out_visible)
+	{
+		u32 mask = (u32)_mm256_movemask_ps(is_visible);
+		__m256i lanes = _mm256_cvtepu8_epi32(_mm_cvtsi64_si128((s64)g_compaction_lut.lanes[mask]));
+		_mm256_storeu_si256((__m256i*)out_visible, _mm256_add_epi32(lanes, _mm256_set1_epi32((s32)i)));
+		return count_bits_u64(mask);
+	}
+
+	inline __m256 get_plane_distance_avx2(const Frustum_Avx2& wide, const u32 p, const Vec3x8 c)
+	{
+		return _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(wide.normal_x[p], c.x), _mm256_mul_ps(wide.normal_y[p], c.y)),
+		                                   _mm256_mul_ps(wide.normal_z[p], c.z)), wide.distance[p]);
+	}
+
+	inline u32 cull_spheres_avx2(const Frustum& frustum, const Vec3_Soa_View centers, const f32* radii, const u32 count, u32* out_visible)
+	{
+		Frustum_Avx2 wide = splat_frustum_avx2(frustum);
+		u32 count_visible = 0;
+		u32 i = 0;
+		for (; i + g_simd_width <= count; i += g_simd_width)
+		{
+			Vec3x8 c = load_x8(centers, i);
+			__m256 min_distance = get_plane_distance_avx2(wide, 0, c);
+			for (u32 p = 1; p < 6; ++p)
+				min_distance = _mm256_min_ps(min_distance, get_plane_distance_avx2(wide, p, c));
+			__m256 neg_radius = _mm256_xor_ps(_mm256_loadu_ps(radii + i), _mm256_set1_ps(-0.f));
+			count_visible += store_visible_avx2(_mm256_cmp_ps(min_distance, neg_radius, _CMP_GE_OQ), i, out_visible + count_visible);
+		}
+		u32* tail = out_visible + count_visible;
+		return count_visible + rebase_indices(tail, cull_spheres_scalar(frustum, offset_view(centers, i), radii + i, count - i, tail), i);
+	}
+
+	inline u32 cull_aabbs_avx2(const Frustum& frustum, const Vec3_Soa_View centers, const Vec3_Soa_View extents, const u32 count, u32* out_visible)
+	{
+		Frustum_Avx2 wide = splat_frustum_avx2(frustum);
+		u32 count_visible = 0;
+		u32 i = 0;
+		for (; i + g_simd_width <= count; i += g_simd_width)
+		{
+			Vec3x8 c = load_x8(centers, i), e = load_x8(extents, i);
+			__m256 min_distance = _mm256_set1_ps(HUGE_VALF);
+			for (u32 p = 0; p < 6; ++p)
+			{
+				__m256 radius = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(wide.abs_x[p], e.x), _mm256_mul_ps(wide.abs_y[p], e.y)),
+				                              _mm256_mul_ps(wide.abs_z[p], e.z));
+				min_distance = _mm256_min_ps(min_distance, _mm256_add_ps(get_plane_distance_avx2(wide, p, c), radius));
+			}
+			count_visible += store_visible_avx2(_mm256_cmp_ps(min_distance, _mm256_setzero_ps(), _CMP_GE_OQ), i, out_visible + count_visible);
+		}
+		u32* tail = out_visible + count_visible;
+		return count_visible + rebase_indices(tail, cull_aabbs_scalar(frustum, offset_view(centers, i), offset_view(extents, i), count - i, tail), i);
+	}
+}
+
+LIB_TARGET_AVX2_END
+
+// ===============================================================================================================================
+// ======================================================= AVX-512 ===============================================================
+// ===============================================================================================================================
+
+LIB_TARGET_AVX512_BEGIN
+
+namespace lib
+{
+	inline constexpr u32 g_simd_width_avx512 = 16;
+
+	//? Lanes of last, partial group of 16
+	inline __mmask16 get_tail_mask_avx512(const u32 count_left)
+	{
+		return (__mmask16)((1u << count_left) - 1);
+	}
+
+	inline void transform_points_avx512(const Mat4& a, const Vec3_Soa_View in, const Vec3_Soa_View out, const u32 count)
+	{
+		__m512 m[4][3];
+		for (u32 column = 0; column < 4; ++column)
+		{
+			for (u32 row = 0; row < 3; ++row)
+				m[column][row] = _mm512_set1_ps(a.e[column][row]);
+		}
+
+		f32* rows_out[3] = { out.x, out.y, out.z };
+		for (u32 i = 0; i < count; i += g_simd_width_avx512)
+		{
+			__mmask16 mask = (count - i >= g_simd_width_avx512) ? (__mmask16)0xffff : get_tail_mask_avx512(count - i);
+			__m512 x = _mm512_maskz_loadu_ps(mask, in.x + i), y = _mm512_maskz_loadu_ps(mask, in.y + i), z = _mm512_maskz_loadu_ps(mask, in.z + i);
+			for (u32 row = 0; row < 3; ++row)
+			{
+				__m512 sum = _mm512_fmadd_ps(m[0][row], x, _mm512_fmadd_ps(m[1][row], y, _mm512_fmadd_ps(m[2][row], z, m[3][row])));
+				_mm512_mask_storeu_ps(rows_out[row] + i, mask, sum);
+			}
+		}
+	}
+
+	inline void transform_vectors_avx512(const Mat4& a, const Vec3_Soa_View in, const Vec3_Soa_View out, const u32 count)
+	{
+		__m512 m[3][3];
+		for (u32 column = 0; column < 3; ++column)
+		{
+			for (u32 row = 0; row < 3; ++row)
+				m[column][row] = _mm512_set1_ps(a.e[column][row]);
+		}
+
+		f32* rows_out[3] = { out.x, out.y, out.z };
+		for (u32 i = 0; i < count; i += g_simd_width_avx512)
+		{
+			__mmask16 mask = (count - i >= g_simd_width_avx512) ? (__mmask16)0xffff : get_tail_mask_avx512(count - i);
+			__m512 x = _mm512_maskz_loadu_ps(mask, in.x + i), y = _mm512_maskz_loadu_ps(mask, in.y + i), z = _mm512_maskz_loadu_ps(mask, in.z + i);
+			for (u32 row = 0; row < 3; ++row)
+			{
+				__m512 sum = _mm512_fmadd_ps(m[0][row], x, _mm512_fmadd_ps(m[1][row], y, _mm512_mul_ps(m[2][row], z)));
+				_mm512_mask_storeu_ps(rows_out[row] + i, mask, sum);
+			}
+		}
+	}
+
+	inline void transform_vec4s_avx512(const Mat4& a, const Vec4_Soa_View in, const Vec4_Soa_View out, const u32 count)
+	{
+		__m512 m[4][4];
+		for (u32 column = 0; column < 4; ++column)
+		{
+			for (u32 row = 0; row < 4; ++row)
+				m[column][row] = _mm512_set1_ps(a.e[column][row]);
+		}
+
+		f32* rows_out[4] = { out.x, out.y, out.z, out.w };
+		for (u32 i = 0; i < count; i += g_simd_width_avx512)
+		{
+			__mmask16 mask = (count - i >= g_simd_width_avx512) ? (__mmask16)0xffff : get_tail_mask_avx512(count - i);
+			__m512 x = _mm512_maskz_loadu_ps(mask, in.x + i), y = _mm512_maskz_loadu_ps(mask, in.y + i);
+			__m512 z = _mm512_maskz_loadu_ps(mask, in.z + i), w = _mm512_maskz_loadu_ps(mask, in.w + i);
+			for (u32 row = 0; row < 4; ++row)
+			{
+				__m512 sum = _mm512_mul_ps(m[0][row], x);
+				sum = _mm512_fmadd_ps(m[1][row], y, sum);
+				sum = _mm512_fmadd_ps(m[2][row], z, sum);
+				_mm512_mask_storeu_ps(rows_out[row] + i, mask, _mm512_fmadd_ps(m[3][row], w, sum));
+			}
+		}
+	}
+
+	inline void multiply_matrices_avx512(const Mat4& a, const Mat4_Soa_View& in, const Mat4_Soa_View& out, const u32 count)
+	{
+		__m512 m[4][4];
+		for (u32 column = 0; column < 4; ++column)
+		{
+			for (u32 row = 0; row < 4; ++row)
+				m[column][row] = _mm512_set1_ps(a.e[column][row]);
+		}
+
+		for (u32 i = 0; i < count; i += g_simd_width_avx512)
+		{
+			__mmask16 mask = (count - i >= g_simd_width_avx512) ? (__mmask16)0xffff : get_tail_mask_avx512(count - i);
+			for (u32 column = 0; column < 4; ++column)
+			{
+				__m512 b0 = _mm512_maskz_loadu_ps(mask, in.e[column][0] + i);
+				__m512 b1 = _mm512_maskz_loadu_ps(mask, in.e[column][1] + i);
+				__m512 b2 = _mm512_maskz_loadu_ps(mask, in.e[column][2] + i);
+				__m512 b3 = _mm512_maskz_loadu_ps(mask, in.e[column][3] + i);
+				for (u32 row = 0; row < 4; ++row)
+				{
+					__m512 sum = _mm512_mul_ps(m[0][row], b0);
+					sum = _mm512_fmadd_ps(m[1][row], b1, sum);
+					sum = _mm512_fmadd_ps(m[2][row], b2, sum);
+					_mm512_mask_storeu_ps(out.e[column][row] + i, mask, _mm512_fmadd_ps(m[3][row], b3, sum));
+				}
+			}
+		}
+	}
+
+	inline void normalize_vectors_avx512(const Vec3_Soa_View in, const Vec3_Soa_View out, const u32 count)
+	{
+		for (u32 i = 0; i < count; i += g_simd_width_avx512)
+		{
+			__mmask16 mask = (count - i >= g_simd_width_avx512) ? (__mmask16)0xffff : get_tail_mask_avx512(count - i);
+			__m512 x = _mm512_maskz_loadu_ps(mask, in.x + i), y = _mm512_maskz_loadu_ps(mask, in.y + i), z = _mm512_maskz_loadu_ps(mask, in.z + i);
+			__m512 length_squared = _mm512_fmadd_ps(z, z, _mm512_fmadd_ps(y, y, _mm512_mul_ps(x, x)));
+			__mmask16 is_non_zero = _mm512_cmp_ps_mask(length_squared, _mm512_setzero_ps(), _CMP_GT_OQ);
+			__m512 multi = _mm512_maskz_div_ps(is_non_zero, _mm512_set1_ps(1.0f), _mm512_sqrt_ps(length_squared));
+			_mm512_mask_storeu_ps(out.x + i, mask, _mm512_mul_ps(x, multi));
+			_mm512_mask_storeu_ps(out.y + i, mask, _mm512_mul_ps(y, multi));
+			_mm512_mask_storeu_ps(out.z + i, mask, _mm512_mul_ps(z, multi));
+		}
+	}
+
+	inline f32 reduce_min_avx512(__m512 a)
+	{
+		a = _mm512_min_ps(a, _mm512_shuffle_f32x4(a, a, _MM_SHUFFLE(1, 0, 3, 2)));
+		a = _mm512_min_ps(a, _mm512_shuffle_f32x4(a, a, _MM_SHUFFLE(2, 3, 0, 1)));
+		return reduce_min_sse41(_mm512_castps512_ps128(a));
+	}
+
+	inline f32 reduce_max_avx512(__m512 a)
+	{
+		a = _mm512_max_ps(a, _mm512_shuffle_f32x4(a, a, _MM_SHUFFLE(1, 0, 3, 2)));
+		a = _mm512_max_ps(a, _mm512_shuffle_f32x4(a, a, _MM_SHUFFLE(2, 3, 0, 1)));
+		return reduce_max_sse41(_mm512_castps512_ps128(a));
+	}
+
+	inline void find_min_max_avx512(const Vec3_Soa_View in, const u32 count, Vec3* out_min, Vec3* out_max)
+	{
+		__m512 min_x = _mm512_set1_ps(HUGE_VALF), min_y = min_x, min_z = min_x;
+		__m512 max_x = _mm512_set1_ps(-HUGE_VALF), max_y = max_x, max_z = max_x;
+		for (u32 i = 0; i < count; i += g_simd_width_avx512)
+		{
+			// Lanes past the end keep previous min/max
+			__mmask16 mask = (count - i >= g_simd_width_avx512) ? (__mmask16)0xffff : get_tail_mask_avx512(count - i);
+			__m512 x = _mm512_maskz_loadu_ps(mask, in.x + i), y = _mm512_maskz_loadu_ps(mask, in.y + i), z = _mm512_maskz_loadu_ps(mask, in.z + i);
+			min_x = _mm512_mask_min_ps(min_x, mask, min_x, x); min_y = _mm512_mask_min_ps(min_y, mask, min_y, y); min_z = _mm512_mask_min_ps(min_z, mask, min_z, z);
+			max_x = _mm512_mask_max_ps(max_x, mask, max_x, x); max_y = _mm512_mask_max_ps(max_y, mask, max_y, y); max_z = _mm512_mask_max_ps(max_z, mask, max_z, z);
+		}
+		*out_min = { reduce_min_avx512(min_x), reduce_min_avx512(min_y), reduce_min_avx512(min_z) };
+		*out_max = { reduce_max_avx512(max_x), reduce_max_avx512(max_y), reduce_max_avx512(max_z) };
+	}
+
+	//? Compress store writes only visible lanes, tail is masked as in other AVX-512 kernels
+	inline u32 cull_spheres_avx512(const Frustum& frustum, const Vec3_Soa_View centers, const f32* radii, const u32 count, u32* out_visible)
+	{
+		__m512 normal_x[6], normal_y[6], normal_z[6], distance[6];
+		for (u32 p = 0; p < 6; ++p)
+		{
+			normal_x[p] = _mm512_set1_ps(frustum.planes[p].x); normal_y[p] = _mm512_set1_ps(frustum.planes[p].y);
+			normal_z[p] = _mm512_set1_ps(frustum.planes[p].z); distance[p] = _mm512_set1_ps(frustum.planes[p].w);
+		}
+
+		const __m512i lanes = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+		u32 count_visible = 0;
+		for (u32 i = 0; i < count; i += g_simd_width_avx512)
+		{
+			__mmask16 mask = (count - i >= g_simd_width_avx512) ? (__mmask16)0xffff : get_tail_mask_avx512(count - i);
+			__m512 x = _mm512_maskz_loadu_ps(mask, centers.x + i), y = _mm512_maskz_loadu_ps(mask, centers.y + i), z = _mm512_maskz_loadu_ps(mask, centers.z + i);
+			__m512 min_distance = _mm512_set1_ps(HUGE_VALF);
+			for (u32 p = 0; p < 6; ++p)
+			{
+				__m512 plane_distance = _mm512_add_ps(_mm512_add_ps(_mm512_add_ps(_mm512_mul_ps(normal_x[p], x), _mm512_mul_ps(normal_y[p], y)),
+				                                                    _mm512_mul_ps(normal_z[p], z)), distance[p]);
+				min_distance = _mm512_min_ps(min_distance, plane_distance);
+			}
+			__m512 neg_radius = _mm512_sub_ps(_mm512_setzero_ps(), _mm512_maskz_loadu_ps(mask, radii + i));
+			__mmask16 is_visible = _mm512_mask_cmp_ps_mask(mask, min_distance, neg_radius, _CMP_GE_OQ);
+			_mm512_mask_compressstoreu_epi32(out_visible + count_visible, is_visible, _mm512_add_epi32(lanes, _mm512_set1_epi32((s32)i)));
+			count_visible += count_bits_u64(is_visible);
+		}
+		return count_visible;
+	}
+
+	inline u32 cull_aabbs_avx512(const Frustum& frustum, const Vec3_Soa_View centers, const Vec3_Soa_View extents, const u32 count, u32* out_visible)
+	{
+		__m512 normal_x[6], normal_y[6], normal_z[6], distance[6], abs_x[6], abs_y[6], abs_z[6];
+		for (u32 p = 0; p < 6; ++p)
+		{
+			const Vec4& plane = frustum.planes[p];
+			normal_x[p] = _mm512_set1_ps(plane.x); normal_y[p] = _mm512_set1_ps(plane.y); normal_z[p] = _mm512_set1_ps(plane.z);
+			distance[p] = _mm512_set1_ps(plane.w);
+			abs_x[p] = _mm512_set1_ps(fabsf(plane.x)); abs_y[p] = _mm512_set1_ps(fabsf(plane.y)); abs_z[p] = _mm512_set1_ps(fabsf(plane.z));
+		}
+
+		const __m512i lanes = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+		u32 count_visible = 0;
+		for (u32 i = 0; i < count; i += g_simd_width_avx512)
+		{
+			__mmask16 mask = (count - i >= g_simd_width_avx512) ? (__mmask16)0xffff : get_tail_mask_avx512(count - i);
+			__m512 x = _mm512_maskz_loadu_ps(mask, centers.x + i), y = _mm512_maskz_loadu_ps(mask, centers.y + i), z = _mm512_maskz_loadu_ps(mask, centers.z + i);
+			__m512 ex = _mm512_maskz_loadu_ps(mask, extents.x + i), ey = _mm512_maskz_loadu_ps(mask, extents.y + i), ez = _mm512_maskz_loadu_ps(mask, extents.z + i);
+			__m512 min_distance = _mm512_set1_ps(HUGE_VALF);
+			for (u32 p = 0; p < 6; ++p)
+			{
+				__m512 plane_distance = _mm512_add_ps(_mm512_add_ps(_mm512_add_ps(_mm512_mul_ps(normal_x[p], x), _mm512_mul_ps(normal_y[p], y)),
+				                                                    _mm512_mul_ps(normal_z[p], z)), distance[p]);
+				__m512 radius = _mm512_add_ps(_mm512_add_ps(_mm512_mul_ps(abs_x[p], ex), _mm512_mul_ps(abs_y[p], ey)), _mm512_mul_ps(abs_z[p], ez));
+				min_distance = _mm512_min_ps(min_distance, _mm512_add_ps(plane_distance, radius));
+			}
+			__mmask16 is_visible = _mm512_mask_cmp_ps_mask(mask, min_distance, _mm512_setzero_ps(), _CMP_GE_OQ);
+			_mm512_mask_compressstoreu_epi32(out_visible + count_visible, is_visible, _mm512_add_epi32(lanes, _mm512_set1_epi32((s32)i)));
+			count_visible += count_bits_u64(is_visible);
+		}
+		return count_visible;
+	}
+}
+
+LIB_TARGET_AVX512_END
+
+// ===============================================================================================================================
+// ======================================================= DISPATCH ==============================================================
+// ===============================================================================================================================
+
+namespace lib
+{
+	struct Math_Kernels
+	{
+		Simd_Level level;
+		void (*transform_points)(const Mat4& a, const Vec3_Soa_View in, const Vec3_Soa_View out, const u32 count);
+		void (*transform_vectors)(const Mat4& a, const Vec3_Soa_View in, const Vec3_Soa_View out, const u32 count);
+		void (*transform_vec4s)(const Mat4& a, const Vec4_Soa_View in, const Vec4_Soa_View out, const u32 count);
+		void (*multiply_matrices)(const Mat4& a, const Mat4_Soa_View& in, const Mat4_Soa_View& out, const u32 count);
+		void (*normalize_vectors)(const Vec3_Soa_View in, const Vec3_Soa_View out, const u32 count);
+		void (*find_min_max)(const Vec3_Soa_View in, const u32 count, Vec3* out_min, Vec3* out_max);
+		void (*nlerp_quats)(const Vec4_Soa_View a, const Vec4_Soa_View b, const f32* t, const Vec4_Soa_View out, const u32 count);
+		void (*slerp_quats)(const Vec4_Soa_View a, const Vec4_Soa_View b, const f32* t, const Vec4_Soa_View out, const u32 count);
+		u32 (*cull_spheres)(const Frustum& frustum, const Vec3_Soa_View centers, const f32* radii, const u32 count, u32* out_visible);
+		u32 (*cull_aabbs)(const Frustum& frustum, const Vec3_Soa_View centers, const Vec3_Soa_View extents, const u32 count, u32* out_visible);
+	};
+
+	//? Level has to be supported by this CPU (is_simd_level_supported)
+	[[nodiscard]]
+	inline Math_Kernels get_math_kernels_for(const Simd_Level level)
+	{
+		// AVX-512 level reuses AVX2 quaternion blends
+		switch (level)
+		{
+			case Simd_Level::avx512:
+				return { level, &transform_points_avx512, &transform_vectors_avx512, &transform_vec4s_avx512,
+				         &multiply_matrices_avx512, &normalize_vectors_avx512, &find_min_max_avx512,
+				         &nlerp_quats_avx2, &slerp_quats_avx2,
+				         &cull_spheres_avx512, &cull_aabbs_avx512 };
+			case Simd_Level::avx2:
+				return { level, &transform_points_avx2, &transform_vectors_avx2, &transform_vec4s_avx2,
+				         &multiply_matrices_avx2, &normalize_vectors_avx2, &find_min_max_avx2,
+				         &nlerp_quats_avx2, &slerp_quats_avx2,
+				         &cull_spheres_avx2, &cull_aabbs_avx2 };
+			case Simd_Level::sse41:
+				return { level, &transform_points_sse41, &transform_vectors_sse41, &transform_vec4s_sse41,
+				         &multiply_matrices_sse41, &normalize_vectors_sse41, &find_min_max_sse41,
+				         &nlerp_quats_sse41, &slerp_quats_sse41,
+				         &cull_spheres_sse41, &cull_aabbs_sse41 };
+			default:
+				return { Simd_Level::scalar, &transform_points_scalar, &transform_vectors_scalar, &transform_vec4s_scalar,
+				         &multiply_matrices_scalar, &normalize_vectors_scalar, &find_min_max_scalar,
+				         &nlerp_quats_scalar, &slerp_quats_scalar,
+				         &cull_spheres_scalar, &cull_aabbs_scalar };
+		}
+	}
+
+	//? Widest level "find_min_max" is dispatched to: the reduction is memory bound, 512 bit registers give it nothing
+	//? and it measured slower than AVX2 where they lower the clock ("bench simd_dispatch")
+	inline constexpr Simd_Level g_find_min_max_max_level = Simd_Level::avx2;
+
+	//? Variants of "best_level", except kernels capped to lower level because wider variant is not faster
+	[[nodiscard]]
+	inline Math_Kernels get_dispatched_math_kernels(const Simd_Level best_level)
+	{
+		Math_Kernels out = get_math_kernels_for(best_level);
+		if (best_level > g_find_min_max_max_level)
+			out.find_min_max = get_math_kernels_for(g_find_min_max_max_level).find_min_max;
+		return out;
+	}
+
+	//? Best variants for this CPU, picked on first call
+	[[nodiscard]]
+	inline const Math_Kernels& get_math_kernels()
+	{
+		static const Math_Kernels kernels = get_dispatched_math_kernels(get_cpu_features().best_level);
+		return kernels;
+	}
+
+	inline void transform_points(const Mat4& a, const Vec3_Soa_View in, const Vec3_Soa_View out, const u32 count)
+	{
+		get_math_kernels().transform_points(a, in, out, count);
+	}
+
+	inline void transform_vectors(const Mat4& a, const Vec3_Soa_View in, const Vec3_Soa_View out, const u32 count)
+	{
+		get_math_kernels().transform_vectors(a, in, out, count);
+	}
+
+	inline void transform_vec4s(const Mat4& a, const Vec4_Soa_View in, const Vec4_Soa_View out, const u32 count)
+	{
+		get_math_kernels().transform_vec4s(a, in, out, count);
+	}
+
+	inline void multiply_matrices(const Mat4& a, const Mat4_Soa_View& in, const Mat4_Soa_View& out, const u32 count)
+	{
+		get_math_kernels().multiply_matrices(a, in, out, count);
+	}
+
+	inline void normalize_vectors(const Vec3_Soa_View in, const Vec3_Soa_View out, const u32 count)
+	{
+		get_math_kernels().normalize_vectors(in, out, count);
+	}
+
+	inline void find_min_max(const Vec3_Soa_View in, const u32 count, Vec3* out_min, Vec3* out_max)
+	{
+		get_math_kernels().find_min_max(in, count, out_min, out_max);
+	}
+
+	inline void nlerp_quats(const Vec4_Soa_View a, const Vec4_Soa_View b, const f32* t, const Vec4_Soa_View out, const u32 count)
+	{
+		get_math_kernels().nlerp_quats(a, b, t, out, count);
+	}
+
+	inline void slerp_quats(const Vec4_Soa_View a, const Vec4_Soa_View b, const f32* t, const Vec4_Soa_View out, const u32 count)
+	{
+		get_math_kernels().slerp_quats(a, b, t, out, count);
+	}
+
+	inline u32 cull_spheres(const Frustum& frustum, const Vec3_Soa_View centers, const f32* radii, const u32 count, u32* out_visible)
+	{
+		return get_math_kernels().cull_spheres(frustum, centers, radii, count, out_visible);
+	}
+
+	inline u32 cull_aabbs(const Frustum& frustum, const Vec3_Soa_View centers, const Vec3_Soa_View extents, const u32 count, u32* out_visible)
+	{
+		return get_math_kernels().cull_aabbs(frustum, centers, extents, count, out_visible);
+	}
+}
@@ -0,0 +1,277 @@
+#pragma once
+#include <immintrin.h>
+
+#include "Utils.hpp"
+#include "Cpu_Features.hpp"
+#include "Math.hpp"
+
+//? 8 wide SoA counterparts of Vec3/Vec4/Mat4 on AVX2 + FMA: every component holds same component of 8 different
+//? vectors, so one instruction does what 8 scalar (or 2 Vec4) operations would. Views over SoA streams (separate x/y/z
+//? arrays, e.g. from Soa_Array or culling data) need no alignment. Everything here is compiled for AVX2 target, call it
+//? only from AVX2 code paths - batch kernels in Math_Kernels.hpp pick those at runtime
+
+LIB_TARGET_AVX2_BEGIN
+
+namespace lib
+{
+	inline constexpr u32 g_simd_width = 8;
+
+	struct Vec3x8
+	{
+		__m256 x, y, z;
+	};
+
+	struct Vec4x8
+	{
+		__m256 x, y, z, w;
+	};
+
+	//? Column major as Mat4, e[column][row]
+	struct Mat4x8
+	{
+		__m256 e[4][4];
+	};
+
+	// ===============================================================================================================================
+	// ======================================================= VEC3x8 ================================================================
+	// ===============================================================================================================================
+
+	inline Vec3x8 splat(const Vec3 a)
+	{
+		return { _mm256_set1_ps(a.x), _mm256_set1_ps(a.y), _mm256_set1_ps(a.z) };
+	}
+
+	inline Vec3x8 operator+(const Vec3x8 a, const Vec3x8 b)
+	{
+		return { _mm256_add_ps(a.x, b.x), _mm256_add_ps(a.y, b.y), _mm256_add_ps(a.z, b.z) };
+	}
+
+	inline Vec3x8 operator-(const Vec3x8 a, const Vec3x8 b)
+	{
+		return { _mm256_sub_ps(a.x, b.x), _mm256_sub_ps(a.y, b.y), _mm256_sub_ps(a.z, b.z) };
+	}
+
+	inline Vec3x8 operator*(const Vec3x8 a, const Vec3x8 b)
+	{
+		return { _mm256_mul_ps(a.x, b.x), _mm256_mul_ps(a.y, b.y), _mm256_mul_ps(a.z, b.z) };
+	}
+
+	//? Every vector by its own scalar
+	inline Vec3x8 operator*(const __m256 t, const Vec3x8 b)
+	{
+		return { _mm256_mul_ps(t, b.x), _mm256_mul_ps(t, b.y), _mm256_mul_ps(t, b.z) };
+	}
+
+	inline Vec3x8 operator*(const f32 t, const Vec3x8 b)
+	{
+		return _mm256_set1_ps(t) * b;
+	}
+
+	inline __m256 dot(const Vec3x8 a, const Vec3x8 b)
+	{
+		__m256 out = _mm256_mul_ps(a.x, b.x);
+		out = _mm256_fmadd_ps(a.y, b.y, out);
+		return _mm256_fmadd_ps(a.z, b.z, out);
+	}
+
+	inline __m256 length_squared_vec(const Vec3x8 a)
+	{
+		return dot(a, a);
+	}
+
+	inline __m256 length_vec(const Vec3x8 a)
+	{
+		return _mm256_sqrt_ps(dot(a, a));
+	}
+
+	inline Vec3x8 cross(const Vec3x8 a, const Vec3x8 b)
+	{
+		return { _mm256_fmsub_ps(a.y, b.z, _mm256_mul_ps(a.z, b.y)),
+		         _mm256_fmsub_ps(a.z, b.x, _mm256_mul_ps(a.x, b.z)),
+		         _mm256_fmsub_ps(a.x, b.y, _mm256_mul_ps(a.y, b.x)) };
+	}
+
+	//? Zero length vectors stay zero, as in scalar normalize
+	inline Vec3x8 normalize(const Vec3x8 a)
+	{
+		__m256 length_squared = dot(a, a);
+		__m256 is_non_zero = _mm256_cmp_ps(length_squared, _mm256_setzero_ps(), _CMP_GT_OQ);
+		__m256 multi = _mm256_and_ps(_mm256_div_ps(_mm256_set1_ps(1.0f), _mm256_sqrt_ps(length_squared)), is_non_zero);
+		return multi * a;
+	}
+
+	//? ~12 bits of precision, zero length gives inf/nan
+	inline Vec3x8 normalize_fast(const Vec3x8 a)
+	{
+		return _mm256_rsqrt_ps(dot(a, a)) * a;
+	}
+
+	// ===============================================================================================================================
+	// ======================================================= VEC4x8 ================================================================
+	// ===============================================================================================================================
+
+	inline Vec4x8 splat(const Vec4 a)
+	{
+		return { _mm256_set1_ps(a.x), _mm256_set1_ps(a.y), _mm256_set1_ps(a.z), _mm256_set1_ps(a.w) };
+	}
+
+	inline Vec4x8 operator+(const Vec4x8 a, const Vec4x8 b)
+	{
+		return { _mm256_add_ps(a.x, b.x), _mm256_add_ps(a.y, b.y), _mm256_add_ps(a.z, b.z), _mm256_add_ps(a.w, b.w) };
+	}
+
+	inline Vec4x8 operator-(const Vec4x8 a, const Vec4x8 b)
+	{
+		return { _mm256_sub_ps(a.x, b.x), _mm256_sub_ps(a.y, b.y), _mm256_sub_ps(a.z, b.z), _mm256_sub_ps(a.w, b.w) };
+	}
+
+	inline Vec4x8 operator*(const Vec4x8 a, const Vec4x8 b)
+	{
+		return { _mm256_mul_ps(a.x, b.x), _mm256_mul_ps(a.y, b.y), _mm256_mul_ps(a.z, b.z), _mm256_mul_ps(a.w, b.w) };
+	}
+
+	inline Vec4x8 operator*(const __m256 t, const Vec4x8 b)
+	{
+		return { _mm256_mul_ps(t, b.x), _mm256_mul_ps(t, b.y), _mm256_mul_ps(t, b.z), _mm256_mul_ps(t, b.w) };
+	}
+
+	inline Vec4x8 operator*(const f32 t, const Vec4x8 b)
+	{
+		return _mm256_set1_ps(t) * b;
+	}
+
+	inline __m256 dot(const Vec4x8 a, const Vec4x8 b)
+	{
+		__m256 out = _mm256_mul_ps(a.x, b.x);
+		out = _mm256_fmadd_ps(a.y, b.y, out);
+		out = _mm256_fmadd_ps(a.z, b.z, out);
+		return _mm256_fmadd_ps(a.w, b.w, out);
+	}
+
+	inline __m256 length_vec(const Vec4x8 a)
+	{
+		return _mm256_sqrt_ps(dot(a, a));
+	}
+
+	inline Vec4x8 normalize(const Vec4x8 a)
+	{
+		__m256 length_squared = dot(a, a);
+		__m256 is_non_zero = _mm256_cmp_ps(length_squared, _mm256_setzero_ps(), _CMP_GT_OQ);
+		__m256 multi = _mm256_and_ps(_mm256_div_ps(_mm256_set1_ps(1.0f), _mm256_sqrt_ps(length_squared)), is_non_zero);
+		return multi * a;
+	}
+
+	// ===============================================================================================================================
+	// ======================================================= MAT4x8 ================================================================
+	// ===============================================================================================================================
+
+	inline Mat4x8 splat(const Mat4& a)
+	{
+		Mat4x8 out;
+		for (u32 column = 0; column < 4; ++column)
+		{
+			for (u32 row = 0; row < 4; ++row)
+				out.e[column][row] = _mm256_set1_ps(a.e[column][row]);
+		}
+		return out;
+	}
+
+	//? Columns of "a" times components of "b", same as scalar linear_combination
+	inline Vec4x8 operator*(const Mat4x8& a, const Vec4x8 b)
+	{
+		auto row = [&](u32 i)
+		{
+			__m256 sum = _mm256_mul_ps(a.e[0][i], b.x);
+			sum = _mm256_fmadd_ps(a.e[1][i], b.y, sum);
+			sum = _mm256_fmadd_ps(a.e[2][i], b.z, sum);
+			return _mm256_fmadd_ps(a.e[3][i], b.w, sum);
+		};
+		return { row(0), row(1), row(2), row(3) };
+	}
+
+	inline Mat4x8 operator*(const Mat4x8& a, const Mat4x8& b)
+	{
+		Mat4x8 out;
+		for (u32 column = 0; column < 4; ++column)
+		{
+			Vec4x8 result = a * Vec4x8{ b.e[column][0], b.e[column][1], b.e[column][2], b.e[column][3] };
+			out.e[column][0] = result.x;
+			out.e[column][1] = result.y;
+			out.e[column][2] = result.z;
+			out.e[column][3] = result.w;
+		}
+		return out;
+	}
+
+	// ===============================================================================================================================
+	// ======================================================= SOA STREAMS ===========================================================
+	// ===============================================================================================================================
+
+	struct Vec3_Soa_View
+	{
+		f32* x;
+		f32* y;
+		f32* z;
+	};
+
+	struct Vec4_Soa_View
+	{
+		f32* x;
+		f32* y;
+		f32* z;
+		f32* w;
+	};
+
+	//? One stream per element, e[column][row] as in Mat4
+	struct Mat4_Soa_View
+	{
+		f32* e[4][4];
+	};
+
+	inline Vec3x8 load_x8(const Vec3_Soa_View view, const u32 i)
+	{
+		return { _mm256_loadu_ps(view.x + i), _mm256_loadu_ps(view.y + i), _mm256_loadu_ps(view.z + i) };
+	}
+
+	inline void store_x8(const Vec3_Soa_View view, const u32 i, const Vec3x8 a)
+	{
+		_mm256_storeu_ps(view.x + i, a.x);
+		_mm256_storeu_ps(view.y + i, a.y);
+		_mm256_storeu_ps(view.z + i, a.z);
+	}
+
+	inline Vec4x8 load_x8(const Vec4_Soa_View view, const u32 i)
+	{
+		return { _mm256_loadu_ps(view.x + i), _mm256_loadu_ps(view.y + i), _mm256_loadu_ps(view.z + i), _mm256_loadu_ps(view.w + i) };
+	}
+
+	inline void store_x8(const Vec4_Soa_View view, const u32 i, const Vec4x8 a)
+	{
+		_mm256_storeu_ps(view.x + i, a.x);
+		_mm256_storeu_ps(view.y + i, a.y);
+		_mm256_storeu_ps(view.z + i, a.z);
+		_mm256_storeu_ps(view.w + i, a.w);
+	}
+
+	inline Mat4x8 load_x8(const Mat4_Soa_View& view, const u32 i)
+	{
+		Mat4x8 out;
+		for (u32 column = 0; column < 4; ++column)
+		{
+			for (u32 row = 0; row < 4; ++row)
+				out.e[column][row] = _mm256_loadu_ps(view.e[column][row] + i);
+		}
+		return out;
+	}
+
+	inline void store_x8(const Mat4_Soa_View& view, const u32 i, const Mat4x8& a)
+	{
+		for (u32 column = 0; column < 4; ++column)
+		{
+			for (u32 row = 0; row < 4; ++row)
+				_mm256_storeu_ps(view.e[column][row] + i, a.e[column][row]);
+		}
+	}
+}
+
+LIB_TARGET_AVX2_END
@@ -0,0 +1,402 @@
+#pragma once
+
+#include <cassert>
+#include <cstring>
+
+#include "Utils.hpp"
+#include "Allocators.hpp"
+
+//? TLSF over byte offsets of memory it never touches (GPU heaps, regions of a file): blocks are described by nodes
+//? kept in separate array, so it works on the CPU without any device. Sizes and offsets are multiples of
+//? "min_alignment", size classes are counted in those units with class mapping and search of Alloc_TLSF.
+//? Bigger alignment cuts free block off the front
+
+//? Placement alignments of D3D12 resources in heaps
+enum struct Placement_Class : u8
+{
+	buffer, 				// D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT, also textures bigger than 64 KiB
+	small_texture, 	// D3D12_SMALL_RESOURCE_PLACEMENT_ALIGNMENT, textures up to 64 KiB
+	msaa, 					// D3D12_DEFAULT_MSAA_RESOURCE_PLACEMENT_ALIGNMENT
+};
+
+inline constexpr u64 g_placement_alignments[] = { KiB(64), KiB(4), MiB(4) };
+
+[[nodiscard]]
+constexpr u64 get_placement_alignment(const Placement_Class placement)
+{
+	return g_placement_alignments[(u32)placement];
+}
+
+inline constexpr u32 g_offset_fl_count = 32 - g_tlsf_sl_log2 + 1; // sizes up to 2^32 units
+inline constexpr u32 g_offset_null_node = 0xffffffff;
+
+struct Offset_Node
+{
+	u64 offset;
+	u64 size;
+
+	// Physical neighbours, or for unused node "next_phys" is next unused one
+	u32 prev_phys;
+	u32 next_phys;
+
+	u32 next_free;
+	u32 prev_free;
+	b32 is_free;
+};
+
+//? Result of allocation, "node" is needed to free it. Null when it did not fit
+struct Offset_Allocation
+{
+	u64 offset;
+	u64 size;
+	u32 node = g_offset_null_node;
+};
+
+[[nodiscard]]
+constexpr b32 is_null(const Offset_Allocation allocation)
+{
+	return allocation.node == g_offset_null_node;
+}
+
+struct Alloc_Offset
+{
+	u64 max_size;
+	u32 min_alignment_log2;
+
+	u32 fl_bitmap;
+	u32 sl_bitmaps[g_offset_fl_count];
+	u32 free_heads[g_offset_fl_count][g_tlsf_sl_count];
+
+	Offset_Node *nodes;
+	u32 max_count_nodes;
+	u32 unused_node_head;
+
+	u64 used_bytes;
+	u64 peak_used_bytes;
+	u64 free_bytes;
+	u32 count_allocs;
+	u32 count_free_blocks;
+};
+
+inline void offset_insert_free(Alloc_Offset *alloc, const u32 node_i)
+{
+	Offset_Node *node = &alloc->nodes[node_i];
+	u32 fl, sl;
+	tlsf_mapping_units(node->size >> alloc->min_alignment_log2, &fl, &sl);
+
+	u32 head = alloc->free_heads[fl][sl];
+	node->is_free = true;
+	node->next_free = head;
+	node->prev_free = g_offset_null_node;
+	if (head != g_offset_null_node)
+		alloc->nodes[head].prev_free = node_i;
+	alloc->free_heads[fl][sl] = node_i;
+
+	alloc->fl_bitmap |= 1u << fl;
+	alloc->sl_bitmaps[fl] |= 1u << sl;
+	alloc->free_bytes += node->size;
+	alloc->count_free_blocks += 1;
+}
+
+inline void offset_remove_free(Alloc_Offset *alloc, const u32 node_i)
+{
+	Offset_Node *node = &alloc->nodes[node_i];
+	u32 fl, sl;
+	tlsf_mapping_units(node->size >> alloc->min_alignment_log2, &fl, &sl);
+
+	if (node->prev_free != g_offset_null_node)
+		alloc->nodes[node->prev_free].next_free = node->next_free;
+	else
+		alloc->free_heads[fl][sl] = node->next_free;
+	if (node->next_free != g_offset_null_node)
+		alloc->nodes[node->next_free].prev_free = node->prev_free;
+
+	if (alloc->free_heads[fl][sl] == g_offset_null_node)
+	{
+		alloc->sl_bitmaps[fl] &= ~(1u << sl);
+		if (alloc->sl_bitmaps[fl] == 0)
+			alloc->fl_bitmap &= ~(1u << fl);
+	}
+	node->is_free = false;
+	alloc->free_bytes -= node->size;
+	alloc->count_free_blocks -= 1;
+}
+
+[[nodiscard]]
+inline u32 offset_take_node(Alloc_Offset *alloc)
+{
+	u32 out = alloc->unused_node_head;
+	assert(out != g_offset_null_node && "No more nodes!");
+	alloc->unused_node_head = alloc->nodes[out].next_phys;
+	return out;
+}
+
+inline void offset_return_node(Alloc_Offset *alloc, const u32 node_i)
+{
+	alloc->nodes[node_i].next_phys = alloc->unused_node_head;
+	alloc->unused_node_head = node_i;
+}
+
+//? New physical node after "node_i" with "size" bytes cut off its end
+[[nodiscard]]
+inline u32 offset_split(Alloc_Offset *alloc, const u32 node_i, const u64 size)
+{
+	u32 out = offset_take_node(alloc);
+	Offset_Node *node = &alloc->nodes[node_i];
+	Offset_Node *rest = &alloc->nodes[out];
+
+	node->size -= size;
+	*rest = { .offset = node->offset + node->size, .size = size, .prev_phys = node_i, .next_phys = node->next_phys,
+	          .next_free = g_offset_null_node, .prev_free = g_offset_null_node, .is_free = false };
+	if (rest->next_phys != g_offset_null_node)
+		alloc->nodes[rest->next_phys].prev_phys = out;
+	node->next_phys = out;
+
+	return out;
+}
+
+//? Merges "next_i" into "node_i" and gives its node back
+inline void offset_merge(Alloc_Offset *alloc, const u32 node_i, const u32 next_i)
+{
+	Offset_Node *node = &alloc->nodes[node_i];
+	Offset_Node *next = &alloc->nodes[next_i];
+
+	node->size += next->size;
+	node->next_phys = next->next_phys;
+	if (node->next_phys != g_offset_null_node)
+		alloc->nodes[node->next_phys].prev_phys = node_i;
+	offset_return_node(alloc, next_i);
+}
+
+//? Everything is freed, previous allocations must not be used anymore. Peak of used bytes is kept
+inline void offset_reset(Alloc_Offset *alloc)
+{
+	alloc->fl_bitmap = 0;
+	memset(alloc->sl_bitmaps, 0, sizeof(alloc->sl_bitmaps));
+	memset(alloc->free_heads, 0xff, sizeof(alloc->free_heads)); // g_offset_null_node
+	alloc->used_bytes = 0;
+	alloc->free_bytes = 0;
+	alloc->count_allocs = 0;
+	alloc->count_free_blocks = 0;
+
+	for (u32 i = 0; i < alloc->max_count_nodes; ++i)
+		alloc->nodes[i].next_phys = (i + 1 < alloc->max_count_nodes) ? i + 1 : g_offset_null_node;
+	alloc->unused_node_head = 0;
+
+	u32 first = offset_take_node(alloc);
+	alloc->nodes[first] = { .offset = 0, .size = alloc->max_size, .prev_phys = g_offset_null_node, .next_phys = g_offset_null_node,
+	                        .next_free = g_offset_null_node, .prev_free = g_offset_null_node, .is_free = false };
+	offset_insert_free(alloc, first);
+}
+
+//? Range of "max_size" bytes, at most "max_count_allocs" live allocations. Node array is taken from "allocator",
+//? free blocks are always separated by used ones, so 2 nodes per allocation + 1 are enough
+inline void create_offset_allocator(Alloc_Offset *alloc, auto* allocator, const u64 max_size, const u32 max_count_allocs,
+                                    const u64 min_alignment)
+{
+	assert(min_alignment != 0 && (min_alignment & (min_alignment - 1)) == 0 && "Alignment is not power of 2!");
+	assert(max_size % min_alignment == 0 && "Size is not multiple of alignment!");
+	*alloc = {};
+	alloc->max_size = max_size;
+	alloc->min_alignment_log2 = find_lsb_u64(min_alignment);
+	assert((max_size >> alloc->min_alignment_log2) <= 0xffffffffull && "Size is too big for this alignment!");
+
+	alloc->max_count_nodes = max_count_allocs * 2 + 1;
+	alloc->nodes = (Offset_Node *)allocate(allocator, alloc->max_count_nodes * sizeof(Offset_Node), alignof(Offset_Node));
+	offset_reset(alloc);
+}
+
+//? "alignment" below "min_alignment" is raised to it. Returns null allocation (and asserts) when nothing fits
+[[nodiscard]]
+inline Offset_Allocation allocate_offset(Alloc_Offset *alloc, const u64 size_bytes, const u64 alignment)
+{
+	assert(alignment != 0 && (alignment & (alignment - 1)) == 0 && "Alignment is not power of 2!");
+	u64 min_alignment = 1ull << alloc->min_alignment_log2;
+	u64 size = AlignAddressPow2(size_bytes ? size_bytes : 1, min_alignment);
+	u64 search_size = (alignment > min_alignment) ? size + alignment - min_alignment : size;
+
+	u32 fl, sl;
+	b32 has_class = tlsf_search_class(search_size >> alloc->min_alignment_log2, alloc->fl_bitmap, alloc->sl_bitmaps,
+	                                  g_offset_fl_count, &fl, &sl);
+
+	// Split may need 2 nodes
+	b32 has_nodes = alloc->unused_node_head != g_offset_null_node &&
+	                alloc->nodes[alloc->unused_node_head].next_phys != g_offset_null_node;
+	assert(has_class && "No more memory!");
+	assert(has_nodes && "Too many allocations!");
+	if (!has_class || !has_nodes)
+		return {};
+
+	u32 node_i = alloc->free_heads[fl][sl];
+	offset_remove_free(alloc, node_i);
+
+	u64 offset = alloc->nodes[node_i].offset;
+	u64 aligned = AlignAddressPow2(offset, alignment);
+	if (aligned != offset)
+	{
+		// Front gap stays free, block before it is used (free ones are always merged)
+		u32 front_i = node_i;
+		node_i = offset_split(alloc, front_i, alloc->nodes[front_i].size - (aligned - offset));
+		offset_insert_free(alloc, front_i);
+	}
+
+	if (alloc->nodes[node_i].size > size)
+		offset_insert_free(alloc, offset_split(alloc, node_i, alloc->nodes[node_i].size - size));
+
+	alloc->used_bytes += size;
+	alloc->peak_used_bytes = (alloc->used_bytes > alloc->peak_used_bytes) ? alloc->used_bytes : alloc->peak_used_bytes;
+	alloc->count_allocs += 1;
+
+	return { .offset = aligned, .size = size, .node = node_i };
+}
+
+inline void free_offset(Alloc_Offset *alloc, const Offset_Allocation allocation)
+{
+	if (is_null(allocation))
+		return;
+
+	u32 node_i = allocation.node;
+	assert(node_i < alloc->max_count_nodes && alloc->nodes[node_i].offset == allocation.offset && "Not this allocator allocation!");
+	assert(!alloc->nodes[node_i].is_free && "Double free!");
+
+	alloc->used_bytes -= alloc->nodes[node_i].size;
+	alloc->count_allocs -= 1;
+
+	u32 prev_i = alloc->nodes[node_i].prev_phys;
+	if (prev_i != g_offset_null_node && alloc->nodes[prev_i].is_free)
+	{
+		offset_remove_free(alloc, prev_i);
+		offset_merge(alloc, prev_i, node_i);
+		node_i = prev_i;
+	}
+
+	u32 next_i = alloc->nodes[node_i].next_phys;
+	if (next_i != g_offset_null_node && alloc->nodes[next_i].is_free)
+	{
+		offset_remove_free(alloc, next_i);
+		offset_merge(alloc, node_i, next_i);
+	}
+
+	offset_insert_free(alloc, node_i);
+}
+
+[[nodiscard]]
+inline Tlsf_Stats offset_get_stats(const Alloc_Offset *alloc)
+{
+	Tlsf_Stats out = { .used_bytes = alloc->used_bytes, .peak_used_bytes = alloc->peak_used_bytes, .free_bytes = alloc->free_bytes,
+	                   .largest_free_bytes = 0, .count_allocs = alloc->count_allocs, .count_free_blocks = alloc->count_free_blocks };
+
+	// Biggest block is in highest non empty class, only that list is walked
+	if (alloc->fl_bitmap)
+	{
+		u32 fl = find_msb_u64(alloc->fl_bitmap);
+		u32 sl = find_msb_u64(alloc->sl_bitmaps[fl]);
+		for (u32 at = alloc->free_heads[fl][sl]; at != g_offset_null_node; at = alloc->nodes[at].next_free)
+			out.largest_free_bytes = (alloc->nodes[at].size > out.largest_free_bytes) ? alloc->nodes[at].size : out.largest_free_bytes;
+	}
+
+	return out;
+}
+
+//? Ring of offsets for streaming data (upload heaps): allocations go one after another with wraparound and are
+//? freed in the same order. Everything allocated before "ring_submit" is tagged with fence value and comes back
+//? once "ring_retire" sees that value completed. Offsets "head" & "tail" only grow, position in ring is modulo size
+inline constexpr u32 g_ring_max_count_marks = 64;
+inline constexpr u64 g_ring_full = ~0ull;
+
+struct Ring_Fence_Mark
+{
+	u64 fence_value;
+	u64 end; // "head" at submit
+};
+
+struct Alloc_Ring
+{
+	u64 max_size;
+	u64 head;
+	u64 tail;
+
+	Ring_Fence_Mark marks[g_ring_max_count_marks];
+	u32 first_mark;
+	u32 count_marks;
+};
+
+inline void create_ring(Alloc_Ring *ring, const u64 max_size)
+{
+	*ring = {};
+	ring->max_size = max_size;
+}
+
+//? Bytes not retired yet, both submitted and not
+[[nodiscard]]
+constexpr u64 ring_get_used(const Alloc_Ring *ring)
+{
+	return ring->head - ring->tail;
+}
+
+//? Offset in ring or "g_ring_full" when it does not fit before oldest not retired region.
+//? Allocation never wraps, space left at the end of ring is skipped
+[[nodiscard]]
+inline u64 allocate_ring(Alloc_Ring *ring, const u64 size_bytes, const u64 alignment)
+{
+	assert(alignment != 0 && (alignment & (alignment - 1)) == 0 && "Alignment is not power of 2!");
+	assert(size_bytes <= ring->max_size && "Allocation is bigger than whole ring!");
+
+	u64 position = ring->head % ring->max_size;
+	u64 out = AlignAddressPow2(position, alignment);
+	if (out + size_bytes > ring->max_size)
+		out = 0;
+
+	u64 new_head = ring->head + (out >= position ? out - position : ring->max_size - position + out) + size_bytes;
+	if (new_head - ring->tail > ring->max_size)
+		return g_ring_full;
+
+	ring->head = new_head;
+	return out;
+}
+
+//? All allocations up to now are free to reuse after "fence_value" completes
+inline void ring_submit(Alloc_Ring *ring, const u64 fence_value)
+{
+	if (ring->count_marks > 0)
+	{
+		Ring_Fence_Mark *last = &ring->marks[(ring->first_mark + ring->count_marks - 1) % g_ring_max_count_marks];
+		assert(last->fence_value <= fence_value && "Fence values must grow!");
+
+		// Nothing allocated since last submit, its fence already covers everything
+		if (last->end == ring->head)
+			return;
+
+		// No more marks, later fence covers both
+		if (ring->count_marks == g_ring_max_count_marks)
+		{
+			*last = { .fence_value = fence_value, .end = ring->head };
+			return;
+		}
+	}
+	else if (ring->tail == ring->head)
+	{
+		return;
+	}
+
+	ring->marks[(ring->first_mark + ring->count_marks) % g_ring_max_count_marks] = { .fence_value = fence_value, .end = ring->head };
+	ring->count_marks += 1;
+}
+
+//? Frees regions of all fences up to "completed_fence_value"
+inline void ring_retire(Alloc_Ring *ring, const u64 completed_fence_value)
+{
+	while (ring->count_marks > 0 && ring->marks[ring->first_mark].fence_value <= completed_fence_value)
+	{
+		ring->tail = ring->marks[ring->first_mark].end;
+		ring->first_mark = (ring->first_mark + 1) % g_ring_max_count_marks;
+		ring->count_marks -= 1;
+	}
+}
+
+//? Fence value that has to complete to free anything, 0 when there is nothing submitted
+[[nodiscard]]
+inline u64 ring_get_oldest_fence(const Alloc_Ring *ring)
+{
+	return (ring->count_marks > 0) ? ring->marks[ring->first_mark].fence_value : 0;
+}
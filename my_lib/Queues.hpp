@@ -0,0 +1,277 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <new>
+#include <type_traits>
+
+#include "Utils.hpp"
+
+//? Bounded queues for handing work between threads, memory comes from any allocator in "init" only.
+//? Push & pop never block - they return false (or count moved) when queue is full/empty, waiting policy is up to caller.
+//? Indices are 64 bit and never wrap in practice, elements are copied so they have to be trivially copyable
+
+inline constexpr u64 g_cache_line_size = 64;
+
+[[nodiscard]]
+inline u32 get_queue_capacity(const u32 min_capacity)
+{
+	assert(min_capacity > 1 && min_capacity <= (1u << 31));
+	return 1u << (find_msb_u64(min_capacity - 1) + 1);
+}
+
+// ===============================================================================================================================
+// ======================================================= SPSC RING =============================================================
+// ===============================================================================================================================
+
+//? One producer thread, one consumer thread. Each side owns its index on own cache line and keeps cached copy of other
+//? side index, so shared line is read only when ring looks full (producer) or empty (consumer)
+template<typename T>
+struct Spsc_Ring
+{
+	static_assert(std::is_trivially_copyable_v<T>, "Elements must be trivially copyable!");
+
+	T* data;
+	u64 mask;
+
+	alignas(g_cache_line_size) std::atomic<u64> head; // written by producer
+	u64 cached_tail;
+
+	alignas(g_cache_line_size) std::atomic<u64> tail; // written by consumer
+	u64 cached_head;
+
+	//? Capacity is rounded up to power of 2
+	inline void init(auto* allocator, const u32 min_capacity)
+	{
+		constexpr u64 alignment = (alignof(T) > g_cache_line_size) ? alignof(T) : g_cache_line_size;
+		u32 capacity = get_queue_capacity(min_capacity);
+		data = (T*)allocate(allocator, (u64)capacity * sizeof(T), alignment);
+		mask = capacity - 1;
+		head.store(0, std::memory_order_relaxed);
+		tail.store(0, std::memory_order_relaxed);
+		cached_head = 0;
+		cached_tail = 0;
+	}
+
+	//? Producer only, returns count pushed (0 when full)
+	inline u32 push_batch(const T* elements, const u32 count)
+	{
+		u64 pos = head.load(std::memory_order_relaxed);
+		u64 capacity = mask + 1;
+		if (pos + count - cached_tail > capacity)
+			cached_tail = tail.load(std::memory_order_acquire);
+
+		u64 free_count = capacity - (pos - cached_tail);
+		u32 out = (u32)((count < free_count) ? count : free_count);
+		for (u32 i = 0; i < out; ++i)
+			data[(pos + i) & mask] = elements[i];
+
+		head.store(pos + out, std::memory_order_release);
+		return out;
+	}
+
+	//? Consumer only, returns count popped (0 when empty)
+	inline u32 pop_batch(T* out_elements, const u32 max_count)
+	{
+		u64 pos = tail.load(std::memory_order_relaxed);
+		if (pos + max_count > cached_head)
+			cached_head = head.load(std::memory_order_acquire);
+
+		u64 ready_count = cached_head - pos;
+		u32 out = (u32)((max_count < ready_count) ? max_count : ready_count);
+		for (u32 i = 0; i < out; ++i)
+			out_elements[i] = data[(pos + i) & mask];
+
+		tail.store(pos + out, std::memory_order_release);
+		return out;
+	}
+
+	inline b32 push(const T& element)
+	{
+		return push_batch(&element, 1) == 1;
+	}
+
+	inline b32 pop(T* out_element)
+	{
+		return pop_batch(out_element, 1) == 1;
+	}
+
+	//? Exact only when called from one of both sides while other one is idle
+	[[nodiscard]]
+	inline u64 get_count_approx() const
+	{
+		return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+	}
+};
+
+// ===============================================================================================================================
+// ======================================================= MPMC QUEUE ============================================================
+// ===============================================================================================================================
+
+//? Cell "sequence" tells whose turn it is: equal to position - free for producer of that position, position + 1 - holds
+//? value for consumer of that position, it becomes position + capacity when consumer is done (free for next lap)
+template<typename T>
+struct Mpmc_Cell
+{
+	std::atomic<u64> sequence;
+	T value;
+};
+
+//? Any count of producer and consumer threads (D. Vyukov bounded MPMC). Push & pop is one CAS on shared position and
+//? no CAS on cell, batch claims run of ready cells with one CAS too
+template<typename T>
+struct Mpmc_Queue
+{
+	static_assert(std::is_trivially_copyable_v<T>, "Elements must be trivially copyable!");
+
+	Mpmc_Cell<T>* cells;
+	u64 mask;
+
+	alignas(g_cache_line_size) std::atomic<u64> enqueue_pos;
+	alignas(g_cache_line_size) std::atomic<u64> dequeue_pos;
+	alignas(g_cache_line_size) byte pad; // nothing else shares line with dequeue_pos
+
+	//? Capacity is rounded up to power of 2
+	inline void init(auto* allocator, const u32 min_capacity)
+	{
+		u32 capacity = get_queue_capacity(min_capacity);
+		cells = (Mpmc_Cell<T>*)allocate(allocator, (u64)capacity * sizeof(Mpmc_Cell<T>), g_cache_line_size);
+		mask = capacity - 1;
+		for (u32 i = 0; i < capacity; ++i)
+			new (&cells[i].sequence) std::atomic<u64>(i);
+		enqueue_pos.store(0, std::memory_order_relaxed);
+		dequeue_pos.store(0, std::memory_order_relaxed);
+	}
+
+	inline b32 push(const T& element)
+	{
+		u64 pos = enqueue_pos.load(std::memory_order_relaxed);
+		for (;;)
+		{
+			Mpmc_Cell<T>* cell = &cells[pos & mask];
+			u64 sequence = cell->sequence.load(std::memory_order_acquire);
+			s64 diff = (s64)(sequence - pos);
+			if (diff == 0)
+			{
+				if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				{
+					cell->value = element;
+					cell->sequence.store(pos + 1, std::memory_order_release);
+					return true;
+				}
+			}
+			else if (diff < 0)
+			{
+				return false; // full, cell still holds value from previous lap
+			}
+			else
+			{
+				pos = enqueue_pos.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	inline b32 pop(T* out_element)
+	{
+		u64 pos = dequeue_pos.load(std::memory_order_relaxed);
+		for (;;)
+		{
+			Mpmc_Cell<T>* cell = &cells[pos & mask];
+			u64 sequence = cell->sequence.load(std::memory_order_acquire);
+			s64 diff = (s64)(sequence - (pos + 1));
+			if (diff == 0)
+			{
+				if (dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				{
+					*out_element = cell->value;
+					cell->sequence.store(pos + mask + 1, std::memory_order_release);
+					return true;
+				}
+			}
+			else if (diff < 0)
+			{
+				return false; // empty
+			}
+			else
+			{
+				pos = dequeue_pos.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	//? Returns count pushed, less than "count" when queue got full. Only cells already free are claimed, so it never
+	//? waits for consumer that took cell but did not finish reading it yet
+	inline u32 push_batch(const T* elements, const u32 count)
+	{
+		u64 pos = enqueue_pos.load(std::memory_order_relaxed);
+		for (;;)
+		{
+			u32 count_free = 0;
+			while (count_free < count && cells[(pos + count_free) & mask].sequence.load(std::memory_order_acquire) == pos + count_free)
+				++count_free;
+
+			if (count_free == 0)
+			{
+				s64 diff = (s64)(cells[pos & mask].sequence.load(std::memory_order_acquire) - pos);
+				if (diff < 0)
+					return 0; // full
+				pos = enqueue_pos.load(std::memory_order_relaxed);
+				continue;
+			}
+
+			// Cells seen free can change only by producer of their position, which is this one once CAS succeeds
+			if (enqueue_pos.compare_exchange_weak(pos, pos + count_free, std::memory_order_relaxed))
+			{
+				for (u32 i = 0; i < count_free; ++i)
+				{
+					Mpmc_Cell<T>* cell = &cells[(pos + i) & mask];
+					cell->value = elements[i];
+					cell->sequence.store(pos + i + 1, std::memory_order_release);
+				}
+				return count_free;
+			}
+		}
+	}
+
+	//? Returns count popped, 0 when queue is empty. Only cells already written are claimed, as in "push_batch"
+	inline u32 pop_batch(T* out_elements, const u32 max_count)
+	{
+		u64 pos = dequeue_pos.load(std::memory_order_relaxed);
+		for (;;)
+		{
+			u32 count_ready = 0;
+			while (count_ready < max_count &&
+			       cells[(pos + count_ready) & mask].sequence.load(std::memory_order_acquire) == pos + count_ready + 1)
+				++count_ready;
+
+			if (count_ready == 0)
+			{
+				s64 diff = (s64)(cells[pos & mask].sequence.load(std::memory_order_acquire) - (pos + 1));
+				if (diff < 0)
+					return 0; // empty
+				pos = dequeue_pos.load(std::memory_order_relaxed);
+				continue;
+			}
+
+			if (dequeue_pos.compare_exchange_weak(pos, pos + count_ready, std::memory_order_relaxed))
+			{
+				for (u32 i = 0; i < count_ready; ++i)
+				{
+					Mpmc_Cell<T>* cell = &cells[(pos + i) & mask];
+					out_elements[i] = cell->value;
+					cell->sequence.store(pos + i + mask + 1, std::memory_order_release);
+				}
+				return count_ready;
+			}
+		}
+	}
+
+	//? Snapshot only, other threads may change it right away
+	[[nodiscard]]
+	inline u64 get_count_approx() const
+	{
+		u64 enqueued = enqueue_pos.load(std::memory_order_acquire);
+		u64 dequeued = dequeue_pos.load(std::memory_order_acquire);
+		return (enqueued > dequeued) ? enqueued - dequeued : 0;
+	}
+};
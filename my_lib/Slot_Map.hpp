@@ -0,0 +1,147 @@
+#pragma once
+
+#include <cassert>
+
+#include "Utils.hpp"
+#include "Alloc_Instrumentation.hpp"
+
+//? Generational handle to element of Slot_Map<T>. Generation 0 is never given to live element,
+//? so zero initialized handle is null handle
+template<typename T>
+struct Handle
+{
+	u32 index;
+	u32 generation;
+
+	constexpr bool operator==(const Handle&) const = default;
+};
+
+template<typename T>
+[[nodiscard]]
+constexpr b32 is_null(const Handle<T> handle)
+{
+	return handle.generation == 0;
+}
+
+//? Indirection of one handle index, for free slot "dense_index" is next free slot ("capacity" ends the list)
+struct Slot_Map_Slot
+{
+	u32 dense_index;
+	u32 generation;
+};
+
+//? Fixed capacity slot map: values are kept packed in "data" (iterate it directly, order is not stable),
+//? handles go through "slots" so lookup is O(1) and removed or reused slot is detected by generation.
+//? Arrays are SoA - "data" and "dense_to_slot" (owner slot of every value, needed by erase swap) are separate
+template<typename T>
+struct Slot_Map
+{
+	u32 capacity;
+	u32 count;
+	u32 free_head;
+
+	Slot_Map_Slot* slots;
+	u32* dense_to_slot;
+	T* data;
+
+	inline void init(auto* allocator, const u32 elements ALLOC_SITE_PARAM)
+	{
+		assert(elements > 0 && elements < 0xffffffff);
+		slots = (Slot_Map_Slot*)allocate(allocator, elements * sizeof(Slot_Map_Slot), alignof(Slot_Map_Slot) ALLOC_SITE_ARG);
+		dense_to_slot = (u32*)allocate(allocator, elements * sizeof(u32), alignof(u32) ALLOC_SITE_ARG);
+		data = (T*)allocate(allocator, elements * sizeof(T), alignof(T) ALLOC_SITE_ARG);
+		capacity = elements;
+		reset();
+	}
+
+	//? Removes everything, generations survive so all previously given handles become stale
+	inline void reset()
+	{
+		for (u32 i = 0; i < capacity; ++i)
+		{
+			slots[i].generation = next_generation(slots[i].generation);
+			slots[i].dense_index = i + 1;
+		}
+		free_head = 0;
+		count = 0;
+	}
+
+	[[nodiscard]]
+	inline Handle<T> insert(const T& value)
+	{
+		assert(free_head != capacity && "Slot map is full!");
+		u32 slot_i = free_head;
+		Slot_Map_Slot* slot = &slots[slot_i];
+		free_head = slot->dense_index;
+
+		slot->dense_index = count;
+		dense_to_slot[count] = slot_i;
+		data[count] = value;
+		++count;
+
+		return { slot_i, slot->generation };
+	}
+
+	[[nodiscard]]
+	constexpr b32 is_valid(const Handle<T> handle) const
+	{
+		return handle.index < capacity && handle.generation != 0 && slots[handle.index].generation == handle.generation;
+	}
+
+	//? nullptr for stale handle
+	[[nodiscard]]
+	constexpr T* get(const Handle<T> handle)
+	{
+		return is_valid(handle) ? &data[slots[handle.index].dense_index] : nullptr;
+	}
+
+	[[nodiscard]]
+	constexpr const T* get(const Handle<T> handle) const
+	{
+		return is_valid(handle) ? &data[slots[handle.index].dense_index] : nullptr;
+	}
+
+	//? Last value is moved into place of removed one, stale handle is ignored
+	inline void remove(const Handle<T> handle)
+	{
+		if (!is_valid(handle))
+			return;
+
+		Slot_Map_Slot* slot = &slots[handle.index];
+		u32 last_i = count - 1;
+		data[slot->dense_index] = data[last_i];
+		dense_to_slot[slot->dense_index] = dense_to_slot[last_i];
+		slots[dense_to_slot[last_i]].dense_index = slot->dense_index;
+		--count;
+
+		slot->generation = next_generation(slot->generation);
+		slot->dense_index = free_head;
+		free_head = handle.index;
+	}
+
+	constexpr T* begin()
+	{
+		return data;
+	}
+
+	constexpr const T* begin() const
+	{
+		return data;
+	}
+
+	constexpr T* end()
+	{
+		return data + count;
+	}
+
+	constexpr const T* end() const
+	{
+		return data + count;
+	}
+
+	[[nodiscard]]
+	static constexpr u32 next_generation(const u32 generation)
+	{
+		return (generation + 1 == 0) ? 1 : generation + 1;
+	}
+};
@@ -0,0 +1,231 @@
+#pragma once
+
+#include <cassert>
+#include <cstring>
+#include <type_traits>
+
+#include "Utils.hpp"
+#include "Alloc_Instrumentation.hpp"
+#include "Views.hpp"
+
+//? Struct of arrays generated from member list of AoS record: Soa_Array<&Vertex::position, &Vertex::normal> keeps
+//? every listed member in its own array, so pass over one member streams only its bytes. Arrays are cache line aligned
+//? and capacity is multiple of g_soa_lanes, so SIMD loops can run up to "get_padded_count" without scalar tail
+//? (call "pad_tail" first to zero elements past "count"). Members have to be trivially copyable
+
+inline constexpr u32 g_soa_lanes = 16; // f32 lanes of AVX-512, multiple of narrower widths
+inline constexpr u64 g_soa_alignment = 64;
+
+template<typename T>
+struct Soa_Member;
+
+template<typename Record_T, typename Field_T>
+struct Soa_Member<Field_T Record_T::*>
+{
+	using Record = Record_T;
+	using Field = Field_T;
+};
+
+template<auto member>
+using Soa_Field = typename Soa_Member<decltype(member)>::Field;
+
+template<auto member>
+using Soa_Record = typename Soa_Member<decltype(member)>::Record;
+
+template<auto a, auto b>
+[[nodiscard]]
+constexpr bool is_same_member()
+{
+	if constexpr (std::is_same_v<decltype(a), decltype(b)>)
+		return a == b;
+	else
+		return false;
+}
+
+template<auto first_member, auto... members>
+struct Soa_Array
+{
+	using Record = Soa_Record<first_member>;
+	static constexpr u32 count_fields = 1 + sizeof...(members);
+
+	static_assert((std::is_same_v<Record, Soa_Record<members>> && ...), "All members must be from same record!");
+	static_assert((std::is_trivially_copyable_v<Soa_Field<first_member>> && ... && std::is_trivially_copyable_v<Soa_Field<members>>),
+	              "Members must be trivially copyable!");
+
+	u32 capacity;
+	u32 count;
+	byte* streams[count_fields];
+
+	inline void init(auto* allocator, const u32 elements ALLOC_SITE_PARAM)
+	{
+		assert(elements > 0);
+		capacity = (elements + g_soa_lanes - 1) / g_soa_lanes * g_soa_lanes;
+		count = 0;
+
+		u32 field_i = 0;
+		((streams[field_i++] = (byte*)allocate(allocator, (u64)capacity * sizeof(Soa_Field<first_member>), g_soa_alignment ALLOC_SITE_ARG)), ...,
+		 (streams[field_i++] = (byte*)allocate(allocator, (u64)capacity * sizeof(Soa_Field<members>), g_soa_alignment ALLOC_SITE_ARG)));
+	}
+
+	//? Index of member in "streams"
+	template<auto member>
+	[[nodiscard]]
+	static constexpr u32 get_field_index()
+	{
+		u32 out = count_fields;
+		u32 field_i = 0;
+		((is_same_member<member, first_member>() ? out = field_i : 0, ++field_i), ...,
+		 (is_same_member<member, members>() ? out = field_i : 0, ++field_i));
+		return out;
+	}
+
+	template<auto member>
+	[[nodiscard]]
+	constexpr Soa_Field<member>* field()
+	{
+		static_assert(get_field_index<member>() < count_fields, "Member is not part of this Soa_Array!");
+		return (Soa_Field<member>*)streams[get_field_index<member>()];
+	}
+
+	template<auto member>
+	[[nodiscard]]
+	constexpr const Soa_Field<member>* field() const
+	{
+		static_assert(get_field_index<member>() < count_fields, "Member is not part of this Soa_Array!");
+		return (const Soa_Field<member>*)streams[get_field_index<member>()];
+	}
+
+	//? One member as strided view, as any other vertex stream
+	template<auto member>
+	[[nodiscard]]
+	inline Memory_View get_memory_view()
+	{
+		return { field<member>(), (u64)count * sizeof(Soa_Field<member>), sizeof(Soa_Field<member>) };
+	}
+
+	inline void set_count(const u32 count_to_set)
+	{
+		assert(count_to_set <= capacity);
+		count = count_to_set;
+	}
+
+	//? Count rounded up to SIMD lanes, elements past "count" are valid memory but not data
+	[[nodiscard]]
+	constexpr u32 get_padded_count() const
+	{
+		return (count + g_soa_lanes - 1) / g_soa_lanes * g_soa_lanes;
+	}
+
+	//? Zeroes elements between "count" and "get_padded_count", so whole lanes can be processed and summed
+	inline void pad_tail()
+	{
+		u32 padded_count = get_padded_count();
+		u32 field_i = 0;
+		(memset(streams[field_i++] + (u64)count * sizeof(Soa_Field<first_member>), 0,
+		        (u64)(padded_count - count) * sizeof(Soa_Field<first_member>)), ...,
+		 memset(streams[field_i++] + (u64)count * sizeof(Soa_Field<members>), 0,
+		        (u64)(padded_count - count) * sizeof(Soa_Field<members>)));
+	}
+
+	inline void push(const Record& record)
+	{
+		assert(count < capacity && "Soa_Array is full!");
+		set(count++, record);
+	}
+
+	inline void set(const u32 i, const Record& record)
+	{
+		assert(i < capacity);
+		field<first_member>()[i] = record.*first_member;
+		((field<members>()[i] = record.*members), ...);
+	}
+
+	//? Listed members of "i"-th element, rest of record is zeroed
+	[[nodiscard]]
+	inline Record get(const u32 i) const
+	{
+		assert(i < count);
+		Record out{};
+		out.*first_member = field<first_member>()[i];
+		((out.*members = field<members>()[i]), ...);
+		return out;
+	}
+
+	//? Bulk AoS -> SoA, "src" holds records with any stride (interleaved vertex buffers have bigger one than record).
+	//? One member is copied at time, so every destination array is written sequentially
+	inline void from_aos(const Memory_View src)
+	{
+		assert(src.stride >= sizeof(Record) && "Stride is smaller than record!");
+		u32 count_src = (u32)(src.bytes / src.stride);
+		assert(count_src <= capacity && "Soa_Array is too small!");
+		count = count_src;
+
+		gather_member<first_member>(src);
+		(gather_member<members>(src), ...);
+	}
+
+	//? Bulk SoA -> AoS into "dst" records of any stride, members not listed are left untouched
+	inline void to_aos(Memory_View dst) const
+	{
+		assert(dst.stride >= sizeof(Record) && "Stride is smaller than record!");
+		assert(count <= dst.bytes / dst.stride && "Destination is too small!");
+
+		scatter_member<first_member>(dst);
+		(scatter_member<members>(dst), ...);
+	}
+
+	//? One member from stream of "element_bytes" sized values with any stride (e.g. gltf accessor). When source values
+	//? are smaller than member (Vec3 into Vec4) rest of member is zeroed
+	template<auto member>
+	inline void from_stream(const Memory_View src, const u32 element_bytes = sizeof(Soa_Field<member>))
+	{
+		assert(element_bytes <= sizeof(Soa_Field<member>) && element_bytes <= src.stride);
+		assert(count <= src.bytes / src.stride && "Source stream is too short!");
+
+		byte* dst = (byte*)field<member>();
+		const byte* at = (const byte*)src.data;
+		if (element_bytes == sizeof(Soa_Field<member>) && src.stride == element_bytes)
+		{
+			memcpy(dst, at, (u64)count * element_bytes);
+			return;
+		}
+
+		for (u32 i = 0; i < count; ++i, at += src.stride, dst += sizeof(Soa_Field<member>))
+		{
+			Soa_Field<member> value{};
+			memcpy(&value, at, element_bytes);
+			memcpy(dst, &value, sizeof(Soa_Field<member>));
+		}
+	}
+
+	//? One member into stream with any stride
+	template<auto member>
+	inline void to_stream(Memory_View dst) const
+	{
+		assert(sizeof(Soa_Field<member>) <= dst.stride);
+		assert(count <= dst.bytes / dst.stride && "Destination stream is too short!");
+
+		const Soa_Field<member>* src = field<member>();
+		byte* at = (byte*)dst.data;
+		for (u32 i = 0; i < count; ++i, at += dst.stride)
+			memcpy(at, &src[i], sizeof(Soa_Field<member>));
+	}
+
+	template<auto member>
+	inline void gather_member(const Memory_View src)
+	{
+		Soa_Field<member>* dst = field<member>();
+		const byte* at = (const byte*)src.data;
+		for (u32 i = 0; i < count; ++i, at += src.stride)
+			dst[i] = ((const Record*)at)->*member;
+	}
+
+	template<auto member>
+	inline void scatter_member(Memory_View dst) const
+	{
+		const Soa_Field<member>* src = field<member>();
+		byte* at = (byte*)dst.data;
+		for (u32 i = 0; i < count; ++i, at += dst.stride)
+			((Record*)at)->*member = src[i];
+	}
+};
@@ -0,0 +1,191 @@
+#pragma once
+
+#include <cassert>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+
+#include "Utils.hpp"
+#include "Allocators.hpp"
+#include "Views.hpp"
+#include "Hash_Map.hpp"
+
+//? Strings made in arenas are null terminated, so they can go straight to C and OS APIs
+
+[[nodiscard]]
+inline String_View str_push(Alloc_Arena *arena, const String_View view ALLOC_SITE_PARAM)
+{
+	char *out = (char*)allocate(arena, (u64)view.size + 1, 1 ALLOC_SITE_ARG);
+	memcpy(out, view.str, view.size);
+	out[view.size] = '\0';
+	return { out, view.size, view.hash };
+}
+
+[[nodiscard]]
+inline String_View str_concat(Alloc_Arena *arena, const String_View a, const String_View b ALLOC_SITE_PARAM)
+{
+	s32 size = a.size + b.size;
+	char *out = (char*)allocate(arena, (u64)size + 1, 1 ALLOC_SITE_ARG);
+	memcpy(out, a.str, a.size);
+	memcpy(out + a.size, b.str, b.size);
+	out[size] = '\0';
+	return str_view(out, size);
+}
+
+//? printf formatting, views go with "%.*s" and (int)view.size, view.str
+[[nodiscard]]
+inline String_View str_format(Alloc_Arena *arena, const char *format, ...)
+{
+	va_list args;
+	va_start(args, format);
+	va_list args_copy;
+	va_copy(args_copy, args);
+	s32 size = vsnprintf(nullptr, 0, format, args_copy);
+	va_end(args_copy);
+	assert(size >= 0 && "Wrong format!");
+
+	char *out = (char*)allocate(arena, (u64)size + 1, 1);
+	vsnprintf(out, (u64)size + 1, format, args);
+	va_end(args);
+	return str_view(out, size);
+}
+
+//? Index of last "c" or -1
+[[nodiscard]]
+inline s32 str_find_last(const String_View view, const char c)
+{
+	for (s32 i = view.size - 1; i >= 0; --i)
+	{
+		if (view.str[i] == c)
+			return i;
+	}
+	return -1;
+}
+
+//? File name without directories and extension, "../shaders/default.hlsl" -> "default"
+[[nodiscard]]
+inline String_View str_file_stem(const String_View path)
+{
+	s32 last_slash = str_find_last(path, '/');
+	s32 last_backslash = str_find_last(path, '\\');
+	s32 start = ((last_slash > last_backslash) ? last_slash : last_backslash) + 1;
+	String_View name = { path.str + start, path.size - start, 0 };
+	s32 last_dot = str_find_last(name, '.');
+	return str_view(name.str, (last_dot > 0) ? last_dot : name.size);
+}
+
+//? UTF-8 to null terminated wide string for OS APIs (UTF-16 on Windows, UTF-32 elsewhere), returns count of chars
+//? without terminator. Invalid bytes become U+FFFD
+inline u32 str_to_wide(const String_View view, wchar_t *out, const u32 max_chars)
+{
+	assert(max_chars > 0);
+	u32 count = 0;
+	for (s32 i = 0; i < view.size;)
+	{
+		u8 lead = (u8)view.str[i];
+		u32 count_bytes = (lead < 0x80) ? 1 : ((lead >> 5) == 0x6) ? 2 : ((lead >> 4) == 0xE) ? 3 : ((lead >> 3) == 0x1E) ? 4 : 0;
+		u32 code = 0xFFFD;
+		if (count_bytes == 0 || i + (s32)count_bytes > view.size)
+		{
+			count_bytes = 1;
+		}
+		else
+		{
+			code = (count_bytes == 1) ? lead : (lead & (0x7F >> count_bytes));
+			for (u32 byte_i = 1; byte_i < count_bytes; ++byte_i)
+				code = (code << 6) | ((u8)view.str[i + byte_i] & 0x3F);
+		}
+		i += count_bytes;
+
+		if constexpr (sizeof(wchar_t) == 2)
+		{
+			if (code >= 0x10000)
+			{
+				assert(count + 2 < max_chars && "Wide string buffer too small!");
+				code -= 0x10000;
+				out[count++] = (wchar_t)(0xD800 + (code >> 10));
+				out[count++] = (wchar_t)(0xDC00 + (code & 0x3FF));
+				continue;
+			}
+		}
+		assert(count + 1 < max_chars && "Wide string buffer too small!");
+		out[count++] = (wchar_t)code;
+	}
+
+	out[count] = L'\0';
+	return count;
+}
+
+// ===============================================================================================================================
+// ======================================================= INTERNING =============================================================
+// ===============================================================================================================================
+
+//? Stable 32 bit id of interned string, 0 is empty string. Ids compare as integers, text comes from String_Table
+struct String_Id
+{
+	u32 index;
+
+	constexpr bool operator== (const String_Id&) const = default;
+};
+
+inline constexpr String_Id g_string_id_null = { 0 };
+
+[[nodiscard]]
+inline u64 hash_string_view(const String_View& view)
+{
+	return view.hash;
+}
+
+//? Every distinct string is stored once in table own arena, ids live as long as table (no removal)
+struct String_Table
+{
+	Alloc_Arena arena;
+	Hash_Map<String_View, u32, hash_string_view> ids;
+	String_View *strings;
+	u32 count;
+	u32 max_count;
+};
+
+inline void string_table_init(String_Table *table, Alloc_Arena *parent, const u32 max_count, const u64 max_bytes ALLOC_SITE_PARAM)
+{
+	assert(max_count > 1);
+	table->ids = {};
+	table->ids.init(parent, max_count ALLOC_SITE_ARG);
+	table->strings = (String_View*)allocate(parent, (u64)max_count * sizeof(String_View), alignof(String_View) ALLOC_SITE_ARG);
+	table->arena = arena_from_allocator(parent, max_bytes, 0 ALLOC_SITE_ARG);
+	table->strings[0] = str_push(&table->arena, str_view(""));
+	table->count = 1;
+	table->max_count = max_count;
+}
+
+[[nodiscard]]
+inline String_Id intern(String_Table *table, const String_View view ALLOC_SITE_PARAM)
+{
+	if (view.size == 0)
+		return g_string_id_null;
+
+	b32 is_new;
+	auto* slot = &table->ids.slots[table->ids.find_or_insert_index(view, &is_new)];
+	if (is_new)
+	{
+		assert(table->count < table->max_count && "String table is full!");
+		slot->key = str_push(&table->arena, view ALLOC_SITE_ARG); // key has to point to table own copy, not to caller memory
+		slot->value = table->count++;
+		table->strings[slot->value] = slot->key;
+	}
+	return { slot->value };
+}
+
+[[nodiscard]]
+inline String_Id intern(String_Table *table, const char *cstr ALLOC_SITE_PARAM)
+{
+	return intern(table, str_view(cstr) ALLOC_SITE_ARG);
+}
+
+//? Null terminated text of "id"
+[[nodiscard]]
+inline String_View get_string(const String_Table *table, const String_Id id)
+{
+	assert(id.index < table->count && "Wrong string id!");
+	return table->strings[id.index];
+}
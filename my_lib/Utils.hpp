@@ -1,5 +1,9 @@
 #pragma once
 #include <cstdint>
+#include <cstring>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 // version: 0.0.1 19.02.2024
 
@@ -27,6 +31,10 @@ using b32 = s32;
 
 using byte = u8;
 
+#if !defined(_MSC_VER)
+#define __debugbreak() __builtin_trap()
+#endif
+
 #define SoftAssert(cond) do { if (!(cond)) __debugbreak(); } while (0)
 
 #define KiB(Value) ((Value)*1024LL)
@@ -41,13 +49,80 @@ using byte = u8;
 constexpr f32 PI32 = 3.14159265359f;
 constexpr f64 PI64 = 3.14159265359;
 
-#define AlignAddressPow2(Value, Alignment) ((Value) + ((Alignment)-1)) & ~((Alignment)-1)
+#define AlignAddressPow2(Value, Alignment) (((Value) + ((Alignment)-1)) & ~((Alignment)-1))
 #define AlignAddress4(Value) ((Value + 3) & ~3)
 #define AlignAddress8(Value) ((Value + 7) & ~7)
 #define AlignAddress16(Value) ((Value + 15) & ~15)
 
 #define AlignValuePow2(Value, Alignment) ((Value) + ((Alignment)-1)) & -(Alignment)
 
+//? Index of lowest/highest set bit, value must not be 0
+inline u32 find_lsb_u64(const u64 value)
+{
+#if defined(_MSC_VER)
+	unsigned long out;
+	_BitScanForward64(&out, value);
+	return (u32)out;
+#else
+	return (u32)__builtin_ctzll(value);
+#endif
+}
+
+inline u32 find_msb_u64(const u64 value)
+{
+#if defined(_MSC_VER)
+	unsigned long out;
+	_BitScanReverse64(&out, value);
+	return (u32)out;
+#else
+	return 63u - (u32)__builtin_clzll(value);
+#endif
+}
+
+//? Count of set bits
+inline u32 count_bits_u64(const u64 value)
+{
+#if defined(_MSC_VER)
+	return (u32)__popcnt64(value);
+#else
+	return (u32)__builtin_popcountll(value);
+#endif
+}
+
+//? 64 bit finalizer of MurmurHash3 and byte hash built on it, used by hash tables and strings
+[[nodiscard]]
+constexpr u64 hash_mix(u64 x)
+{
+	x ^= x >> 33;
+	x *= 0xff51afd7ed558ccdull;
+	x ^= x >> 33;
+	x *= 0xc4ceb9fe1a85ec53ull;
+	x ^= x >> 33;
+	return x;
+}
+
+[[nodiscard]]
+inline u64 hash_bytes(const void* data, u64 size, const u64 seed = 0x9E3779B97F4A7C15ull)
+{
+	const byte* at = (const byte*)data;
+	u64 out = seed ^ (size * 0xff51afd7ed558ccdull);
+	for (; size >= 8; size -= 8, at += 8)
+	{
+		u64 word;
+		memcpy(&word, at, 8);
+		out = (out ^ hash_mix(word)) * 0x9E3779B97F4A7C15ull;
+	}
+
+	if (size > 0)
+	{
+		u64 word = 0;
+		memcpy(&word, at, size);
+		out = (out ^ hash_mix(word ^ (size << 56))) * 0x9E3779B97F4A7C15ull;
+	}
+
+	return hash_mix(out);
+}
+
 #define TestBit(El, Pos) ((El) & (1 << (Pos))) // return 0/1 if notset/set
 #define TestBitPos(El,Pos) (((El) >> (Pos)) & 1) // returns position or 0 if not set
 
@@ -77,13 +152,13 @@ constexpr u32 trunc_u64_to_u32(u64 val)
 };
 
 template <typename T, u64 N>
-constexpr u64 array_count_64(const T (&array)[N]) noexcept
+constexpr u64 array_count_64(const T (&)[N]) noexcept
 {
 	return N;
 }
 
 template <typename T, u32 N>
-constexpr u32 array_count_32(const T (&array)[N]) noexcept
+constexpr u32 array_count_32(const T (&)[N]) noexcept
 {
 	return N;
 }
@@ -4,9 +4,9 @@
 template<typename T>
 struct VM_Array
 {
-	VM_Array(u64 maxAddressSpace, u64 elements )
+	VM_Array(u64 maxAddressSpace, u64 elements, u64 commit_step = 0)
 	{
-		vm_alloc_reserve(&origin, maxAddressSpace, elements);
+		vm_alloc_reserve(&origin, maxAddressSpace, elements, commit_step);
 	}
 
 	T* origin = nullptr;
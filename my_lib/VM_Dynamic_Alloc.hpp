@@ -1,6 +1,6 @@
 //? -----------------------------------------------------------------------------------------------
-//? DYNAMIC ALLOCATOR/ARRAY WITH REQUIRED PRE-RESERVATION. IT WILL GROW BY MULTIPLIES OF 4KB (PAGE SIZE)
-//? UP TO MAXIMUM SPECIFIED DURING RESERVATION. THE MINIMAL COMMIT (ACTUAL SIZE) WILL BE 4 KB! 
+//? DYNAMIC ALLOCATOR/ARRAY WITH REQUIRED PRE-RESERVATION. IT WILL GROW BY MULTIPLIES OF COMMIT STEP (DEFAULT PAGE SIZE)
+//? UP TO MAXIMUM SPECIFIED DURING RESERVATION. THE MINIMAL COMMIT (ACTUAL SIZE) WILL BE ONE COMMIT STEP! 
 //? THE RESERVE FUNCTION MUST BE CALLED FIRST! THE MINIMAL RESERVATION SHOULD BE MULTIPLE OF 64KB!
 //? USE AS LAZY GENERAL ALLOCATON METHOD ONLY IF YOU CAN GUARANTEE 64BIT PLATFORM!
 //? -----------------------------------------------------------------------------------------------
@@ -12,14 +12,18 @@
 //TODO: Rewrite it to match API of other allocators
 #pragma once
 #include <cassert>
-#include "external/Minimal_Windows.hpp"
 
 #include "Utils.hpp"
+#include "VM_Memory.hpp"
 
 struct VM_Alloc_Header
 {
 	u64 size;
 	u64 capacity;
+	u64 reserved_bytes;
+	u64 committed_bytes;
+	u64 commit_step;
+	u64 padding; // keeps data 16 bytes aligned
 };
 
 #define VMAllocGetHeader(a) ((VM_Alloc_Header*)((char*)(a) - sizeof(VM_Alloc_Header)))
@@ -29,42 +33,56 @@ struct VM_Alloc_Header
 #define VMAllocIsEmpty(a) ((VMAllocGetSize(a))==0)
 
 //? Commit memory and init it to 0, DO NOT CALL THIS FUNCTION DIRECTLY
+//? Only not yet committed pages are committed, already used ones are never moved nor copied
 template<typename T>
-inline T* vm_alloc_grow(T* arr, u64 n, u64 initSize = 0)
+inline T* vm_alloc_grow(T* arr, u64 n, u64 initSize = 0, u64 commit_step = 0)
 {
 	u64 currentCapacity = 0;
 	u64 size = 0;
 	u64 growBy = 0;
-	VM_Alloc_Header* h;
+	u64 committed = 0;
+	u64 reserved = 0;
+	byte* base = nullptr;
 
 	if (arr == nullptr)
 	{
+		commit_step = vm_align_to_page(commit_step ? commit_step : vm_page_size());
 		size = 0;
-		growBy = ( sizeof(T) * n + sizeof(VM_Alloc_Header) + (KiB(4) - 1) ) & -KiB(4);
-		currentCapacity = ( growBy - sizeof(VM_Alloc_Header) ) / sizeof(T);
-		assert(growBy < initSize && "Reached max reservation size limit");
-		arr = (T*)VirtualAlloc(nullptr, initSize, MEM_RESERVE, PAGE_READWRITE);
-		h = (VM_Alloc_Header*)arr;
+		growBy = ( sizeof(T) * n + sizeof(VM_Alloc_Header) + (commit_step - 1) ) / commit_step * commit_step;
+		reserved = initSize;
+		assert(growBy <= reserved && "Reached max reservation size limit");
+		base = (byte*)vm_reserve(reserved);
+		assert(base && "Failed to reserve memory");
 	}
 	else
 	{
+		VM_Alloc_Header* old_h = VMAllocGetHeader(arr);
+		commit_step = old_h->commit_step;
+		committed = old_h->committed_bytes;
+		reserved = old_h->reserved_bytes;
+		base = (byte*)old_h;
 		// Minimum elements required
 		currentCapacity = VMAllocGetCapacity(arr) * 2 + n;
 		size = VMAllocGetSize(arr);
-		h = VMAllocGetHeader(arr);
-		// Grow rounded up to next multiple of page size.
-		growBy = ( sizeof(T) * currentCapacity + sizeof(VM_Alloc_Header) + (KiB(4) - 1) ) & -KiB(4);
-		// Effective capacity after rounding up
-		currentCapacity = ( growBy - sizeof(VM_Alloc_Header) ) / sizeof(T);
+		// Grow rounded up to next multiple of commit step, clamped to reservation
+		growBy = ( sizeof(T) * currentCapacity + sizeof(VM_Alloc_Header) + (commit_step - 1) ) / commit_step * commit_step;
+		growBy = (growBy > reserved) ? vm_align_to_page(reserved) : growBy;
+		assert(sizeof(T) * (size + n) + sizeof(VM_Alloc_Header) <= growBy && "Reached max reservation size limit");
 	}
 
-	arr = (T*)VirtualAlloc(h, growBy, MEM_COMMIT, PAGE_READWRITE);
-	assert(arr && "Failed to allocate memory");
-	arr = (T*)((char*)arr + sizeof(VM_Alloc_Header));
+	b32 is_committed = vm_commit(base + committed, growBy - committed);
+	assert(is_committed && "Failed to commit memory");
 
-	h = VMAllocGetHeader(arr);
+	arr = (T*)(base + sizeof(VM_Alloc_Header));
+	// Effective capacity after rounding up
+	currentCapacity = ( growBy - sizeof(VM_Alloc_Header) ) / sizeof(T);
+
+	VM_Alloc_Header* h = VMAllocGetHeader(arr);
 	h->capacity = currentCapacity;
 	h->size = size;
+	h->reserved_bytes = reserved;
+	h->committed_bytes = growBy;
+	h->commit_step = commit_step;
 
 	return arr;
 }
@@ -81,16 +99,17 @@ inline void vm_alloc_push(T** arr, T el)
 	(*arr)[VMAllocGetHeader((*arr))->size++] = el;
 }
 
-//? Reserves max address space from windows (max space to which array could grow),
-//? and commits capacity of elements rounded up to  next 4KB page boundry (it will always commit atleast 4KB)
+//? Reserves max address space from OS (max space to which array could grow), and commits capacity of elements 
+//? rounded up to next commit step boundry (it will always commit atleast one step). 
+//? "commit_step" is rounded up to page size, 0 means single page
 template<typename T>
-inline bool vm_alloc_reserve(T** arr, u64 maxAdressSpace, u64 elements)
+inline bool vm_alloc_reserve(T** arr, u64 maxAdressSpace, u64 elements, u64 commit_step = 0)
 {
 	assert(maxAdressSpace > KiB(64) && "Trying to reserve less than granularity");
 
 	if ((*arr) == nullptr)
 	{
-		(*arr) = vm_alloc_grow((*arr), elements, maxAdressSpace);
+		(*arr) = vm_alloc_grow((*arr), elements, maxAdressSpace, commit_step);
 		return 0;
 	}
 	return 1;
@@ -105,6 +124,8 @@ inline void vm_alloc_add(T** arr, u64 n)
 	{
 		(*arr) = vm_alloc_grow((*arr), n);
 	}
+	// Fresh pages are zero, but ones left by popped elements still hold their data
+	memset((*arr) + VMAllocGetSize((*arr)), 0, n * sizeof(T));
 	(VMAllocGetHeader((*arr))->size += n);
 }
 
@@ -137,8 +158,13 @@ inline T* vm_alloc_get_end(T* arr)
 	return &arr[VMAllocGetCapacity(arr) - 1];
 }
 
+//? Gives whole reservation back to OS, returns 0 on success
 template<typename T>
 inline bool vm_alloc_free(T* arr)
 {
-	return !VirtualFree(VMAllocGetHeader(arr), 0, MEM_RELEASE);
+	if (arr == nullptr)
+		return 0;
+	
+	VM_Alloc_Header* h = VMAllocGetHeader(arr);
+	return !vm_release(h, h->reserved_bytes);
 }
\ No newline at end of file
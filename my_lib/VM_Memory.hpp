@@ -0,0 +1,146 @@
+//? -----------------------------------------------------------------------------------------------
+//? PLATFORM VIRTUAL MEMORY: RESERVE ADDRESS SPACE, COMMIT/DECOMMIT PAGES INSIDE IT, RELEASE IT ALL.
+//? RESERVED BUT NOT COMMITTED PAGES ARE INACCESSIBLE AND DO NOT USE RAM NOR PAGE FILE.
+//? ALL SIZES ARE ROUNDED UP TO PAGE SIZE, ALL POINTERS PASSED TO COMMIT/DECOMMIT SHOULD BE PAGE ALIGNED!
+//? -----------------------------------------------------------------------------------------------
+#pragma once
+#include <cassert>
+
+#include "Utils.hpp"
+
+#if defined(_WIN32)
+// Minimal declarations instead of <windows.h>, so including this header does not drag min/max macros etc.
+extern "C"
+{
+	__declspec(dllimport) void* __stdcall VirtualAlloc(void* address, unsigned long long size, unsigned long type, unsigned long protect);
+	__declspec(dllimport) int __stdcall VirtualFree(void* address, unsigned long long size, unsigned long type);
+}
+#else
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+#if defined(_WIN32)
+inline constexpr unsigned long g_vm_win_mem_commit 		= 0x00001000; // MEM_COMMIT
+inline constexpr unsigned long g_vm_win_mem_reserve 	= 0x00002000; // MEM_RESERVE
+inline constexpr unsigned long g_vm_win_mem_decommit 	= 0x00004000; // MEM_DECOMMIT
+inline constexpr unsigned long g_vm_win_mem_release 	= 0x00008000; // MEM_RELEASE
+inline constexpr unsigned long g_vm_win_page_noaccess = 0x01; // PAGE_NOACCESS
+inline constexpr unsigned long g_vm_win_page_rw 			= 0x04; // PAGE_READWRITE
+#endif
+
+inline constexpr u64 g_vm_huge_page_size = MiB(2);
+
+[[nodiscard]]
+inline u64 vm_page_size()
+{
+#if defined(_WIN32)
+	return KiB(4);
+#else
+	local_persist u64 page_size = (u64)sysconf(_SC_PAGESIZE);
+	return page_size;
+#endif
+}
+
+[[nodiscard]]
+inline u64 vm_align_to_page(const u64 size_bytes)
+{
+	u64 page = vm_page_size();
+	return (size_bytes + (page - 1)) & ~(page - 1);
+}
+
+//? Returns nullptr on failure
+[[nodiscard]]
+inline void* vm_reserve(const u64 size_bytes)
+{
+	void* out = nullptr;
+	u64 size = vm_align_to_page(size_bytes);
+#if defined(_WIN32)
+	out = VirtualAlloc(nullptr, size, g_vm_win_mem_reserve, g_vm_win_page_noaccess);
+#else
+	out = mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	if (out == MAP_FAILED)
+		out = nullptr;
+#endif
+	return out;
+}
+
+//? Reservation aligned to huge page, committed pages are backed by huge pages where OS can give them (transparent
+//? huge pages on Linux, normal pages when THP is disabled or memory is fragmented). Only whole aligned huge pages
+//? inside committed range can be used, so commit in multiples of "g_vm_huge_page_size".
+//? Windows large pages need SeLockMemoryPrivilege and are committed at reserve time - there it is plain "vm_reserve"
+[[nodiscard]]
+inline void* vm_reserve_huge(const u64 size_bytes)
+{
+#if defined(_WIN32)
+	return vm_reserve(size_bytes);
+#else
+	// Over-reserve and trim to get huge page aligned start
+	u64 size = vm_align_to_page(size_bytes);
+	byte* reserved = (byte*)vm_reserve(size + g_vm_huge_page_size);
+	if (reserved == nullptr)
+		return nullptr;
+
+	byte* out = (byte*)(AlignAddressPow2((u64)reserved, g_vm_huge_page_size));
+	if (out != reserved)
+		munmap(reserved, (u64)(out - reserved));
+	munmap(out + size, (u64)(reserved + g_vm_huge_page_size - out));
+
+	// Only a hint, without THP support memory stays usable with normal pages
+	madvise(out, size, MADV_HUGEPAGE);
+	return out;
+#endif
+}
+
+//? Committed memory is zero initialized on first touch
+inline b32 vm_commit(void* ptr, const u64 size_bytes)
+{
+	assert(((u64)ptr & (vm_page_size() - 1)) == 0 && "Not page aligned address");
+	u64 size = vm_align_to_page(size_bytes);
+#if defined(_WIN32)
+	return VirtualAlloc(ptr, size, g_vm_win_mem_commit, g_vm_win_page_rw) != nullptr;
+#else
+	return mprotect(ptr, size, PROT_READ | PROT_WRITE) == 0;
+#endif
+}
+
+//? Pages go back to OS but address range stays reserved, content is lost (zeroed on next commit)
+inline b32 vm_decommit(void* ptr, const u64 size_bytes)
+{
+	assert(((u64)ptr & (vm_page_size() - 1)) == 0 && "Not page aligned address");
+	u64 size = vm_align_to_page(size_bytes);
+	if (size == 0)
+		return true;
+#if defined(_WIN32)
+	return VirtualFree(ptr, size, g_vm_win_mem_decommit) != 0;
+#else
+	return madvise(ptr, size, MADV_DONTNEED) == 0 && mprotect(ptr, size, PROT_NONE) == 0;
+#endif
+}
+
+//? Drops content of committed pages - they stay committed and accessible, but read back as zero and give their
+//? physical memory back to OS until touched again. Only for memory coming from "vm_reserve"!
+inline b32 vm_reclaim(void* ptr, const u64 size_bytes)
+{
+	assert(((u64)ptr & (vm_page_size() - 1)) == 0 && "Not page aligned address");
+	assert((size_bytes & (vm_page_size() - 1)) == 0 && "Not page aligned size, reclaim would drop data behind it");
+	if (size_bytes == 0)
+		return true;
+#if defined(_WIN32)
+	// MEM_RESET does not guarantee zeroed pages, so round trip through decommit instead
+	return VirtualFree(ptr, size_bytes, g_vm_win_mem_decommit) != 0 && 
+	       VirtualAlloc(ptr, size_bytes, g_vm_win_mem_commit, g_vm_win_page_rw) != nullptr;
+#else
+	return madvise(ptr, size_bytes, MADV_DONTNEED) == 0;
+#endif
+}
+
+//? "reserved_size" must be the same as passed to "vm_reserve" (needed by munmap, ignored on Windows)
+inline b32 vm_release(void* ptr, const u64 reserved_size)
+{
+#if defined(_WIN32)
+	return VirtualFree(ptr, 0, g_vm_win_mem_release) != 0;
+#else
+	return munmap(ptr, vm_align_to_page(reserved_size)) == 0;
+#endif
+}
@@ -7,8 +7,6 @@
 
 // Version 0.0.41 02.06.2024
 
-//TODO: Extend String_View implementation
-
 struct Memory_View
 {
 	void* data;
@@ -95,7 +93,7 @@ struct Array_View
 	inline void init(auto* allocator, const s32 elements)
 	{
 		assert(elements > 0);
-		data = (T*)allocate(allocator, elements * sizeof(T));
+		data = (T*)allocate(allocator, elements * sizeof(T), alignof(T));
 		size = elements;
 		count = 0;
 	}
@@ -104,7 +102,7 @@ struct Array_View
 	inline void init(auto* allocator, Args&&... args) 
 	{
 		constexpr u64 elements = sizeof...(Args);
-		data = (T*)allocate(allocator, elements * sizeof(T));
+		data = (T*)allocate(allocator, elements * sizeof(T), alignof(T));
 		size = elements;
 		(push((T)args), ...);
 		count = elements;
@@ -122,24 +120,17 @@ struct Array_View
 	}
 };
 
+//? UTF-8 text, not owned and not always null terminated (interned and arena made strings are). Hash is computed once
+//? when view is made, so comparisons and table lookups start with integers. Make views with "str_view" only
 struct String_View
 {
-	char *str;
+	const char *str;
 	s32 size;
-
-	constexpr char& operator[] (const s32 i)
-	{
-		assert(i < size); return str[i];
-	}
+	u32 hash;
 
 	constexpr const char& operator[] (const s32 i) const
 	{
-		assert(i < size); return str[i];
-	}
-
-	constexpr char* begin()
-	{
-		return str;
+		assert(i < size && i >= 0); return str[i];
 	}
 
 	constexpr const char* begin() const
@@ -147,19 +138,26 @@ struct String_View
 		return str;
 	}
 
-	constexpr char* end()
-	{
-		return str + size;
-	}
-
 	constexpr const char* end() const
 	{
 		return str + size;
 	}
 
-	inline void init(const auto& allocator, const s32 elements)
+	constexpr bool operator== (const String_View& other) const
 	{
-		str = allocate<char>(allocator, elements);
-		size = elements;
+		return hash == other.hash && size == other.size && (str == other.str || memcmp(str, other.str, size) == 0);
 	}
-};
\ No newline at end of file
+};
+
+[[nodiscard]]
+inline String_View str_view(const char *str, const s32 size)
+{
+	assert(size >= 0 && (str || size == 0));
+	return { str, size, (u32)hash_bytes(str, (u64)size) };
+}
+
+[[nodiscard]]
+inline String_View str_view(const char *cstr)
+{
+	return str_view(cstr, (s32)strlen(cstr));
+}
@@ -4,18 +4,28 @@
 #include "Allocators.hpp"
 #include "GameAsserts.hpp"
 #include "Views.hpp"
+#include "Slot_Map.hpp"
+#include "Hash_Map.hpp"
+#include "Strings.hpp"
+#include "Soa_Array.hpp"
+#include "Arena_Array.hpp"
 #include "Math.hpp"
 
-#pragma warning(push, 0)   
+#if defined(_MSC_VER)
+#pragma warning(push, 0)
+#endif
 #define CGLTF_IMPLEMENTATION
 #include "cgltf.h"
+#if defined(_MSC_VER)
 #pragma warning(pop)
+#endif
 
 #include "Game_Services.hpp"
 #include "Render_Data.hpp"
 #include "App.hpp"
 
 inline constexpr u64 frame_max_size = MiB(128);
+inline constexpr u64 frame_retained_size = MiB(8);
 inline constexpr u64 assets_max_size = GiB(1);
 
 inline internal lib::Vec3 move_camera(lib::Vec3 cam_pos, lib::Vec3 dir, f32 speed = 0.2f)
@@ -25,19 +35,20 @@ inline internal lib::Vec3 move_camera(lib::Vec3 cam_pos, lib::Vec3 dir, f32 spee
 	return out + dir * speed;
 }
 
-Geometry load_geometry_from_gltf(const char* file_path, Alloc_Arena* arena_to_push, Alloc_Arena* arena_temp)
+//? "out_transform" gets world transform of first node with mesh, all meshes are merged so one transform is kept
+Geometry load_geometry_from_gltf(const char* file_path, Alloc_Arena* arena_to_push, lib::Trs* out_transform)
 {
-	assert(arena_to_push != arena_temp && "Same arenas");
-	
 	Geometry out{};
 			
-	arena_start_temp(arena_temp);
-	auto d = defer([&] { arena_end_temp(arena_temp); });
+	// cgltf data and intermediate attributes live only in this scope
+	Arena_Temp_Scope scratch = get_scratch(arena_to_push);
+	Alloc_Arena* arena_temp = scratch.arena();
 	
-	cgltf_options options = {.memory = {
-																		 .alloc_func = &arena_alloc_for_lib,
-																		 .free_func = &arena_reset_for_lib, 
-																		 .user_data = arena_temp } };
+	Arena_Lib_Context lib_context = arena_lib_context(arena_temp);
+	cgltf_options options = {};
+	options.memory = { .alloc_func = &arena_alloc_for_lib,
+	                   .free_func = &arena_reset_for_lib,
+	                   .user_data = &lib_context };
 	cgltf_data* data = nullptr;
 		
 	cgltf_result result = cgltf_parse_file(&options, file_path, &data);
@@ -46,79 +57,154 @@ Geometry load_geometry_from_gltf(const char* file_path, Alloc_Arena* arena_to_pu
 	result = cgltf_load_buffers(&options, data, file_path);
 	assert(result == cgltf_result_success);
 			
-	auto copy_data = [](Alloc_Arena* arena, Memory_View& mem, void* src, u32 size, u32 stride)
-										{
-									 		mem.data = allocate(arena, size);
-											mem.bytes = size;  
-											mem.stride = stride; // or stride from bufferView?
-											memcpy(mem.data, src, mem.bytes);
-										};
-			
-	// Copy indices
+	// All triangle primitives of all meshes are merged into one Geometry
+	auto get_stream = [](const cgltf_accessor* acc) -> Memory_View
 	{
-		cgltf_accessor* acc = data->meshes[0].primitives[0].indices;
-		auto src_data = (byte *)acc->buffer_view->buffer->data + acc->offset + acc->buffer_view->offset;
-		u32 size_bytes = (u32)acc->buffer_view->size; // shouldnt this be subtracted with offset from accesor?
-				
-		copy_data(arena_to_push, out.indices, src_data, size_bytes, (u32)acc->stride);
-	}
-			
-	// Copy attributes
-	Memory_View temp_normals{};
-	Memory_View temp_tangents{};
-	Memory_View temp_uvs{};
+		auto src_data = (byte *)acc->buffer_view->buffer->data + acc->buffer_view->offset + acc->offset;
+		return { src_data, acc->count * acc->stride, (u32)acc->stride };
+	};
+	auto find_accessor = [](const cgltf_primitive* primitive, cgltf_attribute_type type) -> const cgltf_accessor*
 	{
-		u32 count_attributes = (u32)data->meshes[0].primitives[0].attributes_count;
-		for (u32 attr_i = 0; attr_i < count_attributes; ++attr_i)
+		for (u64 attr_i = 0; attr_i < primitive->attributes_count; ++attr_i)
 		{
-			cgltf_attribute* attribute = &data->meshes[0].primitives[0].attributes[attr_i];
-			cgltf_accessor* acc = attribute->data;
-			auto src_data = (byte *)acc->buffer_view->buffer->data + acc->offset + acc->buffer_view->offset;
-			u32 size_bytes = (u32)acc->buffer_view->size;
-			
-			if (attribute->type == cgltf_attribute_type_position)
-			{
-				copy_data(arena_to_push, out.positions, src_data, size_bytes, (u32)acc->stride);
-			}
-			// Rest of attributes copied first to intermediate buffers
-			else if (attribute->type == cgltf_attribute_type_normal)
-			{
-				AlwaysAssert(acc->type == cgltf_type_vec3 && acc->component_type == cgltf_component_type_r_32f);
-				copy_data(arena_temp, temp_normals, src_data, size_bytes, (u32)acc->stride);
-			}
-			else if (attribute->type == cgltf_attribute_type_tangent)
-			{
-				AlwaysAssert(acc->type == cgltf_type_vec4 && acc->component_type == cgltf_component_type_r_32f);
-				copy_data(arena_temp, temp_tangents, src_data, size_bytes, (u32)acc->stride);
-			}
-			else if (attribute->type == cgltf_attribute_type_texcoord)
+			if (primitive->attributes[attr_i].type == type && primitive->attributes[attr_i].index == 0)
+				return primitive->attributes[attr_i].data;
+		}
+		return nullptr;
+	};
+	auto for_each_primitive = [data](auto func)
+	{
+		for (u64 mesh_i = 0; mesh_i < data->meshes_count; ++mesh_i)
+		{
+			for (u64 prim_i = 0; prim_i < data->meshes[mesh_i].primitives_count; ++prim_i)
 			{
-				AlwaysAssert(acc->type == cgltf_type_vec2 && acc->component_type == cgltf_component_type_r_32f);
-				copy_data(arena_temp, temp_uvs, src_data, size_bytes, (u32)acc->stride);
+				const cgltf_primitive* primitive = &data->meshes[mesh_i].primitives[prim_i];
+				if (primitive->type == cgltf_primitive_type_triangles && primitive->indices)
+					func(primitive);
 			}
 		}
-	}
+	};
 	
-	AlwaysAssert(temp_normals.data 	!= nullptr && "No normals loaded!");
-	AlwaysAssert(temp_tangents.data != nullptr && "No tangents loaded!");
-	AlwaysAssert(temp_uvs.data 			!= nullptr && "No uvs loaded!");
+	// Counts are not known up front - every stream grows in place as last allocation of "arena_to_push",
+	// so streams are built one after another
 	
-	s32 vertex_count = (s32)(out.positions.bytes / out.positions.stride);
-	out.attributes.init(arena_to_push, vertex_count);
+	// Positions, bounds come from accessors (glTF requires min & max for positions)
+	Arena_Array<lib::Vec3> positions;
+	positions.init(arena_to_push);
+	out.bounds_min = { HUGE_VALF, HUGE_VALF, HUGE_VALF };
+	out.bounds_max = { -HUGE_VALF, -HUGE_VALF, -HUGE_VALF };
+	for_each_primitive([&](const cgltf_primitive* primitive)
+	{
+		const cgltf_accessor* acc = find_accessor(primitive, cgltf_attribute_type_position);
+		AlwaysAssert(acc && acc->type == cgltf_type_vec3 && acc->component_type == cgltf_component_type_r_32f && "No positions loaded!");
+		AlwaysAssert(acc->has_min && acc->has_max && "Positions without bounds!");
+		positions.append(get_stream(acc));
+		for (u32 i = 0; i < 3; ++i)
+		{
+			out.bounds_min[i] = lib::min(out.bounds_min[i], acc->min[i]);
+			out.bounds_max[i] = lib::max(out.bounds_max[i], acc->max[i]);
+		}
+	});
+	positions.shrink_to_fit();
+	out.positions = positions.get_memory_view();
 	
-	// Copy rest of attributes to Geometry layout
-	for(u64 v_i = 0; v_i < out.attributes.size; ++v_i)
+	// Attributes, gltf streams are widened into per attribute arrays, then interleaved into Geometry layout in one pass
+	Arena_Array<Attributes> attributes;
+	attributes.init(arena_to_push);
+	for_each_primitive([&](const cgltf_primitive* primitive)
 	{
-		// casts are "safe" here cause we know the data has this type
-		lib::Vec3 normal = *(lib::Vec3*)((byte *)(temp_normals.data) + v_i * temp_normals.stride);
-		lib::Vec4 tangent = *(lib::Vec4*)((byte *)(temp_tangents.data) + v_i * temp_tangents.stride);
-		lib::Vec2 uv = *(lib::Vec2*)((byte *)(temp_uvs.data) + v_i * temp_uvs.stride);
+		const cgltf_accessor* acc_normals = find_accessor(primitive, cgltf_attribute_type_normal);
+		const cgltf_accessor* acc_tangents = find_accessor(primitive, cgltf_attribute_type_tangent);
+		const cgltf_accessor* acc_uvs = find_accessor(primitive, cgltf_attribute_type_texcoord);
+		AlwaysAssert(acc_normals 	&& acc_normals->type == cgltf_type_vec3 && "No normals loaded!");
+		AlwaysAssert(acc_tangents && acc_tangents->type == cgltf_type_vec4 && "No tangents loaded!");
+		AlwaysAssert(acc_uvs 			&& acc_uvs->type == cgltf_type_vec2 && "No uvs loaded!");
+		AlwaysAssert(acc_normals->component_type == cgltf_component_type_r_32f && acc_tangents->component_type == cgltf_component_type_r_32f &&
+		             acc_uvs->component_type == cgltf_component_type_r_32f);
+		
+		Arena_Temp_Scope primitive_scratch(arena_temp);
+		u32 vertex_count = (u32)acc_normals->count;
+		Soa_Array<&Attributes::tangent, &Attributes::normal, &Attributes::uv> attribute_streams;
+		attribute_streams.init(arena_temp, vertex_count);
+		attribute_streams.set_count(vertex_count);
+		attribute_streams.from_stream<&Attributes::tangent>(get_stream(acc_tangents), sizeof(lib::Vec4));
+		attribute_streams.from_stream<&Attributes::normal>(get_stream(acc_normals), sizeof(lib::Vec3));
+		attribute_streams.from_stream<&Attributes::uv>(get_stream(acc_uvs), sizeof(lib::Vec2));
 		
-		out.attributes.push( {{ tangent.x, tangent.y, tangent.z, tangent.w },
-													{ normal.x, normal.y, normal.z, 0.0f }, 
-													{ uv.x, uv.y, 0.0f, 0.0f } });
+		Attributes* dst = attributes.add_count(vertex_count);
+		attribute_streams.to_aos({ dst, vertex_count * sizeof(Attributes), sizeof(Attributes) });
+
+		// Set explicitly, so padding of normals and uvs does not depend on zeroing of arenas
+		for (u32 v_i = 0; v_i < vertex_count; ++v_i)
+		{
+			dst[v_i].normal.w = 0.0f;
+			dst[v_i].uv.z = 0.0f;
+			dst[v_i].uv.w = 0.0f;
+		}
+	});
+	attributes.shrink_to_fit();
+	AlwaysAssert(attributes.count == positions.count && "Attributes and positions counts differ!");
+	out.attributes = attributes.get_array_view();
+	
+	// Indices are rebased to merged vertices as u32, packed to u16 at the end when all vertices fit
+	Arena_Array<u32> indices;
+	indices.init(arena_to_push);
+	u32 base_vertex = 0;
+	for_each_primitive([&](const cgltf_primitive* primitive)
+	{
+		Memory_View src = get_stream(primitive->indices);
+		u32* dst = indices.add_count(primitive->indices->count);
+		for (u64 i = 0; i < primitive->indices->count; ++i)
+		{
+			const byte* at = (const byte*)src.data + i * src.stride;
+			if (src.stride == 4)
+				dst[i] = base_vertex + *(const u32*)at;
+			else if (src.stride == 2)
+				dst[i] = base_vertex + *(const u16*)at;
+			else
+				dst[i] = base_vertex + *at;
+		}
+		base_vertex += (u32)find_accessor(primitive, cgltf_attribute_type_position)->count;
+	});
+	
+	AlwaysAssert(indices.count > 0 && "No triangles loaded!");
+	out.indices = indices.get_memory_view();
+	if (positions.count <= 0x10000)
+	{
+		u16* packed = (u16*)indices.data;
+		for (u64 i = 0; i < indices.count; ++i)
+			packed[i] = (u16)indices.data[i];
+		out.indices = { packed, indices.count * sizeof(u16), sizeof(u16) };
+		(void)arena_resize_last(arena_to_push, indices.data, out.indices.bytes);
 	}
-			
+	else
+	{
+		indices.shrink_to_fit();
+	}
+	
+	// Node TRS is taken as is, nodes with matrix or parents are decomposed from their world matrix
+	*out_transform = lib::create_trs_identity();
+	for (u64 node_i = 0; node_i < data->nodes_count; ++node_i)
+	{
+		const cgltf_node* node = &data->nodes[node_i];
+		if (!node->mesh)
+			continue;
+		
+		if (!node->has_matrix && !node->parent)
+		{
+			out_transform->translation = { node->translation[0], node->translation[1], node->translation[2] };
+			out_transform->rotation = lib::Quat{ node->rotation[0], node->rotation[1], node->rotation[2], node->rotation[3] };
+			out_transform->scale = { node->scale[0], node->scale[1], node->scale[2] };
+		}
+		else
+		{
+			lib::Mat4 world{};
+			cgltf_node_transform_world(node, &world.e[0][0]);
+			*out_transform = lib::decompose_trs(world);
+		}
+		break;
+	}
+	
 	return out;
 }
 
@@ -127,21 +213,43 @@ extern "C" Data_To_RHI* app_full_update(Game_Memory *memory, Game_Window *window
 	App_State* app_state = (App_State*)memory->permanent_storage;
 	auto* camera = &app_state->camera;
 	arena_reset(&app_state->arena_frame); // reset all previous frame
+	alloc_end_frame();
 	
 	if (!memory->is_initalized)
 	{
 		app_state->arena_persist.max_size 		= memory->size_permanent_storage - sizeof(App_State);
 		app_state->arena_persist.base 				= (byte*)memory->permanent_storage + sizeof(App_State);
-		app_state->arena_transient.max_size 	= memory->size_transient_storage;
-		app_state->arena_transient.base 			= (byte*)memory->transient_storage;
+		if (memory->transient_commit_step)
+		{
+			app_state->arena_transient = arena_from_reserved(memory->transient_storage, memory->size_transient_storage,
+			                                                 memory->transient_commit_step, memory->size_transient_storage);
+		}
+		else
+		{
+			app_state->arena_transient.max_size = memory->size_transient_storage;
+			app_state->arena_transient.base 		= (byte*)memory->transient_storage;
+		}
 		
-		app_state->arena_frame = arena_from_allocator(&app_state->arena_transient, frame_max_size);
+		// Frame arena gives memory back above retained size if some frame spikes
+		app_state->arena_frame = arena_from_allocator(&app_state->arena_transient, frame_max_size, frame_retained_size);
+		app_state->arena_frame.zeroing = Alloc_Zeroing::on_allocate; // reset is O(1), only what next frame asks for is cleared
 		app_state->arena_assets = arena_from_allocator(&app_state->arena_transient, assets_max_size);
+		
+		alloc_name(&app_state->arena_persist, "persist", app_state->arena_persist.max_size);
+		alloc_name(&app_state->arena_frame, "frame", frame_max_size);
+		alloc_name(&app_state->arena_assets, "assets", assets_max_size);
+		
+		app_state->render_assets.geometries.init(&app_state->arena_persist, g_max_count_geometries);
+		app_state->render_assets.images.init(&app_state->arena_persist, g_max_count_images);
+		string_table_init(&app_state->render_assets.names, &app_state->arena_persist, g_max_count_asset_names, g_max_asset_names_bytes);
 			
 		memory->is_initalized = true;
 	}
 	
+	auto* assets = &app_state->render_assets;
 	auto* data_to_rhi = push_type<Data_To_RHI>(&app_state->arena_frame);
+	data_to_rhi->assets = assets;
+	data_to_rhi->static_draws = { .size = 1, .count = 1, .data = &app_state->lvl_draw };
 	
 	if (!app_state->is_new_level)
 	{
@@ -149,26 +257,38 @@ extern "C" Data_To_RHI* app_full_update(Game_Memory *memory, Game_Window *window
 		//TODO: get URI for textures from gltf
 		//TODO: temporarily not holding it anywhere
 		//TODO: async loading
-		Geometry lvl_geo = load_geometry_from_gltf("../assets/meshes/damagedhelmet/DamagedHelmet.gltf", &app_state->arena_assets, &app_state->arena_frame);
+		// Paths are interned once, later loads of same asset compare ids only
+		String_View lvl_dir = str_view("../assets/meshes/damagedhelmet/");
+		auto lvl_path = [&](const char* file_name)
+		{
+			String_Id id = intern(&assets->names, str_concat(&app_state->arena_frame, lvl_dir, str_view(file_name)));
+			return get_string(&assets->names, id);
+		};
+		
+		Geometry lvl_geo = load_geometry_from_gltf(lvl_path("DamagedHelmet.gltf").str, &app_state->arena_assets,
+		                                           &app_state->lvl_transform);
 		
 		//TODO: compress and save as .dds - maybe do compression in RHI?
 		//TODO: material abstraction that hold indexes to textures
-		Image_View lvl_tex_albedo = memory->os_api.read_img(L"../assets/meshes/damagedhelmet/albedo.jpg", &app_state->arena_assets, true);
-		Image_View lvl_tex_normal = memory->os_api.read_img(L"../assets/meshes/damagedhelmet/normal.jpg", &app_state->arena_assets, false);
-		Image_View lvl_tex_rough = memory->os_api.read_img(L"../assets/meshes/damagedhelmet/metrough.jpg", &app_state->arena_assets, false);
-		Image_View lvl_tex_ao = memory->os_api.read_img(L"../assets/meshes/damagedhelmet/ao.jpg", &app_state->arena_assets, true);
+		Image_View lvl_tex_albedo = memory->os_api.read_img(lvl_path("albedo.jpg"), &app_state->arena_assets, true);
+		Image_View lvl_tex_normal = memory->os_api.read_img(lvl_path("normal.jpg"), &app_state->arena_assets, false);
+		Image_View lvl_tex_rough = memory->os_api.read_img(lvl_path("metrough.jpg"), &app_state->arena_assets, false);
+		Image_View lvl_tex_ao = memory->os_api.read_img(lvl_path("ao.jpg"), &app_state->arena_assets, true);
 			
-		// Sending static geometric data to RHI
-		data_to_rhi->st_geo = lvl_geo;
-		// Sending static textures
-		data_to_rhi->st_albedo = lvl_tex_albedo;
-		data_to_rhi->st_normal = lvl_tex_normal;
-		data_to_rhi->st_roughness = lvl_tex_rough;
-		data_to_rhi->st_ao = lvl_tex_ao;
+		app_state->lvl_center = 0.5f * (lvl_geo.bounds_max + lvl_geo.bounds_min);
+		app_state->lvl_extent = 0.5f * (lvl_geo.bounds_max - lvl_geo.bounds_min);
 		
-		data_to_rhi->shader_path = L"../source/shaders/default_ibl.hlsl";
+		// Static draw sent to RHI, assets go by handles
+		app_state->lvl_draw =
+		{
+			.geometry = assets->geometries.insert(lvl_geo),
+			.textures = { assets->images.insert(lvl_tex_albedo), assets->images.insert(lvl_tex_normal),
+			              assets->images.insert(lvl_tex_rough), assets->images.insert(lvl_tex_ao) },
+			.shader_path = intern(&assets->names, "../source/shaders/default_ibl.hlsl"),
+			.is_visible = false
+		};
 		
-		app_state->camera = { .pos = { 0.0f, 1.0f, 20.0f }, .yaw = -PI32 / 2.0f , .fov = 50.0f };
+		app_state->camera = { .pos = { 0.0f, 1.0f, 20.0f }, .forward = {}, .pitch = 0.0f, .yaw = -PI32 / 2.0f , .fov = 50.0f };
 		
 		app_state->is_new_level = true;
 		data_to_rhi->is_new_static = app_state->is_new_level;
@@ -177,9 +297,9 @@ extern "C" Data_To_RHI* app_full_update(Game_Memory *memory, Game_Window *window
 	// Camera
 	{
 		camera->forward = lib::normalize( lib::Vec3{
-		                  .x = cos(camera->yaw) * cos(camera->pitch),
-											.y = sin(camera->pitch),
-											.z = sin(camera->yaw) * cos(camera->pitch) });
+		                  .x = cosf(camera->yaw) * cosf(camera->pitch),
+											.y = sinf(camera->pitch),
+											.z = sinf(camera->yaw) * cosf(camera->pitch) });
 	}
 
 	// Input check
@@ -241,12 +361,11 @@ extern "C" Data_To_RHI* app_full_update(Game_Memory *memory, Game_Window *window
 		lib::Mat4 mat_view = lib::create_look_at( camera->pos, camera->pos + camera->forward, { 0.0f, 1.0f, 0.0f });
 		lib::Mat4 mat_scale = lib::create_scale(4.0f);
 		lib::Mat4 mat_trans = lib::create_translate({0.0f, 0.0f, 0.0f});
-		lib::Mat4 mat_rotation = lib::create_rotation_y((f32)window->time_ms / 1000.0f);
 		lib::Mat4 mat_projection = lib::create_perspective(lib::deg_to_rad(camera->fov), 
 		                                                   (f32)window->width/window->height, 
 		                                                   0.1f, 
 		                                                   10000.0f);
-		lib::Mat4 mat_model = mat_trans * mat_scale;
+		lib::Trans4 obj_to_world = lib::create_trans4(mat_trans * mat_scale) * lib::create_trans4(app_state->lvl_transform);
 		
 		// Pushing data
 		{
@@ -269,12 +388,18 @@ extern "C" Data_To_RHI* app_full_update(Game_Memory *memory, Game_Window *window
 			
 			// Draw constants
 			{
-				draw_consts->obj_to_world = mat_model;
+				draw_consts->obj_to_world = obj_to_world;
 				draw_consts->world_to_clip = mat_projection * mat_view;
 				draw_consts->clip_to_world = lib::inverse(draw_consts->world_to_clip);
+				
+				// Level mesh box against camera frustum, in world space
+				lib::Frustum frustum = lib::create_frustum(draw_consts->world_to_clip);
+				lib::Vec3 world_center, world_extent;
+				lib::transform_aabb(obj_to_world, app_state->lvl_center, app_state->lvl_extent, &world_center, &world_extent);
+				app_state->lvl_draw.is_visible = lib::is_aabb_visible(frustum, world_center, world_extent);
 			
-				data_to_rhi->cb_frame = { .data = frame_consts, .bytes = sizeof(*frame_consts) };
-				data_to_rhi->cb_draw  = { .data = draw_consts, .bytes = sizeof(*draw_consts)  };
+				data_to_rhi->cb_frame = { .data = frame_consts, .bytes = sizeof(*frame_consts), .stride = 0 };
+				data_to_rhi->cb_draw  = { .data = draw_consts, .bytes = sizeof(*draw_consts), .stride = 0 };
 			}
 		}
 	}
@@ -26,5 +26,11 @@ struct App_State
 	Alloc_Arena arena_assets;
 	b32 is_new_level;
 	
+	Render_Assets render_assets;
+	Static_Draw lvl_draw;
+	lib::Trs lvl_transform; // of level mesh, from glTF node
+	lib::Vec3 lvl_center; // object space box of level mesh
+	lib::Vec3 lvl_extent;
+	
 	Camera camera;
 };
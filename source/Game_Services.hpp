@@ -52,7 +52,8 @@ struct Game_Input
 	Game_Controller controllers[2];
 };
 
-using platform_read_img = Image_View(*)(const wchar_t*, Alloc_Arena*, b32);
+//? Path is UTF-8 and null terminated (interned or arena made strings)
+using platform_read_img = Image_View(*)(String_View, Alloc_Arena*, b32);
 
 struct Platform_Api
 {
@@ -68,6 +69,7 @@ struct Game_Memory
 
 	u64 size_transient_storage;
 	void *transient_storage;
+	u64 transient_commit_step; // != 0 when transient storage is only reserved and has to be committed on demand
 	
 	Platform_Api os_api;
 };
@@ -0,0 +1,80 @@
+#pragma once
+
+//? Microbenchmarks of my_lib building blocks, run by headless runner instead of frames:
+//? DeRex12_headless bench [name]  - without name all benchmarks are run
+//? They only time code, its correctness is checked by DeRex12_tests (Linux_x64_Tests.cpp). Benchmarks of one area
+//? live in their own file in "benchmarks" directory and are listed in "g_benchmarks" below
+//! DO NOT INCLUDE IT ENYWHERE ELSE THAN IN LINUX ENTRY POINT COMPILATION UNIT FILE!
+namespace Linux
+{
+	struct Benchmark
+	{
+		const char* name;
+		void (*run)(const Platform_Clock& clock);
+	};
+
+	//? Median of samples, sorts them in place
+	internal f64 get_median(f64* samples, u64 count)
+	{
+		sort_f64(samples, count);
+		return get_percentile(samples, count, 50.0);
+	}
+}
+
+#include "benchmarks/Bench_Memory.hpp"
+#include "benchmarks/Bench_Allocators.hpp"
+#include "benchmarks/Bench_Containers.hpp"
+#include "benchmarks/Bench_Math.hpp"
+
+namespace Linux
+{
+	inline constexpr Benchmark g_benchmarks[] =
+	{
+		{ "arena_reset", &bench_arena_reset },
+		{ "arena_mt", &bench_arena_mt },
+		{ "scratch", &bench_scratch },
+		{ "pool_mt", &bench_pool_mt },
+		{ "tlsf", &bench_tlsf },
+		{ "offset_alloc", &bench_offset_alloc },
+		{ "upload_ring", &bench_upload_ring },
+		{ "huge_pages", &bench_huge_pages },
+		{ "slot_map", &bench_slot_map },
+		{ "hash_map", &bench_hash_map },
+		{ "intern", &bench_intern },
+		{ "soa", &bench_soa },
+		{ "arena_array", &bench_arena_array },
+		{ "queues", &bench_queues },
+		{ "bitset", &bench_bitset },
+		{ "math_x8", &bench_math_x8 },
+		{ "simd_dispatch", &bench_simd_dispatch },
+		{ "quat", &bench_quat },
+		{ "trans4", &bench_trans4 },
+		{ "culling", &bench_culling },
+	};
+
+	//? Returns process exit code
+	internal int run_benchmarks(const Platform_Clock& clock, const char* name)
+	{
+		b32 is_found = false;
+		for (const auto& bench : g_benchmarks)
+		{
+			if (name && strcmp(name, bench.name) != 0)
+				continue;
+
+			printf("[[ %s ]]\n", bench.name);
+			bench.run(clock);
+			is_found = true;
+		}
+
+		if (!is_found)
+		{
+			printf("ERROR: unknown benchmark \"%s\", available:", name);
+			for (const auto& bench : g_benchmarks)
+				printf(" %s", bench.name);
+			printf("\n");
+			return 1;
+		}
+
+		return 0;
+	}
+} // namespace Linux
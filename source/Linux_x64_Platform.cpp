@@ -0,0 +1,216 @@
+#include <cstdio>
+#include <thread> // before "internal" macro from Utils.hpp
+#include <unordered_map>
+
+#include "Utils.hpp"
+#include "Allocators.hpp"
+#include "Views.hpp"
+#include "Slot_Map.hpp"
+#include "Offset_Allocator.hpp"
+#include "Hash_Map.hpp"
+#include "Strings.hpp"
+#include "Soa_Array.hpp"
+#include "Arena_Array.hpp"
+#include "Queues.hpp"
+#include "Cpu_Features.hpp"
+#include "Bitset.hpp"
+#include "Math.hpp"
+#include "Math_x8.hpp"
+#include "Math_Kernels.hpp"
+
+#include "GameAsserts.hpp"
+#include "Game_Services.hpp"
+#include "Render_Data.hpp"
+#include "App.hpp"
+#include "RHI.hpp"
+#include "Linux_x64_Platform.hpp"
+#include "Linux_x64_Benchmarks.hpp"
+
+//? Headless benchmark runner: drives "app_full_update" and "rhi_run" (null backend) for N frames
+//? without window, GPU and hot reload.
+//? Usage (from build directory, same as DeRex12.exe): DeRex12_headless [frames_count] [--huge-pages]
+//? or to run microbenchmarks instead of frames: DeRex12_headless bench [name]
+//? "--huge-pages" backs Game_Memory with transparent huge pages where kernel gives them
+
+inline constexpr u32 g_default_count_frames = 1000;
+inline constexpr u64 g_platform_commit_step = MiB(1);
+
+struct Arena_High_Water
+{
+	const char* name;
+	const Alloc_Arena* arena;
+	u64 peak_bytes;
+	u64 peak_committed_bytes;
+};
+
+int main(int argc, char** argv)
+{
+	AlwaysAssert(get_cpu_features().has_sse41 && "CPU without SSE4.1 is not supported!");
+	if (argc > 1 && strcmp(argv[1], "bench") == 0)
+		return Linux::run_benchmarks(Linux::clock_create(), (argc > 2) ? argv[2] : nullptr);
+
+	u32 count_frames = g_default_count_frames;
+	b32 is_huge_pages = false;
+	for (int arg_i = 1; arg_i < argc; ++arg_i)
+	{
+		if (strcmp(argv[arg_i], "--huge-pages") == 0)
+			is_huge_pages = true;
+		else
+			count_frames = (u32)strtoul(argv[arg_i], nullptr, 10);
+	}
+	AlwaysAssert(count_frames > 0 && "Frames count must be positive");
+
+	Linux::Platform_Clock clock = Linux::clock_create();
+
+	// Only address space is reserved, pages are committed as arenas grow
+	Alloc_Arena platform_arena = is_huge_pages ? arena_reserve_huge(MiB(2150)) : arena_reserve(MiB(2150), g_platform_commit_step);
+	AlwaysAssert(platform_arena.base && "Failed to reserve memory from OS");
+	alloc_name(&platform_arena, "platform", platform_arena.max_size);
+
+	// Fill game services needed by application, same layout as Win32 platform
+	Game_Memory game_memory
+	{
+		.is_initalized = false,
+		.size_permanent_storage = MiB(64),
+		.permanent_storage = allocate(&platform_arena, MiB(64)),
+		.size_transient_storage = GiB(2),
+		.transient_storage = arena_push_reserved(&platform_arena, GiB(2)),
+		.transient_commit_step = platform_arena.commit_step,
+		.os_api = {}
+	};
+	game_memory.os_api.read_img = &Linux::load_img_headless;
+
+	Game_Window game_window { nullptr, 0.0f, 1280, 720, false };
+
+	Game_Input game_input_buffer[2] = {};
+	Game_Input* new_inputs = &game_input_buffer[0];
+	Game_Input* old_inputs = &game_input_buffer[1];
+
+	// Runner own memory, kept outside of memory given to App so it does not affect App arenas
+	f64* frame_times_ms = (f64*)allocate(&platform_arena, sizeof(f64) * count_frames, alignof(f64));
+	f64* rhi_times_ms = (f64*)allocate(&platform_arena, sizeof(f64) * count_frames, alignof(f64));
+	RHI_Frame_Stats rhi_first_frame{};
+	RHI_Frame_Stats rhi_steady_total{};
+
+	App_State* app_state = (App_State*)game_memory.permanent_storage;
+	Arena_High_Water high_waters[] =
+	{
+		{ "persist", 		&app_state->arena_persist, 0, 0 },
+		{ "transient", 	&app_state->arena_transient, 0, 0 },
+		{ "frame", 			&app_state->arena_frame, 0, 0 },
+		{ "assets", 		&app_state->arena_assets, 0, 0 },
+	};
+
+	for (u32 frame_i = 0; frame_i < count_frames; ++frame_i)
+	{
+		u64 tick_start = Linux::get_performance_ticks();
+
+		// Input handling - no OS events, controller is kept connected and idle
+		Game_Controller* oldKeyboardMouseController = get_game_controller(old_inputs, 0);
+		Game_Controller* newKeyboardMouseController = get_game_controller(new_inputs, 0);
+		*newKeyboardMouseController = {};
+		newKeyboardMouseController->isConnected = true;
+		for (u32 i = 0; i < array_count_32(newKeyboardMouseController->buttons); ++i)
+		{
+			newKeyboardMouseController->buttons[i].wasDown = oldKeyboardMouseController->buttons[i].wasDown;
+			newKeyboardMouseController->mouse.x = oldKeyboardMouseController->mouse.x;
+			newKeyboardMouseController->mouse.y = oldKeyboardMouseController->mouse.y;
+		}
+
+		// Fixed 60Hz simulated time, so every run produces the same sequence of App states
+		game_window.time_ms = (f64)frame_i * 1000.0 / (f64)clock.target_fps;
+
+		// Call application
+		Data_To_RHI* rhi_data = app_full_update(&game_memory, &game_window, new_inputs);
+		AlwaysAssert(rhi_data != nullptr);
+		// Call RHI
+		u64 tick_rhi = Linux::get_performance_ticks();
+		rhi_run(rhi_data, &game_window);
+
+		rhi_times_ms[frame_i] = Linux::get_elapsed_ms_here(clock, tick_rhi);
+		frame_times_ms[frame_i] = Linux::get_elapsed_ms_here(clock, tick_start);
+		swap(old_inputs, new_inputs);
+
+		RHI_Frame_Stats rhi_stats = rhi_get_frame_stats();
+		if (frame_i == 0)
+		{
+			rhi_first_frame = rhi_stats;
+		}
+		else
+		{
+			rhi_steady_total.bytes_uploaded 			+= rhi_stats.bytes_uploaded;
+			rhi_steady_total.buffers_created 			+= rhi_stats.buffers_created;
+			rhi_steady_total.textures_created 		+= rhi_stats.textures_created;
+			rhi_steady_total.pipelines_created 		+= rhi_stats.pipelines_created;
+			rhi_steady_total.descriptors_written 	+= rhi_stats.descriptors_written;
+			rhi_steady_total.draws 								+= rhi_stats.draws;
+			rhi_steady_total.upload_waits 				+= rhi_stats.upload_waits;
+		}
+
+		for (auto& hw : high_waters)
+		{
+			hw.peak_bytes = lib::max(hw.peak_bytes, hw.arena->curr_offset);
+			hw.peak_committed_bytes = lib::max(hw.peak_committed_bytes, hw.arena->committed_size - hw.arena->children_size);
+		}
+
+#if defined(ALLOC_INSTRUMENTATION)
+		// Level load and last steady frame
+		if (frame_i == 0 || frame_i + 1 == count_frames)
+			alloc_print_report(stdout);
+#endif
+	}
+
+	// Report
+	{
+		printf("frames: %u\n", count_frames);
+		printf("first frame (init + level load): %.3lf ms, rhi %.3lf ms\n", frame_times_ms[0], rhi_times_ms[0]);
+
+		// Steady state frames only, first one is dominated by asset loading
+		u64 count_steady = count_frames - 1;
+		if (count_steady > 0)
+		{
+			Linux::print_times("steady frames cpu time", frame_times_ms + 1, count_steady);
+			Linux::print_times("steady rhi cpu time   ", rhi_times_ms + 1, count_steady);
+		}
+
+		printf("rhi first frame: %llu bytes uploaded | %u buffers | %u textures | %u pipelines | %u descriptors | %u draws\n",
+		       (unsigned long long)rhi_first_frame.bytes_uploaded, rhi_first_frame.buffers_created, 
+		       rhi_first_frame.textures_created, rhi_first_frame.pipelines_created,
+		       rhi_first_frame.descriptors_written, rhi_first_frame.draws);
+		printf("rhi resource heaps: %llu bytes placed | %u free blocks\n",
+		       (unsigned long long)rhi_first_frame.heap_bytes_placed, rhi_first_frame.heap_free_blocks);
+		printf("rhi first frame uploads: %u waits for full ring | %u oversized\n", 
+		       rhi_first_frame.upload_waits, rhi_first_frame.uploads_oversized);
+		if (count_steady > 0)
+		{
+			printf("rhi steady per frame: %.1lf bytes uploaded | %.2lf descriptors | %.2lf draws | %.2lf upload waits\n",
+			       (f64)rhi_steady_total.bytes_uploaded / (f64)count_steady,
+			       (f64)rhi_steady_total.descriptors_written / (f64)count_steady,
+			       (f64)rhi_steady_total.draws / (f64)count_steady,
+			       (f64)rhi_steady_total.upload_waits / (f64)count_steady);
+		}
+
+		// Ranges of child arenas are reported apart, they are committed by children and counted in their own lines
+		printf("arena high-water marks (used / max, committed peak -> at exit, reserved for children):\n");
+		for (const auto& hw : high_waters)
+		{
+			printf("  %-10s %14llu / %14llu bytes (%.2lf%%), committed %llu -> %llu bytes, children %llu bytes\n", hw.name,
+			       (unsigned long long)hw.peak_bytes, (unsigned long long)hw.arena->max_size,
+			       hw.arena->max_size ? 100.0 * (f64)hw.peak_bytes / (f64)hw.arena->max_size : 0.0,
+			       (unsigned long long)hw.peak_committed_bytes, 
+			       (unsigned long long)(hw.arena->committed_size - hw.arena->children_size),
+			       (unsigned long long)hw.arena->children_size);
+		}
+
+		// Committed parts of all arenas merge into same mappings, so only whole platform range is reported
+		printf("platform memory on huge pages: %llu bytes (%s)\n", 
+		       (unsigned long long)Linux::get_huge_page_bytes(platform_arena.base, platform_arena.max_size),
+		       is_huge_pages ? "requested" : "not requested");
+		
+		auto&& [resident_bytes, resident_peak_bytes] = Linux::get_process_resident_bytes();
+		printf("process resident memory: %llu bytes, peak %llu bytes\n", 
+		       (unsigned long long)resident_bytes, (unsigned long long)resident_peak_bytes);
+	}
+
+	return 0;
+}
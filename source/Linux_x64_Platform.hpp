@@ -0,0 +1,259 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fcntl.h>
+#include <unistd.h>
+
+//? Headless Linux platform layer implementations, intended to be used with "main" of headless runner only!
+//? There is no window, no GPU and no OS input, it exists to drive "app_full_update" on build/perf machines.
+//? Same as on Win32 all custom platform functions and structures are kept in its own "Linux" namespace
+//! DO NOT INCLUDE IT ENYWHERE ELSE THAN IN LINUX ENTRY POINT COMPILATION UNIT FILES (runner and tests)!
+namespace Linux
+{
+	// Values of DXGI_FORMAT enum, dxgiformat.h is not available here but App/RHI still expect those
+	inline constexpr u32 g_dxgi_format_r8g8b8a8_unorm 			= 28;
+	inline constexpr u32 g_dxgi_format_r8g8b8a8_unorm_srgb	= 29;
+
+	struct Platform_Clock
+	{
+		f32 delta_s;
+		s32 target_fps;
+		u64 clock_freq;
+	};
+
+	// ===============================================================================================================================
+	// ========================================================= TIMERS ==============================================================
+	// ===============================================================================================================================
+	internal Platform_Clock clock_create(s32 fps = 60)
+	{
+		return { .delta_s = 0.0f, .target_fps = fps, .clock_freq = 1000000000ull };
+	}
+
+	internal u64 get_performance_ticks()
+	{
+		timespec now{};
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		return (u64)now.tv_sec * 1000000000ull + (u64)now.tv_nsec;
+	}
+
+	internal f64 get_elapsed_ms_here(const Platform_Clock &clock, u64 tick_start)
+	{
+		return (f64)((get_performance_ticks() - tick_start) * 1000) / clock.clock_freq;
+	}
+
+	// ===============================================================================================================================
+	// ======================================================== THREADS ==============================================================
+	// ===============================================================================================================================
+
+	//? Runs "work(thread_i)" on "count_threads" threads started together, returns wall time of slowest one
+	internal f64 run_on_threads(const Platform_Clock& clock, u32 count_threads, auto work)
+	{
+		constexpr u32 max_count_threads = 256;
+		AlwaysAssert(count_threads <= max_count_threads);
+
+		std::atomic<u32> count_ready = 0;
+		std::atomic<b32> is_go = false;
+		std::thread threads[max_count_threads];
+		for (u32 thread_i = 0; thread_i < count_threads; ++thread_i)
+		{
+			threads[thread_i] = std::thread([&, thread_i] 
+			{
+				count_ready.fetch_add(1);
+				while (!is_go.load(std::memory_order_acquire)) {}
+				work(thread_i);
+			});
+		}
+
+		while (count_ready.load() != count_threads) {}
+		u64 tick_start = get_performance_ticks();
+		is_go.store(true, std::memory_order_release);
+		for (u32 thread_i = 0; thread_i < count_threads; ++thread_i)
+			threads[thread_i].join();
+
+		return get_elapsed_ms_here(clock, tick_start);
+	}
+
+	// ===============================================================================================================================
+	// ===================================================== HEADLESS IMAGES =========================================================
+	// ===============================================================================================================================
+
+	internal u32 read_big_endian_u16(const byte* at)
+	{
+		return ((u32)at[0] << 8) | (u32)at[1];
+	}
+
+	internal u32 read_big_endian_u32(const byte* at)
+	{
+		return ((u32)at[0] << 24) | ((u32)at[1] << 16) | ((u32)at[2] << 8) | (u32)at[3];
+	}
+
+	//? Only dimensions are needed - walks JPEG markers up to first "start of frame" or takes PNG IHDR chunk
+	internal auto read_img_dims(const byte* data, u64 size)
+	{
+		struct Output
+		{
+			u32 w; u32 h;
+		} out{};
+
+		constexpr byte png_signature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+		if (size >= 24 && memcmp(data, png_signature, sizeof(png_signature)) == 0)
+		{
+			out.w = read_big_endian_u32(data + 16);
+			out.h = read_big_endian_u32(data + 20);
+		}
+		else if (size >= 4 && data[0] == 0xFF && data[1] == 0xD8)
+		{
+			u64 at = 2;
+			while (at + 9 < size)
+			{
+				if (data[at] != 0xFF)
+				{ ++at; continue; }
+
+				byte marker = data[at + 1];
+				u32 segment_size = read_big_endian_u16(data + at + 2);
+				// SOF0 - SOF15 without DHT(C4), JPG(C8) and DAC(CC)
+				if (marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC)
+				{
+					out.h = read_big_endian_u16(data + at + 5);
+					out.w = read_big_endian_u16(data + at + 7);
+					break;
+				}
+				at += 2 + segment_size;
+			}
+		}
+
+		return out;
+	}
+
+	//? Counterpart of Win32::load_img_dxgi_compatible without decoding - there is no WIC on Linux.
+	//? Pixels are RGBA8 same as WIC conversion result for JPEG/PNG, so arena usage and bytes written match Win32,
+	//? content is a flat pattern which is enough for CPU side measurements
+	Image_View load_img_headless(String_View file_path, Alloc_Arena* arena, b32 is_srgb = true)
+	{
+		Image_View out{};
+
+		s32 file = open(file_path.str, O_RDONLY);
+		AlwaysAssert(file >= 0 && "Cant open image file!");
+		auto d = defer([&] { close(file); });
+
+		// Enough to reach SOF marker for most of JPEGs, skipped EXIF thumbnails may need more
+		byte header[KiB(64)];
+		s64 header_size = read(file, header, sizeof(header));
+		AlwaysAssert(header_size > 0 && "Cant read image file!");
+
+		auto&& [img_width, img_height] = read_img_dims(header, (u64)header_size);
+		AlwaysAssert(img_width > 0 && img_height > 0 && "Not supported image format!");
+
+		constexpr u32 bits_per_px = 32;
+		u32 bytes_per_row = img_width * bits_per_px / 8;
+		u32 img_size = bytes_per_row * img_height;
+
+		out.mem.data = allocate(arena, img_size);
+		memset(out.mem.data, 0x80, img_size);
+
+		out.mem.bytes = img_size;
+		out.format = is_srgb ? g_dxgi_format_r8g8b8a8_unorm_srgb : g_dxgi_format_r8g8b8a8_unorm;
+		out.width = img_width;
+		out.height = img_height;
+		out.bits_per_px = bits_per_px;
+
+		return out;
+	}
+
+	// ===============================================================================================================================
+	// ========================================================= MEMORY ==============================================================
+	// ===============================================================================================================================
+
+	//? Current and peak resident set size of the process in bytes (VmRSS & VmHWM), 0 when not available
+	[[maybe_unused]] internal auto get_process_resident_bytes()
+	{
+		struct Output
+		{
+			u64 current; u64 peak;
+		} out{};
+
+		FILE* fp = fopen("/proc/self/status", "r");
+		if (fp)
+		{
+			char line[256];
+			while (fgets(line, sizeof(line), fp))
+			{
+				unsigned long long kib = 0;
+				if (sscanf(line, "VmRSS: %llu kB", &kib) == 1)
+					out.current = (u64)KiB(kib);
+				else if (sscanf(line, "VmHWM: %llu kB", &kib) == 1)
+					out.peak = (u64)KiB(kib);
+			}
+			fclose(fp);
+		}
+
+		return out;
+	}
+
+	//? Bytes of [ptr, ptr + size) backed by transparent huge pages, summed over mappings overlapping the range
+	[[maybe_unused]] internal u64 get_huge_page_bytes(const void* ptr, u64 size)
+	{
+		u64 out = 0;
+		u64 range_start = (u64)ptr;
+		u64 range_end = range_start + size;
+
+		FILE* fp = fopen("/proc/self/smaps", "r");
+		if (fp)
+		{
+			char line[512];
+			b32 is_in_range = false;
+			while (fgets(line, sizeof(line), fp))
+			{
+				unsigned long long start = 0, end = 0, kib = 0;
+				if (sscanf(line, "%llx-%llx ", &start, &end) == 2)
+					is_in_range = start < range_end && end > range_start;
+				else if (is_in_range && sscanf(line, "AnonHugePages: %llu kB", &kib) == 1)
+					out += (u64)KiB(kib);
+			}
+			fclose(fp);
+		}
+
+		return out;
+	}
+
+	// ===============================================================================================================================
+	// ======================================================== STATISTICS ===========================================================
+	// ===============================================================================================================================
+
+	//? Nearest-rank percentile, "sorted" must be sorted ascending
+	internal f64 get_percentile(const f64* sorted, u64 count, f64 percent)
+	{
+		assert(count > 0);
+		u64 rank = (u64)lib::ceil((f32)(percent / 100.0 * (f64)count));
+		rank = (rank < 1) ? 1 : (rank > count ? count : rank);
+		return sorted[rank - 1];
+	}
+
+	internal void sort_f64(f64* data, u64 count)
+	{
+		qsort(data, count, sizeof(f64), [](const void* a, const void* b) 
+		      {
+		      	f64 diff = *(const f64*)a - *(const f64*)b;
+		      	return (diff > 0.0) - (diff < 0.0);
+		      });
+	}
+
+	//? Sorts samples in place! Printed in microseconds, steady frames are way below 1 ms
+	[[maybe_unused]] internal void print_times(const char* name, f64* samples_ms, u64 count)
+	{
+		f64 sum_ms = 0.0;
+		for (u64 i = 0; i < count; ++i)
+			sum_ms += samples_ms[i];
+
+		sort_f64(samples_ms, count);
+		printf("%s [us]: min %.2lf | mean %.2lf | p50 %.2lf | p90 %.2lf | p99 %.2lf | max %.2lf\n", name,
+		       samples_ms[0] * 1000.0,
+		       sum_ms / (f64)count * 1000.0,
+		       get_percentile(samples_ms, count, 50.0) * 1000.0,
+		       get_percentile(samples_ms, count, 90.0) * 1000.0,
+		       get_percentile(samples_ms, count, 99.0) * 1000.0,
+		       samples_ms[count - 1] * 1000.0);
+	}
+}
@@ -0,0 +1,146 @@
+#include <cstdio>
+#include <thread> // before "internal" macro from Utils.hpp
+#include <unordered_map>
+
+#include "Utils.hpp"
+#include "Allocators.hpp"
+#include "Views.hpp"
+#include "Slot_Map.hpp"
+#include "Offset_Allocator.hpp"
+#include "Hash_Map.hpp"
+#include "Strings.hpp"
+#include "Soa_Array.hpp"
+#include "Arena_Array.hpp"
+#include "VM_Array.hpp"
+#include "Queues.hpp"
+#include "Cpu_Features.hpp"
+#include "Bitset.hpp"
+#include "Math.hpp"
+#include "Math_x8.hpp"
+#include "Math_Kernels.hpp"
+
+#include "GameAsserts.hpp"
+#include "Shader_And_CPU_Common.h"
+#include "Linux_x64_Platform.hpp"
+
+//? Self-checks of my_lib building blocks, separate executable from headless runner so failed check fails the process.
+//? Usage (from build directory): DeRex12_tests [name] - without name all tests are run, exit code is 1 when any failed.
+//? Tests of one area live in their own file in "tests" directory and are listed in "g_tests" below
+
+//? Failed check is reported and counted, test goes on, so one run shows every broken check
+#define TestCheck(expression) (void)( \
+		(!!(expression)) || \
+		(Linux::test_check_failed(#expression, __FILE__, (unsigned)(__LINE__)), 0) \
+	)
+
+namespace Linux
+{
+	//? Every test gets empty arena, it is reset after test (everything is decommitted)
+	struct Test
+	{
+		const char* name;
+		void (*run)(Alloc_Arena* arena);
+	};
+
+	inline constexpr u64 g_test_arena_size = GiB(4);
+	inline constexpr u32 g_max_count_printed_checks = 8;
+
+	// Failed checks of running test, tests check from several threads too
+	inline std::atomic<u32> g_count_failed_checks = 0;
+
+	internal void test_check_failed(const char* expression, const char* file, unsigned line)
+	{
+		u32 count_failed = g_count_failed_checks.fetch_add(1) + 1;
+		if (count_failed <= g_max_count_printed_checks)
+			fprintf(stderr, "  FAILED: %s, file %s, line %u\n", expression, file, line);
+	}
+
+	//? xorshift64, same generator as benchmarks use, "state" must not be 0
+	internal u64 next_random(u64* state)
+	{
+		*state ^= *state << 13;
+		*state ^= *state >> 7;
+		*state ^= *state << 17;
+		return *state;
+	}
+
+	//? Uniform in -1 to 1
+	internal f32 next_random_f32(u64* state)
+	{
+		return (f32)(next_random(state) >> 40) / (f32)(1 << 24) * 2.0f - 1.0f;
+	}
+}
+
+#include "tests/Tests_Memory.hpp"
+#include "tests/Tests_Allocators.hpp"
+#include "tests/Tests_Containers.hpp"
+#include "tests/Tests_Math.hpp"
+
+namespace Linux
+{
+	inline constexpr Test g_tests[] =
+	{
+		{ "arena_temps", &test_arena_temps },
+		{ "arena_reclaim", &test_arena_reclaim },
+		{ "scratch", &test_scratch },
+		{ "arena_array", &test_arena_array },
+		{ "vm_array", &test_vm_array },
+		{ "pool_mt", &test_pool_mt },
+		{ "tlsf", &test_tlsf },
+		{ "offset_alloc", &test_offset_alloc },
+		{ "upload_ring", &test_upload_ring },
+		{ "slot_map", &test_slot_map },
+		{ "hash_map", &test_hash_map },
+		{ "intern", &test_intern },
+		{ "soa", &test_soa },
+		{ "queues", &test_queues },
+		{ "bitset", &test_bitset },
+		{ "math_x8", &test_math_x8 },
+		{ "simd_dispatch", &test_simd_dispatch },
+		{ "quat", &test_quat },
+		{ "trans4", &test_trans4 },
+		{ "culling", &test_culling },
+	};
+}
+
+int main(int argc, char** argv)
+{
+	AlwaysAssert(get_cpu_features().has_sse41 && "CPU without SSE4.1 is not supported!");
+	const char* name = (argc > 1) ? argv[1] : nullptr;
+
+	// Retained size of 0, so reset after every test gives all its pages back
+	Alloc_Arena arena = arena_from_reserved(vm_reserve(Linux::g_test_arena_size), Linux::g_test_arena_size, MiB(1), 0);
+	AlwaysAssert(arena.base && "Failed to reserve memory from OS");
+
+	u32 count_run = 0;
+	u32 count_failed = 0;
+	for (const auto& test : Linux::g_tests)
+	{
+		if (name && strcmp(name, test.name) != 0)
+			continue;
+
+		Linux::g_count_failed_checks = 0;
+		test.run(&arena);
+		arena_reset(&arena);
+
+		u32 count_failed_checks = Linux::g_count_failed_checks.load();
+		if (count_failed_checks == 0)
+			printf("[[ %s ]] ok\n", test.name);
+		else
+			printf("[[ %s ]] FAILED, %u checks\n", test.name, count_failed_checks);
+		count_failed += (count_failed_checks != 0);
+		++count_run;
+	}
+
+	if (count_run == 0)
+	{
+		printf("ERROR: unknown test \"%s\", available:", name);
+		for (const auto& test : Linux::g_tests)
+			printf(" %s", test.name);
+		printf("\n");
+		return 1;
+	}
+
+	printf("%u of %u tests passed\n", count_run - count_failed, count_run);
+	return (count_failed == 0) ? 0 : 1;
+}
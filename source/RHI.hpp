@@ -0,0 +1,25 @@
+#pragma once
+
+//? Backend-neutral entry points of the renderer. Backend is chosen at link time by compiling exactly one of
+//? RHI_*.cpp translation units (RHI_D3D12.cpp for Win32 build, RHI_Null.cpp for headless build)
+
+struct Data_To_RHI;
+struct Game_Window;
+
+//? Work issued by backend during last "rhi_run" call
+struct RHI_Frame_Stats
+{
+	u64 bytes_uploaded;
+	u64 heap_bytes_placed; // static resources in resource heaps, after this call
+	u32 heap_free_blocks;
+	u32 upload_waits; // upload ring was full
+	u32 uploads_oversized;
+	u32 buffers_created;
+	u32 textures_created;
+	u32 pipelines_created;
+	u32 descriptors_written;
+	u32 draws;
+};
+
+extern void rhi_run(Data_To_RHI* data_from_app, Game_Window* window);
+extern RHI_Frame_Stats rhi_get_frame_stats();
@@ -22,16 +22,20 @@
 #include "Allocators.hpp"
 #include "GameAsserts.hpp"
 #include "Views.hpp"
+#include "Slot_Map.hpp"
+#include "Hash_Map.hpp"
+#include "Strings.hpp"
+#include "Offset_Allocator.hpp"
 #include "Math.hpp"
 
 #define NOMINMAX
 
+#include "Render_Data.hpp"
+#include "RHI.hpp"
 #include "RHI_D3D12.hpp"
 #include "../external/dxc/dxcapi.h"       
 #include "../external/dxc/d3d12shader.h"
 
-#include "Render_Data.hpp"
-
 #include "DDSTextureLoader12.cpp"
 
 extern "C" { __declspec(dllexport) extern const UINT D3D12SDKVersion = 611;}
@@ -50,9 +54,15 @@ inline void THR(HRESULT) {}
 namespace DX
 {
 	internal constexpr u32 g_alloc_alignment = 512;
-	internal constexpr u64 g_upload_heap_max_size = MiB(500);
+	internal constexpr u64 g_upload_oversized_size = MiB(8); // bigger uploads get own buffer
+	internal constexpr u64 g_upload_ring_max_size = 2 * g_upload_oversized_size; // level upload flushes it when full
+	internal constexpr u64 g_heap_size_step = MiB(4); // heaps are sized to resources of level, rounded up to it
+	internal constexpr u32 g_max_count_placed_resources = 4096; // per heap
 	internal constexpr u64 g_max_count_cbv_srv_uav_descriptors = 128;
 	internal constexpr u32 g_max_count_texture_subresource = 72; // max: 12mips for cubemap
+	internal constexpr u32 g_max_count_buffers = 3 * g_max_count_static_draws;
+	internal constexpr u32 g_max_count_textures = g_count_material_textures * g_max_count_static_draws + 2; // + env maps
+	internal constexpr u32 g_max_count_pipelines = g_max_count_static_draws + 1; // + skybox
 	
 	internal RHI_State g_state{};
 		
@@ -126,30 +136,6 @@ namespace DX
 		return out;
 	}
 	
-	//TODO: change to own string implementation later
-	[[nodiscard]]
-	u64 get_file_name(const wchar_t* path, wchar_t* out_result, u32 size) 
-	{
-		u64 out_chars = 0;
-		
-		const wchar_t* last_slash = wcsrchr(path, L'\\');
-    
-		if (last_slash == nullptr) 
-		{
-			last_slash = wcsrchr(path, L'/');
-		}
-
-		const wchar_t* file_name = (last_slash != nullptr) ? last_slash + 1 : path;
-		const wchar_t* last_dot = wcsrchr(file_name, L'.');
-
-		out_chars = (last_dot != nullptr) ? (u64)(last_dot - file_name) : wcslen(file_name);
-
-		wcsncpy_s(out_result, size, file_name, out_chars);
-		out_result[out_chars] = L'\0';
-		
-		return out_chars;
-	}
-	
 	[[nodiscard]]
 	internal IDxcBlob* compile_shader_default(LPCWSTR path, LPCWSTR name, LPCWSTR entry_point, LPCWSTR target)
 	{
@@ -256,67 +242,234 @@ namespace DX
 	}
 	
 	[[nodiscard]]
-	internal Upload_Heap create_upload_heap(ID3D12Device2* device, u64 max_bytes)
+	internal ID3D12Resource* create_upload_buffer(ID3D12Device2* device, u64 max_bytes)
 	{
-		Upload_Heap out{};
+		ID3D12Resource* out = nullptr;
 		
 		THR(device->CreateCommittedResource(get_cptr<D3D12_HEAP_PROPERTIES>({ .Type = D3D12_HEAP_TYPE_UPLOAD }),
 		                                    D3D12_HEAP_FLAG_NONE,
 		                                    get_cptr(CD3DX12_RESOURCE_DESC::Buffer(max_bytes)),
 		                                    D3D12_RESOURCE_STATE_GENERIC_READ,
 		                                    nullptr,
-		                                    IID_PPV_ARGS(&out.heap)));
-		
-		THR(out.heap->Map(0, 
-		                  get_cptr<D3D12_RANGE>({ .Begin = 0, .End = 0 }), 
-		                  (void**) &out.heap_arena.base));
-		
-		out.gpu_base = out.heap->GetGPUVirtualAddress();
-		out.heap_arena.max_size = max_bytes;
+		                                    IID_PPV_ARGS(&out)));
 		
 		return out;
 	}
 	
 	[[nodiscard]]
-	internal auto allocate_to_upload_heap(Upload_Heap* heap, u64 size)
+	internal byte* map_upload_buffer(ID3D12Resource* buffer)
+	{
+		byte* out = nullptr;
+		THR(buffer->Map(0, 
+		                get_cptr<D3D12_RANGE>({ .Begin = 0, .End = 0 }), 
+		                (void**) &out));
+		return out;
+	}
+	
+	internal void create_upload_ring(Upload_Ring* upload, ID3D12Device2* device, u64 max_bytes)
+	{
+		*upload = {};
+		create_ring(&upload->ring, max_bytes);
+		upload->heap = create_upload_buffer(device, max_bytes);
+		upload->base_cpu = map_upload_buffer(upload->heap);
+		upload->gpu_base = upload->heap->GetGPUVirtualAddress();
+	}
+	
+	//? Ring regions & oversized buffers of completed fences are freed
+	internal void retire_uploads(Context* ctx, Upload_Ring* upload)
+	{
+		u64 completed_value = ctx->fence.ptr->GetCompletedValue();
+		ring_retire(&upload->ring, completed_value);
+		
+		for (u32 i = 0; i < upload->count_oversized;)
+		{
+			Oversized_Upload* one_off = &upload->oversized[i];
+			if (one_off->fence_value != 0 && one_off->fence_value <= completed_value)
+			{
+				RELEASE_SAFE(one_off->buffer);
+				*one_off = upload->oversized[--upload->count_oversized];
+			}
+			else
+			{
+				++i;
+			}
+		}
+	}
+	
+	//? Everything uploaded till now is used by work that signals "fence_value"
+	internal void submit_uploads(Upload_Ring* upload, u64 fence_value)
+	{
+		ring_submit(&upload->ring, fence_value);
+		for (u32 i = 0; i < upload->count_oversized; ++i)
+		{
+			if (upload->oversized[i].fence_value == 0)
+				upload->oversized[i].fence_value = fence_value;
+		}
+	}
+	
+	//? Whole ring is taken by recorded work - it is executed and waited for, recording continues in same command list.
+	//? Only level upload may do it, its command list has no state yet. Frame uploads must fit in ring next to frames in
+	//? flight, so frame only waits for oldest of them
+	internal void flush_uploads(Context* ctx, Upload_Ring* upload)
+	{
+		AlwaysAssert(upload->is_flush_allowed && "Upload ring is full of work of this frame, make it bigger!");
+		execute_and_wait(ctx);
+		THR(ctx->cmd_list->Reset(ctx->cmd_allocators[g_state.frame_index], nullptr));
+		submit_uploads(upload, ctx->fence.counter);
+		retire_uploads(ctx, upload);
+	}
+	
+	//? Waits for GPU only when ring is full
+	[[nodiscard]]
+	internal Upload_Region allocate_upload(Context* ctx, Upload_Ring* upload, u64 size, u64 alignment = g_alloc_alignment)
 	{
-		struct { u8* addr_cpu; D3D12_GPU_VIRTUAL_ADDRESS addr_gpu; }out;
+		Upload_Region out{};
+		g_state.frame_stats.bytes_uploaded += AlignAddressPow2(size, alignment);
 		
-		out.addr_cpu = (u8*)allocate(&heap->heap_arena, size, g_alloc_alignment);
-		out.addr_gpu = heap->gpu_base + heap->heap_arena.prev_offset; //prev offset was curr offset in cpu alloc
+		if (size > g_upload_oversized_size)
+		{
+			if (upload->count_oversized == g_max_count_oversized_uploads)
+				flush_uploads(ctx, upload);
+			
+			Oversized_Upload* one_off = &upload->oversized[upload->count_oversized++];
+			*one_off = { .buffer = create_upload_buffer(g_state.device, size) };
+			out = { one_off->buffer, 0, map_upload_buffer(one_off->buffer), one_off->buffer->GetGPUVirtualAddress() };
+			g_state.frame_stats.uploads_oversized += 1;
+			
+			return out;
+		}
+		
+		u64 offset = allocate_ring(&upload->ring, size, alignment);
+		while (offset == g_ring_full)
+		{
+			g_state.frame_stats.upload_waits += 1;
+			u64 oldest_fence = ring_get_oldest_fence(&upload->ring);
+			if (oldest_fence != 0)
+				sync_with_fence(&ctx->fence, oldest_fence);
+			else
+				flush_uploads(ctx, upload);
+			
+			retire_uploads(ctx, upload);
+			offset = allocate_ring(&upload->ring, size, alignment);
+		}
+		out = { upload->heap, offset, upload->base_cpu + offset, upload->gpu_base + offset };
 		
 		return out;
 	}
 	
-	internal D3D12_GPU_VIRTUAL_ADDRESS push_to_upload_heap(Upload_Heap* heap, Memory_View mem)
+	internal Upload_Region push_upload(Context* ctx, Upload_Ring* upload, Memory_View mem)
 	{
-		const auto [cpu_addr, gpu_addr] = allocate_to_upload_heap(heap, mem.bytes);
-		memcpy(cpu_addr, mem.data, mem.bytes);
+		Upload_Region out = allocate_upload(ctx, upload, mem.bytes);
+		memcpy(out.addr_cpu, mem.data, mem.bytes);
 			
-		return gpu_addr;
+		return out;
+	}
+	
+	internal Resource_Heap create_resource_heap(ID3D12Device2* device, u64 max_bytes, D3D12_HEAP_FLAGS flags, Alloc_Arena* arena)
+	{
+		Resource_Heap out{};
+		
+		CD3DX12_HEAP_DESC desc(max_bytes, D3D12_HEAP_TYPE_DEFAULT, 0, flags);
+		THR(device->CreateHeap(&desc, IID_PPV_ARGS(&out.heap)));
+		create_offset_allocator(&out.offsets, arena, max_bytes, g_max_count_placed_resources, 
+		                        get_placement_alignment(Placement_Class::small_texture));
+		
+		return out;
+	}
+	
+	internal void release_resource_heap(Resource_Heap* heap)
+	{
+		RELEASE_SAFE(heap->heap);
+		*heap = {};
+	}
+	
+	//? Size & alignment of resource in heap. Textures try small placement first, driver tells if it is allowed for them
+	[[nodiscard]]
+	internal D3D12_RESOURCE_ALLOCATION_INFO get_placement_info(ID3D12Device2* device, D3D12_RESOURCE_DESC* desc)
+	{
+		D3D12_RESOURCE_ALLOCATION_INFO out{};
+		if (desc->Dimension != D3D12_RESOURCE_DIMENSION_BUFFER)
+		{
+			Placement_Class placement = (desc->SampleDesc.Count > 1) ? Placement_Class::msaa : Placement_Class::small_texture;
+			desc->Alignment = get_placement_alignment(placement);
+			out = device->GetResourceAllocationInfo(0, 1, desc);
+			if (out.Alignment != desc->Alignment || out.SizeInBytes == UINT64_MAX)
+				desc->Alignment = 0;
+		}
+		if (desc->Alignment == 0)
+			out = device->GetResourceAllocationInfo(0, 1, desc);
+		
+		return out;
+	}
+	
+	//? Heap bytes resource may take, with worst case alignment gap before it
+	[[nodiscard]]
+	internal u64 get_placed_bytes(ID3D12Device2* device, D3D12_RESOURCE_DESC desc)
+	{
+		D3D12_RESOURCE_ALLOCATION_INFO info = get_placement_info(device, &desc);
+		return AlignAddressPow2(info.SizeInBytes, info.Alignment) + info.Alignment;
+	}
+	
+	//? Heaps only grow, both are made again when level does not fit in one of them. Nothing may be placed in them
+	//? then and GPU has to be done with old heaps
+	internal void fit_resource_heaps(ID3D12Device2* device, u64 buffer_bytes, u64 texture_bytes)
+	{
+		buffer_bytes = AlignAddressPow2(buffer_bytes, g_heap_size_step);
+		texture_bytes = AlignAddressPow2(texture_bytes, g_heap_size_step);
+		if (buffer_bytes <= g_state.buffer_heap.offsets.max_size && texture_bytes <= g_state.texture_heap.offsets.max_size)
+			return;
+		
+		assert(g_state.buffer_heap.offsets.count_allocs == 0 && g_state.texture_heap.offsets.count_allocs == 0 &&
+		       "Resources are still placed in heaps!");
+		buffer_bytes = lib::max(buffer_bytes, g_state.buffer_heap.offsets.max_size);
+		texture_bytes = lib::max(texture_bytes, g_state.texture_heap.offsets.max_size);
+		release_resource_heap(&g_state.buffer_heap);
+		release_resource_heap(&g_state.texture_heap);
+		
+		// Arena holds only node arrays of both heaps
+		arena_reset(&g_state.arena);
+		g_state.buffer_heap = create_resource_heap(device, buffer_bytes, D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS, &g_state.arena);
+		g_state.texture_heap = create_resource_heap(device, texture_bytes, D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES, 
+		                                            &g_state.arena);
 	}
 	
-	internal void reset_upload_heap(Upload_Heap* heap)
+	//? Range for resource in heap
+	[[nodiscard]]
+	internal Offset_Allocation place_resource(ID3D12Device2* device, Resource_Heap* heap, D3D12_RESOURCE_DESC* desc)
 	{
-		arena_reset_nz(&heap->heap_arena);
+		D3D12_RESOURCE_ALLOCATION_INFO info = get_placement_info(device, desc);
+		Offset_Allocation out = allocate_offset(&heap->offsets, info.SizeInBytes, info.Alignment);
+		AlwaysAssert(!is_null(out) && "Resource heap is full!");
+		
+		return out;
 	}
 	
 	//TODO: return handle to resource
-	internal Buffer create_buffer(ID3D12Device2* device, Memory_View mem)
+	internal Buffer create_buffer(ID3D12Device2* device, Resource_Heap* heap, Memory_View mem)
 	{
 		Buffer out{.size_bytes = mem.bytes, .stride_bytes = mem.stride};
 		
 		D3D12_RESOURCE_DESC desc = CD3DX12_RESOURCE_DESC::Buffer(mem.bytes);
-		THR(device->CreateCommittedResource(get_cptr(CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT)),
-																				D3D12_HEAP_FLAG_NONE,
-																				&desc,
-																				D3D12_RESOURCE_STATE_COMMON,
-																				nullptr,
-																				IID_PPV_ARGS(&out.ptr)));
+		out.placement = place_resource(device, heap, &desc);
+		THR(device->CreatePlacedResource(heap->heap,
+		                                 out.placement.offset,
+		                                 &desc,
+		                                 D3D12_RESOURCE_STATE_COMMON,
+		                                 nullptr,
+		                                 IID_PPV_ARGS(&out.ptr)));
+		g_state.frame_stats.buffers_created += 1;
 		
 		return out;
 	}
 	
+	//? Heap range is reused right away, GPU must be done with resource
+	internal void release_buffer(Resource_Heap* heap, Buffer* buf)
+	{
+		RELEASE_SAFE(buf->ptr);
+		free_offset(&heap->offsets, buf->placement);
+		buf->placement = {};
+	}
+	
 	internal u16 calc_mips(u32 width, u32 height)
 	{
 		u32 out = 1;
@@ -327,7 +480,7 @@ namespace DX
 		return (u16)out;
 	}
 	
-	internal Texture create_texture(ID3D12Device2* device, Image_View img, u16 arr_size = 1, u16 mips = 0)
+	internal Texture create_texture(ID3D12Device2* device, Resource_Heap* heap, Image_View img, u16 arr_size = 1, u16 mips = 0)
 	{
 		assert(arr_size == 1 || arr_size == 6);
 		
@@ -338,23 +491,33 @@ namespace DX
 		};
 		
 		u16 mip_levels = (mips > 0) ? mips : calc_mips(img.width, img.height);
+		out.mips = mip_levels;
 		D3D12_RESOURCE_DESC desc = 	CD3DX12_RESOURCE_DESC::Tex2D(out.format, out.width, out.height, arr_size, mip_levels);
-		THR(device->CreateCommittedResource(get_cptr(CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT)),
-																				D3D12_HEAP_FLAG_NONE,
-																				&desc,
-																				D3D12_RESOURCE_STATE_COMMON,
-																				nullptr,
-																				IID_PPV_ARGS(&out.ptr)));
+		out.placement = place_resource(device, heap, &desc);
+		THR(device->CreatePlacedResource(heap->heap,
+		                                 out.placement.offset,
+		                                 &desc,
+		                                 D3D12_RESOURCE_STATE_COMMON,
+		                                 nullptr,
+		                                 IID_PPV_ARGS(&out.ptr)));
+		g_state.frame_stats.textures_created += 1;
 		
 		return out;
 	}
 	
+	//? Committed textures (without placement) are only released
+	internal void release_texture(Resource_Heap* heap, Texture* tex)
+	{
+		RELEASE_SAFE(tex->ptr);
+		free_offset(&heap->offsets, tex->placement);
+		tex->placement = {};
+	}
+	
 	//TODO: take handle to resource
-	internal void push_to_default(Context* ctx, Buffer* buf, Upload_Heap* upload, Memory_View mem, D3D12_RESOURCE_STATES end_state)
+	internal void push_to_default(Context* ctx, Buffer* buf, Upload_Ring* upload, Memory_View mem, D3D12_RESOURCE_STATES end_state)
 	{
-		auto gpu_h = push_to_upload_heap(upload, mem);
-		u64 aligned_size = upload->heap_arena.curr_offset - upload->heap_arena.prev_offset;
-		ctx->cmd_list->CopyBufferRegion(buf->ptr, 0, upload->heap, upload->heap_arena.prev_offset, aligned_size);
+		Upload_Region region = push_upload(ctx, upload, mem);
+		ctx->cmd_list->CopyBufferRegion(buf->ptr, 0, region.resource, region.offset, mem.bytes);
 		ctx->cmd_list->ResourceBarrier(1, get_cptr(CD3DX12_RESOURCE_BARRIER::Transition
 																																						 (buf->ptr, 
 																																							D3D12_RESOURCE_STATE_COPY_DEST, 
@@ -363,7 +526,7 @@ namespace DX
 	} 
 	
 	internal void push_texture_to_default(ID3D12Device2* device, Context* ctx, Texture* tex, 
-																				Upload_Heap* upload, Memory_View mem, 
+																				Upload_Ring* upload, Memory_View mem, 
 																				D3D12_RESOURCE_STATES end_state = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE,
 																u32 num_subresources = 0)
 	{
@@ -378,33 +541,25 @@ namespace DX
 		device->GetCopyableFootprints(&desc, 0, count_subresources, 0, layouts, rows, row_bytes, &required_bytes);
 		
 		//TODO: more complete handling by Tardiff & MJP https://alextardif.com/D3D11To12P3.html
-		u64 dst_res_start_offset = 0;
+		// Whole footprint is taken at once, rows are placed with their pitch
+		Upload_Region region = allocate_upload(ctx, upload, required_bytes, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
 		for(u32 subres_i = 0; subres_i < count_subresources; ++subres_i)
 		{
 			byte* src_subres = (byte*)(mem.data) + layouts[subres_i].Offset;
+			byte* dst_subres = region.addr_cpu + layouts[subres_i].Offset;
 			for(u32 row_i = 0; row_i < rows[subres_i]; ++row_i)
 			{
-				byte* src_row = src_subres + row_i * row_bytes[subres_i];
-				push_to_upload_heap(upload, { src_row, row_bytes[subres_i] });
-				u64 allocated_row = upload->heap_arena.curr_offset - upload->heap_arena.prev_offset;
-				manual_offset(&upload->heap_arena, layouts[subres_i].Footprint.RowPitch - allocated_row);
-				
-				// get aligned start of the first subresource in upload
-				if (row_i == 0 && subres_i == 0)
-					dst_res_start_offset = upload->heap_arena.prev_offset;
+				memcpy(dst_subres + row_i * layouts[subres_i].Footprint.RowPitch, 
+				       src_subres + row_i * row_bytes[subres_i], row_bytes[subres_i]);
 			}
-			
-			//TODO: This is wrong, commented for now, fix!
-			//u64 dst_subres_offset = upload->heap_arena.curr_offset - dst_res_start_offset;
-			//manual_offset(&upload->heap_arena, layouts[subres_i].Offset - dst_subres_offset);
 		}
 		
 		//TODO: (change) single CopyTextureRegion starting from first subresource instead of each invidually
 		D3D12_TEXTURE_COPY_LOCATION src{};
-		src.pResource = upload->heap;
+		src.pResource = region.resource;
 		src.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
 		src.PlacedFootprint = layouts[0];
-		src.PlacedFootprint.Offset = dst_res_start_offset;
+		src.PlacedFootprint.Offset = region.offset + layouts[0].Offset;
 		
 		ctx->cmd_list->CopyTextureRegion(
 			get_cptr<D3D12_TEXTURE_COPY_LOCATION>({
@@ -421,32 +576,26 @@ namespace DX
 	
 	//TODO: temporary function that handles all uplaoding to default of .dds straight from disk
 	[[nodiscard]]
-	internal Texture load_and_push_dds(ID3D12Device2* device, Context* ctx, const wchar_t* path, 
+	internal Texture load_and_push_dds(ID3D12Device2* device, Context* ctx, Upload_Ring* upload, String_View path, 
 																		 D3D12_RESOURCE_STATES end_state = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE )
 	{
 		Texture out{};
 		
+		wchar_t path_wide[MAX_PATH];
+		str_to_wide(path, path_wide, MAX_PATH);
+		
 		ID3D12Resource* tex;
 		std::unique_ptr<uint8_t[]> dds_data;
 		std::vector<D3D12_SUBRESOURCE_DATA> subresources;
-		THR( DirectX::LoadDDSTextureFromFile(device, path, &tex, dds_data, subresources));
+		THR( DirectX::LoadDDSTextureFromFile(device, path_wide, &tex, dds_data, subresources));
+		g_state.frame_stats.textures_created += 1;
 	
 		const u64 upload_size = GetRequiredIntermediateSize(tex, 0, (u32)(subresources.size()));
 
-		// Create temporary upload heap
-		CD3DX12_HEAP_PROPERTIES heapProps(D3D12_HEAP_TYPE_UPLOAD);
-		auto desc = CD3DX12_RESOURCE_DESC::Buffer(upload_size);
-		ID3D12Resource* temp_upload_heap;
-		THR( device->CreateCommittedResource( &heapProps,
-																					D3D12_HEAP_FLAG_NONE,
-																					&desc,
-																					D3D12_RESOURCE_STATE_GENERIC_READ,
-																					nullptr,
-																					IID_PPV_ARGS(&temp_upload_heap)));
-		
 		// Push to default
-		UpdateSubresources(ctx->cmd_list, tex, temp_upload_heap,
-											 0, 0, (u32)(subresources.size()), subresources.data());
+		Upload_Region region = allocate_upload(ctx, upload, upload_size, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
+		UpdateSubresources(ctx->cmd_list, tex, region.resource,
+											 region.offset, 0, (u32)(subresources.size()), subresources.data());
 		
 		auto res_desc = tex->GetDesc();
 		
@@ -646,9 +795,22 @@ namespace DX
 		
 		// Create heaps
 		{
+			// Static resources are placed in few big heaps instead of one allocation per resource, heaps are made
+			// with first level (fit_resource_heaps), sized to what it needs
+			g_state.arena = arena_reserve(MiB(4), KiB(64));
+			AlwaysAssert(g_state.arena.base && "Failed to reserve memory from Windows");
+			
+			create_upload_ring(&g_state.upload_ring, g_state.device, g_upload_ring_max_size);
+			
+			// Tables of resources used by handles
+			g_state.arena_tables = arena_reserve(MiB(1), KiB(64));
+			AlwaysAssert(g_state.arena_tables.base && "Failed to reserve memory from Windows");
+			g_state.buffers.init(&g_state.arena_tables, g_max_count_buffers);
+			g_state.textures.init(&g_state.arena_tables, g_max_count_textures);
+			g_state.pipelines.init(&g_state.arena_tables, g_max_count_pipelines);
+			
 			for(u32 frame_i = 0; frame_i < g_count_backbuffers; ++frame_i)
 			{
-				g_state.upload_heaps[frame_i] = create_upload_heap(g_state.device, g_upload_heap_max_size);
 				g_state.cbv_srv_uav_heap[frame_i] = create_descriptor_heap(g_state.device, g_max_count_cbv_srv_uav_descriptors,
 																																	 D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, 
 																																	 D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE);
@@ -698,20 +860,27 @@ namespace DX
 	}
 	
 	[[nodiscard]]
-	internal Pipeline create_render_pipeline(ID3D12Device2* device, const wchar_t* vs_ps_path)
+	internal Pipeline create_render_pipeline(ID3D12Device2* device, String_View vs_ps_path)
 	{
 		Pipeline out{};
 		
+		// DXC takes wide strings only, names of outputs are "<file name>_ps" & "<file name>_vs"
 		constexpr u32 max_name_chars = 128;
+		wchar_t buffer_path[MAX_PATH];
 		wchar_t buffer_name[max_name_chars];
-		u64 name_chars = get_file_name(vs_ps_path, buffer_name, max_name_chars);
-		swprintf_s(buffer_name, max_name_chars - name_chars, L"%ls_ps", buffer_name);
+		str_to_wide(vs_ps_path, buffer_path, MAX_PATH);
+		String_View name = str_file_stem(vs_ps_path);
+		u32 name_chars = str_to_wide(name, buffer_name, max_name_chars - 3);
+		buffer_name[name_chars + 0] = L'_';
+		buffer_name[name_chars + 3] = L'\0';
 		
 		// Compile shaders
-		auto pixel_shader = compile_shader_default(vs_ps_path, buffer_name, L"PSMain", L"ps_6_6");
+		buffer_name[name_chars + 1] = L'p';
+		buffer_name[name_chars + 2] = L's';
+		auto pixel_shader = compile_shader_default(buffer_path, buffer_name, L"PSMain", L"ps_6_6");
 		buffer_name[name_chars + 1] = L'v';
 		buffer_name[name_chars + 2] = L's';
-		auto vertex_shader = compile_shader_default(vs_ps_path, buffer_name, L"VSMain", L"vs_6_6");
+		auto vertex_shader = compile_shader_default(buffer_path, buffer_name, L"VSMain", L"vs_6_6");
 		
 		auto d = defer([&] { RELEASE_SAFE(pixel_shader); RELEASE_SAFE(vertex_shader);});
 		
@@ -732,9 +901,67 @@ namespace DX
 			
 			THR(device->CreateGraphicsPipelineState(&pso_desc, IID_PPV_ARGS(&out.pso)));
 		}
+		g_state.frame_stats.pipelines_created += 1;
 		
 		return out;
 	}
+	
+	internal void release_pipeline(Pipeline* pipeline)
+	{
+		RELEASE_SAFE(pipeline->pso);
+		RELEASE_SAFE(pipeline->root_signature);
+	}
+	
+	//? Everything in tables goes away, heap ranges are reused by next level. GPU must be done with all of it
+	internal void release_static_resources()
+	{
+		for (u32 i = 0; i < g_state.buffers.count; ++i)
+			release_buffer(&g_state.buffer_heap, &g_state.buffers.data[i]);
+		for (u32 i = 0; i < g_state.textures.count; ++i)
+			release_texture(&g_state.texture_heap, &g_state.textures.data[i]);
+		for (u32 i = 0; i < g_state.pipelines.count; ++i)
+			release_pipeline(&g_state.pipelines.data[i]);
+		g_state.buffers.reset();
+		g_state.textures.reset();
+		g_state.pipelines.reset();
+		g_state.count_static_draws = 0;
+	}
+	
+	internal Resource_View push_buffer_view(ID3D12Device2* device, Descriptor_Heap* heap, const Buffer& buf)
+	{
+		return push_descriptor(device, heap, buf.ptr, 
+		                       {
+		                         .ViewDimension = D3D12_SRV_DIMENSION_BUFFER,
+		                         .Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING,
+		                         .Buffer = {
+		                                     .FirstElement = 0,
+		                                     .NumElements = (u32)buf.size_bytes / buf.stride_bytes,
+		                                     .StructureByteStride = buf.stride_bytes,
+		                                     .Flags = D3D12_BUFFER_SRV_FLAGS::D3D12_BUFFER_SRV_FLAG_NONE 
+		                       }});
+	}
+	
+	internal Resource_View push_texture_view(ID3D12Device2* device, Descriptor_Heap* heap, const Texture& tex)
+	{
+		return push_descriptor(device, heap, tex.ptr, 
+		                       {
+		                         .Format = tex.format,
+		                         .ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D,
+		                         .Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING,
+		                         .Texture2D = {.MipLevels = tex.mips}
+		                       });
+	}
+	
+	internal Resource_View push_cube_view(ID3D12Device2* device, Descriptor_Heap* heap, const Texture& tex)
+	{
+		return push_descriptor(device, heap, tex.ptr, 
+		                       {
+		                         .Format = tex.format,
+		                         .ViewDimension = D3D12_SRV_DIMENSION_TEXTURECUBE,
+		                         .Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING,
+		                         .TextureCube = {.MipLevels = tex.mips}
+		                       });
+	}
 } // namespace DX
 
 extern void rhi_run(Data_To_RHI* data_from_app, Game_Window* window)
@@ -761,61 +988,107 @@ extern void rhi_run(Data_To_RHI* data_from_app, Game_Window* window)
 	auto& fence_signals = g_state.fence_signals;
 	auto& frame_index 	= g_state.frame_index;
 	
-	auto& vertices_static = g_state.vertices_static;
-	auto& indices_static 	= g_state.indices_static;
-	auto& attr_static 		= g_state.attrs_static;
-	
-	auto& albedo_static 	= g_state.albedo_static;
-	auto& normal_static 	= g_state.normal_static;
-	auto& rough_static 		= g_state.rough_static;
-	auto& ao_static 			= g_state.ao_static;
-	
-	auto& env 						= g_state.env;
-	auto& env_irr 				= g_state.env_irr;
-	
-	auto& default_pso 		= g_state.default_pso;
-	auto& skybox_pso 			= g_state.skybox_pso;
-	
-	auto* upload_heap = &g_state.upload_heaps[frame_index];
+	auto* upload_ring = &g_state.upload_ring;
+	auto& frame_stats = g_state.frame_stats;
+	frame_stats = {};
 
 	// Static data upload
 	if (data_from_app->is_new_static) 
 	{
-		//TODO: should clear old ones ( wait till all frames finished before clear)
-		
-		// Create static shaders & psos
-		default_pso = create_render_pipeline(device, data_from_app->shader_path);
-		skybox_pso = create_render_pipeline(device, L"../source/shaders/skybox.hlsl");
-		
-		// Create & push static buffers
-		vertices_static = create_buffer(device, data_from_app->st_geo.positions);
-		push_to_default(ctx, &vertices_static, upload_heap, data_from_app->st_geo.positions, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
-		
-		indices_static = create_buffer(device, data_from_app->st_geo.indices);
-		push_to_default(ctx, &indices_static, upload_heap, data_from_app->st_geo.indices, D3D12_RESOURCE_STATE_INDEX_BUFFER);
-		
-		Memory_View attr_mem = data_from_app->st_geo.attributes.get_memory_view();
-		attr_static = create_buffer(device, attr_mem);
-		push_to_default(ctx, &attr_static, upload_heap, attr_mem, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
-		
-		// Create & push albedo
-		albedo_static = create_texture(device, data_from_app->st_albedo, 1, 1);
-		push_texture_to_default(device, ctx, &albedo_static, upload_heap, data_from_app->st_albedo.mem);
-		// Create & push normal
-		normal_static = create_texture(device, data_from_app->st_normal, 1, 1);
-		push_texture_to_default(device, ctx, &normal_static, upload_heap, data_from_app->st_normal.mem);
-		// Create & push roughness
-		rough_static = create_texture(device, data_from_app->st_roughness, 1, 1);
-		push_texture_to_default(device, ctx, &rough_static, upload_heap, data_from_app->st_roughness.mem);
-		// Create & push ambient occlusion
-		ao_static = create_texture(device, data_from_app->st_ao, 1, 1);
-		push_texture_to_default(device, ctx, &ao_static, upload_heap, data_from_app->st_ao.mem);
-		
-		env = load_and_push_dds(device, ctx, L"../assets/resting.dds");
-		env_irr = load_and_push_dds(device, ctx, L"../assets/resting_IR.dds");
+		upload_ring->is_flush_allowed = true;
+		// Previous level resources go away, their heap ranges are reused by new ones
+		if (g_state.buffers.count > 0 || g_state.textures.count > 0)
+		{
+			wait_for_work(ctx);
+			release_static_resources();
+		}
+		
+		// Static assets are resolved from App tables, each distinct one gets single resource
+		Render_Assets* assets = data_from_app->assets;
+		Static_Assets level = gather_static_assets(data_from_app->static_draws);
+		Geometry* geometries[g_max_count_static_draws];
+		Image_View* images[g_max_count_static_draws * g_count_material_textures];
+		for (u32 i = 0; i < level.count_geometries; ++i)
+		{
+			geometries[i] = assets->geometries.get(level.geometries[i]);
+			AlwaysAssert(geometries[i] && "Stale asset handle!");
+		}
+		for (u32 i = 0; i < level.count_images; ++i)
+		{
+			images[i] = assets->images.get(level.images[i]);
+			AlwaysAssert(images[i] && "Stale asset handle!");
+		}
+		
+		// Heaps get size of this level resources, same descs as their creation below uses
+		{
+			u64 buffer_bytes = 0;
+			u64 texture_bytes = 0;
+			for (u32 i = 0; i < level.count_geometries; ++i)
+			{
+				Memory_View streams[] = { geometries[i]->positions, geometries[i]->indices, 
+				                          geometries[i]->attributes.get_memory_view() };
+				for (const Memory_View& mem : streams)
+					buffer_bytes += get_placed_bytes(device, CD3DX12_RESOURCE_DESC::Buffer(mem.bytes));
+			}
+			for (u32 i = 0; i < level.count_images; ++i)
+				texture_bytes += get_placed_bytes(device, CD3DX12_RESOURCE_DESC::Tex2D((DXGI_FORMAT)images[i]->format, 
+				                                                                       images[i]->width, images[i]->height, 1, 1));
+			fit_resource_heaps(device, buffer_bytes, texture_bytes);
+		}
+		
+		// Create static shaders & psos, one per distinct shader
+		Handle<Pipeline> pipelines[g_max_count_static_draws];
+		for (u32 i = 0; i < level.count_shader_paths; ++i)
+			pipelines[i] = g_state.pipelines.insert(create_render_pipeline(device, get_string(&assets->names, level.shader_paths[i])));
+		g_state.skybox_pso = g_state.pipelines.insert(create_render_pipeline(device, str_view("../source/shaders/skybox.hlsl")));
+		
+		// Create & push static buffers - vertices, indices & attributes of every geometry
+		Handle<Buffer> geometry_buffers[g_max_count_static_draws][3];
+		for (u32 i = 0; i < level.count_geometries; ++i)
+		{
+			Memory_View streams[] = { geometries[i]->positions, geometries[i]->indices, 
+			                          geometries[i]->attributes.get_memory_view() };
+			D3D12_RESOURCE_STATES end_states[] = { D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE, 
+			                                       D3D12_RESOURCE_STATE_INDEX_BUFFER,
+			                                       D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE };
+			for (u32 stream_i = 0; stream_i < array_count_32(streams); ++stream_i)
+			{
+				Buffer buf = create_buffer(device, &g_state.buffer_heap, streams[stream_i]);
+				push_to_default(ctx, &buf, upload_ring, streams[stream_i], end_states[stream_i]);
+				geometry_buffers[i][stream_i] = g_state.buffers.insert(buf);
+			}
+		}
+		
+		// Create & push material textures
+		Handle<Texture> textures[g_max_count_static_draws * g_count_material_textures];
+		for (u32 i = 0; i < level.count_images; ++i)
+		{
+			Texture tex = create_texture(device, &g_state.texture_heap, *images[i], 1, 1);
+			push_texture_to_default(device, ctx, &tex, upload_ring, images[i]->mem);
+			textures[i] = g_state.textures.insert(tex);
+		}
+		
+		g_state.env = g_state.textures.insert(load_and_push_dds(device, ctx, upload_ring, str_view("../assets/resting.dds")));
+		g_state.env_irr = g_state.textures.insert(load_and_push_dds(device, ctx, upload_ring, str_view("../assets/resting_IR.dds")));
+		
+		for (s32 draw_i = 0; draw_i < data_from_app->static_draws.count; ++draw_i)
+		{
+			Static_Draw_Resources* draw = &g_state.static_draws[draw_i];
+			Handle<Buffer>* buffers = geometry_buffers[level.draw_geometry[draw_i]];
+			*draw = { .vertices = buffers[0], .indices = buffers[1], .attributes = buffers[2], .textures = {},
+			          .pipeline = pipelines[level.draw_shader_path[draw_i]] };
+			for (u32 tex_i = 0; tex_i < g_count_material_textures; ++tex_i)
+				draw->textures[tex_i] = textures[level.draw_images[draw_i][tex_i]];
+		}
+		g_state.count_static_draws = (u32)data_from_app->static_draws.count;
 		
 		execute_and_wait(ctx);
+		submit_uploads(upload_ring, ctx->fence.counter);
+		retire_uploads(ctx, upload_ring);
+		upload_ring->is_flush_allowed = false;
 	}
+	frame_stats.heap_bytes_placed = g_state.buffer_heap.offsets.used_bytes + g_state.texture_heap.offsets.used_bytes;
+	frame_stats.heap_free_blocks = g_state.buffer_heap.offsets.count_free_blocks + g_state.texture_heap.offsets.count_free_blocks;
 	
 	// RTV & DSV check for re/creation
 	if (window->width != width || window->height != height || !rtv_texture[0])
@@ -901,7 +1174,7 @@ extern void rhi_run(Data_To_RHI* data_from_app, Game_Window* window)
 			
 		THR(cmd_alloc->Reset());
 		// Reset current command list taken from current command allocator
-		THR(ctx->cmd_list->Reset(cmd_alloc, default_pso.pso));
+		THR(ctx->cmd_list->Reset(cmd_alloc, nullptr));
 			
 		// Clear rtv & dsv
 		{
@@ -917,79 +1190,12 @@ extern void rhi_run(Data_To_RHI* data_from_app, Game_Window* window)
 			ctx->cmd_list->OMSetRenderTargets(1, &rtv_handle, FALSE, &dsv_heap->base.h_cpu);
 		}
 			
-		D3D12_GPU_VIRTUAL_ADDRESS cbv_gpu_addr_frame = push_to_upload_heap(upload_heap, data_from_app->cb_frame);
-		D3D12_GPU_VIRTUAL_ADDRESS cbv_gpu_addr_draw = push_to_upload_heap(upload_heap, data_from_app->cb_draw);
-		
-		//TODO: This will need proper refactor along with whole resource/view/descriptor_heap managment
-		Resource_View view_verts = push_descriptor(device, cbv_srv_uav_heap, vertices_static.ptr, 
-																								 {
-																										.ViewDimension = D3D12_SRV_DIMENSION_BUFFER,
-																										.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING,
-																										.Buffer = {
-																															.FirstElement = 0,
-																															.NumElements = (u32)vertices_static.size_bytes / vertices_static.stride_bytes,
-																															.StructureByteStride = vertices_static.stride_bytes,
-																															.Flags = D3D12_BUFFER_SRV_FLAGS::D3D12_BUFFER_SRV_FLAG_NONE 
-																									}});
-			
-		Resource_View view_attrs = push_descriptor(device, cbv_srv_uav_heap, attr_static.ptr, 
-																							 {
-																								 .ViewDimension = D3D12_SRV_DIMENSION_BUFFER,
-																								 .Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING,
-																								 .Buffer = {
-																													 .FirstElement = 0,
-																													 .NumElements = (u32)attr_static.size_bytes / attr_static.stride_bytes,
-																													 .StructureByteStride = attr_static.stride_bytes,
-																													 .Flags = D3D12_BUFFER_SRV_FLAGS::D3D12_BUFFER_SRV_FLAG_NONE 
-																								 }});
-		
-		Resource_View view_tex_albedo = push_descriptor(device, cbv_srv_uav_heap, albedo_static.ptr, 
-																										{
-																											.Format = albedo_static.format,
-																											.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D,
-																											.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING,
-																											.Texture2D = {.MipLevels = 1}
-																										});
-		
-		Resource_View view_tex_normal = push_descriptor(device, cbv_srv_uav_heap, normal_static.ptr, 
-																									 {
-																										 .Format = normal_static.format,
-																										 .ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D,
-																										 .Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING,
-																										 .Texture2D = {.MipLevels = 1}
-																									 });
-		
-		Resource_View view_tex_rough = push_descriptor(device, cbv_srv_uav_heap, rough_static.ptr, 
-																										{
-																											.Format = rough_static.format,
-																											.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D,
-																											.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING,
-																											.Texture2D = {.MipLevels = 1}
-																										});
-		
-		Resource_View view_ao = push_descriptor(device, cbv_srv_uav_heap, ao_static.ptr, 
-																									 {
-																										 .Format = ao_static.format,
-																										 .ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D,
-																										 .Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING,
-																										 .Texture2D = {.MipLevels = 1}
-																									 });
-		
-		Resource_View view_env = push_descriptor(device, cbv_srv_uav_heap, env.ptr, 
-																						{
-																							.Format = env.format,
-																							.ViewDimension = D3D12_SRV_DIMENSION_TEXTURECUBE,
-																							.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING,
-																							.TextureCube = {.MipLevels = env.mips}
-																						});
-		
-		Resource_View view_env_irr = push_descriptor(device, cbv_srv_uav_heap, env_irr.ptr, 
-																						 {
-																							 .Format = env_irr.format,
-																							 .ViewDimension = D3D12_SRV_DIMENSION_TEXTURECUBE,
-																							 .Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING,
-																							 .TextureCube = {.MipLevels = env_irr.mips}
-																						 });
+		D3D12_GPU_VIRTUAL_ADDRESS cbv_gpu_addr_frame = push_upload(ctx, upload_ring, data_from_app->cb_frame).addr_gpu;
+		D3D12_GPU_VIRTUAL_ADDRESS cbv_gpu_addr_draw = push_upload(ctx, upload_ring, data_from_app->cb_draw).addr_gpu;
+		
+		// Env maps are shared by every draw
+		Resource_View view_env = push_cube_view(device, cbv_srv_uav_heap, *g_state.textures.get(g_state.env));
+		Resource_View view_env_irr = push_cube_view(device, cbv_srv_uav_heap, *g_state.textures.get(g_state.env_irr));
 		
 		// Populate command list
 		{
@@ -999,35 +1205,61 @@ extern void rhi_run(Data_To_RHI* data_from_app, Game_Window* window)
 			ctx->cmd_list->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 			ctx->cmd_list->SetDescriptorHeaps(1, &cbv_srv_uav_heap->heap);
 			
-			// Drawing static data
+			// Drawing static data, views of culled draws are still written so descriptor count does not depend on culling
+			AlwaysAssert(data_from_app->static_draws.count == (s32)g_state.count_static_draws && 
+			             "Static draws changed without new static data!");
+			for (u32 draw_i = 0; draw_i < g_state.count_static_draws; ++draw_i)
 			{
-				ctx->cmd_list->SetGraphicsRootSignature(default_pso.root_signature);
+				const Static_Draw_Resources& draw = g_state.static_draws[draw_i];
+				const Pipeline* pipeline = g_state.pipelines.get(draw.pipeline);
+				const Texture* textures[g_count_material_textures];
+				for (u32 tex_i = 0; tex_i < g_count_material_textures; ++tex_i)
+					textures[tex_i] = g_state.textures.get(draw.textures[tex_i]);
+				
+				//TODO: find a way to generalize this
+				Draw_Ids ids {
+					.pos_id = push_buffer_view(device, cbv_srv_uav_heap, *g_state.buffers.get(draw.vertices)).id,
+					.attr_id = push_buffer_view(device, cbv_srv_uav_heap, *g_state.buffers.get(draw.attributes)).id,
+					.albedo_id = push_texture_view(device, cbv_srv_uav_heap, *textures[0]).id,
+					.normal_id = push_texture_view(device, cbv_srv_uav_heap, *textures[1]).id,
+					.rough_id = push_texture_view(device, cbv_srv_uav_heap, *textures[2]).id,
+					.ao_id = push_texture_view(device, cbv_srv_uav_heap, *textures[3]).id,
+					.env_id = view_env.id,
+					.env_irr_id = view_env_irr.id
+				};
+				if (!data_from_app->static_draws[draw_i].is_visible)
+					continue;
+				
+				ctx->cmd_list->SetPipelineState(pipeline->pso);
+				ctx->cmd_list->SetGraphicsRootSignature(pipeline->root_signature);
 				ctx->cmd_list->SetGraphicsRootConstantBufferView(2, cbv_gpu_addr_frame);
 				ctx->cmd_list->SetGraphicsRootConstantBufferView(1, cbv_gpu_addr_draw);
-				//TODO: find a way to generalize this
-				ctx->cmd_list->SetGraphicsRoot32BitConstants(0, sizeof(Draw_Ids) / sizeof(u32),
-																										 get_cptr(Draw_Ids{
-																											view_verts.id, 
-																											view_attrs.id,
-																											view_tex_albedo.id,
-																											view_tex_normal.id,
-																											view_tex_rough.id,
-																											view_ao.id,
-																											view_env.id,
-																											view_env_irr.id
-																										}), 0);
+				ctx->cmd_list->SetGraphicsRoot32BitConstants(0, sizeof(Draw_Ids) / sizeof(u32), &ids, 0);
 				
-				auto view_indices = get_index_buffer_view(indices_static);
+				auto view_indices = get_index_buffer_view(*g_state.buffers.get(draw.indices));
 				ctx->cmd_list->IASetIndexBuffer(&view_indices);
 				ctx->cmd_list->DrawIndexedInstanced(get_count_indices(view_indices), 1, 0, 0, 0);
+				frame_stats.draws += 1;
 			}
 			
-			// Drawing skybox
+			// Drawing skybox, only env maps are read from its ids
 			{
-				ctx->cmd_list->SetPipelineState(skybox_pso.pso);
+				const Pipeline* skybox = g_state.pipelines.get(g_state.skybox_pso);
+				Draw_Ids ids{};
+				ids.env_id = view_env.id;
+				ids.env_irr_id = view_env_irr.id;
+				
+				ctx->cmd_list->SetPipelineState(skybox->pso);
+				ctx->cmd_list->SetGraphicsRootSignature(skybox->root_signature);
+				ctx->cmd_list->SetGraphicsRootConstantBufferView(2, cbv_gpu_addr_frame);
+				ctx->cmd_list->SetGraphicsRootConstantBufferView(1, cbv_gpu_addr_draw);
+				ctx->cmd_list->SetGraphicsRoot32BitConstants(0, sizeof(Draw_Ids) / sizeof(u32), &ids, 0);
 				ctx->cmd_list->DrawInstanced(3, 1, 0, 0);
+				frame_stats.draws += 1;
 			}
 		}
+		
+		frame_stats.descriptors_written = cbv_srv_uav_heap->count;
 			
 		// Present
 		{
@@ -1045,6 +1277,7 @@ extern void rhi_run(Data_To_RHI* data_from_app, Game_Window* window)
 				
 			// Signal the end of direct context work for this frame and store its value for later synchronization
 			fence_signals[frame_index] = signal(ctx);
+			submit_uploads(upload_ring, fence_signals[frame_index]);
 				
 			// Get next backbuffer index - updated on swapchain by Present()
 			frame_index = swapchain->GetCurrentBackBufferIndex();
@@ -1052,8 +1285,13 @@ extern void rhi_run(Data_To_RHI* data_from_app, Game_Window* window)
 			// Wait for fence value from next frame from swapchain - not waiting on current frame
 			sync_with_fence(&ctx->fence, fence_signals[frame_index]);
 			// Heaps from next frame are safe to reset cause work from that frame has finished
-			reset_upload_heap(&g_state.upload_heaps[frame_index]);
+			retire_uploads(ctx, upload_ring);
 			reset_descriptor_heap(&g_state.cbv_srv_uav_heap[frame_index]);
 		}
 	}
+}
+
+extern RHI_Frame_Stats rhi_get_frame_stats()
+{
+	return DX::g_state.frame_stats;
 }
\ No newline at end of file
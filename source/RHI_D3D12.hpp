@@ -8,6 +8,7 @@
 
 inline constexpr u8 g_count_backbuffers = 3;
 inline constexpr u32 max_temp_barriers = 32;
+inline constexpr u32 g_max_count_oversized_uploads = 32;
 
 struct Data_To_RHI;
 
@@ -33,11 +34,42 @@ namespace DX
 		HANDLE event;
 	};
 	
-	struct Upload_Heap
+	//? Upload too big for ring, has own buffer released when its fence completes (0 until submitted)
+	struct Oversized_Upload
 	{
-		Alloc_Arena heap_arena;
+		ID3D12Resource* buffer;
+		u64 fence_value;
+	};
+	
+	//? Single persistently mapped upload buffer used as ring, regions are retired by direct queue fence values
+	struct Upload_Ring
+	{
+		Alloc_Ring ring;
 		ID3D12Resource* heap;
+		byte* base_cpu;
     D3D12_GPU_VIRTUAL_ADDRESS gpu_base;
+		
+		Oversized_Upload oversized[g_max_count_oversized_uploads];
+		u32 count_oversized;
+		
+		// Set only for level upload, frame command list has render state that flush would lose with its reset
+		b32 is_flush_allowed;
+	};
+	
+	//? Place of upload, "offset" is in "resource" (ring buffer or oversized one)
+	struct Upload_Region
+	{
+		ID3D12Resource* resource;
+		u64 offset;
+		byte* addr_cpu;
+		D3D12_GPU_VIRTUAL_ADDRESS addr_gpu;
+	};
+	
+	//? Default heap with resources placed in it, ranges are given by offset allocator
+	struct Resource_Heap
+	{
+		ID3D12Heap* heap;
+		Alloc_Offset offsets;
 	};
 	
 	struct Descriptor_Heap
@@ -58,6 +90,7 @@ struct Buffer
 	D3D12_RESOURCE_STATES state;
 	u64 size_bytes;
 	u32 stride_bytes;
+	Offset_Allocation placement;
 };
 
 struct Texture
@@ -68,6 +101,7 @@ struct Texture
 	u32 width;
 	u32 height;
 	u16 mips;
+	Offset_Allocation placement; // null for committed resource
 };
 
 struct Pipeline
@@ -76,6 +110,16 @@ struct Pipeline
 	ID3D12RootSignature* root_signature;
 };
 
+//? Resources of one static draw, handles of RHI_State tables
+struct Static_Draw_Resources
+{
+	Handle<Buffer> vertices;
+	Handle<Buffer> indices;
+	Handle<Buffer> attributes;
+	Handle<Texture> textures[g_count_material_textures];
+	Handle<Pipeline> pipeline;
+};
+
 struct Context
 {
 	ID3D12CommandQueue* queue;
@@ -103,31 +147,31 @@ struct RHI_State
 	Texture dsv_texture;
 	DX::Descriptor_Heap dsv_heap;
 	
-	DX::Upload_Heap upload_heaps[g_count_backbuffers];
+	Alloc_Arena arena; // bookkeeping of heaps
+	DX::Resource_Heap buffer_heap;
+	DX::Resource_Heap texture_heap;
+	DX::Upload_Ring upload_ring;
 	DX::Descriptor_Heap cbv_srv_uav_heap[g_count_backbuffers];
 	
 	u32 frame_index;
 	u64 fence_signals[g_count_backbuffers];
+	RHI_Frame_Stats frame_stats;
 	
 	b32 is_initalized;
 	b32 vsync;
 	u32 width;
 	u32 height;
 	
-	// Data State
-	//TODO: Managment and/or abstraction 
-	Buffer vertices_static;
-	Buffer indices_static;
-	Buffer attrs_static;
-	
-	Texture albedo_static;
-	Texture normal_static;
-	Texture rough_static;
-	Texture ao_static;
+	// Data State, every resource is used by handle
+	Alloc_Arena arena_tables;
+	Slot_Map<Buffer> buffers;
+	Slot_Map<Texture> textures;
+	Slot_Map<Pipeline> pipelines;
 	
-	Texture env;
-	Texture env_irr;
+	Static_Draw_Resources static_draws[g_max_count_static_draws];
+	u32 count_static_draws;
 	
-	Pipeline default_pso;
-	Pipeline skybox_pso;
+	Handle<Texture> env;
+	Handle<Texture> env_irr;
+	Handle<Pipeline> skybox_pso;
 };
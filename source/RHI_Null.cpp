@@ -0,0 +1,404 @@
+/* Null RHI backend
+*
+* Consumes Data_To_RHI exactly like RHI_D3D12.cpp does, but instead of talking to a device it records
+* resource creations, uploads, descriptor writes and draws into a compact command log. Sizes follow D3D12
+* backend placement rules (upload alignment, texture row pitch), so stats are a CPU-only cost model of the
+* render path and can be used as a regression baseline on machines without GPU.
+* */
+
+#include <cstdio>
+
+#include "Utils.hpp"
+#include "Allocators.hpp"
+#include "GameAsserts.hpp"
+#include "Views.hpp"
+#include "Slot_Map.hpp"
+#include "Hash_Map.hpp"
+#include "Strings.hpp"
+#include "Offset_Allocator.hpp"
+#include "Math.hpp"
+
+#include "Render_Data.hpp"
+
+#include "RHI.hpp"
+#include "RHI_Null.hpp"
+
+namespace Null
+{
+	// Same placement rules as D3D12 backend uses for its upload heaps
+	internal constexpr u64 g_alloc_alignment = 512;
+	internal constexpr u64 g_texture_pitch_alignment = 256; // D3D12_TEXTURE_DATA_PITCH_ALIGNMENT
+	internal constexpr u64 g_heap_size_step = MiB(4); // heaps are sized to resources of level, rounded up to it
+	internal constexpr u32 g_max_count_placed_resources = 4096; // per heap
+	internal constexpr u32 g_max_count_buffers = 3 * g_max_count_static_draws;
+	internal constexpr u32 g_max_count_textures = g_count_material_textures * g_max_count_static_draws + 2; // + env maps
+	internal constexpr u32 g_max_count_pipelines = g_max_count_static_draws + 1; // + skybox
+	internal constexpr u64 g_upload_oversized_size = MiB(8); // bigger uploads get own buffer
+	internal constexpr u64 g_upload_ring_max_size = 2 * g_upload_oversized_size; // level upload flushes it when full
+	internal constexpr u64 g_count_frames_in_flight = 3; // D3D12 backend waits for frame that used next backbuffer
+
+	internal RHI_Null_State g_state{};
+
+	internal void record(Cmd_Type type, u32 resource, u64 value)
+	{
+		g_state.cmd_log.push({ .type = type, .resource = resource, .value = value });
+	}
+
+	//? Simulated GPU, work completes only when waited for - at the end of frame that is work of oldest frame in flight
+	[[nodiscard]]
+	internal u64 signal()
+	{
+		return ++g_state.fence_counter;
+	}
+
+	internal void sync_with_fence(u64 value_to_wait)
+	{
+		g_state.fence_completed = lib::max(g_state.fence_completed, value_to_wait);
+		ring_retire(&g_state.upload_ring, g_state.fence_completed);
+	}
+
+	//? Same ring as D3D12 backend uses, oversized uploads have one-off buffers there, nothing to track here
+	internal void push_upload(u32 resource, u64 bytes)
+	{
+		u64 aligned_bytes = AlignAddressPow2(bytes, g_alloc_alignment);
+		record(Cmd_Type::upload, resource, aligned_bytes);
+		g_state.frame_stats.bytes_uploaded += aligned_bytes;
+
+		if (bytes > g_upload_oversized_size)
+		{
+			g_state.frame_stats.uploads_oversized += 1;
+			return;
+		}
+
+		while (allocate_ring(&g_state.upload_ring, bytes, g_alloc_alignment) == g_ring_full)
+		{
+			g_state.frame_stats.upload_waits += 1;
+			u64 oldest_fence = ring_get_oldest_fence(&g_state.upload_ring);
+			if (oldest_fence == 0)
+			{
+				// Whole ring is taken by recorded work, it is executed and waited for - D3D12 backend can do it only
+				// before frame command list gets its state
+				AlwaysAssert(g_state.is_upload_flush_allowed && "Upload ring is full of work of this frame, make it bigger!");
+				oldest_fence = signal();
+				ring_submit(&g_state.upload_ring, oldest_fence);
+			}
+			sync_with_fence(oldest_fence);
+		}
+	}
+
+	//? Heaps are made with first level (fit_resource_heaps), sized to what it needs
+	internal void init_heaps()
+	{
+		g_state.arena = arena_reserve(MiB(4), KiB(64));
+		AlwaysAssert(g_state.arena.base && "Failed to reserve memory from OS");
+	}
+
+	internal void init_tables()
+	{
+		g_state.arena_tables = arena_reserve(MiB(1), KiB(64));
+		AlwaysAssert(g_state.arena_tables.base && "Failed to reserve memory from OS");
+		g_state.buffers.init(&g_state.arena_tables, g_max_count_buffers);
+		g_state.textures.init(&g_state.arena_tables, g_max_count_textures);
+		g_state.pipelines.init(&g_state.arena_tables, g_max_count_pipelines);
+	}
+
+	//? Device would report size & alignment, here buffers take 64 KiB granularity and textures up to 64 KiB get small
+	//? placement, which is what drivers give for single mip textures
+	[[nodiscard]]
+	internal Placement_Class get_texture_placement(u64 size_bytes)
+	{
+		return (size_bytes <= KiB(64)) ? Placement_Class::small_texture : Placement_Class::buffer;
+	}
+
+	//? Heap bytes resource may take, with worst case alignment gap before it
+	[[nodiscard]]
+	internal u64 get_placed_bytes(u64 size_bytes, Placement_Class placement)
+	{
+		u64 alignment = get_placement_alignment(placement);
+		return AlignAddressPow2(size_bytes, alignment) + alignment;
+	}
+
+	//? Heaps only grow, both are made again when level does not fit in one of them. Nothing may be placed in them then
+	internal void fit_resource_heaps(u64 buffer_bytes, u64 texture_bytes)
+	{
+		buffer_bytes = AlignAddressPow2(buffer_bytes, g_heap_size_step);
+		texture_bytes = AlignAddressPow2(texture_bytes, g_heap_size_step);
+		if (buffer_bytes <= g_state.buffer_heap.max_size && texture_bytes <= g_state.texture_heap.max_size)
+			return;
+
+		assert(g_state.buffer_heap.count_allocs == 0 && g_state.texture_heap.count_allocs == 0 &&
+		       "Resources are still placed in heaps!");
+		buffer_bytes = lib::max(buffer_bytes, g_state.buffer_heap.max_size);
+		texture_bytes = lib::max(texture_bytes, g_state.texture_heap.max_size);
+
+		// Arena holds only node arrays of both heaps
+		arena_reset(&g_state.arena);
+		create_offset_allocator(&g_state.buffer_heap, &g_state.arena, buffer_bytes, g_max_count_placed_resources,
+		                        get_placement_alignment(Placement_Class::small_texture));
+		create_offset_allocator(&g_state.texture_heap, &g_state.arena, texture_bytes, g_max_count_placed_resources,
+		                        get_placement_alignment(Placement_Class::small_texture));
+	}
+
+	[[nodiscard]]
+	internal Offset_Allocation place_resource(Alloc_Offset* heap, u64 size_bytes, Placement_Class placement)
+	{
+		u64 alignment = get_placement_alignment(placement);
+		Offset_Allocation out = allocate_offset(heap, AlignAddressPow2(size_bytes, alignment), alignment);
+		AlwaysAssert(!is_null(out) && "Resource heap is full!");
+		return out;
+	}
+
+	internal void release_resource(Alloc_Offset* heap, Null_Resource* res)
+	{
+		free_offset(heap, res->placement);
+		*res = {};
+	}
+
+	[[nodiscard]]
+	internal Null_Resource create_buffer(Memory_View mem)
+	{
+		Null_Resource out{ .id = g_state.count_buffers++, .size_bytes = mem.bytes, .stride_bytes = mem.stride,
+		                   .placement = place_resource(&g_state.buffer_heap, mem.bytes, Placement_Class::buffer) };
+
+		record(Cmd_Type::create_buffer, out.id, out.size_bytes);
+		g_state.frame_stats.buffers_created += 1;
+
+		return out;
+	}
+
+	internal void push_to_default(Null_Resource* buf, Memory_View mem)
+	{
+		push_upload(buf->id, mem.bytes);
+	}
+
+	//? Without "heap" it is committed resource
+	[[nodiscard]]
+	internal Null_Resource create_texture(Alloc_Offset* heap, u64 size_bytes)
+	{
+		Null_Resource out{ .id = g_state.count_textures++, .size_bytes = size_bytes, .stride_bytes = 0, .placement = {} };
+		if (heap)
+		{
+			out.placement = place_resource(heap, size_bytes, get_texture_placement(size_bytes));
+		}
+
+		record(Cmd_Type::create_texture, out.id, out.size_bytes);
+		g_state.frame_stats.textures_created += 1;
+
+		return out;
+	}
+
+	//? Single mip, every row is placed with aligned pitch in upload heap
+	internal void push_texture_to_default(Null_Resource* tex, Image_View img)
+	{
+		u64 row_bytes = (u64)img.width * img.bits_per_px / 8;
+		u64 row_pitch = AlignAddressPow2(row_bytes, g_texture_pitch_alignment);
+		push_upload(tex->id, row_pitch * img.height);
+	}
+
+	//? .dds goes through upload ring like other textures (D3D12 backend copies it into committed texture made by DDS
+	//? loader), file size is taken as its cost
+	[[nodiscard]]
+	internal Null_Resource load_and_push_dds(const char* path)
+	{
+		u64 file_bytes = 0;
+		FILE* fp = fopen(path, "rb");
+		if (fp)
+		{
+			fseek(fp, 0, SEEK_END);
+			file_bytes = (u64)ftell(fp);
+			fclose(fp);
+		}
+
+		Null_Resource out = create_texture(nullptr, file_bytes);
+		push_upload(out.id, file_bytes);
+
+		return out;
+	}
+
+	[[nodiscard]]
+	internal Null_Pipeline create_render_pipeline()
+	{
+		Null_Pipeline out{ .id = g_state.count_pipelines++ };
+
+		record(Cmd_Type::create_pipeline, out.id, 0);
+		g_state.frame_stats.pipelines_created += 1;
+
+		return out;
+	}
+
+	internal void push_descriptor(const Null_Resource& res)
+	{
+		record(Cmd_Type::write_descriptor, res.id, res.size_bytes);
+		g_state.frame_stats.descriptors_written += 1;
+	}
+
+	internal void draw_indexed(const Null_Resource& indices)
+	{
+		assert((indices.stride_bytes == 2 || indices.stride_bytes == 4) && "not supported stride!");
+		record(Cmd_Type::draw_indexed, indices.id, indices.size_bytes / indices.stride_bytes);
+		g_state.frame_stats.draws += 1;
+	}
+
+	internal void draw(u32 count_vertices)
+	{
+		record(Cmd_Type::draw, 0, count_vertices);
+		g_state.frame_stats.draws += 1;
+	}
+
+	//? Everything in tables goes away, heap ranges are reused by next level
+	internal void release_static_resources()
+	{
+		for (u32 i = 0; i < g_state.buffers.count; ++i)
+			release_resource(&g_state.buffer_heap, &g_state.buffers.data[i]);
+		for (u32 i = 0; i < g_state.textures.count; ++i)
+			release_resource(&g_state.texture_heap, &g_state.textures.data[i]);
+		g_state.buffers.reset();
+		g_state.textures.reset();
+		g_state.pipelines.reset();
+		g_state.count_static_draws = 0;
+	}
+} // namespace Null
+
+extern void rhi_run(Data_To_RHI* data_from_app, Game_Window* window)
+{
+	using namespace Null;
+
+	if (!g_state.is_initalized)
+	{
+		init_heaps();
+		init_tables();
+		create_ring(&g_state.upload_ring, g_upload_ring_max_size);
+	}
+	g_state.cmd_log.set_count(0);
+	g_state.frame_stats = {};
+	g_state.is_initalized = true;
+
+	// Static data upload
+	if (data_from_app->is_new_static)
+	{
+		g_state.is_upload_flush_allowed = true;
+
+		// Previous level resources go away, their heap ranges are reused by new ones
+		release_static_resources();
+
+		// Static assets are resolved from App tables, each distinct one gets single resource
+		Render_Assets* assets = data_from_app->assets;
+		Static_Assets level = gather_static_assets(data_from_app->static_draws);
+		Geometry* geometries[g_max_count_static_draws];
+		Image_View* images[g_max_count_static_draws * g_count_material_textures];
+		for (u32 i = 0; i < level.count_geometries; ++i)
+		{
+			geometries[i] = assets->geometries.get(level.geometries[i]);
+			AlwaysAssert(geometries[i] && "Stale asset handle!");
+		}
+		for (u32 i = 0; i < level.count_images; ++i)
+		{
+			images[i] = assets->images.get(level.images[i]);
+			AlwaysAssert(images[i] && "Stale asset handle!");
+		}
+
+		// Heaps get size of this level resources
+		{
+			u64 buffer_bytes = 0;
+			u64 texture_bytes = 0;
+			for (u32 i = 0; i < level.count_geometries; ++i)
+			{
+				buffer_bytes += get_placed_bytes(geometries[i]->positions.bytes, Placement_Class::buffer) +
+				                get_placed_bytes(geometries[i]->indices.bytes, Placement_Class::buffer) +
+				                get_placed_bytes(geometries[i]->attributes.get_memory_view().bytes, Placement_Class::buffer);
+			}
+			for (u32 i = 0; i < level.count_images; ++i)
+				texture_bytes += get_placed_bytes(images[i]->mem.bytes, get_texture_placement(images[i]->mem.bytes));
+			fit_resource_heaps(buffer_bytes, texture_bytes);
+		}
+
+		Handle<Null_Pipeline> pipelines[g_max_count_static_draws];
+		for (u32 i = 0; i < level.count_shader_paths; ++i)
+			pipelines[i] = g_state.pipelines.insert(create_render_pipeline());
+		g_state.skybox_pso = g_state.pipelines.insert(create_render_pipeline());
+
+		// Vertices, indices & attributes of every geometry
+		Handle<Null_Resource> geometry_buffers[g_max_count_static_draws][3];
+		for (u32 i = 0; i < level.count_geometries; ++i)
+		{
+			Memory_View streams[] = { geometries[i]->positions, geometries[i]->indices, 
+			                          geometries[i]->attributes.get_memory_view() };
+			for (u32 stream_i = 0; stream_i < array_count_32(streams); ++stream_i)
+			{
+				Null_Resource buf = create_buffer(streams[stream_i]);
+				push_to_default(&buf, streams[stream_i]);
+				geometry_buffers[i][stream_i] = g_state.buffers.insert(buf);
+			}
+		}
+
+		Handle<Null_Resource> textures[g_max_count_static_draws * g_count_material_textures];
+		for (u32 i = 0; i < level.count_images; ++i)
+		{
+			Null_Resource tex = create_texture(&g_state.texture_heap, images[i]->mem.bytes);
+			push_texture_to_default(&tex, *images[i]);
+			textures[i] = g_state.textures.insert(tex);
+		}
+
+		g_state.env = g_state.textures.insert(load_and_push_dds("../assets/resting.dds"));
+		g_state.env_irr = g_state.textures.insert(load_and_push_dds("../assets/resting_IR.dds"));
+
+		for (s32 draw_i = 0; draw_i < data_from_app->static_draws.count; ++draw_i)
+		{
+			Null_Draw* draw = &g_state.static_draws[draw_i];
+			Handle<Null_Resource>* buffers = geometry_buffers[level.draw_geometry[draw_i]];
+			*draw = { .vertices = buffers[0], .indices = buffers[1], .attributes = buffers[2], .textures = {},
+			          .pipeline = pipelines[level.draw_shader_path[draw_i]] };
+			for (u32 tex_i = 0; tex_i < g_count_material_textures; ++tex_i)
+				draw->textures[tex_i] = textures[level.draw_images[draw_i][tex_i]];
+		}
+		g_state.count_static_draws = (u32)data_from_app->static_draws.count;
+
+		// Static uploads are executed and waited for
+		u64 static_fence = signal();
+		ring_submit(&g_state.upload_ring, static_fence);
+		sync_with_fence(static_fence);
+		g_state.is_upload_flush_allowed = false;
+	}
+
+	g_state.frame_stats.heap_bytes_placed = g_state.buffer_heap.used_bytes + g_state.texture_heap.used_bytes;
+	g_state.frame_stats.heap_free_blocks = g_state.buffer_heap.count_free_blocks + g_state.texture_heap.count_free_blocks;
+
+	g_state.width = window->width;
+	g_state.height = window->height;
+
+	// Per frame constants
+	push_upload(0, data_from_app->cb_frame.bytes);
+	push_upload(0, data_from_app->cb_draw.bytes);
+
+	// Bindless views, recreated every frame same as in D3D12 backend - env maps once, rest per draw
+	push_descriptor(*g_state.textures.get(g_state.env));
+	push_descriptor(*g_state.textures.get(g_state.env_irr));
+
+	// Static meshes (unless culled) and fullscreen skybox triangle
+	AlwaysAssert(data_from_app->static_draws.count == (s32)g_state.count_static_draws && "Static draws changed without new static data!");
+	for (u32 draw_i = 0; draw_i < g_state.count_static_draws; ++draw_i)
+	{
+		const Null_Draw& draw = g_state.static_draws[draw_i];
+		push_descriptor(*g_state.buffers.get(draw.vertices));
+		push_descriptor(*g_state.buffers.get(draw.attributes));
+		for (Handle<Null_Resource> tex : draw.textures)
+			push_descriptor(*g_state.textures.get(tex));
+
+		assert(g_state.pipelines.get(draw.pipeline) && "Stale pipeline handle!");
+		if (data_from_app->static_draws[draw_i].is_visible)
+			draw_indexed(*g_state.buffers.get(draw.indices));
+	}
+	assert(g_state.pipelines.get(g_state.skybox_pso) && "Stale pipeline handle!");
+	draw(3);
+
+	// End of frame work
+	u64 frame_fence = signal();
+	ring_submit(&g_state.upload_ring, frame_fence);
+	if (frame_fence >= g_count_frames_in_flight)
+		sync_with_fence(frame_fence - (g_count_frames_in_flight - 1));
+}
+
+extern RHI_Frame_Stats rhi_get_frame_stats()
+{
+	return Null::g_state.frame_stats;
+}
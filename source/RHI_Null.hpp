@@ -0,0 +1,91 @@
+#pragma once
+
+inline constexpr u32 g_null_max_count_cmds = 1024;
+
+// internal structures
+namespace Null
+{
+	enum struct Cmd_Type : u8
+	{
+		create_buffer,
+		create_texture,
+		create_pipeline,
+		upload,
+		write_descriptor,
+		draw_indexed,
+		draw,
+	};
+
+	//? Single entry of command log, 16 bytes. "resource" is an id in creation order per resource type,
+	//? "value" is size in bytes for creations & uploads and element count for draws
+	struct Cmd
+	{
+		Cmd_Type type;
+		u32 resource;
+		u64 value;
+	};
+} // namespace Null
+
+// external structures
+struct Null_Resource
+{
+	u32 id;
+	u64 size_bytes;
+	u32 stride_bytes;
+	Offset_Allocation placement; // null for committed resource
+};
+
+struct Null_Pipeline
+{
+	u32 id;
+};
+
+//? Resources of one static draw, handles of backend tables
+struct Null_Draw
+{
+	Handle<Null_Resource> vertices;
+	Handle<Null_Resource> indices;
+	Handle<Null_Resource> attributes;
+	Handle<Null_Resource> textures[g_count_material_textures];
+	Handle<Null_Pipeline> pipeline;
+};
+
+struct RHI_Null_State
+{
+	// Logical State
+	Null::Cmd cmd_buffer[g_null_max_count_cmds];
+	Array_View<Null::Cmd> cmd_log { .size = g_null_max_count_cmds, .count = 0, .data = cmd_buffer };
+	RHI_Frame_Stats frame_stats;
+
+	u32 count_buffers;
+	u32 count_textures;
+	u32 count_pipelines;
+
+	// Resource heaps, only ranges are tracked
+	Alloc_Arena arena;
+	Alloc_Offset buffer_heap;
+	Alloc_Offset texture_heap;
+
+	// Upload ring retired by simulated fence
+	Alloc_Ring upload_ring;
+	u64 fence_counter;
+	u64 fence_completed;
+	b32 is_upload_flush_allowed; // level upload only, same as D3D12 backend
+
+	b32 is_initalized;
+	u32 width;
+	u32 height;
+
+	// Data State, same tables as D3D12 backend holds - every resource is used by handle
+	Alloc_Arena arena_tables;
+	Slot_Map<Null_Resource> buffers;
+	Slot_Map<Null_Resource> textures;
+	Slot_Map<Null_Pipeline> pipelines;
+
+	Null_Draw static_draws[g_max_count_static_draws];
+	u32 count_static_draws;
+
+	Handle<Null_Resource> env;
+	Handle<Null_Resource> env_irr;
+	Handle<Null_Pipeline> skybox_pso;
+};
@@ -2,7 +2,6 @@
 #include "Shader_And_CPU_Common.h"
 
 //TODO: Only static (sent once) data for now
-//TODO: Pass generational handles, instead of direct views
 
 struct Game_Window
 {
@@ -18,20 +17,88 @@ struct Geometry
 	Memory_View indices;
 	Memory_View positions;
 	Array_View<Attributes> attributes; // this can be Memory_View when passed to RHI
+	Vec3 bounds_min; // object space
+	Vec3 bounds_max;
+};
+
+inline constexpr u32 g_max_count_geometries = 1024;
+inline constexpr u32 g_max_count_images = 4096;
+inline constexpr u32 g_max_count_static_draws = 16;
+inline constexpr u32 g_count_material_textures = 4; // albedo, normal, roughness, ao - order of Draw_Ids
+inline constexpr u32 g_max_count_asset_names = 4096;
+inline constexpr u64 g_max_asset_names_bytes = KiB(512);
+
+//? Asset tables owned by App (live in persistent memory), RHI resolves handles from Data_To_RHI through them
+struct Render_Assets
+{
+	Slot_Map<Geometry> geometries;
+	Slot_Map<Image_View> images;
+	String_Table names; // paths of assets & shaders
+};
+
+//? Draw of level mesh. Same handles in several draws share one GPU resource (pipeline for same shader path)
+struct Static_Draw
+{
+	Handle<Geometry> geometry;
+	Handle<Image_View> textures[g_count_material_textures];
+	String_Id shader_path;
+	b32 is_visible; // frustum culled by App, every frame
 };
 
 struct Data_To_RHI
 {
-	Geometry st_geo;
+	Render_Assets* assets;
 	
-	Image_View st_albedo;
-	Image_View st_normal;
-	Image_View st_roughness;
-	Image_View st_ao;
-	
-	const wchar_t* shader_path;
+	// Same draws every frame, their resources are made by RHI only when "is_new_static" is set
+	Array_View<Static_Draw> static_draws;
 	b32 is_new_static;
 	
 	Memory_View cb_frame;
-	Memory_View cb_draw;
-};
\ No newline at end of file
+	Memory_View cb_draw; // shared by static draws
+};
+
+//? Distinct assets of static draws, RHI backends make one resource (or pipeline) per entry.
+//? "draw_*" arrays index them for every draw
+struct Static_Assets
+{
+	Handle<Geometry> geometries[g_max_count_static_draws];
+	Handle<Image_View> images[g_max_count_static_draws * g_count_material_textures];
+	String_Id shader_paths[g_max_count_static_draws];
+	u32 count_geometries;
+	u32 count_images;
+	u32 count_shader_paths;
+	
+	u32 draw_geometry[g_max_count_static_draws];
+	u32 draw_images[g_max_count_static_draws][g_count_material_textures];
+	u32 draw_shader_path[g_max_count_static_draws];
+};
+
+//? Index of "value" in "values", it is added when it is not there yet. Few assets per level, linear search is enough
+template<typename T>
+[[nodiscard]]
+inline u32 find_or_add(T* values, u32* count, const T& value)
+{
+	for (u32 i = 0; i < *count; ++i)
+	{
+		if (values[i] == value)
+			return i;
+	}
+	values[*count] = value;
+	return (*count)++;
+}
+
+[[nodiscard]]
+inline Static_Assets gather_static_assets(const Array_View<Static_Draw> draws)
+{
+	AlwaysAssert(draws.count <= (s32)g_max_count_static_draws && "Too many static draws!");
+	Static_Assets out{};
+	for (s32 draw_i = 0; draw_i < draws.count; ++draw_i)
+	{
+		const Static_Draw& draw = draws[draw_i];
+		out.draw_geometry[draw_i] = find_or_add(out.geometries, &out.count_geometries, draw.geometry);
+		for (u32 tex_i = 0; tex_i < g_count_material_textures; ++tex_i)
+			out.draw_images[draw_i][tex_i] = find_or_add(out.images, &out.count_images, draw.textures[tex_i]);
+		out.draw_shader_path[draw_i] = find_or_add(out.shader_paths, &out.count_shader_paths, draw.shader_path);
+	}
+	return out;
+}
\ No newline at end of file
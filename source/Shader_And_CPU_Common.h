@@ -54,9 +54,11 @@ AlignedConstantStruct Constant_Data_Frame
 	Vec4 view_pos;
 };
 
+// Trans4 is 3x4 affine (rows in 3 registers, 48 bytes), in HLSL it is float4x3 - same memory seen as transposed
+// matrix, so points are multiplied from left: mul(float4(p, 1), obj_to_world)
 AlignedConstantStruct Constant_Data_Draw
 {
-	Mat4 obj_to_world;
+	Trans4 obj_to_world;
 	Mat4 world_to_clip;
 	
 	Mat4 clip_to_world; // only used in skybox for now
@@ -3,10 +3,15 @@
 #include "Utils.hpp"
 #include "Allocators.hpp"
 #include "Views.hpp"
+#include "Slot_Map.hpp"
+#include "Hash_Map.hpp"
+#include "Strings.hpp"
+#include "Cpu_Features.hpp"
 
 #include "GameAsserts.hpp"
 #include "Game_Services.hpp"
 #include "Render_Data.hpp"
+#include "RHI.hpp"
 #include "Win32_x64_Platform.hpp"
 
 #ifdef _DEBUG
@@ -14,7 +19,7 @@
 
 #endif
 
-extern void rhi_run(Data_To_RHI*, Game_Window*);
+inline constexpr u64 g_platform_commit_step = MiB(1);
 
 int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int nCmdShow)
 {
@@ -26,6 +31,7 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
 	auto cores_count = windows_info.dwNumberOfProcessors;
 	AlwaysAssert(windows_info.wProcessorArchitecture == PROCESSOR_ARCHITECTURE_AMD64 
 	             && "This is not a 64-bit OS!");
+	AlwaysAssert(get_cpu_features().has_sse41 && "CPU without SSE4.1 is not supported!");
 	
 	Win32::Platform_Clock clock = Win32::clock_create();
 	UINT schedulerGranularity = 1;
@@ -40,12 +46,9 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
 	CoInitialize(NULL);
 	THR(CoCreateInstance(CLSID_WICImagingFactory, 0, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(&Win32::wic_factory)));
 	
-	Alloc_Arena platform_arena
-	{
-		.max_size = MiB(2150),
-		.base = (byte*)VirtualAlloc(0, MiB(2150), MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE)
-	};
-	AlwaysAssert(platform_arena.base && "Failed to allocate memory from Windows");
+	// Only address space is reserved, pages are committed as arenas grow
+	Alloc_Arena platform_arena = arena_reserve(MiB(2150), g_platform_commit_step);
+	AlwaysAssert(platform_arena.base && "Failed to reserve memory from Windows");
 	
 	// Fill game services needed by application
 	Game_Memory game_memory
@@ -54,7 +57,8 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
 		.size_permanent_storage = MiB(64),
 		.permanent_storage = allocate(&platform_arena, MiB(64)),
 		.size_transient_storage = GiB(2),
-		.transient_storage = allocate(&platform_arena, GiB(2))
+		.transient_storage = arena_push_reserved(&platform_arena, GiB(2)),
+		.transient_commit_step = platform_arena.commit_step
 	};
 	
 	Game_Window game_window { (void*)win_handle, 0.0f, width, height };
@@ -119,6 +123,7 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
 		
 		game_memory.os_api.read_img = &Win32::load_img_dxgi_compatible;
 		
+		alloc_end_frame(); // platform & RHI allocations, App DLL has its own tables
 		if (Win32::g_is_running)
 		{
 			// Call application
@@ -138,6 +143,15 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
 		}
 	}
 
+#if defined(ALLOC_INSTRUMENTATION)
+	FILE* report_file = nullptr;
+	if (fopen_s(&report_file, "alloc_report.txt", "w") == 0)
+	{
+		alloc_print_report(report_file);
+		fclose(report_file);
+	}
+#endif
+
 	UnregisterClassA("DeRex12", GetModuleHandle(nullptr));
 	return 0;
 }
\ No newline at end of file
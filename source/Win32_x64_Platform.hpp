@@ -560,7 +560,7 @@ namespace Win32
 	}
 	
 	//TODO: Consider refactor with https://gist.github.com/mmozeiko/1f97a51db53999093ba5759c16c577d4
-	Image_View load_img_dxgi_compatible(const wchar_t* file_path, Alloc_Arena* arena, b32 is_srgb = true)
+	Image_View load_img_dxgi_compatible(String_View file_path, Alloc_Arena* arena, b32 is_srgb = true)
 	{
 		DXGI_FORMAT dxgi_format = DXGI_FORMAT_UNKNOWN;
 		u32 img_width		= 0;
@@ -574,7 +574,9 @@ namespace Win32
 		WICPixelFormatGUID pixel_format = {};
 		auto d = defer([&] { bitmap_decoder->Release(); bitmap_frame->Release(); converter->Release(); });
 		
-		THR(Win32::wic_factory->CreateDecoderFromFilename(file_path, NULL, 
+		wchar_t file_path_wide[MAX_PATH];
+		str_to_wide(file_path, file_path_wide, MAX_PATH);
+		THR(Win32::wic_factory->CreateDecoderFromFilename(file_path_wide, NULL, 
 																									GENERIC_READ, 
 																									WICDecodeMetadataCacheOnDemand, &bitmap_decoder));
 		THR(bitmap_decoder->GetFrame(0, &bitmap_frame));
@@ -0,0 +1,264 @@
+#pragma once
+
+//? General purpose and GPU side allocator benchmarks: thread cached pool, TLSF, offset allocator and upload ring
+namespace Linux
+{
+	// ===============================================================================================================================
+	// ======================================================= POOL MT ===============================================================
+	// ===============================================================================================================================
+
+	//? Throughput of Alloc_Pool_MT churn per thread count: every thread keeps up to 96 blocks (more than magazine, so
+	//? refills and flushes hit global list) and frees random ones of them. Correctness is checked by "pool_mt" test
+	internal void bench_pool_mt(const Platform_Clock& clock)
+	{
+		constexpr u64 block_size = 64;
+		constexpr u32 count_blocks = 1 << 14;
+		constexpr u32 max_count_held = 96;
+		constexpr u32 count_churn = 1 << 18;
+		constexpr u32 count_runs = 5;
+
+		u32 max_count_threads = lib::clamp(std::thread::hardware_concurrency(), 1u, 64u);
+		AlwaysAssert(max_count_threads * max_count_held < count_blocks);
+		Alloc_Arena arena = arena_reserve(MiB(8));
+		AlwaysAssert(arena.base && "Failed to reserve memory from OS");
+		Alloc_Pool_MT pool{};
+		pool_mt_from_allocator(&pool, &arena, count_blocks * block_size, block_size, 64);
+
+		printf("%u allocs/frees per thread, median of %u runs\n", count_churn, count_runs);
+		printf("  %8s | %10s | %12s\n", "threads", "ms", "Mops/s");
+		for (u32 count_threads = 1; ; count_threads = lib::min(count_threads * 2, max_count_threads))
+		{
+			auto work = [&](u32 thread_i)
+			{
+				u64 rng = 0x9E3779B97F4A7C15ull * (thread_i + 1);
+				void* local[max_count_held];
+				u32 count_local = 0;
+				for (u32 op_i = 0; op_i < count_churn; ++op_i)
+				{
+					rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17;
+					if (count_local < max_count_held && (count_local == 0 || (rng & 3) != 0))
+					{
+						local[count_local] = allocate(&pool);
+						*(u64*)local[count_local++] = op_i;
+					}
+					else
+					{
+						u32 i = (u32)(rng >> 32) % count_local;
+						free_block(&pool, local[i]);
+						local[i] = local[--count_local];
+					}
+				}
+				for (u32 i = 0; i < count_local; ++i)
+					free_block(&pool, local[i]);
+				pool_mt_flush_thread(&pool);
+			};
+
+			f64 times_ms[count_runs];
+			for (u32 run_i = 0; run_i < count_runs; ++run_i)
+				times_ms[run_i] = run_on_threads(clock, count_threads, work);
+
+			f64 median_ms = get_median(times_ms, count_runs);
+			printf("  %8u | %10.2lf | %12.2lf\n", count_threads, median_ms, (f64)count_churn * count_threads / median_ms / 1000.0);
+
+			if (count_threads == max_count_threads)
+				break;
+		}
+
+		vm_release(arena.base, arena.max_size);
+	}
+
+	// ===============================================================================================================================
+	// ======================================================= TLSF ==================================================================
+	// ===============================================================================================================================
+
+	//? Random allocate/free churn of mixed sizes and alignments in Alloc_TLSF, fragmentation is reported at the end.
+	//? Correctness is checked by "tlsf" test
+	internal void bench_tlsf(const Platform_Clock& clock)
+	{
+		constexpr u64 tlsf_size = MiB(64);
+		constexpr u32 max_count_live = 4096;
+		constexpr u32 count_ops = 1 << 20;
+		constexpr u32 count_runs = 5;
+		constexpr u64 alignments[] = { 16, 16, 16, 16, 64, 256, 4096, KiB(64) };
+
+		Alloc_Arena arena = arena_reserve(tlsf_size + MiB(1));
+		AlwaysAssert(arena.base && "Failed to reserve memory from OS");
+		Alloc_TLSF tlsf{};
+		tlsf_from_allocator(&tlsf, &arena, tlsf_size);
+		void** live = (void**)allocate(&arena, max_count_live * sizeof(void*));
+
+		f64 times_ms[count_runs];
+		Tlsf_Stats stats{};
+		for (u32 run_i = 0; run_i < count_runs; ++run_i)
+		{
+			for (u32 i = 0; i < max_count_live; ++i)
+				live[i] = nullptr;
+			tlsf_reset(&tlsf);
+
+			u64 rng = 0x9E3779B97F4A7C15ull + run_i;
+			u64 tick_start = get_performance_ticks();
+			for (u32 op_i = 0; op_i < count_ops; ++op_i)
+			{
+				rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17;
+				void** slot = &live[rng % max_count_live];
+				if (*slot)
+				{
+					free_block(&tlsf, *slot);
+					*slot = nullptr;
+				}
+				else
+				{
+					// Mostly small, some up to 256 KiB
+					u64 size = ((rng >> 24) % 16 == 0) ? 1 + (rng >> 32) % KiB(256) : 1 + (rng >> 32) % 512;
+					*slot = allocate(&tlsf, size, alignments[(rng >> 16) % array_count_32(alignments)]);
+					*(u8*)*slot = (u8)op_i;
+				}
+			}
+			times_ms[run_i] = get_elapsed_ms_here(clock, tick_start);
+			stats = tlsf_get_stats(&tlsf);
+		}
+
+		f64 median_ms = get_median(times_ms, count_runs);
+		printf("%u random allocate/free ops, %u live max, median of %u runs: %.2lf ms, %.1lf ns per op\n",
+		       count_ops, max_count_live, count_runs, median_ms, median_ms * 1e6 / (f64)count_ops);
+		printf("  at end: %u live, %llu bytes used (peak %llu), %llu free in %u blocks, largest free %llu (%.1lf%% fragmentation)\n",
+		       stats.count_allocs, (unsigned long long)stats.used_bytes, (unsigned long long)stats.peak_used_bytes,
+		       (unsigned long long)stats.free_bytes, stats.count_free_blocks, (unsigned long long)stats.largest_free_bytes,
+		       stats.free_bytes ? 100.0 * (1.0 - (f64)stats.largest_free_bytes / (f64)stats.free_bytes) : 0.0);
+
+		vm_release(arena.base, arena.max_size);
+	}
+
+	// ===============================================================================================================================
+	// ======================================================= OFFSET ALLOCATOR ======================================================
+	// ===============================================================================================================================
+
+	//? Random create/release churn of placed resources in 1 GiB heap: small textures and buffers, some of them big
+	internal void bench_offset_alloc(const Platform_Clock& clock)
+	{
+		constexpr u64 heap_size = GiB(1);
+		constexpr u32 max_count_live = 4096;
+		constexpr u32 count_ops = 1 << 20;
+		constexpr u32 count_runs = 5;
+
+		Alloc_Arena arena = arena_reserve(MiB(16));
+		AlwaysAssert(arena.base && "Failed to reserve memory from OS");
+		Alloc_Offset heap{};
+		create_offset_allocator(&heap, &arena, heap_size, max_count_live, get_placement_alignment(Placement_Class::small_texture));
+		Offset_Allocation* live = (Offset_Allocation*)allocate(&arena, max_count_live * sizeof(Offset_Allocation));
+
+		f64 times_ms[count_runs];
+		Tlsf_Stats stats{};
+		for (u32 run_i = 0; run_i < count_runs; ++run_i)
+		{
+			for (u32 i = 0; i < max_count_live; ++i)
+				live[i] = {};
+			offset_reset(&heap);
+
+			u64 rng = 0x9E3779B97F4A7C15ull + run_i;
+			u64 tick_start = get_performance_ticks();
+			for (u32 op_i = 0; op_i < count_ops; ++op_i)
+			{
+				// xorshift, cheap enough not to hide allocator cost
+				rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17;
+				Offset_Allocation* slot = &live[rng % max_count_live];
+				if (!is_null(*slot))
+				{
+					free_offset(&heap, *slot);
+					*slot = {};
+					continue;
+				}
+
+				// MSAA targets are rare and live in own heap, every one of them would pin a 4 MiB boundary here
+				Placement_Class placement = ((rng >> 20) % 2) ? Placement_Class::small_texture : Placement_Class::buffer;
+				u64 size = (rng >> 32) % KiB(64);
+				if (placement == Placement_Class::buffer)
+					size = ((rng >> 24) % 16 == 0) ? (rng >> 32) % MiB(8) : (rng >> 32) % KiB(512);
+				*slot = allocate_offset(&heap, size, get_placement_alignment(placement));
+			}
+			times_ms[run_i] = get_elapsed_ms_here(clock, tick_start);
+			stats = offset_get_stats(&heap);
+		}
+
+		f64 median_ms = get_median(times_ms, count_runs);
+		printf("%u random create/release ops, %u live max, median of %u runs: %.2lf ms, %.1lf ns per op\n",
+		       count_ops, max_count_live, count_runs, median_ms, median_ms * 1e6 / (f64)count_ops);
+		printf("  at end: %u live, %llu bytes used, %llu free in %u blocks, largest free %llu (%.1lf%% fragmentation)\n",
+		       stats.count_allocs, (unsigned long long)stats.used_bytes, (unsigned long long)stats.free_bytes, stats.count_free_blocks,
+		       (unsigned long long)stats.largest_free_bytes,
+		       stats.free_bytes ? 100.0 * (1.0 - (f64)stats.largest_free_bytes / (f64)stats.free_bytes) : 0.0);
+
+		vm_release(arena.base, arena.max_size);
+	}
+
+	// ===============================================================================================================================
+	// ======================================================= UPLOAD RING ===========================================================
+	// ===============================================================================================================================
+
+	//? Frames of random uploads into Alloc_Ring retired by simulated fence - GPU finishes frames 1 to 3 frames late
+	internal void bench_upload_ring(const Platform_Clock& clock)
+	{
+		constexpr u64 ring_size = MiB(4);
+		constexpr u64 granule = 256;
+		constexpr u32 count_frames = 1 << 14;
+		constexpr u32 count_runs = 5;
+
+		f64 times_ms[count_runs];
+		u64 count_allocs = 0;
+		u64 count_waits = 0;
+		for (u32 run_i = 0; run_i < count_runs; ++run_i)
+		{
+			Alloc_Ring ring{};
+			create_ring(&ring, ring_size);
+			u64 fence_counter = 0;
+			u64 fence_completed = 0;
+			count_allocs = 0;
+			count_waits = 0;
+
+			u64 rng = 0x2545F4914F6CDD1Dull + run_i;
+			u64 tick_start = get_performance_ticks();
+			for (u32 frame_i = 0; frame_i < count_frames; ++frame_i)
+			{
+				rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17;
+				u32 count_uploads = 1 + (u32)(rng % 64);
+				for (u32 upload_i = 0; upload_i < count_uploads; ++upload_i)
+				{
+					rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17;
+					u64 size = 1 + ((rng >> 16) % 8 == 0 ? (rng >> 24) % KiB(256) : (rng >> 24) % KiB(4));
+					u64 offset = allocate_ring(&ring, size, granule);
+					while (offset == g_ring_full)
+					{
+						// Waiting for GPU, or for work of this frame when nothing else is in flight
+						count_waits += 1;
+						u64 oldest_fence = ring_get_oldest_fence(&ring);
+						if (oldest_fence == 0)
+						{
+							oldest_fence = ++fence_counter;
+							ring_submit(&ring, oldest_fence);
+						}
+						fence_completed = lib::max(fence_completed, oldest_fence);
+						ring_retire(&ring, fence_completed);
+						offset = allocate_ring(&ring, size, granule);
+					}
+					count_allocs += 1;
+				}
+
+				u64 frame_fence = ++fence_counter;
+				ring_submit(&ring, frame_fence);
+				u64 lag = 1 + (rng >> 40) % 3;
+				if (frame_fence > lag)
+				{
+					fence_completed = lib::max(fence_completed, frame_fence - lag);
+					ring_retire(&ring, fence_completed);
+				}
+			}
+			times_ms[run_i] = get_elapsed_ms_here(clock, tick_start);
+		}
+
+		f64 median_ms = get_median(times_ms, count_runs);
+		printf("%u frames, %llu allocations in %llu bytes ring, median of %u runs: %.2lf ms, %.1lf ns per allocation\n",
+		       count_frames, (unsigned long long)count_allocs, (unsigned long long)ring_size, count_runs, median_ms, 
+		       median_ms * 1e6 / (f64)count_allocs);
+		printf("  waits for simulated fence: %llu\n", (unsigned long long)count_waits);
+	}
+} // namespace Linux
@@ -0,0 +1,569 @@
+#pragma once
+
+//? Container benchmarks: handles, hashing, interning, SoA layout, queues between threads and bitsets
+namespace Linux
+{
+	// ===============================================================================================================================
+	// ======================================================= SLOT MAP ==============================================================
+	// ===============================================================================================================================
+
+	struct Slot_Map_Item
+	{
+		u64 key;
+		u32 payload[6];
+	};
+
+	//? Random insert/get+remove churn of Slot_Map at fixed capacity. Correctness is checked by "slot_map" test
+	internal void bench_slot_map(const Platform_Clock& clock)
+	{
+		constexpr u32 capacity = 1 << 12;
+		constexpr u32 count_ops = 1 << 20;
+		constexpr u32 count_runs = 5;
+
+		Alloc_Arena arena = arena_reserve(MiB(4));
+		AlwaysAssert(arena.base && "Failed to reserve memory from OS");
+		Slot_Map<Slot_Map_Item> map{};
+		map.init(&arena, capacity);
+		Handle<Slot_Map_Item>* live = (Handle<Slot_Map_Item>*)allocate(&arena, capacity * sizeof(Handle<Slot_Map_Item>));
+
+		f64 times_ms[count_runs];
+		volatile u64 sink = 0;
+		u64 rng = 0x9E3779B97F4A7C15ull;
+		for (u32 run_i = 0; run_i < count_runs; ++run_i)
+		{
+			map.reset();
+			u32 count_live = 0;
+			u64 sum = 0;
+			u64 tick_start = get_performance_ticks();
+			for (u32 op_i = 0; op_i < count_ops; ++op_i)
+			{
+				rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17;
+				if (count_live == 0 || (count_live < capacity && (rng & 1)))
+				{
+					live[count_live++] = map.insert({ .key = op_i, .payload = {} });
+				}
+				else
+				{
+					u32 live_i = (u32)((rng >> 32) % count_live);
+					sum += map.get(live[live_i])->key;
+					map.remove(live[live_i]);
+					live[live_i] = live[--count_live];
+				}
+			}
+			times_ms[run_i] = get_elapsed_ms_here(clock, tick_start);
+			sink = sink + sum;
+		}
+
+		f64 median_ms = get_median(times_ms, count_runs);
+		printf("%u random insert/get+remove ops, %u capacity, median of %u runs: %.2lf ms, %.1lf ns per op\n",
+		       count_ops, capacity, count_runs, median_ms, median_ms * 1e6 / (f64)count_ops);
+
+		vm_release(arena.base, arena.max_size);
+	}
+
+	// ===============================================================================================================================
+	// ======================================================= HASH MAP ==============================================================
+	// ===============================================================================================================================
+
+	//? Insert, lookup of present and missing keys and erase of random u64 -> u64, arena backed Hash_Map against
+	//? std::unordered_map with same reserve
+	internal void bench_hash_map(const Platform_Clock& clock)
+	{
+		constexpr u32 count_runs = 3;
+		constexpr u32 counts[] = { 1 << 10, 1 << 16, 1 << 20 };
+		constexpr u32 max_count = 1 << 20;
+		constexpr const char* phases[] = { "insert", "find hit", "find miss", "erase" };
+
+		Alloc_Arena arena = arena_reserve(MiB(256));
+		AlwaysAssert(arena.base && "Failed to reserve memory from OS");
+		u64* keys = (u64*)allocate(&arena, max_count * 2 * sizeof(u64)); // second half is missing keys
+		volatile u64 sink = 0; // keeps lookups from being optimized out
+
+		printf("random u64 -> u64, median of %u runs [ns per op]\n", count_runs);
+		printf("  %10s | %-9s", "elements", "map");
+		for (const char* phase : phases)
+			printf(" | %9s", phase);
+		printf("\n");
+
+		for (u32 count : counts)
+		{
+			u64 rng = 0x9E3779B97F4A7C15ull + count;
+			for (u32 i = 0; i < count * 2; ++i)
+			{
+				rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17;
+				keys[i] = rng;
+			}
+
+			f64 times_ms[2][array_count_32(phases)][count_runs];
+			for (u32 run_i = 0; run_i < count_runs; ++run_i)
+			{
+				// Hash_Map
+				{
+					Arena_Temp_Scope temp(&arena);
+					Hash_Map<u64, u64> map{};
+					map.init(&arena, count);
+
+					u64 sum = 0;
+					u64 tick_start = get_performance_ticks();
+					for (u32 i = 0; i < count; ++i)
+						map.insert(keys[i], i);
+					times_ms[0][0][run_i] = get_elapsed_ms_here(clock, tick_start);
+
+					tick_start = get_performance_ticks();
+					for (u32 i = 0; i < count; ++i)
+						sum += *map.find(keys[i]);
+					times_ms[0][1][run_i] = get_elapsed_ms_here(clock, tick_start);
+
+					tick_start = get_performance_ticks();
+					for (u32 i = count; i < count * 2; ++i)
+						sum += (map.find(keys[i]) != nullptr);
+					times_ms[0][2][run_i] = get_elapsed_ms_here(clock, tick_start);
+
+					tick_start = get_performance_ticks();
+					for (u32 i = 0; i < count; ++i)
+						sum += map.remove(keys[i]);
+					times_ms[0][3][run_i] = get_elapsed_ms_here(clock, tick_start);
+
+					sink = sink + sum;
+				}
+
+				// std::unordered_map
+				{
+					std::unordered_map<u64, u64> map;
+					map.reserve(count);
+
+					u64 sum = 0;
+					u64 tick_start = get_performance_ticks();
+					for (u32 i = 0; i < count; ++i)
+						map[keys[i]] = i;
+					times_ms[1][0][run_i] = get_elapsed_ms_here(clock, tick_start);
+
+					tick_start = get_performance_ticks();
+					for (u32 i = 0; i < count; ++i)
+						sum += map.find(keys[i])->second;
+					times_ms[1][1][run_i] = get_elapsed_ms_here(clock, tick_start);
+
+					tick_start = get_performance_ticks();
+					for (u32 i = count; i < count * 2; ++i)
+						sum += (map.find(keys[i]) != map.end());
+					times_ms[1][2][run_i] = get_elapsed_ms_here(clock, tick_start);
+
+					tick_start = get_performance_ticks();
+					for (u32 i = 0; i < count; ++i)
+						sum += map.erase(keys[i]);
+					times_ms[1][3][run_i] = get_elapsed_ms_here(clock, tick_start);
+
+					sink = sink + sum;
+				}
+			}
+
+			for (u32 map_i = 0; map_i < 2; ++map_i)
+			{
+				printf("  %10u | %-9s", count, map_i == 0 ? "Hash_Map" : "std");
+				for (u32 phase_i = 0; phase_i < array_count_32(phases); ++phase_i)
+					printf(" | %9.2lf", get_median(times_ms[map_i][phase_i], count_runs) * 1e6 / (f64)count);
+				printf("\n");
+			}
+		}
+
+		vm_release(arena.base, arena.max_size);
+	}
+
+	// ===============================================================================================================================
+	// ======================================================= STRING INTERNING ======================================================
+	// ===============================================================================================================================
+
+	//? Interning of asset like paths (first time and repeated) and lookup of one name among all of them by id against
+	//? strcmp
+	internal void bench_intern(const Platform_Clock& clock)
+	{
+		constexpr u32 count_names = 1 << 14;
+		constexpr u32 count_runs = 5;
+
+		Alloc_Arena arena = arena_reserve(MiB(64));
+		AlwaysAssert(arena.base && "Failed to reserve memory from OS");
+		String_View* paths = (String_View*)allocate(&arena, count_names * sizeof(String_View));
+		for (u32 i = 0; i < count_names; ++i)
+			paths[i] = str_format(&arena, "../assets/meshes/level_%u/mesh_%u/texture_%u.png", i % 7, i / 7, i);
+
+		f64 first_ms[count_runs];
+		f64 repeat_ms[count_runs];
+		f64 find_id_ms[count_runs];
+		f64 find_strcmp_ms[count_runs];
+		String_Id* ids = (String_Id*)allocate(&arena, count_names * sizeof(String_Id));
+		volatile u32 sink = 0;
+		for (u32 run_i = 0; run_i < count_runs; ++run_i)
+		{
+			// Own arena per run, table carves lazily committed child arena from it
+			Alloc_Arena table_arena = arena_reserve(MiB(16));
+			AlwaysAssert(table_arena.base && "Failed to reserve memory from OS");
+			String_Table table{};
+			string_table_init(&table, &table_arena, count_names + 1, MiB(4));
+
+			u64 tick_start = get_performance_ticks();
+			for (u32 i = 0; i < count_names; ++i)
+				ids[i] = intern(&table, paths[i]);
+			first_ms[run_i] = get_elapsed_ms_here(clock, tick_start);
+
+			// Views made again from text, so hash is computed as in real load path
+			tick_start = get_performance_ticks();
+			for (u32 i = 0; i < count_names; ++i)
+				sink = sink + intern(&table, str_view(paths[i].str)).index;
+			repeat_ms[run_i] = get_elapsed_ms_here(clock, tick_start);
+
+			// Linear search of every 64th name, as asset table without interning would do
+			tick_start = get_performance_ticks();
+			for (u32 i = 0; i < count_names; i += 64)
+			{
+				for (u32 j = 0; j < count_names; ++j)
+				{
+					if (ids[j] == ids[i]) { sink = sink + j; break; }
+				}
+			}
+			find_id_ms[run_i] = get_elapsed_ms_here(clock, tick_start);
+
+			tick_start = get_performance_ticks();
+			for (u32 i = 0; i < count_names; i += 64)
+			{
+				for (u32 j = 0; j < count_names; ++j)
+				{
+					if (strcmp(paths[j].str, paths[i].str) == 0) { sink = sink + j; break; }
+				}
+			}
+			find_strcmp_ms[run_i] = get_elapsed_ms_here(clock, tick_start);
+
+			vm_release(table_arena.base, table_arena.max_size);
+		}
+
+		u32 count_finds = count_names / 64;
+		printf("%u paths, median of %u runs\n", count_names, count_runs);
+		printf("  intern first time: %.1lf ns, repeated: %.1lf ns per path\n",
+		       get_median(first_ms, count_runs) * 1e6 / count_names, get_median(repeat_ms, count_runs) * 1e6 / count_names);
+		printf("  linear find by id: %.1lf us, by strcmp: %.1lf us per name\n",
+		       get_median(find_id_ms, count_runs) * 1e3 / count_finds, get_median(find_strcmp_ms, count_runs) * 1e3 / count_finds);
+
+		vm_release(arena.base, arena.max_size);
+	}
+
+	// ===============================================================================================================================
+	// ======================================================= SOA ARRAY =============================================================
+	// ===============================================================================================================================
+
+	//? Pass over one attribute (normalize normals) in 48 bytes Attributes records against same pass over normal array of
+	//? Soa_Array, and cost of bulk AoS <-> SoA conversion
+	internal void bench_soa(const Platform_Clock& clock)
+	{
+		constexpr u32 counts[] = { 1 << 14, 1 << 22 };
+		constexpr u32 max_count = 1 << 22;
+		constexpr u32 count_runs = 5;
+
+		Alloc_Arena arena = arena_reserve(MiB(640));
+		AlwaysAssert(arena.base && "Failed to reserve memory from OS");
+		Attributes* aos = (Attributes*)allocate(&arena, max_count * sizeof(Attributes), g_soa_alignment);
+		Attributes* aos_back = (Attributes*)allocate(&arena, max_count * sizeof(Attributes), g_soa_alignment);
+		Soa_Array<&Attributes::tangent, &Attributes::normal, &Attributes::uv> soa;
+		soa.init(&arena, max_count);
+
+		auto normalize = [](Vec4* n)
+		{
+			f32 inv_length = 1.0f / sqrtf(n->x * n->x + n->y * n->y + n->z * n->z + 1e-20f);
+			n->x *= inv_length;
+			n->y *= inv_length;
+			n->z *= inv_length;
+		};
+
+		printf("normalize normals of Attributes, median of %u runs [ns per element]\n", count_runs);
+		printf("  %10s | %9s | %9s | %9s | %9s\n", "elements", "aos pass", "soa pass", "from_aos", "to_aos");
+		for (u32 count : counts)
+		{
+			u64 rng = 0x9E3779B97F4A7C15ull;
+			for (u32 i = 0; i < count; ++i)
+			{
+				rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17;
+				f32 value = (f32)(rng >> 40) / (f32)(1 << 24) + 0.5f;
+				aos[i] = { { value, 1.0f, 2.0f, 1.0f }, { value, -value, 0.5f, 0.0f }, { value, 1.0f - value, 0.0f, 0.0f } };
+			}
+
+			f64 aos_ms[count_runs];
+			f64 soa_ms[count_runs];
+			f64 from_aos_ms[count_runs];
+			f64 to_aos_ms[count_runs];
+			Memory_View aos_view = { aos, (u64)count * sizeof(Attributes), sizeof(Attributes) };
+			Memory_View aos_back_view = { aos_back, (u64)count * sizeof(Attributes), sizeof(Attributes) };
+			for (u32 run_i = 0; run_i < count_runs; ++run_i)
+			{
+				u64 tick_start = get_performance_ticks();
+				soa.from_aos(aos_view);
+				from_aos_ms[run_i] = get_elapsed_ms_here(clock, tick_start);
+
+				tick_start = get_performance_ticks();
+				for (u32 i = 0; i < count; ++i)
+					normalize(&aos[i].normal);
+				aos_ms[run_i] = get_elapsed_ms_here(clock, tick_start);
+
+				// Padded tail is zeroed, so loop runs over whole SIMD lanes
+				soa.pad_tail();
+				Vec4* normals = soa.field<&Attributes::normal>();
+				u32 padded_count = soa.get_padded_count();
+				tick_start = get_performance_ticks();
+				for (u32 i = 0; i < padded_count; ++i)
+					normalize(&normals[i]);
+				soa_ms[run_i] = get_elapsed_ms_here(clock, tick_start);
+
+				tick_start = get_performance_ticks();
+				soa.to_aos(aos_back_view);
+				to_aos_ms[run_i] = get_elapsed_ms_here(clock, tick_start);
+			}
+
+			printf("  %10u | %9.2lf | %9.2lf | %9.2lf | %9.2lf\n", count,
+			       get_median(aos_ms, count_runs) * 1e6 / count, get_median(soa_ms, count_runs) * 1e6 / count,
+			       get_median(from_aos_ms, count_runs) * 1e6 / count, get_median(to_aos_ms, count_runs) * 1e6 / count);
+		}
+
+		vm_release(arena.base, arena.max_size);
+	}
+
+	// ===============================================================================================================================
+	// ========================================================= QUEUES ==============================================================
+	// ===============================================================================================================================
+
+	//? Throughput of Spsc_Ring and Mpmc_Queue moving u64 values from producer to consumer threads, one at time and in
+	//? batches, and round trip latency of two Spsc_Rings ping-ponging one value. Waiting side yields, so it also
+	//? finishes when there are less cores than threads
+	internal void bench_queues(const Platform_Clock& clock)
+	{
+		constexpr u64 count_values = 1 << 21;
+		constexpr u32 capacity = 1024;
+		constexpr u32 max_batch = 32;
+		constexpr u32 count_runs = 3;
+		constexpr u32 count_round_trips = 1 << 14;
+		constexpr u32 batch_sizes[] = { 1, max_batch };
+
+		Alloc_Arena arena = arena_reserve(MiB(64));
+		AlwaysAssert(arena.base && "Failed to reserve memory from OS");
+
+		u32 max_count_threads = lib::clamp(std::thread::hardware_concurrency(), 2u, 8u);
+		printf("%llu u64 values, capacity %u, median of %u runs\n", (unsigned long long)count_values, capacity, count_runs);
+		printf("  %-6s | %9s | %5s | %9s | %12s\n", "queue", "prod:cons", "batch", "ms", "Mvalues/s");
+
+		auto print_row = [&](const char* name, u32 count_producers, u32 count_consumers, u32 batch, f64* times_ms)
+		{
+			f64 median_ms = get_median(times_ms, count_runs);
+			printf("  %-6s | %4u:%-4u | %5u | %9.2lf | %12.2lf\n", name, count_producers, count_consumers, batch, median_ms,
+			       (f64)count_values / (median_ms * 1000.0));
+		};
+
+		for (u32 batch : batch_sizes)
+		{
+			f64 times_ms[count_runs];
+			for (u32 run_i = 0; run_i < count_runs; ++run_i)
+			{
+				Arena_Temp_Scope temp(&arena);
+				Spsc_Ring<u64>* ring = (Spsc_Ring<u64>*)allocate(&arena, sizeof(Spsc_Ring<u64>), alignof(Spsc_Ring<u64>));
+				ring->init(&arena, capacity);
+
+				auto work = [&](u32 thread_i)
+				{
+					u64 values[max_batch];
+					if (thread_i == 0)
+					{
+						for (u64 sent = 0; sent < count_values; )
+						{
+							u32 count = (u32)lib::min((u64)batch, count_values - sent);
+							for (u32 i = 0; i < count; ++i)
+								values[i] = sent + i;
+							u32 pushed = ring->push_batch(values, count);
+							sent += pushed;
+							if (pushed == 0)
+								std::this_thread::yield();
+						}
+					}
+					else
+					{
+						for (u64 received = 0; received < count_values; )
+						{
+							u32 popped = ring->pop_batch(values, batch);
+							received += popped;
+							if (popped == 0)
+								std::this_thread::yield();
+						}
+					}
+				};
+				times_ms[run_i] = run_on_threads(clock, 2, work);
+			}
+			print_row("spsc", 1, 1, batch, times_ms);
+		}
+
+		for (u32 count_threads = 2; ; count_threads = lib::min(count_threads * 2, max_count_threads))
+		{
+			u32 count_producers = count_threads / 2;
+			u32 count_consumers = count_threads - count_producers;
+			for (u32 batch : batch_sizes)
+			{
+				f64 times_ms[count_runs];
+				for (u32 run_i = 0; run_i < count_runs; ++run_i)
+				{
+					Arena_Temp_Scope temp(&arena);
+					Mpmc_Queue<u64>* queue = (Mpmc_Queue<u64>*)allocate(&arena, sizeof(Mpmc_Queue<u64>), alignof(Mpmc_Queue<u64>));
+					queue->init(&arena, capacity);
+					std::atomic<u64> count_received = 0;
+
+					auto work = [&](u32 thread_i)
+					{
+						u64 values[max_batch];
+						if (thread_i < count_producers)
+						{
+							// Producer "i" sends every count_producers-th value, together they send 1..count_values
+							u64 count_to_send = count_values / count_producers + (thread_i < count_values % count_producers);
+							for (u64 sent = 0; sent < count_to_send; )
+							{
+								u32 count = (u32)lib::min((u64)batch, count_to_send - sent);
+								for (u32 i = 0; i < count; ++i)
+									values[i] = (sent + i) * count_producers + thread_i + 1;
+								u32 pushed = queue->push_batch(values, count);
+								sent += pushed;
+								if (pushed == 0)
+									std::this_thread::yield();
+							}
+						}
+						else
+						{
+							while (count_received.load(std::memory_order_relaxed) < count_values)
+							{
+								u32 popped = queue->pop_batch(values, batch);
+								if (popped > 0)
+									count_received.fetch_add(popped, std::memory_order_relaxed);
+								else
+									std::this_thread::yield();
+							}
+						}
+					};
+					times_ms[run_i] = run_on_threads(clock, count_threads, work);
+				}
+				print_row("mpmc", count_producers, count_consumers, batch, times_ms);
+			}
+
+			if (count_threads == max_count_threads)
+				break;
+		}
+
+		// Latency - value goes there on one ring and back on other, so every sample is two hand-offs
+		{
+			Arena_Temp_Scope temp(&arena);
+			Spsc_Ring<u64>* rings = (Spsc_Ring<u64>*)allocate(&arena, 2 * sizeof(Spsc_Ring<u64>), alignof(Spsc_Ring<u64>));
+			rings[0].init(&arena, 2);
+			rings[1].init(&arena, 2);
+			f64* round_trip_ns = (f64*)allocate(&arena, count_round_trips * sizeof(f64), alignof(f64));
+			f64 ns_per_tick = 1e9 / (f64)clock.clock_freq;
+
+			auto work = [&](u32 thread_i)
+			{
+				Spsc_Ring<u64>* from = &rings[thread_i];
+				Spsc_Ring<u64>* to = &rings[1 - thread_i];
+				for (u32 i = 0; i < count_round_trips; ++i)
+				{
+					u64 value = 0;
+					u64 tick_start = get_performance_ticks();
+					if (thread_i == 0)
+						AlwaysAssert(to->push(i));
+					while (!from->pop(&value))
+						std::this_thread::yield();
+					if (thread_i == 0)
+						round_trip_ns[i] = (f64)(get_performance_ticks() - tick_start) * ns_per_tick;
+					else
+						AlwaysAssert(to->push(value));
+				}
+			};
+			(void)run_on_threads(clock, 2, work);
+
+			sort_f64(round_trip_ns, count_round_trips);
+			printf("spsc ping-pong, %u round trips [us]: p50 %.2lf | p90 %.2lf | p99 %.2lf | max %.2lf\n", count_round_trips,
+			       get_percentile(round_trip_ns, count_round_trips, 50.0) / 1000.0, get_percentile(round_trip_ns, count_round_trips, 90.0) / 1000.0,
+			       get_percentile(round_trip_ns, count_round_trips, 99.0) / 1000.0, round_trip_ns[count_round_trips - 1] / 1000.0);
+		}
+
+		vm_release(arena.base, arena.max_size);
+	}
+
+	// ===============================================================================================================================
+	// ========================================================= BITSET ==============================================================
+	// ===============================================================================================================================
+
+	//? Visible & resident sets of 1M objects at few densities: Bitset AND (AVX2, summary skip) against plain u64 loop, and
+	//? visiting set bits through summary against scan of every word
+	internal void bench_bitset(const Platform_Clock& clock)
+	{
+		constexpr u32 count_objects = 1 << 20;
+		constexpr u32 count_runs = 9;
+		constexpr f64 densities[] = { 0.001, 0.01, 0.1, 0.5 };
+
+		Alloc_Arena arena = arena_reserve(MiB(16));
+		AlwaysAssert(arena.base && "Failed to reserve memory from OS");
+		Bitset visible, resident, live;
+		visible.init(&arena, count_objects);
+		resident.init(&arena, count_objects);
+		live.init(&arena, count_objects);
+		u64* live_flat = (u64*)allocate(&arena, (u64)live.count_words * sizeof(u64), alignof(u64));
+		volatile u64 sink = 0; // keeps iterations from being optimized out
+
+		printf("%u objects, resident = 90%%, live = visible & resident, median of %u runs [us]\n", count_objects, count_runs);
+		printf("  %8s | %10s | %10s | %10s | %10s | %10s\n", "visible", "live bits", "and", "and flat", "iterate", "iter flat");
+		for (f64 density : densities)
+		{
+			u64 rng = 0x9E3779B97F4A7C15ull;
+			auto next_unit = [&]
+			{
+				rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17;
+				return (f64)(rng >> 11) / (f64)(1ull << 53);
+			};
+
+			visible.clear_all();
+			resident.clear_all();
+			for (u32 i = 0; i < count_objects; ++i)
+			{
+				visible.set_to(i, next_unit() < density);
+				resident.set_to(i, next_unit() < 0.9);
+			}
+
+			f64 and_ms[count_runs];
+			f64 and_flat_ms[count_runs];
+			f64 iterate_ms[count_runs];
+			f64 iterate_flat_ms[count_runs];
+			u64 index_sum = 0;
+			u64 index_sum_flat = 0;
+			for (u32 run_i = 0; run_i < count_runs; ++run_i)
+			{
+				u64 tick_start = get_performance_ticks();
+				live.assign_and(visible, resident);
+				and_ms[run_i] = get_elapsed_ms_here(clock, tick_start);
+
+				tick_start = get_performance_ticks();
+				for (u32 i = 0; i < live.count_words; ++i)
+					live_flat[i] = visible.words[i] & resident.words[i];
+				and_flat_ms[run_i] = get_elapsed_ms_here(clock, tick_start);
+
+				index_sum = 0;
+				tick_start = get_performance_ticks();
+				live.for_each_set([&](u32 i) { index_sum += i; });
+				iterate_ms[run_i] = get_elapsed_ms_here(clock, tick_start);
+
+				index_sum_flat = 0;
+				tick_start = get_performance_ticks();
+				for (u32 word_i = 0; word_i < live.count_words; ++word_i)
+				{
+					for (u64 bits = live_flat[word_i]; bits; bits &= bits - 1)
+						index_sum_flat += word_i * 64 + find_lsb_u64(bits);
+				}
+				iterate_flat_ms[run_i] = get_elapsed_ms_here(clock, tick_start);
+			}
+
+			sink = sink + index_sum + index_sum_flat;
+
+			printf("  %7.1lf%% | %10u | %10.2lf | %10.2lf | %10.2lf | %10.2lf\n", density * 100.0, live.count(),
+			       get_median(and_ms, count_runs) * 1000.0, get_median(and_flat_ms, count_runs) * 1000.0,
+			       get_median(iterate_ms, count_runs) * 1000.0, get_median(iterate_flat_ms, count_runs) * 1000.0);
+		}
+
+		vm_release(arena.base, arena.max_size);
+	}
+} // namespace Linux
@@ -0,0 +1,430 @@
+#pragma once
+
+//? Math benchmarks: batch kernels, their SIMD levels, quaternion blends, affine transforms and culling
+namespace Linux
+{
+	// ===============================================================================================================================
+	// ======================================================= MATH x8 ===============================================================
+	// ===============================================================================================================================
+
+	//? Batch kernels of Math_x8.hpp over SoA streams against per element Mat4/Vec3 operators over AoS arrays, odd count
+	//? so scalar tail runs too
+	internal void bench_math_x8(const Platform_Clock& clock)
+	{
+		constexpr u32 count = (1 << 20) + 5;
+		constexpr u32 count_matrices = (1 << 18) + 3;
+		constexpr u32 count_runs = 9;
+
+		Alloc_Arena arena = arena_reserve(MiB(256));
+		AlwaysAssert(arena.base && "Failed to reserve memory from OS");
+		auto push_floats = [&](u32 count_floats) { return (f32*)allocate(&arena, (u64)count_floats * sizeof(f32), 64); };
+
+		lib::Vec4* aos_points = (lib::Vec4*)allocate(&arena, (u64)count * sizeof(lib::Vec4), alignof(lib::Vec4));
+		lib::Vec3* aos_normals = (lib::Vec3*)allocate(&arena, (u64)count * sizeof(lib::Vec3), alignof(lib::Vec3));
+		lib::Mat4* aos_matrices = (lib::Mat4*)allocate(&arena, (u64)count_matrices * sizeof(lib::Mat4), alignof(lib::Mat4));
+		lib::Vec3_Soa_View points = { push_floats(count), push_floats(count), push_floats(count) };
+		lib::Vec3_Soa_View points_out = { push_floats(count), push_floats(count), push_floats(count) };
+		lib::Vec3_Soa_View normals = { push_floats(count), push_floats(count), push_floats(count) };
+		lib::Vec3_Soa_View normals_out = { push_floats(count), push_floats(count), push_floats(count) };
+		lib::Mat4_Soa_View matrices;
+		lib::Mat4_Soa_View matrices_out;
+		for (u32 column = 0; column < 4; ++column)
+		{
+			for (u32 row = 0; row < 4; ++row)
+			{
+				matrices.e[column][row] = push_floats(count_matrices);
+				matrices_out.e[column][row] = push_floats(count_matrices);
+			}
+		}
+
+		u64 rng = 0x9E3779B97F4A7C15ull;
+		auto next_f32 = [&]
+		{
+			rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17;
+			return (f32)(rng >> 40) / (f32)(1 << 24) * 2.0f - 1.0f;
+		};
+		for (u32 i = 0; i < count; ++i)
+		{
+			aos_points[i] = { next_f32(), next_f32(), next_f32(), 1.0f };
+			aos_normals[i] = { next_f32(), next_f32(), next_f32() };
+			points.x[i] = aos_points[i].x; points.y[i] = aos_points[i].y; points.z[i] = aos_points[i].z;
+			normals.x[i] = aos_normals[i].x; normals.y[i] = aos_normals[i].y; normals.z[i] = aos_normals[i].z;
+		}
+		for (u32 i = 0; i < count_matrices; ++i)
+		{
+			for (u32 column = 0; column < 4; ++column)
+			{
+				for (u32 row = 0; row < 4; ++row)
+				{
+					aos_matrices[i].e[column][row] = next_f32();
+					matrices.e[column][row][i] = aos_matrices[i].e[column][row];
+				}
+			}
+		}
+
+		lib::Mat4 model = lib::create_translate(lib::Vec3{ 1.0f, -2.0f, 3.0f }) * lib::create_rotation(lib::Vec3{ 0.3f, 1.0f, 0.2f }, 0.7f);
+		lib::Vec4* aos_points_out = (lib::Vec4*)allocate(&arena, (u64)count * sizeof(lib::Vec4), alignof(lib::Vec4));
+		lib::Vec3* aos_normals_out = (lib::Vec3*)allocate(&arena, (u64)count * sizeof(lib::Vec3), alignof(lib::Vec3));
+		lib::Mat4* aos_matrices_out = (lib::Mat4*)allocate(&arena, (u64)count_matrices * sizeof(lib::Mat4), alignof(lib::Mat4));
+
+		auto run = [&](const char* name, u32 elements, auto scalar_work, auto batch_work)
+		{
+			f64 scalar_ms[count_runs];
+			f64 batch_ms[count_runs];
+			for (u32 run_i = 0; run_i < count_runs; ++run_i)
+			{
+				u64 tick_start = get_performance_ticks();
+				scalar_work();
+				scalar_ms[run_i] = get_elapsed_ms_here(clock, tick_start);
+
+				tick_start = get_performance_ticks();
+				batch_work();
+				batch_ms[run_i] = get_elapsed_ms_here(clock, tick_start);
+			}
+			f64 scalar_median = get_median(scalar_ms, count_runs);
+			f64 batch_median = get_median(batch_ms, count_runs);
+			printf("  %-18s | %8u | %10.2lf | %10.2lf | %6.2lfx\n", name, elements, scalar_median * 1e6 / elements,
+			       batch_median * 1e6 / elements, scalar_median / batch_median);
+		};
+
+		// Small counts stay in cache and show compute, big ones are bound by memory bandwidth
+		printf("median of %u runs [ns per element]\n", count_runs);
+		printf("  %-18s | %8s | %10s | %10s | %7s\n", "kernel", "count", "per elem", "batch x8", "speedup");
+		for (u32 divisor : { 256u, 1u })
+		{
+			u32 n = count / divisor;
+			u32 n_matrices = count_matrices / divisor;
+			run("transform_points", n,
+			    [&] { for (u32 i = 0; i < n; ++i) aos_points_out[i] = model * aos_points[i]; },
+			    [&] { lib::transform_points(model, points, points_out, n); });
+			run("normalize_vectors", n,
+			    [&] { for (u32 i = 0; i < n; ++i) aos_normals_out[i] = lib::normalize(aos_normals[i]); },
+			    [&] { lib::normalize_vectors(normals, normals_out, n); });
+			run("multiply_matrices", n_matrices,
+			    [&] { for (u32 i = 0; i < n_matrices; ++i) aos_matrices_out[i] = model * aos_matrices[i]; },
+			    [&] { lib::multiply_matrices(model, matrices, matrices_out, n_matrices); });
+		}
+
+		vm_release(arena.base, arena.max_size);
+	}
+
+	// ===============================================================================================================================
+	// ===================================================== SIMD DISPATCH ===========================================================
+	// ===============================================================================================================================
+
+	//? Times every Math_Kernels variant this CPU supports on 64K elements
+	internal void bench_simd_dispatch(const Platform_Clock& clock)
+	{
+		constexpr u32 max_count = 1 << 16;
+		constexpr u32 count_runs = 9;
+
+		const Cpu_Features& features = get_cpu_features();
+		const lib::Math_Kernels& dispatched = lib::get_math_kernels();
+		Simd_Level min_max_level = dispatched.level;
+		while (lib::get_math_kernels_for(min_max_level).find_min_max != dispatched.find_min_max)
+			min_max_level = (Simd_Level)((u32)min_max_level - 1);
+		printf("cpu: sse4.1 %d | avx2+fma %d | avx512f %d -> dispatch picks %s (find_min_max %s)\n", features.has_sse41,
+		       features.has_avx2, features.has_avx512, g_simd_level_names[(u32)dispatched.level], g_simd_level_names[(u32)min_max_level]);
+
+		Alloc_Arena arena = arena_reserve(MiB(64));
+		AlwaysAssert(arena.base && "Failed to reserve memory from OS");
+		auto push_floats = [&] { return (f32*)allocate(&arena, max_count * sizeof(f32), 64); };
+		auto push_vec4s = [&] { return lib::Vec4_Soa_View{ push_floats(), push_floats(), push_floats(), push_floats() }; };
+		auto push_mat4s = [&]
+		{
+			lib::Mat4_Soa_View out;
+			for (u32 column = 0; column < 4; ++column)
+			{
+				for (u32 row = 0; row < 4; ++row)
+					out.e[column][row] = push_floats();
+			}
+			return out;
+		};
+
+		// Vec3 views use first 3 streams of Vec4 ones
+		lib::Vec4_Soa_View in = push_vec4s();
+		lib::Vec4_Soa_View result = push_vec4s();
+		lib::Mat4_Soa_View in_matrices = push_mat4s();
+		lib::Mat4_Soa_View result_matrices = push_mat4s();
+		lib::Vec3_Soa_View in3 = { in.x, in.y, in.z };
+		lib::Vec3_Soa_View result3 = { result.x, result.y, result.z };
+
+		u64 rng = 0x9E3779B97F4A7C15ull;
+		auto next_f32 = [&]
+		{
+			rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17;
+			return (f32)(rng >> 40) / (f32)(1 << 24) * 200.0f - 100.0f;
+		};
+		for (u32 i = 0; i < max_count; ++i)
+		{
+			in.x[i] = next_f32(); in.y[i] = next_f32(); in.z[i] = next_f32(); in.w[i] = next_f32();
+			for (u32 column = 0; column < 4; ++column)
+			{
+				for (u32 row = 0; row < 4; ++row)
+					in_matrices.e[column][row][i] = next_f32() * 0.01f;
+			}
+		}
+
+		lib::Mat4 model = lib::create_translate(lib::Vec3{ 1.0f, -2.0f, 3.0f }) * lib::create_rotation(lib::Vec3{ 0.3f, 1.0f, 0.2f }, 0.7f) *
+		                  lib::create_scale(1.5f);
+		auto time_ns = [&](auto work)
+		{
+			f64 times_ms[count_runs];
+			for (u32 run_i = 0; run_i < count_runs; ++run_i)
+			{
+				u64 tick_start = get_performance_ticks();
+				work();
+				times_ms[run_i] = get_elapsed_ms_here(clock, tick_start);
+			}
+			return get_median(times_ms, count_runs) * 1e6 / max_count;
+		};
+
+		printf("%u elements, median of %u runs [ns per element]\n", max_count, count_runs);
+		printf("  %-7s | %9s | %9s | %9s | %9s | %9s\n", "level", "points", "vectors", "normalize", "matrices", "min_max");
+		for (u32 level_i = 0; level_i < (u32)Simd_Level::count; ++level_i)
+		{
+			Simd_Level level = (Simd_Level)level_i;
+			if (!is_simd_level_supported(level))
+				continue;
+
+			lib::Math_Kernels kernels = lib::get_math_kernels_for(level);
+			lib::Vec3 bounds_min, bounds_max;
+			printf("  %-7s | %9.3lf | %9.3lf | %9.3lf | %9.3lf | %9.3lf\n", g_simd_level_names[level_i],
+			       time_ns([&] { kernels.transform_points(model, in3, result3, max_count); }),
+			       time_ns([&] { kernels.transform_vectors(model, in3, result3, max_count); }),
+			       time_ns([&] { kernels.normalize_vectors(in3, result3, max_count); }),
+			       time_ns([&] { kernels.multiply_matrices(model, in_matrices, result_matrices, max_count); }),
+			       time_ns([&] { kernels.find_min_max(in3, max_count, &bounds_min, &bounds_max); }));
+		}
+
+		vm_release(arena.base, arena.max_size);
+	}
+
+	// ===============================================================================================================================
+	// ===================================================== QUATERNIONS =============================================================
+	// ===============================================================================================================================
+
+	//? TRS composition against product of matrices and batch nlerp/slerp of every supported level
+	internal void bench_quat(const Platform_Clock& clock)
+	{
+		constexpr u32 count_quats = 1 << 16;
+		constexpr u32 count_runs = 9;
+
+		u64 rng = 0x9E3779B97F4A7C15ull;
+		auto next_f32 = [&] // -1 to 1
+		{
+			rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17;
+			return (f32)(rng >> 40) / (f32)(1 << 24) * 2.0f - 1.0f;
+		};
+		auto next_quat = [&] { return lib::normalize(lib::Quat{ next_f32(), next_f32(), next_f32(), next_f32() }); };
+		lib::Quat q_x90 = lib::create_quat(lib::Vec3{ 1.0f, 0.0f, 0.0f }, lib::deg_to_rad(90.0f));
+
+		// Batch blends
+		Alloc_Arena arena = arena_reserve(MiB(16));
+		AlwaysAssert(arena.base && "Failed to reserve memory from OS");
+		auto push_floats = [&] { return (f32*)allocate(&arena, count_quats * sizeof(f32), 64); };
+		auto push_quats = [&] { return lib::Vec4_Soa_View{ push_floats(), push_floats(), push_floats(), push_floats() }; };
+		lib::Vec4_Soa_View a = push_quats(), b = push_quats(), result = push_quats();
+		f32* t = push_floats();
+		for (u32 i = 0; i < count_quats; ++i)
+		{
+			lib::Quat qa = next_quat();
+			// Mostly nearby rotations as between animation keys, every 4th one anywhere (also opposite hemisphere)
+			lib::Quat qb = (i % 4 == 0) ? next_quat() : lib::normalize(qa + 0.2f * next_quat());
+			a.x[i] = qa.x; a.y[i] = qa.y; a.z[i] = qa.z; a.w[i] = qa.w;
+			b.x[i] = qb.x; b.y[i] = qb.y; b.z[i] = qb.z; b.w[i] = qb.w;
+			t[i] = fabsf(next_f32());
+		}
+
+		auto time_ns = [&](auto work)
+		{
+			f64 times_ms[count_runs];
+			for (u32 run_i = 0; run_i < count_runs; ++run_i)
+			{
+				u64 tick_start = get_performance_ticks();
+				work();
+				times_ms[run_i] = get_elapsed_ms_here(clock, tick_start);
+			}
+			return get_median(times_ms, count_runs) * 1e6 / count_quats;
+		};
+
+		// Composition of local transforms, written out TRS vs product of 3 matrices
+		lib::Trs trs = { .translation = { 1.0f, 2.0f, 3.0f }, .rotation = q_x90, .scale = { 2.0f, 2.0f, 2.0f } };
+		f32 sink = 0.0f;
+		f64 trs_ns = time_ns([&]
+		{
+			for (u32 i = 0; i < count_quats; ++i)
+			{
+				trs.rotation = lib::Quat{ a.x[i], a.y[i], a.z[i], a.w[i] };
+				sink += lib::create_transform(trs).e[0][1];
+			}
+		});
+		f64 product_ns = time_ns([&]
+		{
+			for (u32 i = 0; i < count_quats; ++i)
+			{
+				trs.rotation = lib::Quat{ a.x[i], a.y[i], a.z[i], a.w[i] };
+				sink += (lib::create_translate(trs.translation) * lib::create_rotation(trs.rotation) * lib::create_scale(trs.scale.x)).e[0][1];
+			}
+		});
+		printf("trs to mat4: create_transform %.3lf ns | T * R * S products %.3lf ns (%.2fx) [sink %.1f]\n",
+		       trs_ns, product_ns, product_ns / trs_ns, sink);
+
+		printf("%u quaternions, median of %u runs [ns per quaternion]\n", count_quats, count_runs);
+		printf("  %-7s | %9s | %9s\n", "level", "nlerp", "slerp");
+		for (u32 level_i = 0; level_i < (u32)Simd_Level::count; ++level_i)
+		{
+			Simd_Level level = (Simd_Level)level_i;
+			if (!is_simd_level_supported(level))
+				continue;
+
+			lib::Math_Kernels kernels = lib::get_math_kernels_for(level);
+			printf("  %-7s | %9.3lf | %9.3lf\n", g_simd_level_names[level_i],
+			       time_ns([&] { kernels.nlerp_quats(a, b, t, result, count_quats); }),
+			       time_ns([&] { kernels.slerp_quats(a, b, t, result, count_quats); }));
+		}
+
+		vm_release(arena.base, arena.max_size);
+	}
+
+	// ===============================================================================================================================
+	// ======================================================= TRANS4 ================================================================
+	// ===============================================================================================================================
+
+	//? Propagation of local transforms down parent chains (world = parent world * local) with Mat4 and Trans4
+	internal void bench_trans4(const Platform_Clock& clock)
+	{
+		constexpr u32 count_nodes = 1 << 16;
+		constexpr u32 count_runs = 9;
+
+		u64 rng = 0x9E3779B97F4A7C15ull;
+		auto next_f32 = [&] // -1 to 1
+		{
+			rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17;
+			return (f32)(rng >> 40) / (f32)(1 << 24) * 2.0f - 1.0f;
+		};
+		printf("%llu vs %llu bytes per transform\n", (unsigned long long)sizeof(lib::Trans4), (unsigned long long)sizeof(lib::Mat4));
+
+		// Nodes in parent before child order as flattened hierarchy, parent is one of 64 nodes before
+		Alloc_Arena arena = arena_reserve(MiB(64));
+		AlwaysAssert(arena.base && "Failed to reserve memory from OS");
+		u32* parents = (u32*)allocate(&arena, count_nodes * sizeof(u32), 64);
+		lib::Mat4* locals = (lib::Mat4*)allocate(&arena, count_nodes * sizeof(lib::Mat4), 64);
+		lib::Mat4* worlds = (lib::Mat4*)allocate(&arena, count_nodes * sizeof(lib::Mat4), 64);
+		lib::Trans4* locals_t = (lib::Trans4*)allocate(&arena, count_nodes * sizeof(lib::Trans4), 64);
+		lib::Trans4* worlds_t = (lib::Trans4*)allocate(&arena, count_nodes * sizeof(lib::Trans4), 64);
+		for (u32 i = 0; i < count_nodes; ++i)
+		{
+			parents[i] = (i == 0) ? 0 : i - 1 - (u32)(rng % lib::min(i, 64u));
+			rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17;
+			// Rotation only, so long chains stay in range
+			locals[i] = lib::create_translate(lib::Vec3{ next_f32(), next_f32(), next_f32() }) *
+			            lib::create_rotation(lib::Vec3{ next_f32(), next_f32(), 1.0f }, next_f32());
+			locals_t[i] = lib::create_trans4(locals[i]);
+		}
+
+		auto propagate_mat4 = [&]
+		{
+			worlds[0] = locals[0];
+			for (u32 i = 1; i < count_nodes; ++i)
+				worlds[i] = lib::mul_trans(worlds[parents[i]], locals[i]);
+		};
+		auto propagate_trans4 = [&]
+		{
+			worlds_t[0] = locals_t[0];
+			for (u32 i = 1; i < count_nodes; ++i)
+				worlds_t[i] = worlds_t[parents[i]] * locals_t[i];
+		};
+		auto time_ns = [&](auto work)
+		{
+			f64 times_ms[count_runs];
+			for (u32 run_i = 0; run_i < count_runs; ++run_i)
+			{
+				u64 tick_start = get_performance_ticks();
+				work();
+				times_ms[run_i] = get_elapsed_ms_here(clock, tick_start);
+			}
+			return get_median(times_ms, count_runs) * 1e6 / count_nodes;
+		};
+		f64 mat4_ns = time_ns(propagate_mat4);
+		f64 trans4_ns = time_ns(propagate_trans4);
+		printf("propagation of %u nodes, median of %u runs: mat4 mul_trans %.3lf ns | trans4 %.3lf ns per node (%.2fx)\n",
+		       count_nodes, count_runs, mat4_ns, trans4_ns, mat4_ns / trans4_ns);
+
+		vm_release(arena.base, arena.max_size);
+	}
+
+	// ===============================================================================================================================
+	// ======================================================= CULLING ===============================================================
+	// ===============================================================================================================================
+
+	//? Frustum of 60 degree camera against 1M spheres / boxes scattered around it, throughput of every supported
+	//? kernel variant
+	internal void bench_culling(const Platform_Clock& clock)
+	{
+		constexpr u32 count_objects = 1 << 20;
+		constexpr u32 count_runs = 9;
+
+		lib::Mat4 view = lib::create_look_at(lib::Vec3{ 0.0f, 0.0f, 0.0f }, lib::Vec3{ 0.0f, 0.0f, -1.0f }, lib::Vec3{ 0.0f, 1.0f, 0.0f });
+		lib::Mat4 projection = lib::create_perspective(lib::deg_to_rad(60.0f), 16.0f / 9.0f, 0.1f, 1000.0f);
+		lib::Frustum frustum = lib::create_frustum(projection * view);
+
+		Alloc_Arena arena = arena_reserve(MiB(64));
+		AlwaysAssert(arena.base && "Failed to reserve memory from OS");
+		auto push_floats = [&] { return (f32*)allocate(&arena, count_objects * sizeof(f32), 64); };
+		auto push_indices = [&] { return (u32*)allocate(&arena, count_objects * sizeof(u32), 64); };
+		lib::Vec3_Soa_View centers = { push_floats(), push_floats(), push_floats() };
+		lib::Vec3_Soa_View extents = { push_floats(), push_floats(), push_floats() };
+		f32* radii = push_floats();
+		u32* result = push_indices();
+
+		u64 rng = 0x9E3779B97F4A7C15ull;
+		auto next_f32 = [&] // 0 to 1
+		{
+			rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17;
+			return (f32)(rng >> 40) / (f32)(1 << 24);
+		};
+		for (u32 i = 0; i < count_objects; ++i)
+		{
+			centers.x[i] = next_f32() * 1000.0f - 500.0f;
+			centers.y[i] = next_f32() * 1000.0f - 500.0f;
+			centers.z[i] = next_f32() * 1000.0f - 500.0f;
+			extents.x[i] = 0.5f + next_f32() * 4.0f;
+			extents.y[i] = 0.5f + next_f32() * 4.0f;
+			extents.z[i] = 0.5f + next_f32() * 4.0f;
+			radii[i] = lib::length_vec(lib::Vec3{ extents.x[i], extents.y[i], extents.z[i] });
+		}
+
+		u32 count_visible_spheres = lib::cull_spheres_scalar(frustum, centers, radii, count_objects, result);
+		u32 count_visible_aabbs = lib::cull_aabbs_scalar(frustum, centers, extents, count_objects, result);
+		printf("visible of %u: %u spheres, %u boxes\n", count_objects, count_visible_spheres, count_visible_aabbs);
+
+		auto time_ms = [&](auto work)
+		{
+			f64 times_ms[count_runs];
+			for (u32 run_i = 0; run_i < count_runs; ++run_i)
+			{
+				u64 tick_start = get_performance_ticks();
+				work();
+				times_ms[run_i] = get_elapsed_ms_here(clock, tick_start);
+			}
+			return get_median(times_ms, count_runs);
+		};
+
+		printf("%u objects, median of %u runs [thousands of objects per ms]\n", count_objects, count_runs);
+		printf("  %-7s | %9s | %9s\n", "level", "spheres", "aabbs");
+		for (u32 level_i = 0; level_i < (u32)Simd_Level::count; ++level_i)
+		{
+			Simd_Level level = (Simd_Level)level_i;
+			if (!is_simd_level_supported(level))
+				continue;
+
+			lib::Math_Kernels kernels = lib::get_math_kernels_for(level);
+			f64 spheres_ms = time_ms([&] { (void)kernels.cull_spheres(frustum, centers, radii, count_objects, result); });
+			f64 aabbs_ms = time_ms([&] { (void)kernels.cull_aabbs(frustum, centers, extents, count_objects, result); });
+			printf("  %-7s | %9.1lf | %9.1lf\n", g_simd_level_names[level_i], count_objects / spheres_ms / 1000.0, count_objects / aabbs_ms / 1000.0);
+		}
+
+		vm_release(arena.base, arena.max_size);
+	}
+} // namespace Linux
@@ -0,0 +1,270 @@
+#pragma once
+
+//? Arena benchmarks: reset policies, concurrent arena, scratch scopes, growing arrays and huge pages
+namespace Linux
+{
+	// ===============================================================================================================================
+	// ======================================================= ARENA RESET ===========================================================
+	// ===============================================================================================================================
+
+	//? Cost of arena_reset per zeroing policy versus bytes used before it. "cycle" is reset + allocate + first write of
+	//? same amount of bytes, so cost moved by policy to allocation or to page faults after reclaim is visible too
+	internal void bench_arena_reset(const Platform_Clock& clock)
+	{
+		constexpr u64 max_used = MiB(128);
+		constexpr u32 max_count_runs = 200;
+		constexpr u64 used_sizes[] = { KiB(4), KiB(64), MiB(1), MiB(16), MiB(128) };
+		constexpr struct { Alloc_Zeroing zeroing; const char* name; } policies[] =
+		{
+			{ Alloc_Zeroing::on_free, 			"on_free" },
+			{ Alloc_Zeroing::none, 					"none" },
+			{ Alloc_Zeroing::on_allocate, 	"on_allocate" },
+			{ Alloc_Zeroing::reclaim_pages, "reclaim_pages" },
+		};
+
+		f64 reset_ms[max_count_runs];
+		f64 cycle_ms[max_count_runs];
+
+		printf("arena_reset [us], median (reset only | reset + allocate + first write):\n");
+		printf("  %12s", "bytes used");
+		for (const auto& policy : policies)
+			printf(" | %-23s", policy.name);
+		printf("\n");
+
+		for (u64 used : used_sizes)
+		{
+			// Fewer runs for big sizes, every run touches whole used range
+			u32 count_runs = (u32)lib::clamp<u64>(GiB(4) / used, 5, max_count_runs);
+
+			printf("  %12llu", (unsigned long long)used);
+			for (const auto& policy : policies)
+			{
+				Alloc_Arena arena = arena_reserve(max_used);
+				AlwaysAssert(arena.base && "Failed to reserve memory from OS");
+				arena.zeroing = policy.zeroing;
+
+				// Warm up - pages are committed and touched once, as in steady state frames
+				memset(allocate(&arena, used), 1, used);
+
+				for (u32 run_i = 0; run_i < count_runs; ++run_i)
+				{
+					u64 tick_start = get_performance_ticks();
+					arena_reset(&arena);
+					reset_ms[run_i] = get_elapsed_ms_here(clock, tick_start);
+
+					memset(allocate(&arena, used), 1, used);
+					cycle_ms[run_i] = get_elapsed_ms_here(clock, tick_start);
+				}
+
+				printf(" | %10.2lf | %10.2lf", get_median(reset_ms, count_runs) * 1000.0, get_median(cycle_ms, count_runs) * 1000.0);
+				vm_release(arena.base, arena.max_size);
+			}
+			printf("\n");
+		}
+	}
+
+	// ===============================================================================================================================
+	// ======================================================= ARENA MT ==============================================================
+	// ===============================================================================================================================
+
+	//? Small allocations pushed from 1 to N threads at once into one Alloc_Arena_MT, with per-thread chunks and with
+	//? every allocation going through shared atomic offset (chunk size 0) as baseline
+	internal void bench_arena_mt(const Platform_Clock& clock)
+	{
+		constexpr u64 count_allocs_per_thread = 1 << 18;
+		constexpr u64 alloc_size = 48;
+		constexpr u32 count_runs = 5;
+		constexpr u64 chunk_sizes[] = { g_default_arena_mt_chunk_size, 0 };
+
+		u32 max_count_threads = lib::clamp(std::thread::hardware_concurrency(), 1u, 64u);
+		u64 arena_size = (u64)max_count_threads * (count_allocs_per_thread * (alloc_size + 16) + g_default_arena_mt_chunk_size * 2); // + alignment padding
+
+		printf("%llu allocations of %llu bytes per thread, median of %u runs\n", 
+		       (unsigned long long)count_allocs_per_thread, (unsigned long long)alloc_size, count_runs);
+		printf("  %8s | %-35s | %-35s\n", "threads", "chunked (64 KiB) [ms | Malloc/s | x]", "shared offset [ms | Malloc/s | x]");
+
+		f64 single_thread_ms[array_count_32(chunk_sizes)] = {};
+		for (u32 count_threads = 1; ; count_threads = lib::min(count_threads * 2, max_count_threads))
+		{
+			printf("  %8u", count_threads);
+			for (u32 config_i = 0; config_i < array_count_32(chunk_sizes); ++config_i)
+			{
+				Alloc_Arena parent = arena_reserve(arena_size + MiB(1));
+				AlwaysAssert(parent.base && "Failed to reserve memory from OS");
+				Alloc_Arena_MT arena{};
+				arena_mt_from_allocator(&arena, &parent, arena_size, 0, chunk_sizes[config_i]);
+
+				auto work = [&](u32)
+				{
+					for (u64 alloc_i = 0; alloc_i < count_allocs_per_thread; ++alloc_i)
+					{
+						u64* data = (u64*)allocate(&arena, alloc_size, 16);
+						*data = alloc_i;
+					}
+				};
+
+				// First run commits pages, they stay committed after reset
+				run_on_threads(clock, count_threads, work);
+				arena_mt_reset(&arena);
+
+				f64 times_ms[count_runs];
+				for (u32 run_i = 0; run_i < count_runs; ++run_i)
+				{
+					times_ms[run_i] = run_on_threads(clock, count_threads, work);
+					arena_mt_reset(&arena);
+				}
+
+				f64 median_ms = get_median(times_ms, count_runs);
+				if (count_threads == 1)
+					single_thread_ms[config_i] = median_ms;
+				
+				// Speedup of throughput against single thread, ideal is count of threads
+				f64 count_allocs = (f64)(count_allocs_per_thread * count_threads);
+				printf(" | %10.2lf | %12.2lf | %7.2lf", median_ms, count_allocs / median_ms / 1000.0,
+				       single_thread_ms[config_i] * (f64)count_threads / median_ms);
+
+				vm_release(parent.base, parent.max_size);
+			}
+			printf("\n");
+
+			if (count_threads == max_count_threads)
+				break;
+		}
+	}
+
+	// ===============================================================================================================================
+	// ======================================================= SCRATCH ===============================================================
+	// ===============================================================================================================================
+
+	//? Cost of scratch scope with few small allocations. Runs on own thread, so scratch arenas start unreserved
+	internal void bench_scratch(const Platform_Clock& clock)
+	{
+		constexpr u32 count_scopes = 1 << 20;
+		constexpr u32 count_runs = 5;
+
+		f64 times_ms[count_runs];
+		run_on_threads(clock, 1, [&](u32)
+		{
+			for (u32 run_i = 0; run_i < count_runs; ++run_i)
+			{
+				u64 tick_start = get_performance_ticks();
+				for (u32 scope_i = 0; scope_i < count_scopes; ++scope_i)
+				{
+					Arena_Temp_Scope scratch = get_scratch();
+					u32* a = (u32*)allocate(scratch.arena(), 16 * sizeof(u32));
+					u32* b = (u32*)allocate(scratch.arena(), 64 * sizeof(u32));
+					a[15] = scope_i;
+					b[63] = a[15];
+				}
+				times_ms[run_i] = get_elapsed_ms_here(clock, tick_start);
+			}
+		});
+
+		printf("%u scratch scopes with 2 small allocations, median of %u runs: %.1lf ns per scope\n", count_scopes, count_runs,
+		       get_median(times_ms, count_runs) * 1e6 / (f64)count_scopes);
+	}
+
+	// ===============================================================================================================================
+	// ======================================================= ARENA ARRAY ===========================================================
+	// ===============================================================================================================================
+
+	//? Pushing elements of unknown count into Arena_Array: alone in arena (grows in place), with other allocation made
+	//? whenever it is full (moves on every growth) and reserved up front as baseline
+	internal void bench_arena_array(const Platform_Clock& clock)
+	{
+		constexpr u64 count_elements = 1 << 24;
+		constexpr u32 count_runs = 5;
+		constexpr const char* configs[] = { "in place", "relocating", "reserved" };
+
+		printf("%llu u32 pushes, median of %u runs\n", (unsigned long long)count_elements, count_runs);
+		printf("  %-10s | %9s | %12s | %s\n", "growth", "ms", "ns per push", "arena used [bytes]");
+		for (u32 config_i = 0; config_i < array_count_32(configs); ++config_i)
+		{
+			f64 times_ms[count_runs];
+			u64 used_bytes = 0;
+			for (u32 run_i = 0; run_i < count_runs; ++run_i)
+			{
+				Alloc_Arena arena = arena_reserve(GiB(1));
+				AlwaysAssert(arena.base && "Failed to reserve memory from OS");
+				Arena_Array<u32> array;
+				array.init(&arena, (config_i == 2) ? count_elements : 0);
+
+				u64 tick_start = get_performance_ticks();
+				for (u64 i = 0; i < count_elements; ++i)
+				{
+					array.push((u32)i);
+					// Something else takes arena end every time array is about to grow
+					if (config_i == 1 && array.count == array.capacity)
+						*(u32*)allocate(&arena, sizeof(u32)) = (u32)i;
+				}
+				times_ms[run_i] = get_elapsed_ms_here(clock, tick_start);
+				used_bytes = arena.curr_offset;
+				vm_release(arena.base, arena.max_size);
+			}
+
+			f64 median_ms = get_median(times_ms, count_runs);
+			printf("  %-10s | %9.2lf | %12.2lf | %llu\n", configs[config_i], median_ms, median_ms * 1e6 / (f64)count_elements,
+			       (unsigned long long)used_bytes);
+		}
+	}
+
+	// ===============================================================================================================================
+	// ======================================================= HUGE PAGES ============================================================
+	// ===============================================================================================================================
+
+	//? Dependent random reads over big arena (TLB bound) and sequential sum over it, normal vs huge page backed arena
+	internal void bench_huge_pages(const Platform_Clock& clock)
+	{
+		constexpr u64 used_size = MiB(512);
+		constexpr u64 count_reads = 1 << 24;
+		constexpr u32 count_runs = 3;
+		constexpr u64 count_elements = used_size / sizeof(u64);
+
+		printf("%llu bytes arena, median of %u runs\n", (unsigned long long)used_size, count_runs);
+		printf("  %-8s | %-18s | %-18s | %s\n", "pages", "random read [ns]", "sequential [GB/s]", "on huge pages [bytes]");
+		for (b32 is_huge : { false, true })
+		{
+			Alloc_Arena arena = is_huge ? arena_reserve_huge(used_size) : arena_reserve(used_size);
+			AlwaysAssert(arena.base && "Failed to reserve memory from OS");
+
+			// Random cycle through all elements, so every read depends on previous one
+			u64* next = (u64*)allocate(&arena, used_size);
+			for (u64 i = 0; i < count_elements; ++i)
+				next[i] = i;
+			u64 rng = 0x9E3779B97F4A7C15ull;
+			for (u64 i = count_elements - 1; i > 0; --i)
+			{
+				rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17;
+				u64 j = rng % i;
+				swap(next[i], next[j]);
+			}
+
+			f64 random_ms[count_runs];
+			f64 sequential_ms[count_runs];
+			volatile u64 sink = 0; // keeps reads from being optimized out
+			for (u32 run_i = 0; run_i < count_runs; ++run_i)
+			{
+				u64 tick_start = get_performance_ticks();
+				u64 at = 0;
+				for (u64 read_i = 0; read_i < count_reads; ++read_i)
+					at = next[at];
+				random_ms[run_i] = get_elapsed_ms_here(clock, tick_start);
+				sink = sink + at;
+
+				tick_start = get_performance_ticks();
+				u64 sum = 0;
+				for (u64 i = 0; i < count_elements; ++i)
+					sum += next[i];
+				sequential_ms[run_i] = get_elapsed_ms_here(clock, tick_start);
+				sink = sink + sum;
+			}
+
+			printf("  %-8s | %18.2lf | %18.2lf | %llu\n", is_huge ? "huge" : "normal",
+			       get_median(random_ms, count_runs) * 1e6 / (f64)count_reads,
+			       (f64)used_size / (get_median(sequential_ms, count_runs) * 1e6),
+			       (unsigned long long)get_huge_page_bytes(arena.base, arena.max_size));
+
+			vm_release(arena.base, arena.max_size);
+		}
+	}
+} // namespace Linux
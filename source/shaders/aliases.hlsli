@@ -6,4 +6,4 @@
 #define Vec3 float3
 #define Vec4 float4
 #define Mat4 float4x4
-#define Trans4 float4x4
\ No newline at end of file
+#define Trans4 float4x3
\ No newline at end of file
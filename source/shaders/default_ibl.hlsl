@@ -21,11 +21,10 @@ PSInput VSMain(uint vertex_id : SV_VertexID)
 	
 	float4 pos = float4(pos_buffer[vertex_id].position, 1.0f);
 	
-	const float4x4 obj_to_world = cb_per_draw.obj_to_world;
-	const float4x4 obj_to_clip = mul(cb_per_draw.world_to_clip, obj_to_world);
+	const float3 pos_world = mul(pos, cb_per_draw.obj_to_world);
 	
-	result.pos_ndc 	= mul(obj_to_clip, pos);
-	result.pos 			= mul(obj_to_world, pos).xyz;
+	result.pos_ndc 	= mul(cb_per_draw.world_to_clip, float4(pos_world, 1.0f));
+	result.pos 			= pos_world;
 	result.uv 			= attributes[vertex_id].uv.xy;
 	result.tangent 	= attributes[vertex_id].tangent;
 	result.normal		= attributes[vertex_id].normal.xyz;
@@ -54,7 +53,7 @@ float4 PSMain(PSInput inp) : SV_TARGET
 	TextureCube<float4>env_tex 			= ResourceDescriptorHeap[cb_draw_ids.env_id];
 	TextureCube<float4>env_irr_tex 	= ResourceDescriptorHeap[cb_draw_ids.env_irr_id];
 	
-	const float3x3 obj_to_world = (float3x3)cb_per_draw.obj_to_world;
+	const float3x3 obj_to_world = transpose((float3x3)cb_per_draw.obj_to_world);
 	const float2 met_rough 			= rough_tex.Sample(sam_linear, inp.uv).gb;
 	const float3 ao 						= ao_tex.Sample(sam_linear, inp.uv).rgb;
 	
@@ -0,0 +1,463 @@
+#pragma once
+
+//? General purpose and GPU side allocator tests: thread cached pool, TLSF, offset allocator and upload ring
+namespace Linux
+{
+	// ===============================================================================================================================
+	// ======================================================= POOL MT ===============================================================
+	// ===============================================================================================================================
+
+	struct Pool_MT_Held
+	{
+		u64* block;
+		u64 stamp;
+	};
+
+	//? Every block handed out is claimed in "owners", so block given to two holders at once fails right away. Fresh
+	//? block must carry poison and is then stamped whole, stamp is checked when block is freed
+	internal u64* pool_mt_checked_alloc(Alloc_Pool_MT* pool, u8* owners, u64 stamp)
+	{
+		u64* block = (u64*)allocate(pool);
+		u32 block_i = (u32)(((byte*)block - pool->base) / pool->block_size);
+		TestCheck(std::atomic_ref<u8>(owners[block_i]).exchange(1) == 0);
+
+		const byte* payload = (const byte*)block + sizeof(Pool_Free_Node);
+		u64 count_unpoisoned = 0;
+		for (u64 i = 0; i < pool->block_size - sizeof(Pool_Free_Node); ++i)
+			count_unpoisoned += (payload[i] != g_pool_poison);
+		TestCheck(count_unpoisoned == 0);
+
+		for (u64 i = 0; i < pool->block_size / sizeof(u64); ++i)
+			block[i] = stamp;
+		return block;
+	}
+
+	internal void pool_mt_checked_free(Alloc_Pool_MT* pool, u8* owners, Pool_MT_Held held)
+	{
+		u64 count_overwritten = 0;
+		for (u64 i = 0; i < pool->block_size / sizeof(u64); ++i)
+			count_overwritten += (held.block[i] != held.stamp);
+		TestCheck(count_overwritten == 0);
+
+		u32 block_i = (u32)(((byte*)held.block - pool->base) / pool->block_size);
+		TestCheck(std::atomic_ref<u8>(owners[block_i]).exchange(0) == 1);
+		free_block(pool, held.block);
+	}
+
+	//? Walks global free list, every block must be there exactly once (all magazines flushed)
+	internal void check_pool_mt_all_free(Alloc_Pool_MT* pool, u8* visited)
+	{
+		memset(visited, 0, pool->count_blocks);
+		u32 count_free = 0;
+		for (u32 block_i = (u32)pool->head.load(); block_i != pool->count_blocks; block_i = pool_mt_next(pool, block_i).load())
+		{
+			TestCheck(block_i < pool->count_blocks && !visited[block_i]);
+			if (block_i >= pool->count_blocks || visited[block_i])
+				return; // broken list could loop forever
+			visited[block_i] = 1;
+			++count_free;
+		}
+		TestCheck(count_free == pool->count_blocks);
+	}
+
+	//? N threads allocate and free poisoned Alloc_Pool_MT blocks: local churn that refills and flushes magazines
+	//? concurrently, then blocks held at the end of a round are freed by neighbour thread in next round. Threads flush
+	//? their magazines before they exit, so free list must hold every block after all rounds. Last part checks that
+	//? reset drops blocks cached in magazine of a live thread and gives whole pool out again
+	internal void test_pool_mt(Alloc_Arena* arena)
+	{
+		constexpr u64 block_size = 64;
+		constexpr u32 count_blocks = 1 << 14;
+		constexpr u32 max_count_held = 96; // more than magazine, so refills and flushes hit global list
+		constexpr u32 count_rounds = 32;
+		constexpr u32 count_churn = 1 << 12;
+
+		Platform_Clock clock = clock_create();
+		u32 count_threads = lib::clamp(std::thread::hardware_concurrency(), 4u, 16u);
+		TestCheck(count_threads * max_count_held * 2 < count_blocks);
+
+		Alloc_Pool_MT pool{};
+		pool.zeroing = Alloc_Zeroing::none; // poisoned pool with zeroing would clear blocks on allocate
+		pool_mt_from_allocator(&pool, arena, count_blocks * block_size, block_size, 64, true);
+		TestCheck(pool.count_blocks == count_blocks);
+		u8* owners = (u8*)allocate(arena, count_blocks);
+		u8* visited = (u8*)allocate(arena, count_blocks);
+		// Double buffered by round parity, so neighbour reads last round while thread writes this one
+		Pool_MT_Held* held[2];
+		u32* counts_held[2];
+		for (u32 i = 0; i < 2; ++i)
+		{
+			held[i] = (Pool_MT_Held*)allocate(arena, count_threads * max_count_held * sizeof(Pool_MT_Held));
+			counts_held[i] = (u32*)allocate(arena, count_threads * sizeof(u32));
+		}
+
+		for (u32 round_i = 0; round_i < count_rounds; ++round_i)
+		{
+			(void)run_on_threads(clock, count_threads, [&](u32 thread_i)
+			{
+				// Blocks neighbour allocated in last round are freed here, on other thread
+				u32 last_i = (round_i + 1) % 2;
+				u32 neighbour_i = (thread_i + 1) % count_threads;
+				Pool_MT_Held* neighbour_held = held[last_i] + neighbour_i * max_count_held;
+				for (u32 i = 0; i < counts_held[last_i][neighbour_i]; ++i)
+					pool_mt_checked_free(&pool, owners, neighbour_held[i]);
+
+				u64 rng = 0x9E3779B97F4A7C15ull * (thread_i + 1) + round_i;
+				Pool_MT_Held local[max_count_held];
+				u32 count_local = 0;
+				for (u32 op_i = 0; op_i < count_churn; ++op_i)
+				{
+					u64 random = next_random(&rng);
+					if (count_local < max_count_held && (count_local == 0 || (random & 3) != 0))
+					{
+						u64 stamp = (u64)thread_i << 48 | (u64)round_i << 32 | op_i;
+						local[count_local++] = { pool_mt_checked_alloc(&pool, owners, stamp), stamp };
+					}
+					else
+					{
+						u32 i = (u32)(random >> 32) % count_local;
+						pool_mt_checked_free(&pool, owners, local[i]);
+						local[i] = local[--count_local];
+					}
+				}
+
+				// Handed to previous thread, which frees them after all threads of this round are done
+				Pool_MT_Held* own_held = held[round_i % 2] + thread_i * max_count_held;
+				counts_held[round_i % 2][thread_i] = count_local;
+				memcpy(own_held, local, count_local * sizeof(Pool_MT_Held));
+				pool_mt_flush_thread(&pool);
+			});
+		}
+
+		// Last held blocks go back from one thread
+		(void)run_on_threads(clock, 1, [&](u32)
+		{
+			u32 last_i = (count_rounds - 1) % 2;
+			for (u32 thread_i = 0; thread_i < count_threads; ++thread_i)
+			{
+				for (u32 i = 0; i < counts_held[last_i][thread_i]; ++i)
+					pool_mt_checked_free(&pool, owners, held[last_i][thread_i * max_count_held + i]);
+			}
+			pool_mt_flush_thread(&pool);
+		});
+		check_pool_mt_all_free(&pool, visited);
+
+		// Magazine of this thread caches blocks at reset, they must not be handed out again next to the same ones from list
+		Pool_MT_Held* all = (Pool_MT_Held*)allocate(arena, count_blocks * sizeof(Pool_MT_Held));
+		(void)run_on_threads(clock, 1, [&](u32)
+		{
+			for (u32 i = 0; i < 8; ++i)
+				(void)pool_mt_checked_alloc(&pool, owners, i);
+			pool_mt_reset(&pool);
+			memset(owners, 0, count_blocks);
+
+			for (u32 i = 0; i < count_blocks; ++i)
+				all[i] = { pool_mt_checked_alloc(&pool, owners, i), i };
+			for (u32 i = 0; i < count_blocks; ++i)
+				pool_mt_checked_free(&pool, owners, all[i]);
+			pool_mt_flush_thread(&pool);
+		});
+		check_pool_mt_all_free(&pool, visited);
+	}
+
+	// ===============================================================================================================================
+	// ======================================================= TLSF ==================================================================
+	// ===============================================================================================================================
+
+	struct Tlsf_Live
+	{
+		u64* ptr;
+		u64 size;
+		u64 stamp;
+	};
+
+	//? Walks all blocks in address order and all free lists, both must agree with counters and stats of allocator:
+	//? links are consistent, no two free blocks are neighbours, every free block is in list of its class
+	internal void check_tlsf_invariants(Alloc_TLSF* tlsf)
+	{
+		u64 used_bytes = 0;
+		u64 free_bytes = 0;
+		u64 largest_free_bytes = 0;
+		u32 count_used = 0;
+		u32 count_free = 0;
+		Tlsf_Block* prev = nullptr;
+		Tlsf_Block* block = (Tlsf_Block*)tlsf->base;
+		for (; tlsf_block_size(block) != 0; block = tlsf_next_phys(block))
+		{
+			TestCheck(block->prev_phys == prev);
+			TestCheck(((u64)block + g_tlsf_header_size) % g_tlsf_align == 0 && tlsf_block_size(block) >= g_tlsf_min_payload);
+			if (tlsf_is_free(block))
+			{
+				TestCheck(!(prev && tlsf_is_free(prev)));
+				free_bytes += tlsf_block_size(block);
+				largest_free_bytes = lib::max(largest_free_bytes, tlsf_block_size(block));
+				++count_free;
+			}
+			else
+			{
+				used_bytes += tlsf_block_size(block);
+				++count_used;
+			}
+			prev = block;
+		}
+		TestCheck(block->prev_phys == prev && (byte*)block + g_tlsf_header_size == tlsf->base + tlsf->max_size);
+
+		u32 count_listed = 0;
+		for (u32 fl = 0; fl < g_tlsf_fl_count; ++fl)
+		{
+			TestCheck(((tlsf->fl_bitmap >> fl) & 1) == (tlsf->sl_bitmaps[fl] != 0));
+			for (u32 sl = 0; sl < g_tlsf_sl_count; ++sl)
+			{
+				TestCheck(((tlsf->sl_bitmaps[fl] >> sl) & 1) == (tlsf->free_heads[fl][sl] != nullptr));
+				for (Tlsf_Block* at = tlsf->free_heads[fl][sl]; at; at = at->next_free)
+				{
+					u32 at_fl, at_sl;
+					tlsf_mapping(tlsf_block_size(at), &at_fl, &at_sl);
+					TestCheck(tlsf_is_free(at) && at_fl == fl && at_sl == sl);
+					TestCheck(at->next_free == nullptr || at->next_free->prev_free == at);
+					++count_listed;
+				}
+			}
+		}
+
+		Tlsf_Stats stats = tlsf_get_stats(tlsf);
+		TestCheck(count_listed == count_free && stats.count_free_blocks == count_free && stats.count_allocs == count_used);
+		TestCheck(stats.used_bytes == used_bytes && stats.free_bytes == free_bytes);
+		TestCheck(stats.largest_free_bytes == largest_free_bytes && stats.peak_used_bytes >= used_bytes);
+	}
+
+	internal Tlsf_Live tlsf_checked_alloc(Alloc_TLSF* tlsf, u64 size, u64 alignment, u64 stamp)
+	{
+		u64* ptr = (u64*)allocate(tlsf, size, alignment);
+		TestCheck(ptr && (u64)ptr % alignment == 0);
+		if (!ptr)
+			return {};
+		Tlsf_Block* block = (Tlsf_Block*)((byte*)ptr - g_tlsf_header_size);
+		TestCheck(!tlsf_is_free(block) && tlsf_block_size(block) >= size && (byte*)ptr + size <= tlsf->base + tlsf->max_size);
+
+		// First and last words, overlap of two live blocks would break one of them
+		ptr[0] = stamp;
+		ptr[(lib::max(size, (u64)8) - 8) / 8] = stamp;
+		return { ptr, size, stamp };
+	}
+
+	internal void tlsf_checked_free(Alloc_TLSF* tlsf, const Tlsf_Live& live)
+	{
+		TestCheck(live.ptr[0] == live.stamp && live.ptr[(lib::max(live.size, (u64)8) - 8) / 8] == live.stamp);
+		free_block(tlsf, live.ptr);
+	}
+
+	//? Random allocate/free churn of mixed sizes and alignments in Alloc_TLSF: invariants of blocks, free lists and stats
+	//? after every few ops, peak against own tracking, and full merge back to one block. Over-aligned allocation that
+	//? has to split free block off its front is checked directly
+	internal void test_tlsf(Alloc_Arena* arena)
+	{
+		constexpr u64 tlsf_size = MiB(64);
+		constexpr u32 max_count_live = 4096;
+		constexpr u32 count_ops = 1 << 18;
+		constexpr u32 check_period = 1024;
+		constexpr u64 alignments[] = { 16, 16, 16, 16, 64, 256, 4096, KiB(64) };
+
+		Alloc_TLSF tlsf{};
+		tlsf_from_allocator(&tlsf, arena, tlsf_size);
+		Tlsf_Live* live = (Tlsf_Live*)allocate(arena, max_count_live * sizeof(Tlsf_Live));
+		u64 initial_free_bytes = tlsf_get_stats(&tlsf).free_bytes;
+
+		// Over-aligned allocation after small one leaves free front block between them, freeing all merges it back
+		{
+			Tlsf_Live small = tlsf_checked_alloc(&tlsf, 48, 16, 1);
+			Tlsf_Live aligned = tlsf_checked_alloc(&tlsf, 1000, KiB(4), 2);
+			Tlsf_Block* block = (Tlsf_Block*)((byte*)aligned.ptr - g_tlsf_header_size);
+			TestCheck(block->prev_phys && tlsf_is_free(block->prev_phys));
+			TestCheck(block->prev_phys && block->prev_phys->prev_phys == (Tlsf_Block*)((byte*)small.ptr - g_tlsf_header_size));
+			check_tlsf_invariants(&tlsf);
+
+			tlsf_checked_free(&tlsf, small);
+			tlsf_checked_free(&tlsf, aligned);
+			check_tlsf_invariants(&tlsf);
+			Tlsf_Stats stats = tlsf_get_stats(&tlsf);
+			TestCheck(stats.count_free_blocks == 1 && stats.free_bytes == initial_free_bytes);
+		}
+
+		for (u32 i = 0; i < max_count_live; ++i)
+			live[i] = {};
+		tlsf_reset(&tlsf);
+		u64 peak_used_bytes = tlsf.peak_used_bytes; // reset keeps peak
+
+		u64 rng = 0x9E3779B97F4A7C15ull;
+		for (u32 op_i = 0; op_i < count_ops; ++op_i)
+		{
+			u64 random = next_random(&rng);
+			Tlsf_Live* slot = &live[random % max_count_live];
+			if (slot->ptr)
+			{
+				tlsf_checked_free(&tlsf, *slot);
+				*slot = {};
+			}
+			else
+			{
+				// Mostly small, some up to 256 KiB
+				u64 size = ((random >> 24) % 16 == 0) ? 1 + (random >> 32) % KiB(256) : 1 + (random >> 32) % 512;
+				*slot = tlsf_checked_alloc(&tlsf, size, alignments[(random >> 16) % array_count_32(alignments)], random | 1);
+				peak_used_bytes = lib::max(peak_used_bytes, tlsf.used_bytes);
+			}
+
+			if (op_i % check_period == 0)
+				check_tlsf_invariants(&tlsf);
+		}
+		check_tlsf_invariants(&tlsf);
+		TestCheck(tlsf_get_stats(&tlsf).peak_used_bytes == peak_used_bytes);
+
+		for (u32 i = 0; i < max_count_live; ++i)
+		{
+			if (live[i].ptr)
+				tlsf_checked_free(&tlsf, live[i]);
+		}
+		check_tlsf_invariants(&tlsf);
+		Tlsf_Stats empty = tlsf_get_stats(&tlsf);
+		TestCheck(empty.count_free_blocks == 1 && empty.used_bytes == 0 && empty.largest_free_bytes == initial_free_bytes);
+	}
+
+	// ===============================================================================================================================
+	// ======================================================= OFFSET ALLOCATOR ======================================================
+	// ===============================================================================================================================
+
+	//? Random create/release churn of placed resources in 1 GiB heap: every placement keeps alignment of its class and
+	//? heap bounds, live placements never overlap, and releasing all of them merges heap back to one free block
+	internal void test_offset_alloc(Alloc_Arena* arena)
+	{
+		constexpr u64 heap_size = GiB(1);
+		constexpr u32 max_count_live = 4096;
+		constexpr u32 count_ops = 1 << 18;
+		constexpr u32 check_period = 4096;
+
+		Alloc_Offset heap{};
+		create_offset_allocator(&heap, arena, heap_size, max_count_live, get_placement_alignment(Placement_Class::small_texture));
+		Offset_Allocation* live = (Offset_Allocation*)allocate(arena, max_count_live * sizeof(Offset_Allocation));
+		Offset_Allocation* sorted = (Offset_Allocation*)allocate(arena, max_count_live * sizeof(Offset_Allocation));
+		for (u32 i = 0; i < max_count_live; ++i)
+			live[i] = {};
+
+		u64 rng = 0x9E3779B97F4A7C15ull;
+		for (u32 op_i = 0; op_i < count_ops; ++op_i)
+		{
+			u64 random = next_random(&rng);
+			Offset_Allocation* slot = &live[random % max_count_live];
+			if (!is_null(*slot))
+			{
+				free_offset(&heap, *slot);
+				*slot = {};
+			}
+			else
+			{
+				Placement_Class placement = ((random >> 20) % 2) ? Placement_Class::small_texture : Placement_Class::buffer;
+				u64 size = (random >> 32) % KiB(64);
+				if (placement == Placement_Class::buffer)
+					size = ((random >> 24) % 16 == 0) ? (random >> 32) % MiB(8) : (random >> 32) % KiB(512);
+				*slot = allocate_offset(&heap, size, get_placement_alignment(placement));
+				TestCheck(!is_null(*slot) && slot->size >= size);
+				TestCheck(slot->offset % get_placement_alignment(placement) == 0 && slot->offset + slot->size <= heap_size);
+			}
+
+			if (op_i % check_period == 0)
+			{
+				u32 count_live = 0;
+				for (u32 i = 0; i < max_count_live; ++i)
+				{
+					if (!is_null(live[i]))
+						sorted[count_live++] = live[i];
+				}
+				qsort(sorted, count_live, sizeof(Offset_Allocation), [](const void* a, const void* b)
+				      {
+				      	u64 offset_a = ((const Offset_Allocation*)a)->offset;
+				      	u64 offset_b = ((const Offset_Allocation*)b)->offset;
+				      	return (offset_a > offset_b) - (offset_a < offset_b);
+				      });
+				for (u32 i = 1; i < count_live; ++i)
+					TestCheck(sorted[i - 1].offset + sorted[i - 1].size <= sorted[i].offset);
+				TestCheck(offset_get_stats(&heap).count_allocs == count_live);
+			}
+		}
+
+		for (u32 i = 0; i < max_count_live; ++i)
+			free_offset(&heap, live[i]);
+		Tlsf_Stats stats = offset_get_stats(&heap);
+		TestCheck(stats.count_allocs == 0 && stats.used_bytes == 0);
+		TestCheck(stats.count_free_blocks == 1 && stats.free_bytes == heap_size && stats.largest_free_bytes == heap_size);
+	}
+
+	// ===============================================================================================================================
+	// ======================================================= UPLOAD RING ===========================================================
+	// ===============================================================================================================================
+
+	//? Frames of random uploads into Alloc_Ring retired by simulated fence - GPU finishes frames 1 to 3 frames late.
+	//? Shadow table of fence values per granule tells that no region of frame in flight is given again. Submit with
+	//? nothing new must keep fence of last mark
+	internal void test_upload_ring(Alloc_Arena* arena)
+	{
+		constexpr u64 ring_size = MiB(4);
+		constexpr u64 granule = 256;
+		constexpr u32 count_frames = 1 << 12;
+
+		{
+			Alloc_Ring ring{};
+			create_ring(&ring, ring_size);
+			(void)allocate_ring(&ring, KiB(1), granule);
+			ring_submit(&ring, 1);
+			ring_submit(&ring, 2);
+			TestCheck(ring.count_marks == 1 && ring_get_oldest_fence(&ring) == 1);
+			ring_retire(&ring, 1);
+			TestCheck(ring_get_used(&ring) == 0 && ring.count_marks == 0);
+		}
+
+		u64* shadow_fences = (u64*)allocate(arena, (ring_size / granule) * sizeof(u64));
+		Alloc_Ring ring{};
+		create_ring(&ring, ring_size);
+		u64 fence_counter = 0;
+		u64 fence_completed = 0;
+
+		u64 rng = 0x2545F4914F6CDD1Dull;
+		for (u32 frame_i = 0; frame_i < count_frames; ++frame_i)
+		{
+			u32 count_uploads = 1 + (u32)(next_random(&rng) % 64);
+			for (u32 upload_i = 0; upload_i < count_uploads; ++upload_i)
+			{
+				u64 random = next_random(&rng);
+				u64 size = 1 + ((random >> 16) % 8 == 0 ? (random >> 24) % KiB(256) : (random >> 24) % KiB(4));
+				u64 offset = allocate_ring(&ring, size, granule);
+				while (offset == g_ring_full)
+				{
+					// Waiting for GPU, or for work of this frame when nothing else is in flight
+					u64 oldest_fence = ring_get_oldest_fence(&ring);
+					if (oldest_fence == 0)
+					{
+						oldest_fence = ++fence_counter;
+						ring_submit(&ring, oldest_fence);
+					}
+					fence_completed = lib::max(fence_completed, oldest_fence);
+					ring_retire(&ring, fence_completed);
+					offset = allocate_ring(&ring, size, granule);
+				}
+
+				TestCheck(offset % granule == 0 && offset + size <= ring_size);
+				for (u64 at = offset / granule; at < (offset + size + granule - 1) / granule; ++at)
+				{
+					TestCheck(shadow_fences[at] <= fence_completed);
+					shadow_fences[at] = fence_counter + 1;
+				}
+			}
+
+			u64 frame_fence = ++fence_counter;
+			ring_submit(&ring, frame_fence);
+			u64 lag = 1 + (rng >> 40) % 3;
+			if (frame_fence > lag)
+			{
+				fence_completed = lib::max(fence_completed, frame_fence - lag);
+				ring_retire(&ring, fence_completed);
+			}
+		}
+
+		ring_retire(&ring, fence_counter);
+		TestCheck(ring_get_used(&ring) == 0 && ring.count_marks == 0);
+	}
+} // namespace Linux
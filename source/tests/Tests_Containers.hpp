@@ -0,0 +1,439 @@
+#pragma once
+
+//? Container tests: slot map, hash map, string interning, SoA array, queues and bitset
+namespace Linux
+{
+	// ===============================================================================================================================
+	// ======================================================= SLOT MAP ==============================================================
+	// ===============================================================================================================================
+
+	struct Slot_Map_Item
+	{
+		u64 key;
+		u32 payload[6];
+	};
+
+	//? Slot of every dense value points back at its dense index and value moved together with its payload
+	internal void check_slot_map_dense(const Slot_Map<Slot_Map_Item>& map)
+	{
+		for (u32 dense_i = 0; dense_i < map.count; ++dense_i)
+		{
+			u32 slot_i = map.dense_to_slot[dense_i];
+			TestCheck(slot_i < map.capacity && map.slots[slot_i].dense_index == dense_i);
+			TestCheck(map.data[dense_i].payload[0] == (u32)map.data[dense_i].key);
+		}
+	}
+
+	//? Random insert/remove churn of Slot_Map against shadow array of live handles: values are found through their
+	//? handles, swap-erase keeps dense_to_slot in sync, handles of removed elements stay stale after their slot is
+	//? reused and after reset, zero handle and wrapped generation never point to element
+	internal void test_slot_map(Alloc_Arena* arena)
+	{
+		constexpr u32 capacity = 1 << 12;
+		constexpr u32 count_ops = 1 << 18;
+		constexpr u32 count_stale = 256;
+		constexpr u32 check_period = 4096;
+
+		Slot_Map<Slot_Map_Item> map{};
+		map.init(arena, capacity);
+		Handle<Slot_Map_Item>* live = (Handle<Slot_Map_Item>*)allocate(arena, capacity * sizeof(Handle<Slot_Map_Item>));
+		u64* live_keys = (u64*)allocate(arena, capacity * sizeof(u64));
+		Handle<Slot_Map_Item> stale[count_stale] = {};
+		u32 count_live = 0;
+		u64 next_key = 1;
+
+		Handle<Slot_Map_Item> null_handle{};
+		TestCheck(is_null(null_handle) && !map.is_valid(null_handle) && map.get(null_handle) == nullptr);
+
+		u64 rng = 0x9E3779B97F4A7C15ull;
+		for (u32 op_i = 0; op_i < count_ops; ++op_i)
+		{
+			u64 random = next_random(&rng);
+			b32 is_insert = (count_live == 0) || (count_live < capacity && (random & 1));
+			if (is_insert)
+			{
+				u64 key = next_key++;
+				Slot_Map_Item item{ .key = key, .payload = {} };
+				item.payload[0] = (u32)key;
+				Handle<Slot_Map_Item> handle = map.insert(item);
+				TestCheck(!is_null(handle));
+				live[count_live] = handle;
+				live_keys[count_live] = key;
+				++count_live;
+			}
+			else
+			{
+				// Removed from the middle, so swap-erase moves last value into its place
+				u32 live_i = (u32)((random >> 32) % count_live);
+				Handle<Slot_Map_Item> handle = live[live_i];
+				map.remove(handle);
+				map.remove(handle); // stale, ignored
+				TestCheck(!map.is_valid(handle) && map.get(handle) == nullptr);
+				stale[op_i % count_stale] = handle;
+				live[live_i] = live[--count_live];
+				live_keys[live_i] = live_keys[count_live];
+			}
+			TestCheck(map.count == count_live);
+
+			if (op_i % check_period == 0)
+			{
+				check_slot_map_dense(map);
+				for (u32 i = 0; i < count_live; ++i)
+				{
+					const Slot_Map_Item* item = map.get(live[i]);
+					TestCheck(item && item->key == live_keys[i]);
+				}
+
+				// Slots of stale handles were reused meanwhile, generation must tell them apart
+				for (const auto& handle : stale)
+					TestCheck(is_null(handle) || (!map.is_valid(handle) && map.get(handle) == nullptr));
+			}
+		}
+		check_slot_map_dense(map);
+
+		// Reset makes every handle stale
+		map.reset();
+		for (u32 i = 0; i < count_live; ++i)
+			TestCheck(!map.is_valid(live[i]));
+
+		// Generation wraps past 0, so reused slot never gives null handle
+		Handle<Slot_Map_Item> handle = map.insert({ .key = 1, .payload = {} });
+		map.slots[handle.index].generation = 0xffffffff;
+		map.remove({ handle.index, 0xffffffff });
+		Handle<Slot_Map_Item> reused = map.insert({ .key = 2, .payload = {} });
+		TestCheck(reused.index == handle.index && reused.generation == 1 && !is_null(reused));
+	}
+
+	// ===============================================================================================================================
+	// ======================================================= HASH MAP ==============================================================
+	// ===============================================================================================================================
+
+	//? Insert/remove churn at fixed capacity keeps live keys and never grows the table (deleted slots are reused or dropped
+	//? by in place rehash), and random insert/find/remove sequence agrees with std::unordered_map
+	internal void test_hash_map(Alloc_Arena* arena)
+	{
+		constexpr u32 count_live = 60;
+		constexpr u32 count_churn = 1 << 18;
+		constexpr u32 count_ops = 1 << 18;
+		constexpr u64 key_range = 1 << 12;
+
+		{
+			Arena_Temp_Scope temp(arena);
+			Hash_Map<u64, u64> map{};
+			map.init(arena, 100);
+			u32 capacity = map.capacity;
+
+			// Same key in and out, table never holds more than one element
+			for (u64 i = 0; i < count_churn; ++i)
+			{
+				map.insert(i, i);
+				TestCheck(map.remove(i));
+			}
+			TestCheck(map.count == 0);
+
+			// Live keys must survive rehashes caused by churn of other keys
+			for (u64 i = 0; i < count_live; ++i)
+				map.insert(i * 7919, i);
+			for (u64 i = 0; i < count_churn; ++i)
+			{
+				u64 key = (u64)1 << 40 | i;
+				*map.find_or_insert(key) = i;
+				if (i % 3 == 2)
+				{
+					TestCheck(map.remove(key - 2) && map.remove(key - 1) && map.remove(key));
+					TestCheck(map.count == count_live);
+				}
+			}
+			for (u64 i = 0; i < count_live; ++i)
+			{
+				u64* value = map.find(i * 7919);
+				TestCheck(value && *value == i);
+			}
+			TestCheck(!map.contains((u64)1 << 40 | 5));
+			TestCheck(map.capacity == capacity);
+		}
+
+		// Small key range, so inserts hit present keys and removes hit missing ones often
+		{
+			Arena_Temp_Scope temp(arena);
+			Hash_Map<u64, u64> map{};
+			map.init(arena, key_range);
+			std::unordered_map<u64, u64> reference;
+
+			u64 rng = 0x9E3779B97F4A7C15ull;
+			for (u32 op_i = 0; op_i < count_ops; ++op_i)
+			{
+				u64 random = next_random(&rng);
+				u64 key = (random >> 8) % key_range * 0x9E3779B97F4A7C15ull;
+				switch (random % 3)
+				{
+					case 0:
+						*map.find_or_insert(key) = op_i;
+						reference[key] = op_i;
+						break;
+					case 1:
+						TestCheck(map.remove(key) == (reference.erase(key) == 1));
+						break;
+					default:
+					{
+						u64* value = map.find(key);
+						auto found = reference.find(key);
+						TestCheck((value != nullptr) == (found != reference.end()));
+						TestCheck(!value || *value == found->second);
+					} break;
+				}
+			}
+			TestCheck(map.count == reference.size());
+			for (const auto& [key, value] : reference)
+			{
+				u64* found = map.find(key);
+				TestCheck(found && *found == value);
+			}
+		}
+	}
+
+	// ===============================================================================================================================
+	// ======================================================= STRING INTERNING ======================================================
+	// ===============================================================================================================================
+
+	//? Same text gives same id no matter which view it comes from, different texts give different ids and text round trips
+	internal void test_intern(Alloc_Arena* arena)
+	{
+		constexpr u32 count_names = 1 << 14;
+
+		String_View* paths = (String_View*)allocate(arena, count_names * sizeof(String_View));
+		for (u32 i = 0; i < count_names; ++i)
+			paths[i] = str_format(arena, "../assets/meshes/level_%u/mesh_%u/texture_%u.png", i % 7, i / 7, i);
+
+		String_Table table{};
+		string_table_init(&table, arena, count_names + 1, MiB(4));
+		String_Id* ids = (String_Id*)allocate(arena, count_names * sizeof(String_Id));
+		for (u32 i = 0; i < count_names; ++i)
+			ids[i] = intern(&table, paths[i]);
+
+		for (u32 i = 0; i < count_names; ++i)
+		{
+			// Views made again from text, so hash is computed as in real load path
+			TestCheck(intern(&table, str_view(paths[i].str)) == ids[i]);
+			TestCheck(intern(&table, paths[i].str) == ids[i]);
+			TestCheck(get_string(&table, ids[i]) == paths[i]);
+			if (i > 0)
+				TestCheck(!(ids[i] == ids[i - 1]));
+		}
+	}
+
+	// ===============================================================================================================================
+	// ======================================================= SOA ARRAY =============================================================
+	// ===============================================================================================================================
+
+	//? AoS -> SoA -> AoS gives back same records, narrower stream zeroes rest of member and padded tail reads as zero
+	internal void test_soa(Alloc_Arena* arena)
+	{
+		constexpr u32 count = 1003; // not multiple of SIMD lanes
+
+		Attributes* aos = (Attributes*)allocate(arena, count * sizeof(Attributes), g_soa_alignment);
+		Attributes* aos_back = (Attributes*)allocate(arena, count * sizeof(Attributes), g_soa_alignment);
+		Vec3* positions = (Vec3*)allocate(arena, count * sizeof(Vec3));
+		Soa_Array<&Attributes::tangent, &Attributes::normal, &Attributes::uv> soa;
+		soa.init(arena, count + g_soa_lanes);
+
+		u64 rng = 0x9E3779B97F4A7C15ull;
+		for (u32 i = 0; i < count; ++i)
+		{
+			f32 value = next_random_f32(&rng);
+			aos[i] = { { value, 1.0f, 2.0f, 1.0f }, { value, -value, 0.5f, 0.0f }, { value, 1.0f - value, 0.0f, 0.0f } };
+			positions[i] = { value, 2.0f * value, 3.0f * value };
+		}
+
+		soa.from_aos({ aos, (u64)count * sizeof(Attributes), sizeof(Attributes) });
+		TestCheck(soa.count == count);
+		soa.to_aos({ aos_back, (u64)count * sizeof(Attributes), sizeof(Attributes) });
+		TestCheck(memcmp(aos, aos_back, (u64)count * sizeof(Attributes)) == 0);
+		for (u32 i = 0; i < count; i += 97)
+		{
+			Attributes record = soa.get(i);
+			TestCheck(memcmp(&record, &aos[i], sizeof(Attributes)) == 0);
+		}
+
+		// Vec3 stream into Vec4 member
+		soa.from_stream<&Attributes::normal>({ positions, (u64)count * sizeof(Vec3), sizeof(Vec3) }, sizeof(Vec3));
+		const Vec4* normals = soa.field<&Attributes::normal>();
+		for (u32 i = 0; i < count; ++i)
+		{
+			TestCheck(normals[i].x == positions[i].x && normals[i].y == positions[i].y && normals[i].z == positions[i].z);
+			TestCheck(normals[i].w == 0.0f);
+		}
+
+		soa.pad_tail();
+		const Vec4* uvs = soa.field<&Attributes::uv>();
+		for (u32 i = count; i < soa.get_padded_count(); ++i)
+			TestCheck(normals[i].x == 0.0f && normals[i].w == 0.0f && uvs[i].x == 0.0f && uvs[i].y == 0.0f);
+	}
+
+	// ===============================================================================================================================
+	// ========================================================= QUEUES ==============================================================
+	// ===============================================================================================================================
+
+	//? Spsc_Ring keeps order and loses nothing, one at time and in batches. Mpmc_Queue gives every value exactly once
+	//? (count and sum). Waiting side yields, so it also finishes when there are less cores than threads
+	internal void test_queues(Alloc_Arena* arena)
+	{
+		constexpr u64 count_values = 1 << 18;
+		constexpr u32 capacity = 1024;
+		constexpr u32 max_batch = 32;
+		constexpr u32 batch_sizes[] = { 1, max_batch };
+		Platform_Clock clock = clock_create();
+
+		for (u32 batch : batch_sizes)
+		{
+			Arena_Temp_Scope temp(arena);
+			Spsc_Ring<u64>* ring = (Spsc_Ring<u64>*)allocate(arena, sizeof(Spsc_Ring<u64>), alignof(Spsc_Ring<u64>));
+			ring->init(arena, capacity);
+			std::atomic<u64> count_out_of_order = 0;
+
+			(void)run_on_threads(clock, 2, [&](u32 thread_i)
+			{
+				u64 values[max_batch];
+				if (thread_i == 0)
+				{
+					for (u64 sent = 0; sent < count_values; )
+					{
+						u32 count = (u32)lib::min((u64)batch, count_values - sent);
+						for (u32 i = 0; i < count; ++i)
+							values[i] = sent + i;
+						u32 pushed = ring->push_batch(values, count);
+						sent += pushed;
+						if (pushed == 0)
+							std::this_thread::yield();
+					}
+				}
+				else
+				{
+					u64 out_of_order = 0;
+					for (u64 received = 0; received < count_values; )
+					{
+						u32 popped = ring->pop_batch(values, batch);
+						for (u32 i = 0; i < popped; ++i)
+							out_of_order += values[i] != received + i;
+						received += popped;
+						if (popped == 0)
+							std::this_thread::yield();
+					}
+					count_out_of_order = out_of_order;
+				}
+			});
+			TestCheck(count_out_of_order.load() == 0);
+			u64 value;
+			TestCheck(!ring->pop(&value));
+		}
+
+		for (u32 batch : batch_sizes)
+		{
+			constexpr u32 count_producers = 2;
+			constexpr u32 count_consumers = 2;
+
+			Arena_Temp_Scope temp(arena);
+			Mpmc_Queue<u64>* queue = (Mpmc_Queue<u64>*)allocate(arena, sizeof(Mpmc_Queue<u64>), alignof(Mpmc_Queue<u64>));
+			queue->init(arena, capacity);
+			std::atomic<u64> count_received = 0;
+			std::atomic<u64> sum_received = 0;
+
+			(void)run_on_threads(clock, count_producers + count_consumers, [&](u32 thread_i)
+			{
+				u64 values[max_batch];
+				if (thread_i < count_producers)
+				{
+					// Producer "i" sends every count_producers-th value, together they send 1..count_values
+					u64 count_to_send = count_values / count_producers + (thread_i < count_values % count_producers);
+					for (u64 sent = 0; sent < count_to_send; )
+					{
+						u32 count = (u32)lib::min((u64)batch, count_to_send - sent);
+						for (u32 i = 0; i < count; ++i)
+							values[i] = (sent + i) * count_producers + thread_i + 1;
+						u32 pushed = queue->push_batch(values, count);
+						sent += pushed;
+						if (pushed == 0)
+							std::this_thread::yield();
+					}
+				}
+				else
+				{
+					u64 sum = 0;
+					while (count_received.load(std::memory_order_relaxed) < count_values)
+					{
+						u32 popped = queue->pop_batch(values, batch);
+						for (u32 i = 0; i < popped; ++i)
+							sum += values[i];
+						if (popped > 0)
+							count_received.fetch_add(popped, std::memory_order_relaxed);
+						else
+							std::this_thread::yield();
+					}
+					sum_received.fetch_add(sum);
+				}
+			});
+			TestCheck(count_received.load() == count_values);
+			TestCheck(sum_received.load() == count_values * (count_values + 1) / 2);
+		}
+	}
+
+	// ===============================================================================================================================
+	// ========================================================= BITSET ==============================================================
+	// ===============================================================================================================================
+
+	//? AND, OR and ANDNOT of random sets against per-bit reference at few densities, set bit iteration visits every
+	//? set bit once in order, count and summary words match the bits
+	internal void test_bitset(Alloc_Arena* arena)
+	{
+		constexpr u32 count_objects = (1 << 16) + 77; // partial last word
+		constexpr f64 densities[] = { 0.001, 0.1, 0.9 };
+
+		Bitset visible, resident, live;
+		visible.init(arena, count_objects);
+		resident.init(arena, count_objects);
+		live.init(arena, count_objects);
+
+		u64 rng = 0x9E3779B97F4A7C15ull;
+		for (f64 density : densities)
+		{
+			visible.clear_all();
+			resident.clear_all();
+			for (u32 i = 0; i < count_objects; ++i)
+			{
+				visible.set_to(i, (f64)(next_random(&rng) >> 11) / (f64)(1ull << 53) < density);
+				resident.set_to(i, (next_random(&rng) & 1) != 0);
+			}
+
+			live.assign_and(visible, resident);
+			u32 count_live = 0;
+			for (u32 i = 0; i < count_objects; ++i)
+			{
+				TestCheck(live.test(i) == (visible.test(i) & resident.test(i)));
+				count_live += live.test(i) ? 1 : 0;
+			}
+			TestCheck(live.count() == count_live);
+
+			u32 count_visited = 0;
+			u32 next_expected = 0;
+			live.for_each_set([&](u32 i)
+			{
+				TestCheck(i >= next_expected && i < count_objects && live.test(i));
+				next_expected = i + 1;
+				count_visited += 1;
+			});
+			TestCheck(count_visited == count_live);
+			for (u32 i = 0; i < live.count_words; ++i)
+				TestCheck(((live.summary[i / 64] >> (i % 64)) & 1) == (live.words[i] != 0));
+
+			live.assign_or(visible, resident);
+			for (u32 i = 0; i < count_objects; ++i)
+				TestCheck(live.test(i) == (visible.test(i) | resident.test(i)));
+			live.assign_and_not(resident, visible);
+			for (u32 i = 0; i < count_objects; ++i)
+				TestCheck(live.test(i) == (resident.test(i) & !visible.test(i)));
+		}
+
+		live.set_all();
+		TestCheck(live.count() == count_objects);
+	}
+} // namespace Linux
@@ -0,0 +1,491 @@
+#pragma once
+
+//? Math tests: batch kernels and their SIMD variants, quaternions, affine transforms and culling
+namespace Linux
+{
+	// Relative to magnitude, FMA variants round differently than separate multiply & add
+	internal b32 is_near_f32(const f32 a, const f32 b, const f32 epsilon)
+	{
+		return fabsf(a - b) <= epsilon * lib::max(1.0f, fabsf(b));
+	}
+
+	internal b32 is_near_mat4(const lib::Mat4& a, const lib::Mat4& b, const f32 epsilon)
+	{
+		for (u32 i = 0; i < 16; ++i)
+		{
+			if (!is_near_f32((&a.e[0][0])[i], (&b.e[0][0])[i], epsilon))
+				return false;
+		}
+		return true;
+	}
+
+	internal b32 is_near_vec3(const lib::Vec3 a, const lib::Vec3 b, const f32 epsilon)
+	{
+		return is_near_f32(a.x, b.x, epsilon) && is_near_f32(a.y, b.y, epsilon) && is_near_f32(a.z, b.z, epsilon);
+	}
+
+	//? Elements of "count_streams" streams that differ from reference ones
+	internal u32 count_differing(const f32* const* streams, const f32* const* expected_streams, const u32 count_streams, const u32 count,
+	                             const f32 epsilon)
+	{
+		u32 out = 0;
+		for (u32 stream_i = 0; stream_i < count_streams; ++stream_i)
+		{
+			for (u32 i = 0; i < count; ++i)
+				out += is_near_f32(streams[stream_i][i], expected_streams[stream_i][i], epsilon) ? 0 : 1;
+		}
+		return out;
+	}
+
+	// ===============================================================================================================================
+	// ======================================================= MATH x8 ===============================================================
+	// ===============================================================================================================================
+
+	//? Batch kernels of Math_x8.hpp over SoA streams match per element Mat4/Vec3 operators over AoS arrays, odd counts so
+	//? scalar tail runs too, and translation does not move vectors
+	internal void test_math_x8(Alloc_Arena* arena)
+	{
+		constexpr u32 count = (1 << 14) + 5;
+		constexpr u32 count_matrices = (1 << 12) + 3;
+		constexpr f32 epsilon = 1e-4f;
+
+		auto push_floats = [&](u32 count_floats) { return (f32*)allocate(arena, (u64)count_floats * sizeof(f32), 64); };
+		lib::Vec3_Soa_View points = { push_floats(count), push_floats(count), push_floats(count) };
+		lib::Vec3_Soa_View points_out = { push_floats(count), push_floats(count), push_floats(count) };
+		lib::Vec3_Soa_View normals = { push_floats(count), push_floats(count), push_floats(count) };
+		lib::Vec3_Soa_View normals_out = { push_floats(count), push_floats(count), push_floats(count) };
+		lib::Mat4_Soa_View matrices;
+		lib::Mat4_Soa_View matrices_out;
+		for (u32 column = 0; column < 4; ++column)
+		{
+			for (u32 row = 0; row < 4; ++row)
+			{
+				matrices.e[column][row] = push_floats(count_matrices);
+				matrices_out.e[column][row] = push_floats(count_matrices);
+			}
+		}
+
+		u64 rng = 0x9E3779B97F4A7C15ull;
+		for (u32 i = 0; i < count; ++i)
+		{
+			points.x[i] = next_random_f32(&rng); points.y[i] = next_random_f32(&rng); points.z[i] = next_random_f32(&rng);
+			normals.x[i] = next_random_f32(&rng); normals.y[i] = next_random_f32(&rng); normals.z[i] = next_random_f32(&rng);
+		}
+		for (u32 i = 0; i < count_matrices; ++i)
+		{
+			for (u32 column = 0; column < 4; ++column)
+			{
+				for (u32 row = 0; row < 4; ++row)
+					matrices.e[column][row][i] = next_random_f32(&rng);
+			}
+		}
+
+		lib::Mat4 model = lib::create_translate(lib::Vec3{ 1.0f, -2.0f, 3.0f }) * lib::create_rotation(lib::Vec3{ 0.3f, 1.0f, 0.2f }, 0.7f);
+		lib::transform_points(model, points, points_out, count);
+		lib::normalize_vectors(normals, normals_out, count);
+		lib::multiply_matrices(model, matrices, matrices_out, count_matrices);
+
+		for (u32 i = 0; i < count; ++i)
+		{
+			lib::Vec4 point = model * lib::Vec4{ points.x[i], points.y[i], points.z[i], 1.0f };
+			TestCheck(is_near_vec3({ points_out.x[i], points_out.y[i], points_out.z[i] }, point.xyz, epsilon));
+			lib::Vec3 normal = lib::normalize(lib::Vec3{ normals.x[i], normals.y[i], normals.z[i] });
+			TestCheck(is_near_vec3({ normals_out.x[i], normals_out.y[i], normals_out.z[i] }, normal, epsilon));
+		}
+		for (u32 i = 0; i < count_matrices; ++i)
+		{
+			lib::Mat4 matrix, matrix_out;
+			for (u32 column = 0; column < 4; ++column)
+			{
+				for (u32 row = 0; row < 4; ++row)
+				{
+					matrix.e[column][row] = matrices.e[column][row][i];
+					matrix_out.e[column][row] = matrices_out.e[column][row][i];
+				}
+			}
+			TestCheck(is_near_mat4(matrix_out, model * matrix, epsilon));
+		}
+
+		lib::transform_vectors(lib::create_translate(lib::Vec3{ 5.0f, 5.0f, 5.0f }), normals, normals_out, count);
+		TestCheck(normals_out.x[count - 1] == normals.x[count - 1] && normals_out.z[0] == normals.z[0]);
+	}
+
+	// ===============================================================================================================================
+	// ===================================================== SIMD DISPATCH ===========================================================
+	// ===============================================================================================================================
+
+	//? Every Math_Kernels variant this CPU supports matches scalar reference - counts around vector widths cover tails,
+	//? last run is in place - and dispatch picks supported level
+	internal void test_simd_dispatch(Alloc_Arena* arena)
+	{
+		constexpr u32 max_count = 1 << 12;
+		constexpr u32 counts[] = { 0, 1, 3, 4, 7, 8, 9, 15, 16, 17, 31, 33, 1003, max_count };
+		constexpr f32 epsilon = 1e-4f;
+
+		const lib::Math_Kernels& dispatched = lib::get_math_kernels();
+		TestCheck(is_simd_level_supported(dispatched.level));
+
+		auto push_floats = [&] { return (f32*)allocate(arena, max_count * sizeof(f32), 64); };
+		auto push_vec4s = [&] { return lib::Vec4_Soa_View{ push_floats(), push_floats(), push_floats(), push_floats() }; };
+		auto push_mat4s = [&]
+		{
+			lib::Mat4_Soa_View out;
+			for (u32 column = 0; column < 4; ++column)
+			{
+				for (u32 row = 0; row < 4; ++row)
+					out.e[column][row] = push_floats();
+			}
+			return out;
+		};
+
+		// Vec3 views use first 3 streams of Vec4 ones
+		lib::Vec4_Soa_View in = push_vec4s();
+		lib::Vec4_Soa_View expected = push_vec4s();
+		lib::Vec4_Soa_View result = push_vec4s();
+		lib::Mat4_Soa_View in_matrices = push_mat4s();
+		lib::Mat4_Soa_View expected_matrices = push_mat4s();
+		lib::Mat4_Soa_View result_matrices = push_mat4s();
+		lib::Vec3_Soa_View in3 = { in.x, in.y, in.z };
+		lib::Vec3_Soa_View expected3 = { expected.x, expected.y, expected.z };
+		lib::Vec3_Soa_View result3 = { result.x, result.y, result.z };
+		const f32* expected_streams[] = { expected.x, expected.y, expected.z, expected.w };
+		const f32* result_streams[] = { result.x, result.y, result.z, result.w };
+
+		u64 rng = 0x9E3779B97F4A7C15ull;
+		auto fill = [&]
+		{
+			for (u32 i = 0; i < max_count; ++i)
+			{
+				in.x[i] = next_random_f32(&rng) * 100.0f; in.y[i] = next_random_f32(&rng) * 100.0f;
+				in.z[i] = next_random_f32(&rng) * 100.0f; in.w[i] = next_random_f32(&rng) * 100.0f;
+				for (u32 column = 0; column < 4; ++column)
+				{
+					for (u32 row = 0; row < 4; ++row)
+						in_matrices.e[column][row][i] = next_random_f32(&rng);
+				}
+			}
+			in.x[5] = in.y[5] = in.z[5] = 0.0f; // zero length vector must stay zero
+		};
+
+		lib::Mat4 model = lib::create_translate(lib::Vec3{ 1.0f, -2.0f, 3.0f }) * lib::create_rotation(lib::Vec3{ 0.3f, 1.0f, 0.2f }, 0.7f) *
+		                  lib::create_scale(1.5f);
+		lib::Math_Kernels reference = lib::get_math_kernels_for(Simd_Level::scalar);
+		for (u32 level_i = 0; level_i < (u32)Simd_Level::count; ++level_i)
+		{
+			Simd_Level level = (Simd_Level)level_i;
+			if (!is_simd_level_supported(level))
+				continue;
+
+			lib::Math_Kernels kernels = lib::get_math_kernels_for(level);
+			fill();
+			for (u32 count : counts)
+			{
+				reference.transform_points(model, in3, expected3, count);
+				kernels.transform_points(model, in3, result3, count);
+				TestCheck(count_differing(result_streams, expected_streams, 3, count, epsilon) == 0);
+
+				reference.transform_vectors(model, in3, expected3, count);
+				kernels.transform_vectors(model, in3, result3, count);
+				TestCheck(count_differing(result_streams, expected_streams, 3, count, epsilon) == 0);
+
+				reference.transform_vec4s(model, in, expected, count);
+				kernels.transform_vec4s(model, in, result, count);
+				TestCheck(count_differing(result_streams, expected_streams, 4, count, epsilon) == 0);
+
+				reference.normalize_vectors(in3, expected3, count);
+				kernels.normalize_vectors(in3, result3, count);
+				TestCheck(count_differing(result_streams, expected_streams, 3, count, epsilon) == 0);
+
+				reference.multiply_matrices(model, in_matrices, expected_matrices, count);
+				kernels.multiply_matrices(model, in_matrices, result_matrices, count);
+				TestCheck(count_differing(&result_matrices.e[0][0], &expected_matrices.e[0][0], 16, count, epsilon) == 0);
+
+				lib::Vec3 expected_min, expected_max, result_min, result_max;
+				reference.find_min_max(in3, count, &expected_min, &expected_max);
+				kernels.find_min_max(in3, count, &result_min, &result_max);
+				TestCheck(expected_min == result_min && expected_max == result_max);
+			}
+
+			// In place - "in" is "out"
+			u32 count = counts[array_count_32(counts) - 2];
+			reference.transform_points(model, in3, expected3, count);
+			kernels.transform_points(model, in3, in3, count);
+			const f32* in_streams[] = { in.x, in.y, in.z };
+			TestCheck(count_differing(in_streams, expected_streams, 3, count, epsilon) == 0);
+		}
+	}
+
+	// ===============================================================================================================================
+	// ===================================================== QUATERNIONS =============================================================
+	// ===============================================================================================================================
+
+	//? Round trips of Quat & Trs against matrix functions, batch nlerp/slerp of every supported level against scalar
+	//? "lib::slerp" (acos based), opposite rotations half way blend to identity
+	internal void test_quat(Alloc_Arena* arena)
+	{
+		constexpr u32 count_quats = 1 << 12;
+		constexpr u32 counts[] = { 0, 1, 3, 4, 7, 8, 9, 17, 1003, count_quats };
+		constexpr f32 epsilon = 1e-4f;
+
+		u64 rng = 0x9E3779B97F4A7C15ull;
+		auto next_quat = [&]
+		{
+			return lib::normalize(lib::Quat{ next_random_f32(&rng), next_random_f32(&rng), next_random_f32(&rng), next_random_f32(&rng) });
+		};
+		// q and -q are same rotation
+		auto is_same_rotation = [&](const lib::Quat a, const lib::Quat b) { return fabsf(fabsf(lib::dot(a, b)) - 1.0f) <= epsilon; };
+
+		lib::Quat q_x90 = lib::create_quat(lib::Vec3{ 1.0f, 0.0f, 0.0f }, lib::deg_to_rad(90.0f));
+		TestCheck(is_near_mat4(lib::create_rotation(q_x90), lib::create_rotation_x(lib::deg_to_rad(90.0f)), epsilon));
+		for (u32 i = 0; i < 1000; ++i)
+		{
+			lib::Vec3 axis = { next_random_f32(&rng), next_random_f32(&rng), next_random_f32(&rng) };
+			f32 angle = next_random_f32(&rng) * PI32;
+			lib::Quat q = lib::create_quat(axis, angle);
+			lib::Mat4 rotation = lib::create_rotation(axis, angle);
+			TestCheck(is_near_mat4(lib::create_rotation(q), rotation, epsilon));
+			TestCheck(is_same_rotation(lib::get_rotation(rotation), q));
+
+			lib::Vec3 v = { next_random_f32(&rng), next_random_f32(&rng), next_random_f32(&rng) };
+			TestCheck(is_near_vec3(lib::rotate(q, v), lib::mul_trans_vec(rotation, v), epsilon));
+
+			lib::Quat r = next_quat();
+			TestCheck(is_near_mat4(lib::create_rotation(q * r), lib::create_rotation(q) * lib::create_rotation(r), epsilon));
+
+			lib::Trs trs = { .translation = { next_random_f32(&rng) * 10.0f, next_random_f32(&rng) * 10.0f, next_random_f32(&rng) * 10.0f },
+			                 .rotation = r,
+			                 .scale = { 0.5f + fabsf(next_random_f32(&rng)), 0.5f + fabsf(next_random_f32(&rng)), (i & 1) ? -1.5f : 2.0f } };
+			lib::Mat4 transform = lib::create_transform(trs);
+			lib::Mat4 scale = lib::create_diagonal_matrix();
+			scale.e[0][0] = trs.scale.x; scale.e[1][1] = trs.scale.y; scale.e[2][2] = trs.scale.z;
+			TestCheck(is_near_mat4(transform, lib::create_translate(trs.translation) * lib::create_rotation(r) * scale, epsilon));
+			TestCheck(is_near_mat4(lib::create_transform(lib::decompose_trs(transform)), transform, epsilon));
+		}
+		TestCheck(lib::slerp(q_x90, q_x90, 0.5f) == lib::nlerp(q_x90, q_x90, 0.5f));
+
+		auto push_floats = [&] { return (f32*)allocate(arena, count_quats * sizeof(f32), 64); };
+		auto push_quats = [&] { return lib::Vec4_Soa_View{ push_floats(), push_floats(), push_floats(), push_floats() }; };
+		lib::Vec4_Soa_View a = push_quats(), b = push_quats(), expected = push_quats(), result = push_quats();
+		f32* t = push_floats();
+		for (u32 i = 0; i < count_quats; ++i)
+		{
+			lib::Quat qa = next_quat();
+			// Mostly nearby rotations as between animation keys, every 4th one anywhere (also opposite hemisphere)
+			lib::Quat qb = (i % 4 == 0) ? next_quat() : lib::normalize(qa + 0.2f * next_quat());
+			a.x[i] = qa.x; a.y[i] = qa.y; a.z[i] = qa.z; a.w[i] = qa.w;
+			b.x[i] = qb.x; b.y[i] = qb.y; b.z[i] = qb.z; b.w[i] = qb.w;
+			t[i] = fabsf(next_random_f32(&rng));
+		}
+		// Opposite rotations half way, nlerp has to give identity
+		a.x[2] = 0.0f; a.y[2] = 0.0f; a.z[2] = 0.0f; a.w[2] = 1.0f;
+		b.x[2] = 0.0f; b.y[2] = 0.0f; b.z[2] = 0.0f; b.w[2] = -1.0f;
+		t[2] = 0.5f;
+
+		const f32* expected_streams[] = { expected.x, expected.y, expected.z, expected.w };
+		const f32* result_streams[] = { result.x, result.y, result.z, result.w };
+		lib::Math_Kernels reference = lib::get_math_kernels_for(Simd_Level::scalar);
+		for (u32 level_i = 0; level_i < (u32)Simd_Level::count; ++level_i)
+		{
+			Simd_Level level = (Simd_Level)level_i;
+			if (!is_simd_level_supported(level))
+				continue;
+
+			lib::Math_Kernels kernels = lib::get_math_kernels_for(level);
+			for (u32 count : counts)
+			{
+				reference.nlerp_quats(a, b, t, expected, count);
+				kernels.nlerp_quats(a, b, t, result, count);
+				TestCheck(count_differing(result_streams, expected_streams, 4, count, epsilon) == 0);
+				if (count > 2)
+					TestCheck(is_same_rotation(lib::Quat{ result.x[2], result.y[2], result.z[2], result.w[2] }, lib::Quat{ 0.0f, 0.0f, 0.0f, 1.0f }));
+
+				reference.slerp_quats(a, b, t, expected, count);
+				kernels.slerp_quats(a, b, t, result, count);
+				TestCheck(count_differing(result_streams, expected_streams, 4, count, epsilon) == 0);
+			}
+		}
+	}
+
+	// ===============================================================================================================================
+	// ======================================================= TRANS4 ================================================================
+	// ===============================================================================================================================
+
+	//? Trans4 against Mat4 affine helpers on random sheared transforms, and propagation of local transforms down parent
+	//? chains (world = parent world * local) gives same worlds with both types
+	internal void test_trans4(Alloc_Arena* arena)
+	{
+		constexpr u32 count_nodes = 1 << 14;
+		constexpr f32 epsilon = 1e-3f;
+
+		u64 rng = 0x9E3779B97F4A7C15ull;
+		// Rotation and scale with some shear, translation up to 10
+		auto next_affine = [&]
+		{
+			lib::Mat4 out = lib::create_rotation(lib::Vec3{ next_random_f32(&rng), next_random_f32(&rng), next_random_f32(&rng) },
+			                                     next_random_f32(&rng) * PI32);
+			for (u32 column = 0; column < 3; ++column)
+			{
+				for (u32 row = 0; row < 3; ++row)
+					out.e[column][row] = out.e[column][row] * 1.5f + next_random_f32(&rng) * 0.2f;
+			}
+			out.vecs[3] = { next_random_f32(&rng) * 10.0f, next_random_f32(&rng) * 10.0f, next_random_f32(&rng) * 10.0f, 1.0f };
+			return out;
+		};
+
+		for (u32 i = 0; i < 1000; ++i)
+		{
+			lib::Mat4 a = next_affine(), b = next_affine();
+			lib::Trans4 ta = lib::create_trans4(a), tb = lib::create_trans4(b);
+			lib::Mat4 round_trip = lib::create_mat4(ta);
+			TestCheck(memcmp(&round_trip, &a, sizeof(a)) == 0);
+			TestCheck(is_near_mat4(lib::create_mat4(ta * tb), lib::mul_trans(a, b), epsilon));
+			TestCheck(is_near_mat4(lib::create_mat4(lib::inverse(ta)), lib::inverse(a), epsilon));
+
+			lib::Vec3 p = { next_random_f32(&rng) * 10.0f, next_random_f32(&rng) * 10.0f, next_random_f32(&rng) * 10.0f };
+			TestCheck(is_near_vec3(lib::mul_trans_point(ta, p), lib::mul_trans_point(a, p), epsilon));
+			TestCheck(is_near_vec3(lib::mul_trans_vec(ta, p), lib::mul_trans_vec(a, p), epsilon));
+			TestCheck(is_near_vec3(lib::mul_trans_point(ta * lib::inverse(ta), p), p, epsilon));
+		}
+
+		lib::Trs trs = { .translation = { 1.0f, 2.0f, 3.0f }, .rotation = lib::create_quat(lib::Vec3{ 1.0f, 1.0f, 0.0f }, 0.5f), .scale = { 1.0f, 2.0f, 3.0f } };
+		TestCheck(is_near_mat4(lib::create_mat4(lib::create_trans4(trs)), lib::create_transform(trs), epsilon));
+
+		// Nodes in parent before child order as flattened hierarchy, parent is one of 64 nodes before
+		u32* parents = (u32*)allocate(arena, count_nodes * sizeof(u32), 64);
+		lib::Mat4* locals = (lib::Mat4*)allocate(arena, count_nodes * sizeof(lib::Mat4), 64);
+		lib::Mat4* worlds = (lib::Mat4*)allocate(arena, count_nodes * sizeof(lib::Mat4), 64);
+		lib::Trans4* locals_t = (lib::Trans4*)allocate(arena, count_nodes * sizeof(lib::Trans4), 64);
+		lib::Trans4* worlds_t = (lib::Trans4*)allocate(arena, count_nodes * sizeof(lib::Trans4), 64);
+		for (u32 i = 0; i < count_nodes; ++i)
+		{
+			parents[i] = (i == 0) ? 0 : i - 1 - (u32)(next_random(&rng) % lib::min(i, 64u));
+			// Rotation only, so long chains stay in range
+			locals[i] = lib::create_translate(lib::Vec3{ next_random_f32(&rng), next_random_f32(&rng), next_random_f32(&rng) }) *
+			            lib::create_rotation(lib::Vec3{ next_random_f32(&rng), next_random_f32(&rng), 1.0f }, next_random_f32(&rng));
+			locals_t[i] = lib::create_trans4(locals[i]);
+		}
+
+		worlds[0] = locals[0];
+		worlds_t[0] = locals_t[0];
+		for (u32 i = 1; i < count_nodes; ++i)
+		{
+			worlds[i] = lib::mul_trans(worlds[parents[i]], locals[i]);
+			worlds_t[i] = worlds_t[parents[i]] * locals_t[i];
+		}
+		for (u32 i = 0; i < count_nodes; i += 97)
+			TestCheck(is_near_mat4(lib::create_mat4(worlds_t[i]), worlds[i], epsilon));
+	}
+
+	// ===============================================================================================================================
+	// ======================================================= CULLING ===============================================================
+	// ===============================================================================================================================
+
+	//? Frustum of 60 degree camera: plane extraction on known cases, scalar kernels against per object functions and every
+	//? supported kernel variant against scalar one. Lists may differ only by objects touching some plane
+	internal void test_culling(Alloc_Arena* arena)
+	{
+		constexpr u32 count_objects = 1 << 16;
+		constexpr u32 counts[] = { 0, 1, 3, 4, 7, 8, 9, 15, 16, 17, 31, 33, 1003, count_objects };
+
+		lib::Mat4 view = lib::create_look_at(lib::Vec3{ 0.0f, 0.0f, 0.0f }, lib::Vec3{ 0.0f, 0.0f, -1.0f }, lib::Vec3{ 0.0f, 1.0f, 0.0f });
+		lib::Mat4 projection = lib::create_perspective(lib::deg_to_rad(60.0f), 16.0f / 9.0f, 0.1f, 1000.0f);
+		lib::Frustum frustum = lib::create_frustum(projection * view);
+
+		// Camera looks down -Z (RH)
+		TestCheck(lib::is_sphere_visible(frustum, { 0.0f, 0.0f, -10.0f }, 1.0f));
+		TestCheck(!lib::is_sphere_visible(frustum, { 0.0f, 0.0f, 10.0f }, 1.0f));
+		TestCheck(lib::is_sphere_visible(frustum, { 0.0f, 0.0f, 10.0f }, 20.0f));
+		TestCheck(!lib::is_sphere_visible(frustum, { 0.0f, 0.0f, -1100.0f }, 50.0f));
+		TestCheck(!lib::is_sphere_visible(frustum, { 100.0f, 0.0f, -10.0f }, 1.0f));
+		TestCheck(!lib::is_aabb_visible(frustum, { 0.0f, 30.0f, -10.0f }, { 1.0f, 1.0f, 1.0f }));
+		TestCheck(lib::is_aabb_visible(frustum, { 0.0f, 30.0f, -10.0f }, { 1.0f, 30.0f, 1.0f }));
+
+		auto push_floats = [&] { return (f32*)allocate(arena, count_objects * sizeof(f32), 64); };
+		auto push_indices = [&] { return (u32*)allocate(arena, count_objects * sizeof(u32), 64); };
+		lib::Vec3_Soa_View centers = { push_floats(), push_floats(), push_floats() };
+		lib::Vec3_Soa_View extents = { push_floats(), push_floats(), push_floats() };
+		f32* radii = push_floats();
+		u32* expected = push_indices();
+		u32* result = push_indices();
+
+		// Scattered around camera, so roughly tenth of them is visible
+		u64 rng = 0x9E3779B97F4A7C15ull;
+		for (u32 i = 0; i < count_objects; ++i)
+		{
+			centers.x[i] = next_random_f32(&rng) * 500.0f;
+			centers.y[i] = next_random_f32(&rng) * 500.0f;
+			centers.z[i] = next_random_f32(&rng) * 500.0f;
+			extents.x[i] = 2.5f + next_random_f32(&rng) * 2.0f;
+			extents.y[i] = 2.5f + next_random_f32(&rng) * 2.0f;
+			extents.z[i] = 2.5f + next_random_f32(&rng) * 2.0f;
+			radii[i] = lib::length_vec(lib::Vec3{ extents.x[i], extents.y[i], extents.z[i] });
+		}
+
+		u32 count_visible = lib::cull_spheres_scalar(frustum, centers, radii, count_objects, expected);
+		TestCheck(count_visible > 0 && count_visible < count_objects);
+		for (u32 i = 0, visible_i = 0; i < count_objects; ++i)
+		{
+			b32 is_listed = visible_i < count_visible && expected[visible_i] == i;
+			TestCheck(lib::is_sphere_visible(frustum, { centers.x[i], centers.y[i], centers.z[i] }, radii[i]) == is_listed);
+			visible_i += is_listed ? 1 : 0;
+		}
+		count_visible = lib::cull_aabbs_scalar(frustum, centers, extents, count_objects, expected);
+		for (u32 i = 0, visible_i = 0; i < count_objects; ++i)
+		{
+			b32 is_listed = visible_i < count_visible && expected[visible_i] == i;
+			TestCheck(lib::is_aabb_visible(frustum, { centers.x[i], centers.y[i], centers.z[i] }, { extents.x[i], extents.y[i], extents.z[i] }) ==
+			          is_listed);
+			visible_i += is_listed ? 1 : 0;
+		}
+
+		// Distance of object to closest plane, minus its radius - sign tells visibility
+		auto get_margin = [&](u32 i, b32 is_box)
+		{
+			f32 out = HUGE_VALF;
+			for (const lib::Vec4& plane : frustum.planes)
+			{
+				f32 radius = is_box ? fabsf(plane.x) * extents.x[i] + fabsf(plane.y) * extents.y[i] + fabsf(plane.z) * extents.z[i] : radii[i];
+				out = lib::min(out, lib::dot(plane.xyz, lib::Vec3{ centers.x[i], centers.y[i], centers.z[i] }) + plane.w + radius);
+			}
+			return out;
+		};
+		auto check_lists = [&](u32 count_expected, u32 count_result, u32 first, b32 is_box)
+		{
+			u32 expected_i = 0, result_i = 0;
+			while (expected_i < count_expected || result_i < count_result)
+			{
+				u32 a = (expected_i < count_expected) ? expected[expected_i] : ~0u;
+				u32 b = (result_i < count_result) ? result[result_i] : ~0u;
+				u32 differing = lib::min(a, b);
+				if (a != b)
+					TestCheck(fabsf(get_margin(first + differing, is_box)) <= 1e-3f);
+				expected_i += (a == differing) ? 1 : 0;
+				result_i += (b == differing) ? 1 : 0;
+			}
+		};
+
+		lib::Math_Kernels reference = lib::get_math_kernels_for(Simd_Level::scalar);
+		for (u32 level_i = 0; level_i < (u32)Simd_Level::count; ++level_i)
+		{
+			Simd_Level level = (Simd_Level)level_i;
+			if (!is_simd_level_supported(level))
+				continue;
+
+			lib::Math_Kernels kernels = lib::get_math_kernels_for(level);
+			for (u32 count : counts)
+			{
+				// Short runs from end of streams
+				u32 first = count_objects - count;
+				lib::Vec3_Soa_View centers_at = lib::offset_view(centers, first);
+				lib::Vec3_Soa_View extents_at = lib::offset_view(extents, first);
+				const f32* radii_at = radii + first;
+
+				u32 count_expected = reference.cull_spheres(frustum, centers_at, radii_at, count, expected);
+				check_lists(count_expected, kernels.cull_spheres(frustum, centers_at, radii_at, count, result), first, false);
+
+				count_expected = reference.cull_aabbs(frustum, centers_at, extents_at, count, expected);
+				check_lists(count_expected, kernels.cull_aabbs(frustum, centers_at, extents_at, count, result), first, true);
+			}
+		}
+	}
+} // namespace Linux
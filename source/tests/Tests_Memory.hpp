@@ -0,0 +1,235 @@
+#pragma once
+
+//? Arena tests: nested temps, reclaim of freed pages, per-thread scratch arenas, growing arrays and VM_Array
+namespace Linux
+{
+	// ===============================================================================================================================
+	// ====================================================== ARENA TEMPS ============================================================
+	// ===============================================================================================================================
+
+	//? Nested Arena_Temp_Scope restore arena in LIFO order, only outermost one gives pages above retained size back
+	internal void test_arena_temps(Alloc_Arena*)
+	{
+		Alloc_Arena arena = arena_reserve(MiB(64), KiB(64));
+		AlwaysAssert(arena.base && "Failed to reserve memory from OS");
+		arena.retained_size = KiB(64);
+		(void)allocate(&arena, 100);
+		u64 offsets[3] = { arena.curr_offset };
+		u64 prev_offsets[3] = { arena.prev_offset };
+		{
+			Arena_Temp_Scope outer(&arena);
+			(void)allocate(&arena, 1000);
+			offsets[1] = arena.curr_offset;
+			prev_offsets[1] = arena.prev_offset;
+			{
+				Arena_Temp_Scope middle(&arena);
+				(void)allocate(&arena, MiB(8));
+				offsets[2] = arena.curr_offset;
+				prev_offsets[2] = arena.prev_offset;
+				{
+					Arena_Temp_Scope inner(&arena);
+					(void)allocate(&arena, 10);
+				}
+				TestCheck(arena.curr_offset == offsets[2] && arena.prev_offset == prev_offsets[2]);
+			}
+			TestCheck(arena.curr_offset == offsets[1] && arena.prev_offset == prev_offsets[1]);
+		}
+		TestCheck(arena.curr_offset == offsets[0] && arena.prev_offset == prev_offsets[0]);
+		// Temp above used memory must not decommit
+		TestCheck(arena.committed_size > arena.retained_size);
+
+		arena_reset(&arena);
+		{
+			Arena_Temp_Scope outermost(&arena);
+			(void)allocate(&arena, MiB(8));
+		}
+		TestCheck(arena.curr_offset == 0 && arena.committed_size == arena.retained_size);
+
+		vm_release(arena.base, arena.max_size);
+	}
+
+	// ===============================================================================================================================
+	// ======================================================= ARENA RECLAIM =========================================================
+	// ===============================================================================================================================
+
+	//? "reclaim_pages" arena with threshold below one page: freed ranges that start and end inside one page, span page
+	//? boundary or cover whole pages all read as zero on next allocation
+	internal void test_arena_reclaim(Alloc_Arena*)
+	{
+		constexpr u64 used_offsets[] = { 100, 4000, 4096 };
+		constexpr u64 freed_sizes[] = { 16, 100, 4096, 5000, 9000, KiB(64) };
+
+		Alloc_Arena arena = arena_reserve(MiB(4), KiB(64));
+		AlwaysAssert(arena.base && "Failed to reserve memory from OS");
+		arena.zeroing = Alloc_Zeroing::reclaim_pages;
+		arena.reclaim_threshold = 16;
+		for (u64 used_offset : used_offsets)
+		{
+			for (u64 freed_size : freed_sizes)
+			{
+				arena_reset(&arena);
+				(void)allocate(&arena, used_offset, 1);
+				{
+					Arena_Temp_Scope temp(&arena);
+					memset(allocate(&arena, freed_size, 1), 0xab, freed_size);
+				}
+				const byte* reused = (const byte*)allocate(&arena, freed_size, 1);
+				u64 count_dirty = 0;
+				for (u64 i = 0; i < freed_size; ++i)
+					count_dirty += (reused[i] != 0);
+				TestCheck(count_dirty == 0);
+			}
+		}
+
+		vm_release(arena.base, arena.max_size);
+	}
+
+	// ===============================================================================================================================
+	// ======================================================= SCRATCH ===============================================================
+	// ===============================================================================================================================
+
+	//? Callee that fills output arena and needs its own scratch, as functions taking "arena_to_push" do
+	internal u64* push_squares_with_scratch(Alloc_Arena* arena_to_push, u32 count)
+	{
+		Arena_Temp_Scope scratch = get_scratch(arena_to_push);
+		TestCheck(scratch.arena() != arena_to_push);
+
+		u64* temp = (u64*)allocate(scratch.arena(), count * sizeof(u64));
+		for (u32 i = 0; i < count; ++i)
+			temp[i] = (u64)i * i;
+
+		u64* out = (u64*)allocate(arena_to_push, count * sizeof(u64));
+		memcpy(out, temp, count * sizeof(u64));
+		return out;
+	}
+
+	//? get_scratch picks the other scratch arena when caller scratch is its output arena, in both directions, and
+	//? memory of ended scratch scope reads as zero. Runs on own thread, so scratch arenas start unreserved
+	internal void test_scratch(Alloc_Arena*)
+	{
+		run_on_threads(clock_create(), 1, [&](u32)
+		{
+			TestCheck(g_scratch_arenas[0].base == nullptr && g_scratch_arenas[1].base == nullptr);
+			{
+				Arena_Temp_Scope scratch = get_scratch();
+				// Second scratch is reserved only when needed
+				TestCheck(scratch.arena() == &g_scratch_arenas[0] && g_scratch_arenas[1].base == nullptr);
+
+				// Caller data in its scratch survives callee scratch use, callee result lands in caller scratch
+				u64* caller = (u64*)allocate(scratch.arena(), 64 * sizeof(u64));
+				for (u32 i = 0; i < 64; ++i)
+					caller[i] = ~(u64)i;
+				u64 caller_end = scratch.arena()->curr_offset;
+
+				u64* squares = push_squares_with_scratch(scratch.arena(), 1000);
+				TestCheck(g_scratch_arenas[1].curr_offset == 0);
+				TestCheck((byte*)squares >= scratch.arena()->base + caller_end &&
+				          (byte*)squares < scratch.arena()->base + scratch.arena()->curr_offset);
+				for (u32 i = 0; i < 64; ++i)
+					TestCheck(caller[i] == ~(u64)i);
+				for (u32 i = 0; i < 1000; ++i)
+					TestCheck(squares[i] == (u64)i * i);
+
+				// Other direction, first scratch is the output
+				Arena_Temp_Scope second = get_scratch(scratch.arena());
+				TestCheck(second.arena() == &g_scratch_arenas[1]);
+				u64* back = push_squares_with_scratch(second.arena(), 10);
+				TestCheck(back[9] == 81 && g_scratch_arenas[0].curr_offset >= caller_end);
+			}
+			TestCheck(g_scratch_arenas[0].curr_offset == 0 && g_scratch_arenas[1].curr_offset == 0);
+
+			// Scratch zeroes on allocate
+			{
+				Arena_Temp_Scope scratch = get_scratch();
+				memset(allocate(scratch.arena(), KiB(4)), 0xab, KiB(4));
+			}
+			{
+				Arena_Temp_Scope scratch = get_scratch();
+				const byte* reused = (const byte*)allocate(scratch.arena(), KiB(4));
+				for (u32 i = 0; i < KiB(4); ++i)
+					TestCheck(reused[i] == 0);
+			}
+		});
+	}
+
+	// ===============================================================================================================================
+	// ======================================================= ARENA ARRAY ===========================================================
+	// ===============================================================================================================================
+
+	//? Elements survive growth in place, growth that moves array behind other allocation and reserved array
+	internal void test_arena_array(Alloc_Arena* arena)
+	{
+		constexpr u64 count_elements = 1 << 20;
+
+		for (u32 config_i = 0; config_i < 3; ++config_i)
+		{
+			Arena_Temp_Scope temp(arena);
+			Arena_Array<u32> array;
+			array.init(arena, (config_i == 2) ? count_elements : 0);
+			for (u64 i = 0; i < count_elements; ++i)
+			{
+				array.push((u32)i);
+				// Something else takes arena end every time array is about to grow
+				if (config_i == 1 && array.count == array.capacity)
+					*(u32*)allocate(arena, sizeof(u32)) = ~(u32)i;
+			}
+
+			TestCheck(array.count == count_elements && array.capacity >= count_elements);
+			for (u64 i = 0; i < count_elements; ++i)
+				TestCheck(array[i] == (u32)i);
+		}
+	}
+	// ===============================================================================================================================
+	// ======================================================= VM ARRAY ==============================================================
+	// ===============================================================================================================================
+
+	//? VM_Array grows in place past several commit steps (data never moves, commit stays multiple of step inside
+	//? reservation), shrinks back by pop and erase_swap, and elements added after shrink read as zero again
+	internal void test_vm_array(Alloc_Arena*)
+	{
+		constexpr u64 commit_step = KiB(64);
+		constexpr u64 count_per_step = commit_step / sizeof(u64);
+		constexpr u64 count_elements = count_per_step * 5 + 3;
+		constexpr u64 count_kept = 10;
+
+		VM_Array<u64> array(MiB(16), 16, commit_step);
+		TestCheck(array.get_size() == 0 && array.get_capacity() >= 16);
+		TestCheck(VMAllocGetHeader(array.origin)->committed_bytes == commit_step);
+		const u64* first = array.begin();
+
+		u64 count_grows = 0;
+		u64 prev_capacity = array.get_capacity();
+		for (u64 i = 0; i < count_elements; ++i)
+		{
+			array.push(i * 3);
+			if (array.get_capacity() != prev_capacity)
+			{
+				const VM_Alloc_Header* header = VMAllocGetHeader(array.origin);
+				TestCheck(header->committed_bytes % commit_step == 0 && header->committed_bytes <= header->reserved_bytes);
+				TestCheck(array.get_capacity() > prev_capacity);
+				prev_capacity = array.get_capacity();
+				++count_grows;
+			}
+		}
+		TestCheck(count_grows >= 2 && array.begin() == first);
+		TestCheck(array.get_size() == count_elements && *array.last() == (count_elements - 1) * 3);
+		for (u64 i = 0; i < count_elements; ++i)
+			TestCheck(array[i] == i * 3);
+
+		// Shrink, last element takes place of erased one
+		while (array.get_size() > count_kept + 1)
+			array.pop();
+		array.erase_swap(0);
+		TestCheck(array.get_size() == count_kept && array[0] == count_kept * 3);
+		for (u64 i = 1; i < count_kept; ++i)
+			TestCheck(array[i] == i * 3);
+
+		// Grow again over memory of popped elements
+		array.add_elements_0(count_per_step * 2);
+		TestCheck(array.get_size() == count_kept + count_per_step * 2 && array.begin() == first);
+		u64 count_dirty = 0;
+		for (u64 i = count_kept; i < array.get_size(); ++i)
+			count_dirty += (array[i] != 0);
+		TestCheck(count_dirty == 0);
+	}
+} // namespace Linux